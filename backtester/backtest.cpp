@@ -0,0 +1,355 @@
+#include "backtest.hpp"
+#include "tsc_clock.hpp"
+#include <algorithm>
+#include <atomic>
+#include <queue>
+#include <random>
+#include <thread>
+
+namespace hft {
+namespace backtester {
+
+namespace {
+
+// Synthetic orders standing for captured quotes, clear of captured and child ids
+constexpr uint64_t QUOTE_ID_BASE = 1ULL << 61;
+
+struct Event {
+    uint64_t time;
+    uint64_t sequence;       // Ties broken in creation order
+    uint32_t parent_id;
+    bool arrival;            // Child reaching the venue, else its outcome reaching the strategy
+    lob::OrderRequest request;
+    int32_t filled;
+    int64_t notional;
+};
+
+struct Later {
+    bool operator()(const Event& a, const Event& b) const {
+        return a.time != b.time ? a.time > b.time : a.sequence > b.sequence;
+    }
+};
+
+struct SymbolState {
+    std::unique_ptr<lob::MatchingEngine> venue;
+    std::vector<uint32_t> parents;   // Indexes into BacktestRun::parents
+    double tick_value = 0.0;         // Decimal price of one tick
+    double last_trade = 0.0;
+};
+
+struct ParentState {
+    uint32_t id = 0;                 // ExecutionEngine parent id
+    bool accepted = false;
+    bool arrived = false;
+    double arrival_price = 0.0;
+    double market_notional = 0.0;
+    double market_volume = 0.0;
+};
+
+class Simulation {
+public:
+    Simulation(const ingestion::CaptureReader& capture, const BacktestConfig& config, const BacktestRun& run)
+        : capture_(capture),
+          config_(config),
+          run_(run),
+          algos_(engine_config(capture, config, run)),
+          symbols_(capture.symbol_count()),
+          parents_(run.parents.size()),
+          trades_(std::max<size_t>(config.max_trades, 1)),
+          rng_(run.latency.seed) {}
+
+    BacktestResult execute() {
+        BacktestResult result;
+        uint64_t started = ingestion::TscClock::instance().ticks();
+        result.parents.resize(run_.parents.size());
+
+        lob::MatchingEngineConfig venue_config;
+        venue_config.book = config_.book;
+        venue_config.measure_latency = false;
+        for (size_t i = 0; i < run_.parents.size(); ++i) {
+            uint32_t symbol_id = run_.parents[i].symbol_id;
+            if (symbol_id >= symbols_.size()) {
+                continue;  // start() reports NO_VENUE
+            }
+            SymbolState& symbol = symbols_[symbol_id];
+            if (!symbol.venue) {
+                symbol.venue.reset(new lob::MatchingEngine(venue_config));
+                const lob::OrderBook& book = symbol.venue->book();
+                symbol.tick_value = ingestion::price_to_double(book.to_price(1), book.tick_units());
+                algos_.attach(symbol_id, symbol.venue.get());
+            }
+            symbol.parents.push_back(static_cast<uint32_t>(i));
+        }
+
+        algos_.set_router([this](uint32_t parent_id, const lob::OrderRequest& request) {
+            uint64_t jitter = run_.latency.jitter_ns ? rng_() % run_.latency.jitter_ns : 0;
+            push(algos_.now_ns() + run_.latency.order_ns + jitter, parent_id, true, request, 0, 0);
+        });
+        for (size_t i = 0; i < run_.parents.size(); ++i) {
+            result.parents[i].status = algos_.start(run_.parents[i], parents_[i].id);
+            if (result.parents[i].status == strategy::ExecutionStatus::ACCEPTED) {
+                parents_[i].accepted = true;
+                index_of_.push_back(static_cast<uint32_t>(i));  // Engine ids count up from 0
+            }
+        }
+
+        size_t first = capture_.time_sorted() ? capture_.lower_bound(config_.from_ns) : 0;
+        uint64_t now = algos_.now_ns();
+        for (size_t r = first; r < capture_.size(); ++r) {
+            const ingestion::MarketMessage& message = capture_[r];
+            if (message.timestamp < config_.from_ns) {
+                continue;
+            }
+            if (message.timestamp >= config_.to_ns) {
+                if (capture_.time_sorted()) {
+                    break;
+                }
+                continue;
+            }
+            now = std::max(now, message.timestamp);  // Out-of-order records replay at the latest time seen
+            deliver_until(now);
+            replay(message, now);
+            result.messages++;
+        }
+
+        summarize(result);
+        result.elapsed_ns = ingestion::TscClock::instance().ticks_to_ns(
+            ingestion::TscClock::instance().ticks() - started);
+        return result;
+    }
+
+private:
+    static strategy::ExecutionConfig engine_config(const ingestion::CaptureReader& capture,
+                                                   const BacktestConfig& config, const BacktestRun& run) {
+        strategy::ExecutionConfig engine;
+        uint64_t first = capture.size() ? capture.header().min_timestamp : 0;
+        engine.start_ns = std::max<uint64_t>(std::max(first, config.from_ns), 1);  // 0 would mean wall clock
+        engine.resolution_ns = run.resolution_ns;
+        engine.volume_bucket_ns = run.volume_bucket_ns;
+        engine.symbol_capacity = std::max<size_t>(capture.symbol_count(), 1);
+        engine.max_trades_per_child = config.max_trades;
+        return engine;
+    }
+
+    void push(uint64_t time, uint32_t parent_id, bool arrival, const lob::OrderRequest& request, int32_t filled,
+              int64_t notional) {
+        events_.push(Event{time, sequence_++, parent_id, arrival, request, filled, notional});
+    }
+
+    // Fires due slices and delivers latency events up to time, in time
+    // order. Slices falling due within one advance() see in-flight state
+    // as of its start; in-flight quantity is never resent either way.
+    void deliver_until(uint64_t time) {
+        for (;;) {
+            uint64_t next = time;
+            if (!events_.empty() && events_.top().time < next) {
+                next = events_.top().time;
+            }
+            algos_.advance(next);
+            if (events_.empty() || events_.top().time > time) {
+                return;
+            }
+            Event event = events_.top();
+            events_.pop();
+            deliver(event);
+        }
+    }
+
+    void deliver(const Event& event) {
+        uint32_t index = index_of_[event.parent_id];
+        if (!event.arrival) {
+            algos_.on_child_result(event.parent_id, event.request, event.filled, event.notional);
+            return;
+        }
+        uint32_t symbol_id = run_.parents[index].symbol_id;
+        lob::MatchingEngine& venue = *symbols_[symbol_id].venue;
+        ParentState& parent = parents_[index];
+        if (!parent.arrived) {
+            parent.arrived = true;
+            parent.arrival_price = mark(symbol_id);
+        }
+        lob::MatchResult result = venue.submit(event.request, trades_.data(), trades_.size());
+        push(event.time + run_.latency.response_ns, event.parent_id, false, event.request, result.filled,
+             strategy::fill_notional(trades_.data(), result.trades));
+    }
+
+    void replay(const ingestion::MarketMessage& message, uint64_t now) {
+        if (message.symbol_id >= symbols_.size()) {
+            return;
+        }
+        SymbolState& symbol = symbols_[message.symbol_id];
+        switch (message.type) {
+            case ingestion::MessageType::TRADE:
+                algos_.on_message(message);
+                if (symbol.venue) {
+                    symbol.last_trade = ingestion::price_to_double(message.price, symbol.venue->book().tick_units());
+                    for (uint32_t index : symbol.parents) {
+                        ParentState& parent = parents_[index];
+                        if (!parent.accepted) {
+                            continue;
+                        }
+                        const strategy::ExecutionParams& params = algos_.report(parent.id)->params;
+                        if (now >= params.start_ns && now < params.end_ns) {
+                            parent.market_notional += symbol.last_trade * message.size;
+                            parent.market_volume += message.size;
+                        }
+                    }
+                }
+                break;
+            case ingestion::MessageType::NEW_ORDER:
+            case ingestion::MessageType::CANCEL_ORDER:
+            case ingestion::MessageType::MODIFY_ORDER:
+                if (symbol.venue) {
+                    symbol.venue->apply(message, trades_.data(), trades_.size());
+                }
+                break;
+            case ingestion::MessageType::QUOTE:
+                if (symbol.venue) {
+                    requote(message);
+                }
+                break;
+            default:
+                break;
+        }
+    }
+
+    static uint64_t quote_id(uint32_t symbol_id, ingestion::Side side) {
+        return QUOTE_ID_BASE + symbol_id * 2ULL + (side == ingestion::Side::SELL ? 1 : 0);
+    }
+
+    // Captured quotes replace the synthetic orders at the touch; both sides
+    // of a two-sided quote come out before either goes back in
+    void requote(const ingestion::MarketMessage& message) {
+        lob::MatchingEngine& venue = *symbols_[message.symbol_id].venue;
+        if (message.two_sided()) {
+            venue.cancel(quote_id(message.symbol_id, ingestion::Side::BUY));
+            venue.cancel(quote_id(message.symbol_id, ingestion::Side::SELL));
+            place(message.symbol_id, ingestion::Side::BUY, message.price, message.size);
+            place(message.symbol_id, ingestion::Side::SELL, message.ask_price, message.ask_size);
+        } else if (message.side == ingestion::Side::BUY || message.side == ingestion::Side::SELL) {
+            venue.cancel(quote_id(message.symbol_id, message.side));
+            place(message.symbol_id, message.side, message.price, message.size);
+        }
+    }
+
+    void place(uint32_t symbol_id, ingestion::Side side, ingestion::Price price, int32_t size) {
+        lob::MatchingEngine& venue = *symbols_[symbol_id].venue;
+        lob::OrderRequest request;
+        request.id = quote_id(symbol_id, side);
+        request.price = venue.book().to_ticks(price);
+        request.quantity = size;
+        request.side = side;
+        if (size > 0 && request.price > 0) {
+            venue.submit(request, trades_.data(), trades_.size());
+        }
+    }
+
+    // Mid of the simulated book, or the last trade with one side empty
+    double mark(uint32_t symbol_id) const {
+        const SymbolState& symbol = symbols_[symbol_id];
+        lob::BookLevel bid;
+        lob::BookLevel ask;
+        if (symbol.venue->book().best_bid(bid) && symbol.venue->book().best_ask(ask)) {
+            return (bid.price + ask.price) * 0.5 * symbol.tick_value;
+        }
+        return symbol.last_trade;
+    }
+
+    void summarize(BacktestResult& result) {
+        for (size_t i = 0; i < parents_.size(); ++i) {
+            ParentResult& out = result.parents[i];
+            if (out.status != strategy::ExecutionStatus::ACCEPTED) {
+                out.report.params = run_.parents[i];
+                continue;
+            }
+            out.report = *algos_.report(parents_[i].id);
+            const strategy::ExecutionReport& report = out.report;
+            const SymbolState& symbol = symbols_[report.params.symbol_id];
+            double sign = report.params.side == ingestion::Side::BUY ? 1.0 : -1.0;
+            double notional = report.notional * symbol.tick_value;
+
+            out.fill_rate = static_cast<double>(report.filled) / report.params.quantity;
+            out.arrival_price = parents_[i].arrival_price;
+            if (parents_[i].market_volume > 0.0) {
+                out.market_vwap = parents_[i].market_notional / parents_[i].market_volume;
+            }
+            if (report.filled > 0) {
+                out.average_price = notional / report.filled;
+                if (out.arrival_price > 0.0) {
+                    out.slippage_bps = sign * (out.average_price - out.arrival_price) / out.arrival_price * 1e4;
+                }
+                if (out.market_vwap > 0.0) {
+                    out.vwap_slippage_bps = sign * (out.average_price - out.market_vwap) / out.market_vwap * 1e4;
+                }
+                out.pnl = sign * (report.filled * mark(report.params.symbol_id) - notional);
+            }
+
+            result.children += report.children;
+            result.quantity += report.params.quantity;
+            result.filled += report.filled;
+            result.pnl += out.pnl;
+        }
+        if (result.quantity > 0) {
+            result.fill_rate = static_cast<double>(result.filled) / result.quantity;
+        }
+    }
+
+    const ingestion::CaptureReader& capture_;
+    const BacktestConfig& config_;
+    const BacktestRun& run_;
+    strategy::ExecutionEngine algos_;
+    std::vector<SymbolState> symbols_;
+    std::vector<ParentState> parents_;
+    std::vector<uint32_t> index_of_;   // Engine parent id -> BacktestRun::parents index
+    std::vector<lob::Trade> trades_;
+    std::priority_queue<Event, std::vector<Event>, Later> events_;
+    uint64_t sequence_ = 0;
+    std::mt19937_64 rng_;
+};
+
+} // namespace
+
+Backtest::Backtest(const ingestion::CaptureReader& capture, const BacktestConfig& config)
+    : capture_(capture), config_(config) {}
+
+BacktestResult Backtest::run(const BacktestRun& run) const {
+    Simulation simulation(capture_, config_, run);
+    return simulation.execute();
+}
+
+std::vector<BacktestResult> Backtest::sweep(const std::vector<BacktestRun>& runs, size_t threads) const {
+    std::vector<BacktestResult> results(runs.size());
+    if (threads == 0) {
+        threads = std::max<size_t>(std::thread::hardware_concurrency(), 1);
+    }
+    threads = std::min(threads, runs.size());
+
+    std::atomic<size_t> next{0};
+    auto worker = [&]() {
+        for (size_t i = next.fetch_add(1, std::memory_order_relaxed); i < runs.size();
+             i = next.fetch_add(1, std::memory_order_relaxed)) {
+            results[i] = run(runs[i]);
+        }
+    };
+    std::vector<std::thread> pool;
+    for (size_t t = 1; t < threads; ++t) {
+        pool.emplace_back(worker);
+    }
+    worker();
+    for (std::thread& thread : pool) {
+        thread.join();
+    }
+    return results;
+}
+
+std::unique_ptr<ingestion::SymbolRegistry> Backtest::symbol_registry() const {
+    std::unique_ptr<ingestion::SymbolRegistry> registry(
+        new ingestion::SymbolRegistry(std::max<size_t>(capture_.symbol_count(), 1)));
+    for (uint32_t id = 0; id < capture_.symbol_count(); ++id) {
+        registry->intern(capture_.symbol(id));
+    }
+    return registry;
+}
+
+} // namespace backtester
+} // namespace hft
@@ -0,0 +1,98 @@
+#pragma once
+
+#include "capture_file.hpp"
+#include "execution_engine.hpp"
+#include "matching_engine.hpp"
+#include "symbol_registry.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace hft {
+namespace backtester {
+
+// Simulated one-way delays between the strategy and the venue. Each child
+// reaches the venue order_ns (+ jitter) after its slice fires; the outcome
+// reaches the strategy response_ns later. Jitter is drawn from a generator
+// seeded per run, so a run is reproducible regardless of sweep threading.
+struct LatencyModel {
+    uint64_t order_ns = 0;
+    uint64_t response_ns = 0;
+    uint64_t jitter_ns = 0;      // Uniform [0, jitter_ns) added to each order leg
+    uint64_t seed = 1;
+};
+
+// One parameter set: the parent orders to work and the latency they see
+struct BacktestRun {
+    std::vector<strategy::ExecutionParams> parents;
+    LatencyModel latency;
+    uint64_t resolution_ns = strategy::TimerWheel::DEFAULT_RESOLUTION_NS;
+    uint64_t volume_bucket_ns = strategy::VolumeCurve::DEFAULT_BUCKET_NS;
+};
+
+struct ParentResult {
+    strategy::ExecutionStatus status = strategy::ExecutionStatus::ACCEPTED;
+    strategy::ExecutionReport report;
+    double fill_rate = 0.0;          // filled / quantity
+    double average_price = 0.0;      // Of the fills, decimal
+    double arrival_price = 0.0;      // Mid (or last trade) when the first child reached the venue
+    double market_vwap = 0.0;        // Of the capture's trade prints inside the window
+    double slippage_bps = 0.0;       // Against arrival; positive is a cost for either side
+    double vwap_slippage_bps = 0.0;  // Against market_vwap
+    double pnl = 0.0;                // Fills marked to the closing mid (or last trade)
+};
+
+struct BacktestResult {
+    std::vector<ParentResult> parents;
+    uint64_t messages = 0;           // Capture records replayed
+    uint64_t children = 0;           // Child orders that reached the venue
+    int64_t quantity = 0;            // Over accepted parents
+    int64_t filled = 0;
+    double fill_rate = 0.0;
+    double pnl = 0.0;
+    uint64_t elapsed_ns = 0;         // Wall time of the run
+};
+
+struct BacktestConfig {
+    lob::OrderBookConfig book;       // Per simulated symbol; tick_units as the capture was priced with
+    size_t max_trades = 256;         // Fill records per order
+    uint64_t from_ns = 0;            // Replay window over the capture's timestamps
+    uint64_t to_ns = UINT64_MAX;
+};
+
+// Deterministic backtest kernel over a capture file (capture_file.hpp).
+//
+// Each run replays the capture in timestamp order through one
+// MatchingEngine per traded symbol and an ExecutionEngine driven by the
+// records' timestamps. Captured NEW/CANCEL/MODIFY messages go into the
+// book as-is; QUOTEs become resting orders at the quoted bid and ask, so
+// children trade against displayed size. Before each record the kernel
+// fires due slices and delivers latency events up to its timestamp, in
+// (time, sequence) order. Metrics accumulate online as the run proceeds.
+//
+// run() only reads the capture and keeps all state on its own stack, so
+// sweep() runs many parameter sets on separate threads over one shared
+// read-only mapping.
+class Backtest {
+public:
+    explicit Backtest(const ingestion::CaptureReader& capture, const BacktestConfig& config = BacktestConfig());
+
+    BacktestResult run(const BacktestRun& run) const;
+
+    // Results in the order of runs; threads 0 = one per hardware thread
+    std::vector<BacktestResult> sweep(const std::vector<BacktestRun>& runs, size_t threads = 0) const;
+
+    // Registry whose ids are the capture's symbol ids, so parse_execution_params()
+    // symbol names resolve against this file
+    std::unique_ptr<ingestion::SymbolRegistry> symbol_registry() const;
+
+    const ingestion::CaptureReader& capture() const { return capture_; }
+
+private:
+    const ingestion::CaptureReader& capture_;
+    BacktestConfig config_;
+};
+
+} // namespace backtester
+} // namespace hft
@@ -0,0 +1,191 @@
+// Unit tests for the capture-driven backtest kernel.
+
+#include "backtest.hpp"
+#include "capture_file.hpp"
+#include "execution_engine.hpp"
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+using namespace hft::backtester;
+using namespace hft::ingestion;
+using namespace hft::strategy;
+
+static int g_failures = 0;
+
+#define CHECK(cond)                                                           \
+    do {                                                                      \
+        if (!(cond)) {                                                        \
+            std::fprintf(stderr, "%s:%d: CHECK failed: %s\n", __FILE__, __LINE__, #cond); \
+            g_failures++;                                                     \
+        }                                                                     \
+    } while (0)
+
+namespace {
+
+constexpr uint64_t MS = 1000000ULL;
+constexpr uint64_t SECOND = 1000 * MS;
+constexpr uint64_t T0 = 1705312800ULL * SECOND;  // 2024-01-15 10:00:00 UTC
+constexpr int64_t CENT = 1000000;                // 0.01 in raw fixed-point units
+
+bool near(double a, double b) { return std::fabs(a - b) < 1e-6; }
+
+MarketMessage quote(uint64_t timestamp, const char* symbol, int64_t bid, int64_t ask) {
+    MarketMessage message;
+    message.timestamp = timestamp;
+    message.type = MessageType::QUOTE;
+    message.set_symbol(symbol);
+    message.flags = MESSAGE_FLAG_TWO_SIDED;
+    message.price = ticks_to_price(bid, CENT);
+    message.size = 500;
+    message.ask_price = ticks_to_price(ask, CENT);
+    message.ask_size = 300;
+    return message;
+}
+
+MarketMessage trade(uint64_t timestamp, int64_t price) {
+    MarketMessage message;
+    message.timestamp = timestamp;
+    message.type = MessageType::TRADE;
+    message.set_symbol("AAPL");
+    message.side = Side::BUY;
+    message.price = ticks_to_price(price, CENT);
+    message.size = 100;
+    return message;
+}
+
+// AAPL quoted 100.00 / 100.02 every second, printing at the offer in
+// between; the offer flickers to 100.05 at +1.1 s. SPY is never traded.
+bool write_capture(const std::string& path) {
+    CaptureWriter writer;
+    if (!writer.open(path, 8)) {
+        return false;
+    }
+    for (uint64_t s = 0; s < 10; ++s) {
+        writer.append(quote(T0 + s * SECOND, "AAPL", 10000, 10002));
+        writer.append(quote(T0 + s * SECOND, "SPY", 47000, 47001));
+        if (s == 1) {
+            writer.append(quote(T0 + s * SECOND + 100 * MS, "AAPL", 10000, 10005));
+        }
+        writer.append(trade(T0 + s * SECOND + 500 * MS, 10002));
+    }
+    return writer.close();
+}
+
+ExecutionParams twap_buy() {
+    ExecutionParams params;
+    params.symbol_id = 0;
+    params.side = Side::BUY;
+    params.quantity = 400;
+    params.start_ns = T0 + SECOND;
+    params.duration_ns = 4 * SECOND;
+    params.slices = 2;
+    params.limit_price = 10002 * CENT;
+    return params;
+}
+
+void test_backtest(const CaptureReader& capture) {
+    BacktestConfig config;
+    config.book.tick_units = CENT;
+    Backtest backtest(capture, config);
+    CHECK(capture.symbol(0) == "AAPL");
+
+    // No latency: both children take 200 at the offer before the flicker
+    BacktestRun run;
+    run.parents.push_back(twap_buy());
+    ExecutionParams missing = twap_buy();
+    missing.symbol_id = 99;
+    run.parents.push_back(missing);
+    BacktestResult result = backtest.run(run);
+    CHECK(result.messages == capture.size());
+    CHECK(result.parents.size() == 2 && result.parents[1].status == ExecutionStatus::NO_VENUE);
+    const ParentResult& fast = result.parents[0];
+    CHECK(fast.status == ExecutionStatus::ACCEPTED && fast.report.state == ExecutionState::FILLED);
+    CHECK(fast.report.filled == 400 && fast.report.children == 2 && near(fast.fill_rate, 1.0));
+    CHECK(near(fast.average_price, 100.02) && near(fast.arrival_price, 100.01));
+    CHECK(near(fast.slippage_bps, 0.01 / 100.01 * 1e4));
+    CHECK(near(fast.market_vwap, 100.02) && near(fast.vwap_slippage_bps, 0.0));
+    CHECK(near(fast.pnl, 400 * (100.01 - 100.02)) && near(result.pnl, fast.pnl));
+    CHECK(result.quantity == 400 && result.filled == 400 && result.children == 2);
+
+    // 200 ms to the venue: the first child meets the 100.05 offer and misses,
+    // the second sends the shortfall but only 300 are displayed
+    run.parents.resize(1);
+    run.latency.order_ns = 200 * MS;
+    BacktestResult slow = backtest.run(run);
+    const ExecutionReport& late = slow.parents[0].report;
+    CHECK(late.state == ExecutionState::EXPIRED && late.children == 2 && late.filled == 300);
+    CHECK(near(slow.fill_rate, 0.75) && near(slow.parents[0].arrival_price, 100.025));
+
+    // Slow acks: the second slice does not resend the first child's quantity
+    run.latency.order_ns = 0;
+    run.latency.response_ns = 5 * SECOND;
+    BacktestResult acked = backtest.run(run);
+    CHECK(acked.parents[0].report.state == ExecutionState::FILLED && acked.parents[0].report.in_flight == 0);
+    CHECK(acked.parents[0].report.filled == 400 && acked.parents[0].report.children == 2);
+
+    // Data ends with the result still in flight: the parent stays WORKING
+    BacktestConfig short_window = config;
+    short_window.to_ns = T0 + 5 * SECOND;
+    BacktestResult cut = Backtest(capture, short_window).run(run);
+    CHECK(cut.parents[0].report.state == ExecutionState::WORKING && cut.parents[0].report.in_flight == 400);
+    CHECK(cut.messages < capture.size());
+
+    // Symbol names resolve to the capture's ids
+    auto registry = backtest.symbol_registry();
+    ExecutionParams parsed;
+    CHECK(parse_execution_params("symbol=SPY side=sell quantity=10", parsed, registry.get()) && parsed.symbol_id == 1);
+    CHECK(!parse_execution_params("symbol=MSFT side=sell quantity=10", parsed, registry.get()));
+}
+
+void test_sweep(const CaptureReader& capture) {
+    BacktestConfig config;
+    config.book.tick_units = CENT;
+    Backtest backtest(capture, config);
+
+    std::vector<BacktestRun> runs;
+    for (uint64_t latency = 0; latency < 6; ++latency) {
+        BacktestRun run;
+        run.parents.push_back(twap_buy());
+        run.latency.order_ns = latency * 100 * MS;
+        run.latency.jitter_ns = 50 * MS;
+        run.latency.seed = latency + 1;
+        runs.push_back(run);
+    }
+    std::vector<BacktestResult> serial = backtest.sweep(runs, 1);
+    std::vector<BacktestResult> parallel = backtest.sweep(runs, 3);
+    CHECK(serial.size() == runs.size() && parallel.size() == runs.size());
+    bool same = true;
+    for (size_t i = 0; i < runs.size(); ++i) {
+        same = same && serial[i].filled == parallel[i].filled && serial[i].pnl == parallel[i].pnl &&
+               serial[i].parents[0].arrival_price == parallel[i].parents[0].arrival_price;
+    }
+    CHECK(same);
+    CHECK(serial[0].filled == 400 && serial[2].filled == 300);  // Runs stay in input order
+    CHECK(backtest.sweep(std::vector<BacktestRun>(), 4).empty());
+}
+
+} // namespace
+
+int main() {
+    const std::string path = "backtest_test.cap";
+    CHECK(write_capture(path));
+    CaptureReader capture;
+    CHECK(capture.open(path, AccessPattern::NORMAL));
+    CHECK(capture.size() == 31);
+
+    test_backtest(capture);
+    test_sweep(capture);
+
+    capture.close();
+    std::remove(path.c_str());
+
+    if (g_failures > 0) {
+        std::fprintf(stderr, "%d check(s) failed\n", g_failures);
+        return 1;
+    }
+    std::printf("All backtester tests passed\n");
+    return 0;
+}
@@ -0,0 +1,108 @@
+#include "bbo_tracker.hpp"
+#include <algorithm>
+#include <utility>
+
+namespace hft {
+namespace ingestion {
+
+BboTracker::BboTracker(size_t symbol_capacity)
+    : states_(symbol_capacity, BboState{}), messages_applied_(0), events_published_(0), quotes_suppressed_(0) {}
+
+void BboTracker::subscribe(BboListener listener) {
+    listeners_.push_back(std::move(listener));
+}
+
+bool BboTracker::apply(const MarketMessage& message, BboEvent* event) {
+    messages_applied_++;
+    if (message.symbol_id >= states_.size()) {
+        return false;
+    }
+    BboState& state = states_[message.symbol_id];
+    BboEvent delta;
+    delta.timestamp = message.timestamp;
+    delta.symbol_id = message.symbol_id;
+    delta.trade_price = 0;
+    delta.trade_size = 0;
+    delta.changed = 0;
+    delta.trade_side = Side::UNKNOWN;
+
+    switch (message.type) {
+        case MessageType::QUOTE:
+        case MessageType::MARKET_DATA:
+            if (!update_quote(message, state, delta)) {
+                return false;
+            }
+            break;
+        case MessageType::TRADE:
+            state.last_trade_price = message.price;
+            state.last_trade_size = message.size;
+            state.trade_timestamp = message.timestamp;
+            delta.type = BboEventType::TRADE;
+            delta.trade_price = message.price;
+            delta.trade_size = message.size;
+            delta.trade_side = message.side;
+            break;
+        default:
+            return false;
+    }
+    delta.bbo = state.bbo;
+
+    events_published_++;
+    for (const BboListener& listener : listeners_) {
+        listener(delta);
+    }
+    if (event) {
+        *event = delta;
+    }
+    return true;
+}
+
+size_t BboTracker::apply(const MarketMessage* messages, size_t count, BboEvent* events) {
+    size_t produced = 0;
+    for (size_t i = 0; i < count; ++i) {
+        if (apply(messages[i], events ? events + produced : nullptr)) {
+            produced++;
+        }
+    }
+    return produced;
+}
+
+void BboTracker::clear() {
+    std::fill(states_.begin(), states_.end(), BboState{});
+    messages_applied_ = 0;
+    events_published_ = 0;
+    quotes_suppressed_ = 0;
+}
+
+bool BboTracker::update_quote(const MarketMessage& message, BboState& state, BboEvent& event) {
+    Bbo next = state.bbo;
+    if (message.two_sided()) {
+        next = Bbo{message.price, message.ask_price, message.size, message.ask_size};
+    } else if (message.side == Side::BUY) {
+        next.bid_price = message.price;
+        next.bid_size = message.size;
+    } else if (message.side == Side::SELL) {
+        next.ask_price = message.price;
+        next.ask_size = message.size;
+    } else {
+        return false;  // One-sided without a side says nothing about the BBO
+    }
+
+    uint8_t changed = (next.bid_price != state.bbo.bid_price ? BBO_BID_PRICE : 0) |
+                      (next.bid_size != state.bbo.bid_size ? BBO_BID_SIZE : 0) |
+                      (next.ask_price != state.bbo.ask_price ? BBO_ASK_PRICE : 0) |
+                      (next.ask_size != state.bbo.ask_size ? BBO_ASK_SIZE : 0);
+    if (changed == 0) {
+        quotes_suppressed_++;
+        return false;
+    }
+    state.bbo = next;
+    state.quote_timestamp = message.timestamp;
+    state.quote_changes++;
+    event.type = BboEventType::QUOTE;
+    event.changed = changed;
+    return true;
+}
+
+} // namespace ingestion
+} // namespace hft
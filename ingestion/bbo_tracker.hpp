@@ -0,0 +1,107 @@
+#pragma once
+
+#include "message_types.hpp"
+#include "symbol_registry.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+namespace hft {
+namespace ingestion {
+
+enum class BboEventType : uint8_t {
+    QUOTE = 1,  // Best bid and/or offer changed
+    TRADE = 2   // A trade printed
+};
+
+// BboEvent::changed
+constexpr uint8_t BBO_BID_PRICE = 1u << 0;
+constexpr uint8_t BBO_BID_SIZE = 1u << 1;
+constexpr uint8_t BBO_ASK_PRICE = 1u << 2;
+constexpr uint8_t BBO_ASK_SIZE = 1u << 3;
+
+struct Bbo {
+    Price bid_price;
+    Price ask_price;
+    int32_t bid_size;
+    int32_t ask_size;
+};
+
+// Compact change record: the BBO after the event, plus the print for trades
+struct BboEvent {
+    uint64_t timestamp;
+    Bbo bbo;
+    Price trade_price;   // TRADE only
+    int32_t trade_size;  // TRADE only
+    uint32_t symbol_id;
+    BboEventType type;
+    uint8_t changed;     // BBO_* fields that moved, 0 for trades
+    Side trade_side;     // Aggressor of a TRADE when the feed says
+};
+
+static_assert(sizeof(BboEvent) == 56, "BboEvent fits a cache line");
+
+// One cache line per symbol
+struct alignas(64) BboState {
+    Bbo bbo;
+    uint64_t quote_timestamp;  // Event time of the last BBO change, 0 if none yet
+    uint64_t trade_timestamp;
+    Price last_trade_price;
+    int32_t last_trade_size;
+    uint32_t quote_changes;
+};
+
+static_assert(sizeof(BboState) == 64, "BboState must occupy exactly one cache line");
+
+using BboListener = std::function<void(const BboEvent&)>;
+
+// Per-symbol top of book kept in a flat array indexed by symbol id.
+//
+// Two-sided QUOTEs (MESSAGE_FLAG_TWO_SIDED) replace the BBO; one-sided
+// QUOTE and MARKET_DATA messages update the side they name. Only changes
+// are published: a quote that repeats the current BBO produces no event, so
+// subscribers never reprocess unchanged quotes. Every TRADE produces one.
+// Order-level messages are left to the book (lob/).
+//
+// Single-threaded: listeners run on the applying thread in subscription
+// order. To consume on another thread, subscribe a listener that pushes
+// into an SpscQueue<BboEvent>.
+class BboTracker {
+public:
+    explicit BboTracker(size_t symbol_capacity = SymbolRegistry::DEFAULT_CAPACITY);
+
+    void subscribe(BboListener listener);
+
+    // Returns true and notifies listeners if the message changed the BBO or
+    // printed a trade; the event is also copied to *event when given
+    bool apply(const MarketMessage& message, BboEvent* event = nullptr);
+
+    // Applies a batch; events (room for count) receives only the deltas.
+    // Returns the number of events.
+    size_t apply(const MarketMessage* messages, size_t count, BboEvent* events = nullptr);
+
+    // Current state, nullptr for ids beyond the capacity
+    const BboState* state(uint32_t symbol_id) const {
+        return symbol_id < states_.size() ? &states_[symbol_id] : nullptr;
+    }
+
+    void clear();
+
+    size_t symbol_capacity() const { return states_.size(); }
+    uint64_t messages_applied() const { return messages_applied_; }
+    uint64_t events_published() const { return events_published_; }
+    uint64_t quotes_suppressed() const { return quotes_suppressed_; }  // Repeated the BBO
+
+private:
+    bool update_quote(const MarketMessage& message, BboState& state, BboEvent& event);
+
+    std::vector<BboState> states_;
+    std::vector<BboListener> listeners_;
+    uint64_t messages_applied_;
+    uint64_t events_published_;
+    uint64_t quotes_suppressed_;
+};
+
+} // namespace ingestion
+} // namespace hft
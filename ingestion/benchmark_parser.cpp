@@ -0,0 +1,473 @@
+// Parser throughput and latency benchmarks (Google Benchmark).
+//
+// Runs over synthetic FIX and JSON feeds of small/medium/large message sizes,
+// or over recorded corpora given through HFT_BENCH_FIX_CORPUS (raw FIX
+// stream, framed by BodyLength/CheckSum) and HFT_BENCH_JSON_CORPUS (one
+// object per line). Besides msgs/sec each benchmark reports ns/msg
+// percentiles, sampled over blocks of messages, and heap allocations per
+// message.
+//
+// After the run the binary exits non-zero if any parse benchmark falls below
+// --kpi_min_msgs_per_sec (default 100000, the README throughput target).
+
+#include "message_parser.hpp"
+#include "stream_framer.hpp"
+#include "tsc_clock.hpp"
+#include <benchmark/benchmark.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <new>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace hft::ingestion;
+
+// Global allocation counter, so the benchmarks can prove the hot path is allocation-free.
+// Every replaceable form funnels into these two; keeping them out of line stops
+// GCC from seeing free() applied to the result of operator new at inlined call sites.
+static std::atomic<size_t> g_allocations{0};
+
+__attribute__((noinline)) static void* counted_alloc(size_t size, size_t alignment) noexcept {
+    g_allocations.fetch_add(1, std::memory_order_relaxed);
+    if (size == 0) {
+        size = 1;
+    }
+    if (alignment <= alignof(std::max_align_t)) {
+        return std::malloc(size);
+    }
+    return std::aligned_alloc(alignment, (size + alignment - 1) / alignment * alignment);
+}
+
+__attribute__((noinline)) static void counted_free(void* ptr) noexcept { std::free(ptr); }
+
+static void* counted_alloc_or_throw(size_t size, size_t alignment) {
+    if (void* ptr = counted_alloc(size, alignment)) {
+        return ptr;
+    }
+    throw std::bad_alloc();
+}
+
+void* operator new(size_t size) { return counted_alloc_or_throw(size, 0); }
+void* operator new[](size_t size) { return counted_alloc_or_throw(size, 0); }
+void* operator new(size_t size, std::align_val_t al) { return counted_alloc_or_throw(size, static_cast<size_t>(al)); }
+void* operator new[](size_t size, std::align_val_t al) { return counted_alloc_or_throw(size, static_cast<size_t>(al)); }
+void* operator new(size_t size, const std::nothrow_t&) noexcept { return counted_alloc(size, 0); }
+void* operator new[](size_t size, const std::nothrow_t&) noexcept { return counted_alloc(size, 0); }
+void* operator new(size_t size, std::align_val_t al, const std::nothrow_t&) noexcept {
+    return counted_alloc(size, static_cast<size_t>(al));
+}
+void* operator new[](size_t size, std::align_val_t al, const std::nothrow_t&) noexcept {
+    return counted_alloc(size, static_cast<size_t>(al));
+}
+
+void operator delete(void* ptr) noexcept { counted_free(ptr); }
+void operator delete[](void* ptr) noexcept { counted_free(ptr); }
+void operator delete(void* ptr, size_t) noexcept { counted_free(ptr); }
+void operator delete[](void* ptr, size_t) noexcept { counted_free(ptr); }
+void operator delete(void* ptr, std::align_val_t) noexcept { counted_free(ptr); }
+void operator delete[](void* ptr, std::align_val_t) noexcept { counted_free(ptr); }
+void operator delete(void* ptr, size_t, std::align_val_t) noexcept { counted_free(ptr); }
+void operator delete[](void* ptr, size_t, std::align_val_t) noexcept { counted_free(ptr); }
+void operator delete(void* ptr, const std::nothrow_t&) noexcept { counted_free(ptr); }
+void operator delete[](void* ptr, const std::nothrow_t&) noexcept { counted_free(ptr); }
+void operator delete(void* ptr, std::align_val_t, const std::nothrow_t&) noexcept { counted_free(ptr); }
+void operator delete[](void* ptr, std::align_val_t, const std::nothrow_t&) noexcept { counted_free(ptr); }
+
+namespace {
+
+constexpr size_t CORPUS_MESSAGES = 4096;
+constexpr size_t LATENCY_BLOCK = 64;  // Messages per latency sample
+constexpr double DEFAULT_KPI_MSGS_PER_SEC = 100000.0;
+
+enum MessageSize { SMALL = 0, MEDIUM = 1, LARGE = 2 };
+
+const char* const SYMBOLS[] = {"AAPL", "MSFT", "GOOGL", "AMZN", "TSLA", "NVDA", "META", "JPM",
+                               "BRK.B", "XOM", "ES.Z4", "BTCUSD"};
+constexpr size_t SYMBOL_COUNT = sizeof(SYMBOLS) / sizeof(SYMBOLS[0]);
+
+// A contiguous buffer of frames in parse_batch() layout
+struct Corpus {
+    std::string data;
+    std::vector<uint32_t> offsets{0};
+
+    void add(const std::string& frame) {
+        data += frame;
+        offsets.push_back(static_cast<uint32_t>(data.size()));
+    }
+    size_t size() const { return offsets.size() - 1; }
+    const char* frame(size_t i) const { return data.data() + offsets[i]; }
+    size_t frame_length(size_t i) const { return offsets[i + 1] - offsets[i]; }
+};
+
+std::string format_price(std::mt19937_64& rng) {
+    char buf[32];
+    std::snprintf(buf, sizeof(buf), "%.2f", 10.0 + static_cast<double>(rng() % 500000) / 100.0);
+    return buf;
+}
+
+// Wraps a FIX body with BeginString, BodyLength and a valid CheckSum
+std::string make_fix_frame(const std::string& body) {
+    std::string frame = "8=FIX.4.4\x01" "9=" + std::to_string(body.size()) + "\x01" + body;
+    unsigned sum = 0;
+    for (unsigned char c : frame) {
+        sum += c;
+    }
+    char trailer[8];
+    std::snprintf(trailer, sizeof(trailer), "10=%03u\x01", sum & 0xFF);
+    return frame + trailer;
+}
+
+std::string make_fix_message(std::mt19937_64& rng, MessageSize size) {
+    static const char* const MSG_TYPES[] = {"D", "8", "F", "G"};
+    std::string body = "35=" + std::string(MSG_TYPES[rng() % 4]) + "\x01";
+    if (size != SMALL) {
+        body += "49=SENDERCOMP\x01" "56=TARGETCOMP\x01" "34=" + std::to_string(rng() % 1000000) + "\x01"
+                "52=20240115-14:30:00.123\x01";
+    }
+    body += "55=" + std::string(SYMBOLS[rng() % SYMBOL_COUNT]) + "\x01"
+            "54=" + std::to_string(1 + rng() % 2) + "\x01"
+            "44=" + format_price(rng) + "\x01"
+            "38=" + std::to_string(1 + rng() % 10000) + "\x01";
+    if (size == LARGE) {
+        // Repeating-group style padding seen on venue execution reports
+        body += "11=ORD" + std::to_string(rng()) + "\x01" "37=EX" + std::to_string(rng()) + "\x01"
+                "1=ACCOUNT-0001\x01" "40=2\x01" "59=0\x01" "60=20240115-14:30:00.123456\x01"
+                "207=XNAS\x01" "453=2\x01" "448=BROKER01\x01" "447=D\x01" "452=1\x01"
+                "448=CLIENT01\x01" "447=D\x01" "452=3\x01" "58=benchmark padding text field\x01";
+    }
+    return make_fix_frame(body);
+}
+
+std::string make_json_message(std::mt19937_64& rng, MessageSize size) {
+    std::string symbol = SYMBOLS[rng() % SYMBOL_COUNT];
+    std::string json;
+    if (rng() % 2) {
+        json = "{\"type\":\"trade\",\"symbol\":\"" + symbol + "\",\"side\":\"" + (rng() % 2 ? "buy" : "sell") +
+               "\",\"price\":" + format_price(rng) + ",\"size\":" + std::to_string(1 + rng() % 10000);
+    } else {
+        std::string bid = format_price(rng);
+        json = "{\"type\":\"quote\",\"symbol\":\"" + symbol + "\",\"bid\":" + bid + ",\"ask\":" + bid + "1" +
+               ",\"bid_size\":" + std::to_string(rng() % 5000) + ",\"ask_size\":" + std::to_string(rng() % 5000);
+    }
+    if (size != SMALL) {
+        json += ",\"timestamp\":" + std::to_string(1705329000000000000ULL + rng() % 1000000000) +
+                ",\"exchange\":\"XNAS\",\"seq\":" + std::to_string(rng() % 10000000);
+    }
+    if (size == LARGE) {
+        // Unknown nested fields the parser has to skip
+        json += ",\"conditions\":[\"@\",\"F\",\"T\"],\"meta\":{\"venue\":{\"mic\":\"XNAS\",\"tz\":\"America/New_York\"},"
+                "\"note\":\"escaped \\\"quote\\\" and {braces} in a string\",\"flags\":[1,2,3,4,5,6,7,8]}";
+    }
+    return json + "}";
+}
+
+bool read_file(const char* path, std::string& out) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file) {
+        return false;
+    }
+    out.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    return true;
+}
+
+// Recorded FIX stream, split with the same framing code the live path uses
+bool load_fix_corpus(const char* path, Corpus& corpus) {
+    std::string raw;
+    if (!read_file(path, raw)) {
+        return false;
+    }
+    size_t pos = 0;
+    while (pos < raw.size()) {
+        size_t offset = 0, length = 0, consumed = 0;
+        ParseResult result = StreamFramer::find_frame(FramingMode::FIX, raw.data() + pos, raw.size() - pos,
+                                                      offset, length, consumed);
+        if (result == ParseResult::SUCCESS) {
+            corpus.add(raw.substr(pos + offset, length));
+        } else if (consumed == 0) {
+            break;
+        }
+        pos += consumed;
+    }
+    return corpus.size() > 0;
+}
+
+bool load_json_corpus(const char* path, Corpus& corpus) {
+    std::ifstream file(path);
+    std::string line;
+    while (std::getline(file, line)) {
+        if (!line.empty()) {
+            corpus.add(line);
+        }
+    }
+    return corpus.size() > 0;
+}
+
+// Synthetic frames must all take the full parse path, not an early reject
+void require_parses(const Corpus& corpus, const char* name) {
+    MessageParser parser;
+    MarketMessage message;
+    ParseContext context;
+    for (size_t i = 0; i < corpus.size(); ++i) {
+        ParseResult result = parser.parse_message(corpus.frame(i), corpus.frame_length(i), message, context);
+        if (result != ParseResult::SUCCESS) {
+            std::fprintf(stderr, "%s corpus: message %zu does not parse (result %d): %.*s\n", name, i,
+                         static_cast<int>(result), static_cast<int>(corpus.frame_length(i)), corpus.frame(i));
+            std::exit(2);
+        }
+    }
+}
+
+const Corpus& fix_corpus(MessageSize size) {
+    static Corpus corpora[3];
+    Corpus& corpus = corpora[size];
+    if (corpus.size() == 0) {
+        const char* path = std::getenv("HFT_BENCH_FIX_CORPUS");
+        if (!(path && size == MEDIUM && load_fix_corpus(path, corpus))) {
+            std::mt19937_64 rng(42 + size);
+            for (size_t i = 0; i < CORPUS_MESSAGES; ++i) {
+                corpus.add(make_fix_message(rng, size));
+            }
+            require_parses(corpus, "synthetic FIX");
+        }
+    }
+    return corpus;
+}
+
+const Corpus& json_corpus(MessageSize size) {
+    static Corpus corpora[3];
+    Corpus& corpus = corpora[size];
+    if (corpus.size() == 0) {
+        const char* path = std::getenv("HFT_BENCH_JSON_CORPUS");
+        if (!(path && size == MEDIUM && load_json_corpus(path, corpus))) {
+            std::mt19937_64 rng(1042 + size);
+            for (size_t i = 0; i < CORPUS_MESSAGES; ++i) {
+                corpus.add(make_json_message(rng, size));
+            }
+            require_parses(corpus, "synthetic JSON");
+        }
+    }
+    return corpus;
+}
+
+// Interleaved FIX and JSON frames for the dispatch benchmarks
+const Corpus& mixed_corpus() {
+    static Corpus corpus;
+    if (corpus.size() == 0) {
+        const Corpus& fix = fix_corpus(MEDIUM);
+        const Corpus& json = json_corpus(MEDIUM);
+        for (size_t i = 0; i < CORPUS_MESSAGES; ++i) {
+            const Corpus& source = i % 2 ? json : fix;
+            size_t index = i % source.size();
+            corpus.add(std::string(source.frame(index), source.frame_length(index)));
+        }
+    }
+    return corpus;
+}
+
+// Runs `parse_one(frame, length)` over the corpus and reports throughput,
+// block-sampled ns/msg percentiles and allocations per message
+template <typename ParseFn>
+void run_corpus(benchmark::State& state, const Corpus& corpus, ParseFn parse_one) {
+    std::vector<double> block_ns;
+    block_ns.reserve(1 << 16);
+    size_t messages = 0;
+    size_t bytes = 0;
+    size_t index = 0;
+    size_t allocations_before = g_allocations.load(std::memory_order_relaxed);
+
+    for (auto _ : state) {
+        auto start = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < LATENCY_BLOCK; ++i) {
+            benchmark::DoNotOptimize(parse_one(corpus.frame(index), corpus.frame_length(index)));
+            bytes += corpus.frame_length(index);
+            if (++index == corpus.size()) {
+                index = 0;
+            }
+        }
+        auto elapsed = std::chrono::steady_clock::now() - start;
+        if (block_ns.size() < block_ns.capacity()) {
+            block_ns.push_back(std::chrono::duration<double, std::nano>(elapsed).count() / LATENCY_BLOCK);
+        }
+        messages += LATENCY_BLOCK;
+    }
+
+    size_t allocations = g_allocations.load(std::memory_order_relaxed) - allocations_before;
+    state.SetItemsProcessed(static_cast<int64_t>(messages));
+    state.SetBytesProcessed(static_cast<int64_t>(bytes));
+    state.counters["allocs_per_msg"] = static_cast<double>(allocations) / static_cast<double>(messages);
+    if (!block_ns.empty()) {
+        std::sort(block_ns.begin(), block_ns.end());
+        auto percentile = [&](double p) { return block_ns[static_cast<size_t>(p * (block_ns.size() - 1))]; };
+        state.counters["p50_ns"] = percentile(0.50);
+        state.counters["p99_ns"] = percentile(0.99);
+        state.counters["p999_ns"] = percentile(0.999);
+    }
+}
+
+void BM_ParseFix(benchmark::State& state) {
+    MessageParser parser;
+    MarketMessage message;
+    run_corpus(state, fix_corpus(static_cast<MessageSize>(state.range(0))),
+               [&](const char* data, size_t length) { return parser.parse_fix_message(data, length, message); });
+}
+
+void BM_ParseJson(benchmark::State& state) {
+    MessageParser parser;
+    MarketMessage message;
+    run_corpus(state, json_corpus(static_cast<MessageSize>(state.range(0))),
+               [&](const char* data, size_t length) { return parser.parse_websocket_json(data, length, message); });
+}
+
+void BM_DetectProtocol(benchmark::State& state) {
+    MessageParser parser;
+    run_corpus(state, mixed_corpus(),
+               [&](const char* data, size_t length) { return parser.detect_protocol(data, length); });
+}
+
+void BM_ParseMessage(benchmark::State& state) {
+    MessageParser parser;
+    MarketMessage message;
+    ParseContext context;
+    run_corpus(state, mixed_corpus(), [&](const char* data, size_t length) {
+        context.reset();
+        return parser.parse_message(data, length, message, context);
+    });
+}
+
+// Known protocol and schema: no detection or dispatch
+void BM_ParseFixKnownSchema(benchmark::State& state) {
+    MessageParser parser;
+    MarketMessage message;
+    ParseContext context;
+    run_corpus(state, fix_corpus(MEDIUM), [&](const char* data, size_t length) {
+        context.reset();
+        return parser.parse_fix<DefaultFixSchema>(data, length, message, context);
+    });
+}
+
+void BM_ParseMessageInterned(benchmark::State& state) {
+    SymbolRegistry registry;
+    MessageParser parser;
+    parser.set_symbol_registry(&registry);
+    MarketMessage message;
+    ParseContext context;
+    run_corpus(state, mixed_corpus(), [&](const char* data, size_t length) {
+        context.reset();
+        return parser.parse_message(data, length, message, context);
+    });
+}
+
+void BM_ParseBatch(benchmark::State& state) {
+    const Corpus& corpus = mixed_corpus();
+    MessageParser parser;
+    std::vector<MarketMessage> messages(corpus.size());
+    std::vector<ParseResult> results(corpus.size());
+    size_t allocations_before = g_allocations.load(std::memory_order_relaxed);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(parser.parse_batch(corpus.data.data(), corpus.offsets.data(), corpus.size(),
+                                                    messages.data(), results.data()));
+        benchmark::ClobberMemory();
+    }
+    size_t processed = static_cast<size_t>(state.iterations()) * corpus.size();
+    state.SetItemsProcessed(static_cast<int64_t>(processed));
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) * static_cast<int64_t>(corpus.data.size()));
+    state.counters["allocs_per_msg"] =
+        static_cast<double>(g_allocations.load(std::memory_order_relaxed) - allocations_before) /
+        static_cast<double>(processed ? processed : 1);
+}
+
+// Timestamp sources for messages without their own timestamp
+void BM_TimestampTsc(benchmark::State& state) {
+    const TscClock& clock = TscClock::instance();
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(clock.now_ns());
+    }
+    state.SetLabel(clock.using_counter() ? "tsc" : "fallback");
+}
+
+void BM_TimestampSystemClock(benchmark::State& state) {
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(std::chrono::high_resolution_clock::now());
+    }
+}
+
+BENCHMARK(BM_ParseFix)->Arg(SMALL)->Arg(MEDIUM)->Arg(LARGE);
+BENCHMARK(BM_ParseJson)->Arg(SMALL)->Arg(MEDIUM)->Arg(LARGE);
+BENCHMARK(BM_DetectProtocol);
+BENCHMARK(BM_ParseMessage);
+BENCHMARK(BM_ParseFixKnownSchema);
+BENCHMARK(BM_ParseMessageInterned);
+BENCHMARK(BM_ParseBatch);
+BENCHMARK(BM_TimestampTsc);
+BENCHMARK(BM_TimestampSystemClock);
+
+// Console output plus a record of the slowest parse benchmark for the KPI gate
+class KpiReporter : public benchmark::ConsoleReporter {
+public:
+    void ReportRuns(const std::vector<Run>& runs) override {
+        for (const Run& run : runs) {
+            if (run.error_occurred || run.run_type != Run::RT_Iteration) {
+                continue;
+            }
+            auto it = run.counters.find("items_per_second");
+            bool is_parse = run.benchmark_name().find("BM_Parse") == 0;
+            if (it != run.counters.end() && is_parse && it->second.value < slowest_rate_) {
+                slowest_rate_ = it->second.value;
+                slowest_name_ = run.benchmark_name();
+            }
+        }
+        ConsoleReporter::ReportRuns(runs);
+    }
+
+    double slowest_rate() const { return slowest_rate_; }
+    const std::string& slowest_name() const { return slowest_name_; }
+
+private:
+    double slowest_rate_ = 1e300;
+    std::string slowest_name_;
+};
+
+} // namespace
+
+int main(int argc, char** argv) {
+    double kpi = DEFAULT_KPI_MSGS_PER_SEC;
+    const char* kpi_flag = "--kpi_min_msgs_per_sec=";
+    std::vector<char*> args;
+    for (int i = 0; i < argc; ++i) {
+        if (std::strncmp(argv[i], kpi_flag, std::strlen(kpi_flag)) == 0) {
+            kpi = std::atof(argv[i] + std::strlen(kpi_flag));
+        } else {
+            args.push_back(argv[i]);
+        }
+    }
+    int args_count = static_cast<int>(args.size());
+
+    benchmark::Initialize(&args_count, args.data());
+    if (benchmark::ReportUnrecognizedArguments(args_count, args.data())) {
+        return 1;
+    }
+
+    KpiReporter reporter;
+    benchmark::RunSpecifiedBenchmarks(&reporter);
+    benchmark::Shutdown();
+
+    if (reporter.slowest_name().empty()) {
+        std::printf("KPI skipped: no parse benchmark ran\n");
+        return 0;
+    }
+    if (reporter.slowest_rate() < kpi) {
+        std::fprintf(stderr, "KPI FAILED: %s at %.0f msgs/sec, below %.0f msgs/sec\n",
+                     reporter.slowest_name().c_str(), reporter.slowest_rate(), kpi);
+        return 1;
+    }
+    std::printf("KPI OK: slowest parse benchmark %.0f msgs/sec (minimum %.0f)\n", reporter.slowest_rate(), kpi);
+    return 0;
+}
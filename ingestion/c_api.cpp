@@ -0,0 +1,136 @@
+#include "c_api.h"
+#include "message_parser.hpp"
+#include <cstddef>
+#include <cstring>
+#include <new>
+
+using hft::ingestion::MarketMessage;
+using hft::ingestion::MessageParser;
+using hft::ingestion::ParseContext;
+using hft::ingestion::ParseResult;
+using hft::ingestion::ParserMetricsSnapshot;
+using hft::ingestion::PARSE_RESULT_COUNT;
+using hft::ingestion::PROTOCOL_COUNT;
+using hft::ingestion::ProtocolType;
+
+static_assert(sizeof(hft_market_message) == sizeof(MarketMessage), "C message layout out of sync");
+static_assert(offsetof(hft_market_message, timestamp) == offsetof(MarketMessage, timestamp), "timestamp offset");
+static_assert(offsetof(hft_market_message, price) == offsetof(MarketMessage, price), "price offset");
+static_assert(offsetof(hft_market_message, size) == offsetof(MarketMessage, size), "size offset");
+static_assert(offsetof(hft_market_message, symbol_id) == offsetof(MarketMessage, symbol_id), "symbol_id offset");
+static_assert(offsetof(hft_market_message, side) == offsetof(MarketMessage, side), "side offset");
+static_assert(offsetof(hft_market_message, type) == offsetof(MarketMessage, type), "type offset");
+static_assert(offsetof(hft_market_message, symbol) == offsetof(MarketMessage, symbol), "symbol offset");
+static_assert(offsetof(hft_market_message, order_id) == offsetof(MarketMessage, order_id), "order_id offset");
+static_assert(offsetof(hft_market_message, ask_price) == offsetof(MarketMessage, ask_price), "ask_price offset");
+static_assert(offsetof(hft_market_message, ask_size) == offsetof(MarketMessage, ask_size), "ask_size offset");
+static_assert(offsetof(hft_market_message, flags) == offsetof(MarketMessage, flags), "flags offset");
+static_assert(HFT_MESSAGE_FLAG_TWO_SIDED == hft::ingestion::MESSAGE_FLAG_TWO_SIDED, "flag values");
+static_assert(offsetof(hft_market_message, receive_timestamp) == offsetof(MarketMessage, receive_timestamp),
+              "receive_timestamp offset");
+
+struct hft_parser {
+    MessageParser parser;
+    ParseContext context;
+};
+
+namespace {
+
+// FFI callers (ctypes, NumPy) may hand over buffers that are not cache-line
+// aligned; those are parsed into an aligned temporary and copied out.
+bool is_message_aligned(const void* ptr) {
+    return reinterpret_cast<uintptr_t>(ptr) % alignof(MarketMessage) == 0;
+}
+
+constexpr size_t BATCH_CHUNK = 256;
+
+} // namespace
+
+extern "C" {
+
+hft_parser* hft_parser_create(void) {
+    return new (std::nothrow) hft_parser();
+}
+
+void hft_parser_destroy(hft_parser* parser) {
+    delete parser;
+}
+
+int32_t hft_parse_message(hft_parser* parser, const char* buffer, size_t length,
+                          hft_market_message* message) {
+    parser->context.reset();
+    MarketMessage parsed;
+    ParseResult result = parser->parser.parse_message(buffer, length, parsed, parser->context);
+    std::memcpy(message, &parsed, sizeof(parsed));
+    return static_cast<int32_t>(result);
+}
+
+size_t hft_parse_batch(hft_parser* parser, const char* buffer, const uint32_t* offsets, size_t count,
+                       hft_market_message* messages, int32_t* results) {
+    size_t parsed = 0;
+    ParseResult chunk_results[BATCH_CHUNK];
+
+    if (is_message_aligned(messages)) {
+        MarketMessage* out = reinterpret_cast<MarketMessage*>(messages);
+        for (size_t begin = 0; begin < count; begin += BATCH_CHUNK) {
+            size_t n = count - begin < BATCH_CHUNK ? count - begin : BATCH_CHUNK;
+            parsed += parser->parser.parse_batch(buffer, offsets + begin, n, out + begin, chunk_results);
+            for (size_t i = 0; i < n; ++i) {
+                results[begin + i] = static_cast<int32_t>(chunk_results[i]);
+            }
+        }
+        return parsed;
+    }
+
+    MarketMessage scratch;
+    for (size_t i = 0; i < count; ++i) {
+        ParseResult result;
+        parsed += parser->parser.parse_batch(buffer, offsets + i, 1, &scratch, &result);
+        std::memcpy(&messages[i], &scratch, sizeof(scratch));
+        results[i] = static_cast<int32_t>(result);
+    }
+    return parsed;
+}
+
+uint64_t hft_parser_messages_parsed(const hft_parser* parser) {
+    return parser->parser.messages_parsed();
+}
+
+uint64_t hft_parser_parse_errors(const hft_parser* parser) {
+    return parser->parser.parse_errors();
+}
+
+void hft_parser_reset_stats(hft_parser* parser) {
+    parser->parser.reset_parser_state();
+}
+
+uint64_t hft_parser_result_count(const hft_parser* parser, int32_t result) {
+    if (result < 0 || static_cast<size_t>(result) >= PARSE_RESULT_COUNT) {
+        return 0;
+    }
+    uint64_t total = 0;
+    for (size_t p = 0; p < PROTOCOL_COUNT; ++p) {
+        total += parser->parser.metrics().count(static_cast<ProtocolType>(p), static_cast<ParseResult>(result));
+    }
+    return total;
+}
+
+uint64_t hft_parser_latency_quantile_ns(const hft_parser* parser, double q) {
+    ParserMetricsSnapshot snapshot;
+    parser->parser.metrics().snapshot_into(snapshot);
+    hft::ingestion::HistogramSnapshot successes;
+    for (const auto& by_result : snapshot.latency) {
+        successes.merge(by_result[static_cast<size_t>(ParseResult::SUCCESS)]);
+    }
+    return successes.value_at_quantile(q);
+}
+
+size_t hft_market_message_size(void) {
+    return sizeof(MarketMessage);
+}
+
+int32_t hft_fixed_point_prices(void) {
+    return hft::ingestion::FIXED_POINT_PRICES ? 1 : 0;
+}
+
+} // extern "C"
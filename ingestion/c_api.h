@@ -0,0 +1,82 @@
+/*
+ * C ABI for the ingestion parser, used by ctypes and other FFI callers.
+ *
+ * hft_market_message mirrors hft::ingestion::MarketMessage byte for byte
+ * (checked at compile time in c_api.cpp), so callers can hand over whole
+ * arrays of messages without per-message conversion.
+ */
+#ifndef HFT_INGESTION_C_API_H
+#define HFT_INGESTION_C_API_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct hft_parser hft_parser;
+
+typedef struct hft_market_message {
+    uint64_t timestamp;
+#ifdef HFT_FIXED_POINT_PRICES
+    int64_t price;
+#else
+    double price;
+#endif
+    int32_t size;
+    uint32_t symbol_id;
+    uint8_t side;
+    uint8_t type;
+    char symbol[16];
+    uint8_t flags;          /* HFT_MESSAGE_FLAG_* */
+    uint8_t padding;
+    int32_t ask_size;
+    uint64_t receive_timestamp;
+    union {
+        uint64_t order_id;
+#ifdef HFT_FIXED_POINT_PRICES
+        int64_t ask_price;  /* Set instead of order_id on two-sided quotes */
+#else
+        double ask_price;
+#endif
+    };
+} hft_market_message;
+
+/* hft_market_message.flags */
+#define HFT_MESSAGE_FLAG_TWO_SIDED 0x01  /* price/size are the bid, ask_price/ask_size the ask */
+
+hft_parser* hft_parser_create(void);
+void hft_parser_destroy(hft_parser* parser);
+
+/* Returns a ParseResult value */
+int32_t hft_parse_message(hft_parser* parser, const char* buffer, size_t length,
+                          hft_market_message* message);
+
+/* Frame i is buffer[offsets[i], offsets[i + 1]); offsets holds count + 1 entries.
+ * results receives one ParseResult per frame. Returns the number of successes. */
+size_t hft_parse_batch(hft_parser* parser, const char* buffer, const uint32_t* offsets, size_t count,
+                       hft_market_message* messages, int32_t* results);
+
+/* Counters since creation or the last hft_parser_reset_stats() */
+uint64_t hft_parser_messages_parsed(const hft_parser* parser);
+uint64_t hft_parser_parse_errors(const hft_parser* parser);
+void hft_parser_reset_stats(hft_parser* parser);
+
+/* Lifetime count of messages that ended with the given ParseResult, across
+ * protocols; not affected by hft_parser_reset_stats() */
+uint64_t hft_parser_result_count(const hft_parser* parser, int32_t result);
+
+/* Nanosecond parse latency at quantile q (0..1) over successful parses,
+ * within 12.5%; 0 before the first success */
+uint64_t hft_parser_latency_quantile_ns(const hft_parser* parser, double q);
+
+/* Layout checks for FFI callers */
+size_t hft_market_message_size(void);
+int32_t hft_fixed_point_prices(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* HFT_INGESTION_C_API_H */
@@ -0,0 +1,270 @@
+#include "capture_file.hpp"
+#include <algorithm>
+#include <cstring>
+
+namespace hft {
+namespace ingestion {
+
+namespace {
+
+constexpr size_t WRITE_BUFFER_SIZE = 1 << 20;
+constexpr size_t SYMBOL_NAME_SIZE = MarketMessage::SYMBOL_CAPACITY;
+
+} // namespace
+
+CaptureWriter::CaptureWriter()
+    : file_(nullptr),
+      block_records_(DEFAULT_BLOCK_RECORDS),
+      record_count_(0),
+      last_timestamp_(0),
+      time_sorted_(true),
+      failed_(false) {}
+
+CaptureWriter::~CaptureWriter() {
+    close();
+}
+
+bool CaptureWriter::open(const std::string& path, uint32_t block_records) {
+    close();
+    file_ = std::fopen(path.c_str(), "wb");
+    if (!file_) {
+        return false;
+    }
+    write_buffer_.reset(new char[WRITE_BUFFER_SIZE]);
+    std::setvbuf(file_, write_buffer_.get(), _IOFBF, WRITE_BUFFER_SIZE);
+
+    symbols_.reset(new SymbolRegistry());
+    block_records_ = block_records ? block_records : DEFAULT_BLOCK_RECORDS;
+    record_count_ = 0;
+    last_timestamp_ = 0;
+    time_sorted_ = true;
+    failed_ = false;
+    blocks_.clear();
+    postings_.clear();
+
+    // Placeholder, rewritten by close() once the counts are known
+    CaptureHeader header{};
+    return write(&header, sizeof(header));
+}
+
+bool CaptureWriter::write(const void* data, size_t size) {
+    if (!failed_ && std::fwrite(data, 1, size, file_) != size) {
+        failed_ = true;
+    }
+    return !failed_;
+}
+
+bool CaptureWriter::append(const MarketMessage& message) {
+    if (!file_ || failed_) {
+        return false;
+    }
+    uint32_t symbol_id = symbols_->intern(message.symbol_view());
+    if (symbol_id == INVALID_SYMBOL_ID) {
+        return false;
+    }
+
+    MarketMessage record = message;
+    record.symbol_id = symbol_id;
+    if (!write(&record, sizeof(record))) {
+        return false;
+    }
+
+    time_sorted_ = time_sorted_ && record.timestamp >= last_timestamp_;
+    last_timestamp_ = record.timestamp;
+
+    uint32_t block = static_cast<uint32_t>(record_count_ / block_records_);
+    if (block == blocks_.size()) {
+        blocks_.push_back({record.timestamp, record.timestamp});
+    } else {
+        CaptureBlock& current = blocks_.back();
+        current.min_timestamp = std::min(current.min_timestamp, record.timestamp);
+        current.max_timestamp = std::max(current.max_timestamp, record.timestamp);
+    }
+
+    if (symbol_id >= postings_.size()) {
+        postings_.resize(symbol_id + 1);
+    }
+    std::vector<uint32_t>& symbol_blocks = postings_[symbol_id];
+    if (symbol_blocks.empty() || symbol_blocks.back() != block) {
+        symbol_blocks.push_back(block);
+    }
+
+    record_count_++;
+    return true;
+}
+
+bool CaptureWriter::close() {
+    if (!file_) {
+        return false;
+    }
+
+    CaptureHeader header{};
+    std::memcpy(header.magic, CAPTURE_MAGIC, sizeof(header.magic));
+    header.version = CAPTURE_VERSION;
+    header.record_size = sizeof(MarketMessage);
+    header.flags = (FIXED_POINT_PRICES ? CAPTURE_FLAG_FIXED_POINT : 0) | (time_sorted_ ? CAPTURE_FLAG_TIME_SORTED : 0);
+    header.block_records = block_records_;
+    header.record_count = record_count_;
+    header.symbol_count = static_cast<uint32_t>(symbols_->size());
+    header.block_count = static_cast<uint32_t>(blocks_.size());
+    header.symbol_table_offset = sizeof(CaptureHeader) + record_count_ * sizeof(MarketMessage);
+    header.index_offset = header.symbol_table_offset + header.symbol_count * SYMBOL_NAME_SIZE;
+    header.min_timestamp = UINT64_MAX;
+    header.max_timestamp = 0;
+    for (const CaptureBlock& block : blocks_) {
+        header.min_timestamp = std::min(header.min_timestamp, block.min_timestamp);
+        header.max_timestamp = std::max(header.max_timestamp, block.max_timestamp);
+    }
+    if (blocks_.empty()) {
+        header.min_timestamp = 0;
+    }
+
+    for (uint32_t id = 0; id < header.symbol_count; ++id) {
+        char name[SYMBOL_NAME_SIZE] = {};
+        std::string_view symbol = symbols_->symbol(id);
+        std::memcpy(name, symbol.data(), symbol.size());
+        write(name, sizeof(name));
+    }
+    write(blocks_.data(), blocks_.size() * sizeof(CaptureBlock));
+
+    postings_.resize(header.symbol_count);
+    uint32_t offset = 0;
+    write(&offset, sizeof(offset));
+    for (const auto& symbol_blocks : postings_) {
+        offset += static_cast<uint32_t>(symbol_blocks.size());
+        write(&offset, sizeof(offset));
+    }
+    for (const auto& symbol_blocks : postings_) {
+        write(symbol_blocks.data(), symbol_blocks.size() * sizeof(uint32_t));
+    }
+
+    if (!failed_ && (std::fseek(file_, 0, SEEK_SET) != 0 || !write(&header, sizeof(header)))) {
+        failed_ = true;
+    }
+    bool ok = std::fclose(file_) == 0 && !failed_;
+    file_ = nullptr;
+    write_buffer_.reset();
+    symbols_.reset();
+    blocks_.clear();
+    postings_.clear();
+    return ok;
+}
+
+bool CaptureReader::open(const std::string& path, AccessPattern pattern) {
+    close();
+    if (!file_.open(path, pattern) || file_.size() < sizeof(CaptureHeader)) {
+        close();
+        return false;
+    }
+    std::memcpy(&header_, file_.data(), sizeof(header_));
+
+    bool fixed_point = (header_.flags & CAPTURE_FLAG_FIXED_POINT) != 0;
+    if (std::memcmp(header_.magic, CAPTURE_MAGIC, sizeof(header_.magic)) != 0 ||
+        header_.version != CAPTURE_VERSION || header_.record_size != sizeof(MarketMessage) ||
+        fixed_point != FIXED_POINT_PRICES || header_.block_records == 0) {
+        close();
+        return false;
+    }
+
+    // Bounds-check every section before handing out pointers into the map
+    uint64_t size = file_.size();
+    uint64_t records_end = sizeof(CaptureHeader) + header_.record_count * sizeof(MarketMessage);
+    uint64_t symbols_end = header_.index_offset;
+    uint64_t blocks_end = header_.index_offset + uint64_t(header_.block_count) * sizeof(CaptureBlock);
+    uint64_t offsets_end = blocks_end + (uint64_t(header_.symbol_count) + 1) * sizeof(uint32_t);
+    uint64_t expected_blocks = (header_.record_count + header_.block_records - 1) / header_.block_records;
+    if (header_.symbol_table_offset != records_end ||
+        symbols_end != records_end + uint64_t(header_.symbol_count) * SYMBOL_NAME_SIZE ||
+        header_.block_count != expected_blocks || offsets_end > size) {
+        close();
+        return false;
+    }
+
+    const char* base = file_.data();
+    records_ = reinterpret_cast<const MarketMessage*>(base + sizeof(CaptureHeader));
+    record_count_ = static_cast<size_t>(header_.record_count);
+    symbol_names_ = base + header_.symbol_table_offset;
+    blocks_ = reinterpret_cast<const CaptureBlock*>(base + header_.index_offset);
+    posting_offsets_ = reinterpret_cast<const uint32_t*>(base + blocks_end);
+    postings_ = reinterpret_cast<const uint32_t*>(base + offsets_end);
+
+    uint64_t posting_count = posting_offsets_[header_.symbol_count];
+    if (offsets_end + posting_count * sizeof(uint32_t) > size) {
+        close();
+        return false;
+    }
+    for (uint32_t id = 0; id < header_.symbol_count; ++id) {
+        if (posting_offsets_[id] > posting_offsets_[id + 1] || posting_offsets_[id + 1] > posting_count) {
+            close();
+            return false;
+        }
+    }
+    for (uint64_t i = 0; i < posting_count; ++i) {
+        if (postings_[i] >= header_.block_count) {
+            close();
+            return false;
+        }
+    }
+
+    symbol_lookup_.reset(new SymbolRegistry(header_.symbol_count ? header_.symbol_count : 1));
+    for (uint32_t id = 0; id < header_.symbol_count; ++id) {
+        symbol_lookup_->intern(symbol(id));
+    }
+    return true;
+}
+
+void CaptureReader::close() {
+    file_.close();
+    header_ = CaptureHeader{};
+    records_ = nullptr;
+    record_count_ = 0;
+    symbol_names_ = nullptr;
+    blocks_ = nullptr;
+    posting_offsets_ = nullptr;
+    postings_ = nullptr;
+    symbol_lookup_.reset();
+}
+
+std::string_view CaptureReader::symbol(uint32_t symbol_id) const {
+    if (symbol_id >= header_.symbol_count) {
+        return std::string_view();
+    }
+    const char* name = symbol_names_ + static_cast<size_t>(symbol_id) * SYMBOL_NAME_SIZE;
+    return std::string_view(name, strnlen(name, SYMBOL_NAME_SIZE));
+}
+
+uint32_t CaptureReader::find_symbol(std::string_view symbol) const {
+    // Ids match because the lookup registry was filled in file id order
+    return symbol_lookup_ ? symbol_lookup_->find(symbol) : INVALID_SYMBOL_ID;
+}
+
+size_t CaptureReader::lower_bound(uint64_t timestamp) const {
+    size_t block_begin = 0;
+    if (time_sorted()) {
+        // Block maxima are non-decreasing, so skip whole blocks by binary search
+        const CaptureBlock* block = std::partition_point(
+            blocks_, blocks_ + header_.block_count,
+            [timestamp](const CaptureBlock& b) { return b.max_timestamp < timestamp; });
+        block_begin = static_cast<size_t>(block - blocks_) * header_.block_records;
+        const MarketMessage* first = records_ + std::min(block_begin, record_count_);
+        return static_cast<size_t>(std::partition_point(first, end(), [timestamp](const MarketMessage& m) {
+                                       return m.timestamp < timestamp;
+                                   }) - records_);
+    }
+    for (uint32_t b = 0; b < header_.block_count; ++b) {
+        if (blocks_[b].max_timestamp < timestamp) {
+            continue;
+        }
+        size_t first = static_cast<size_t>(b) * header_.block_records;
+        size_t last = std::min(first + header_.block_records, record_count_);
+        for (size_t r = first; r < last; ++r) {
+            if (records_[r].timestamp >= timestamp) {
+                return r;
+            }
+        }
+    }
+    return record_count_;
+}
+
+} // namespace ingestion
+} // namespace hft
@@ -0,0 +1,155 @@
+#pragma once
+
+#include "mapped_file.hpp"
+#include "message_types.hpp"
+#include "symbol_registry.hpp"
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace hft {
+namespace ingestion {
+
+// Normalized capture format: parsed MarketMessages stored as raw 64-byte
+// records so re-replays skip parsing entirely and read them in place.
+//
+//   [CaptureHeader, 128 bytes]
+//   [record_count x MarketMessage]          64-byte aligned, zero-copy readable
+//   [symbol_count x 16-byte symbol names]   indexed by the records' symbol_id
+//   [block_count x CaptureBlock]            min/max timestamp per block of records
+//   [(symbol_count + 1) x uint32 postings offsets][uint32 block ids]
+//                                           blocks that contain each symbol
+//
+// symbol_id values in the file refer to the file's own symbol table, so a
+// capture is self-contained regardless of the registry used when parsing.
+constexpr char CAPTURE_MAGIC[8] = {'H', 'F', 'T', 'C', 'A', 'P', '0', '1'};
+constexpr uint32_t CAPTURE_VERSION = 1;
+constexpr uint32_t CAPTURE_FLAG_FIXED_POINT = 1u << 0;
+constexpr uint32_t CAPTURE_FLAG_TIME_SORTED = 1u << 1;
+
+struct CaptureHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t record_size;
+    uint32_t flags;
+    uint32_t block_records;       // Records per index block
+    uint64_t record_count;
+    uint64_t symbol_table_offset;
+    uint32_t symbol_count;
+    uint32_t block_count;
+    uint64_t index_offset;
+    uint64_t min_timestamp;
+    uint64_t max_timestamp;
+    uint8_t reserved[56];         // Zero; room for future fields
+};
+
+static_assert(sizeof(CaptureHeader) == 128, "Header must keep records cache-line aligned");
+
+struct CaptureBlock {
+    uint64_t min_timestamp;
+    uint64_t max_timestamp;
+};
+
+// Appends parsed messages to a capture file. Attach it to a MessageParser
+// with set_capture_writer() to record every successful parse.
+class CaptureWriter {
+public:
+    static constexpr uint32_t DEFAULT_BLOCK_RECORDS = 4096;
+
+    CaptureWriter();
+    ~CaptureWriter();
+
+    CaptureWriter(const CaptureWriter&) = delete;
+    CaptureWriter& operator=(const CaptureWriter&) = delete;
+
+    bool open(const std::string& path, uint32_t block_records = DEFAULT_BLOCK_RECORDS);
+    bool append(const MarketMessage& message);
+
+    // Writes the symbol table and index, then the final header
+    bool close();
+
+    bool is_open() const { return file_ != nullptr; }
+    uint64_t record_count() const { return record_count_; }
+
+private:
+    bool write(const void* data, size_t size);
+
+    std::FILE* file_;
+    std::unique_ptr<char[]> write_buffer_;
+    std::unique_ptr<SymbolRegistry> symbols_;  // File-local symbol ids
+    uint32_t block_records_;
+    uint64_t record_count_;
+    uint64_t last_timestamp_;
+    bool time_sorted_;
+    bool failed_;
+    std::vector<CaptureBlock> blocks_;
+    std::vector<std::vector<uint32_t>> postings_;  // Per symbol, ascending block ids
+};
+
+// Zero-copy reader over an mmap'd capture file
+class CaptureReader {
+public:
+    CaptureReader() = default;
+
+    bool open(const std::string& path, AccessPattern pattern = AccessPattern::SEQUENTIAL);
+    void close();
+
+    size_t size() const { return record_count_; }
+    const MarketMessage* records() const { return records_; }
+    const MarketMessage& operator[](size_t index) const { return records_[index]; }
+    const MarketMessage* begin() const { return records_; }
+    const MarketMessage* end() const { return records_ + record_count_; }
+
+    const CaptureHeader& header() const { return header_; }
+    bool time_sorted() const { return (header_.flags & CAPTURE_FLAG_TIME_SORTED) != 0; }
+
+    // File-local symbol table
+    uint32_t symbol_count() const { return header_.symbol_count; }
+    std::string_view symbol(uint32_t symbol_id) const;
+    uint32_t find_symbol(std::string_view symbol) const;
+
+    // Index of the first record with timestamp >= the given one
+    size_t lower_bound(uint64_t timestamp) const;
+
+    // Calls fn(const MarketMessage&) for each record of the symbol with
+    // from <= timestamp < to, visiting only blocks that contain the symbol
+    template <typename Fn>
+    size_t for_each_symbol(uint32_t symbol_id, uint64_t from, uint64_t to, Fn&& fn) const {
+        if (symbol_id >= header_.symbol_count) {
+            return 0;
+        }
+        size_t visited = 0;
+        for (uint32_t i = posting_offsets_[symbol_id]; i < posting_offsets_[symbol_id + 1]; ++i) {
+            uint32_t block = postings_[i];
+            if (blocks_[block].max_timestamp < from || blocks_[block].min_timestamp >= to) {
+                continue;
+            }
+            size_t first = static_cast<size_t>(block) * header_.block_records;
+            size_t last = first + header_.block_records < record_count_ ? first + header_.block_records : record_count_;
+            for (size_t r = first; r < last; ++r) {
+                const MarketMessage& message = records_[r];
+                if (message.symbol_id == symbol_id && message.timestamp >= from && message.timestamp < to) {
+                    fn(message);
+                    visited++;
+                }
+            }
+        }
+        return visited;
+    }
+
+private:
+    MappedFile file_;
+    CaptureHeader header_{};
+    const MarketMessage* records_ = nullptr;
+    size_t record_count_ = 0;
+    const char* symbol_names_ = nullptr;
+    const CaptureBlock* blocks_ = nullptr;
+    const uint32_t* posting_offsets_ = nullptr;
+    const uint32_t* postings_ = nullptr;
+    std::unique_ptr<SymbolRegistry> symbol_lookup_;
+};
+
+} // namespace ingestion
+} // namespace hft
@@ -0,0 +1,385 @@
+#include "feed_handler.hpp"
+#include <linux/mempolicy.h>
+#include <pthread.h>
+#include <sched.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <algorithm>
+
+namespace hft {
+namespace ingestion {
+
+namespace {
+
+constexpr size_t FRAME_BATCH = 64;     // Frames parsed per framer pass
+constexpr size_t MAX_NUMA_NODES = 1024;
+
+// Arena bytes for a feed's queue slots and receive buffer, with room for the
+// arena's power-of-two block rounding
+size_t feed_arena_bytes(const FeedConfig& config) {
+    size_t slots = 1;
+    while (slots < config.queue_capacity) {
+        slots <<= 1;
+    }
+    size_t buffer = MemoryArena::MIN_BLOCK;
+    while (buffer < config.receive_buffer_size) {
+        buffer <<= 1;
+    }
+    return slots * sizeof(MarketMessage) + buffer + 2 * CACHE_LINE_SIZE;
+}
+
+} // namespace
+
+FeedHandler::FeedHandler(const FeedHandlerConfig& config)
+    : config_(config),
+      stop_requested_(false),
+      started_(false),
+      clock_(TscClock::instance()),
+      setup_pending_(0),
+      setup_failed_(false),
+      last_timestamp_(0),
+      late_messages_(0) {
+    if (config_.merge_batch == 0) {
+        config_.merge_batch = FeedHandlerConfig().merge_batch;
+    }
+}
+
+FeedHandler::~FeedHandler() {
+    stop();
+}
+
+size_t FeedHandler::add_feed(const FeedConfig& config) {
+    auto feed = std::make_unique<Feed>();
+    feed->config = config;
+    feeds_.push_back(std::move(feed));
+    return feeds_.size() - 1;
+}
+
+bool FeedHandler::pin_current_thread(int cpu) {
+    if (cpu < 0 || cpu >= CPU_SETSIZE) {
+        return false;
+    }
+    cpu_set_t cpus;
+    CPU_ZERO(&cpus);
+    CPU_SET(cpu, &cpus);
+    return pthread_setaffinity_np(pthread_self(), sizeof(cpus), &cpus) == 0;
+}
+
+bool FeedHandler::bind_current_thread_memory(int numa_node) {
+    // set_mempolicy directly, so libnuma is not a dependency
+    if (numa_node < 0 || static_cast<size_t>(numa_node) >= MAX_NUMA_NODES) {
+        return false;
+    }
+    unsigned long mask[MAX_NUMA_NODES / (8 * sizeof(unsigned long))] = {};
+    mask[numa_node / (8 * sizeof(unsigned long))] = 1UL << (numa_node % (8 * sizeof(unsigned long)));
+    return ::syscall(SYS_set_mempolicy, MPOL_PREFERRED, mask, MAX_NUMA_NODES + 1) == 0;
+}
+
+bool FeedHandler::start() {
+    if (started_ || feeds_.empty()) {
+        return false;
+    }
+    stop_requested_.store(false, std::memory_order_relaxed);
+    setup_pending_ = feeds_.size();
+    setup_failed_ = false;
+    last_timestamp_ = 0;
+    for (auto& feed : feeds_) {
+        feed->pending.resize(config_.merge_batch);
+        feed->pending_index = feed->pending_count = 0;
+        feed->drained = false;
+        feed->thread = std::thread(&FeedHandler::feed_loop, this, std::ref(*feed));
+    }
+    started_ = true;
+
+    bool ok;
+    {
+        std::unique_lock<std::mutex> lock(setup_mutex_);
+        setup_cv_.wait(lock, [this] { return setup_pending_ == 0; });
+        ok = !setup_failed_;
+    }
+    if (!ok) {
+        stop();
+    }
+    return ok;
+}
+
+void FeedHandler::stop() {
+    if (!started_) {
+        return;
+    }
+    stop_requested_.store(true, std::memory_order_relaxed);
+    for (auto& feed : feeds_) {
+        if (feed->queue) {
+            feed->queue->close();  // Releases a feed thread blocked on a full queue
+        }
+    }
+    for (auto& feed : feeds_) {
+        if (feed->thread.joinable()) {
+            feed->thread.join();
+        }
+    }
+    started_ = false;
+}
+
+void FeedHandler::setup_done(bool ok) {
+    std::lock_guard<std::mutex> lock(setup_mutex_);
+    setup_failed_ |= !ok;
+    if (--setup_pending_ == 0) {
+        setup_cv_.notify_all();
+    }
+}
+
+void FeedHandler::feed_loop(Feed& feed) {
+    const FeedConfig& config = feed.config;
+    bool ok = (config.cpu < 0 || pin_current_thread(config.cpu)) &&
+              (config.numa_node < 0 || bind_current_thread_memory(config.numa_node)) &&
+              (config.source || config.datagram_source);
+    if (!ok) {
+        setup_done(false);
+        return;
+    }
+
+    // Allocated after pinning, so first touch places them on this thread's
+    // node; the arena is prefaulted here rather than by the first messages
+    ArenaConfig arena_config = config.arena;
+    arena_config.initial_size = std::max(arena_config.initial_size, feed_arena_bytes(config));
+    feed.queue.reset();  // From a previous start(): its slots live in the arena being replaced
+    feed.arena = std::make_unique<MemoryArena>(arena_config);
+    MessageParser parser;
+    parser.set_symbol_registry(config.symbol_registry);
+    if (config.datagram_source) {
+        feed.queue = std::make_unique<FeedQueue>(config.queue_capacity, feed.arena.get());
+        setup_done(true);
+        datagram_loop(feed, parser);
+        feed.queue->close();
+        return;
+    }
+    StreamFramer framer(config.framing, config.receive_buffer_size, config.verify_checksum, feed.arena.get());
+    feed.queue = std::make_unique<FeedQueue>(config.queue_capacity, feed.arena.get());
+    setup_done(true);
+
+    Frame frames[FRAME_BATCH];
+    MarketMessage parsed[FRAME_BATCH];
+    size_t dropped_seen = 0;
+    while (!stop_requested_.load(std::memory_order_relaxed)) {
+        uint64_t receive_timestamp = 0;
+        ssize_t received = config.source(framer.write_ptr(), framer.writable(), receive_timestamp);
+        if (received < 0) {
+            break;
+        }
+        if (received == 0) {
+            std::this_thread::yield();
+            continue;
+        }
+        framer.commit(static_cast<size_t>(received));
+        single_writer_add(feed.bytes, static_cast<uint64_t>(received));
+
+        // Every message completed by this read shares its receive timestamp
+        size_t frame_count;
+        bool queue_open = true;
+        while (queue_open && (frame_count = framer.next_frames(frames, FRAME_BATCH)) > 0) {
+            queue_open = parse_frames(feed, parser, frames, frame_count, receive_timestamp, parsed);
+        }
+        single_writer_add(feed.parse_errors, framer.frames_dropped() - dropped_seen);
+        dropped_seen = framer.frames_dropped();
+        if (!queue_open) {
+            break;
+        }
+    }
+    feed.queue->close();
+}
+
+void FeedHandler::datagram_loop(Feed& feed, MessageParser& parser) {
+    const FeedConfig& config = feed.config;
+    Datagram datagrams[FRAME_BATCH];
+    Frame frames[FRAME_BATCH];
+    MarketMessage parsed[FRAME_BATCH];
+    while (!stop_requested_.load(std::memory_order_relaxed)) {
+        ssize_t received = config.datagram_source(datagrams, FRAME_BATCH);
+        if (received < 0) {
+            return;
+        }
+        if (received == 0) {
+            std::this_thread::yield();
+            continue;
+        }
+        for (ssize_t d = 0; d < received; ++d) {
+            // Frames are located in place; nothing is copied into a framer
+            const Datagram& datagram = datagrams[d];
+            single_writer_add(feed.bytes, datagram.length);
+            size_t pos = 0;
+            size_t count = 0;
+            uint64_t errors = 0;
+            while (pos < datagram.length) {
+                size_t frame_offset = 0, frame_length = 0, consumed = 0;
+                ParseResult result = StreamFramer::find_frame(config.framing, datagram.data + pos, datagram.length - pos,
+                                                              frame_offset, frame_length, consumed,
+                                                              config.verify_checksum);
+                if (result == ParseResult::SUCCESS) {
+                    frames[count++] = Frame{datagram.data + pos + frame_offset, frame_length};
+                } else if (result == ParseResult::INCOMPLETE_MESSAGE) {
+                    errors += pos + consumed < datagram.length;  // Truncated frame, not just padding
+                    break;
+                } else {
+                    errors++;
+                }
+                pos += consumed;
+                if (count == FRAME_BATCH) {
+                    if (!parse_frames(feed, parser, frames, count, datagram.receive_timestamp, parsed)) {
+                        return;
+                    }
+                    count = 0;
+                }
+            }
+            single_writer_add(feed.parse_errors, errors);
+            if (count > 0 && !parse_frames(feed, parser, frames, count, datagram.receive_timestamp, parsed)) {
+                return;
+            }
+        }
+    }
+}
+
+bool FeedHandler::parse_frames(Feed& feed, MessageParser& parser, const Frame* frames, size_t count,
+                               uint64_t receive_timestamp, MarketMessage* parsed) {
+    ParseContext context;
+    size_t parsed_count = 0;
+    uint64_t errors = 0;
+    for (size_t i = 0; i < count; ++i) {
+        context.reset();
+        context.hardware_timestamp = receive_timestamp;
+        if (parser.parse_message(frames[i].data, frames[i].length, parsed[parsed_count], context) ==
+            ParseResult::SUCCESS) {
+            parsed_count++;
+        } else {
+            errors++;
+        }
+    }
+    single_writer_add(feed.parse_errors, errors);
+    return publish(feed, parsed, parsed_count);
+}
+
+bool FeedHandler::publish(Feed& feed, const MarketMessage* messages, size_t count) {
+    size_t pushed = feed.queue->push_n(messages, count);
+    single_writer_add(feed.messages, pushed);
+    while (pushed < count) {
+        // Back-pressure: let the socket buffer absorb bursts rather than drop here
+        single_writer_add(feed.queue_stalls, 1);
+        if (!feed.queue->push_wait(messages[pushed])) {
+            return false;
+        }
+        single_writer_add(feed.messages, 1);
+        pushed++;
+        size_t more = feed.queue->push_n(messages + pushed, count - pushed);
+        single_writer_add(feed.messages, more);
+        pushed += more;
+    }
+    return true;
+}
+
+bool FeedHandler::refill(Feed& feed) {
+    if (feed.pending_index < feed.pending_count) {
+        return true;
+    }
+    if (!feed.queue) {
+        feed.drained = true;  // The feed thread never got going
+    }
+    if (feed.drained) {
+        return false;
+    }
+    // Check closed before popping: a closed queue that pops empty stays empty
+    bool closed = feed.queue->closed();
+    feed.pending_index = 0;
+    feed.pending_count = feed.queue->pop_n(feed.pending.data(), feed.pending.size());
+    if (feed.pending_count == 0 && closed) {
+        feed.drained = true;
+    }
+    return feed.pending_count > 0;
+}
+
+size_t FeedHandler::poll(MarketMessage* messages, size_t max_messages) {
+    size_t emitted = 0;
+    uint64_t now = 0;
+    while (emitted < max_messages) {
+        // Linear scan of the heads: with the handful of feeds a box runs this
+        // beats maintaining a heap that every refill would have to fix up
+        Feed* best = nullptr;
+        bool waiting_on_live_feed = false;
+        for (auto& feed : feeds_) {
+            if (!refill(*feed)) {
+                waiting_on_live_feed |= !feed->drained;
+                continue;
+            }
+            const MarketMessage& head = feed->pending[feed->pending_index];
+            if (!best || head.timestamp < best->pending[best->pending_index].timestamp) {
+                best = feed.get();
+            }
+        }
+        if (!best) {
+            break;
+        }
+
+        const MarketMessage& head = best->pending[best->pending_index];
+        if (waiting_on_live_feed) {
+            // A quiet feed may still deliver something older; hold the head
+            // back until it has aged past the merge delay
+            if (now == 0) {
+                now = clock_.now_ns();
+            }
+            if (now < head.receive_timestamp + config_.max_merge_delay_ns) {
+                break;
+            }
+        }
+
+        if (head.timestamp < last_timestamp_) {
+            late_messages_++;
+        } else {
+            last_timestamp_ = head.timestamp;
+        }
+        messages[emitted++] = head;
+        best->pending_index++;
+    }
+    return emitted;
+}
+
+uint64_t FeedHandler::run(const std::function<bool(const MarketMessage&)>& handler) {
+    MarketMessage batch[FRAME_BATCH];
+    uint64_t delivered = 0;
+    while (true) {
+        size_t count = poll(batch, FRAME_BATCH);
+        for (size_t i = 0; i < count; ++i) {
+            delivered++;
+            if (!handler(batch[i])) {
+                return delivered;
+            }
+        }
+        if (count == 0) {
+            if (finished()) {
+                break;  // Also reached after stop(), once the closed queues drain
+            }
+            std::this_thread::yield();
+        }
+    }
+    return delivered;
+}
+
+bool FeedHandler::finished() const {
+    for (const auto& feed : feeds_) {
+        if (!feed->drained || feed->pending_index < feed->pending_count) {
+            return false;
+        }
+    }
+    return !feeds_.empty();
+}
+
+FeedStats FeedHandler::feed_stats(size_t index) const {
+    const Feed& feed = *feeds_[index];
+    FeedStats stats;
+    stats.bytes = feed.bytes.load(std::memory_order_relaxed);
+    stats.messages = feed.messages.load(std::memory_order_relaxed);
+    stats.parse_errors = feed.parse_errors.load(std::memory_order_relaxed);
+    stats.queue_stalls = feed.queue_stalls.load(std::memory_order_relaxed);
+    return stats;
+}
+
+} // namespace ingestion
+} // namespace hft
@@ -0,0 +1,180 @@
+#pragma once
+
+#include "message_parser.hpp"
+#include "spsc_queue.hpp"
+#include "stream_framer.hpp"
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <sys/types.h>
+#include <thread>
+#include <vector>
+
+namespace hft {
+namespace ingestion {
+
+// Reads the next bytes of a feed into buffer (at most capacity). Returns the
+// number of bytes read, 0 when nothing is available yet, or -1 once the feed
+// has ended. May set receive_timestamp (epoch ns, e.g. from SO_TIMESTAMPING)
+// for the bytes returned; left at 0 the parser stamps them from TscClock.
+//
+// Sources should not block indefinitely (use a receive timeout), so that
+// FeedHandler::stop() is noticed.
+using FeedSource = std::function<ssize_t(char* buffer, size_t capacity, uint64_t& receive_timestamp)>;
+
+// One received datagram (or kernel-bypass packet payload) holding whole
+// frames; a trailing partial frame is dropped, as no datagram continues
+// in the next one.
+struct Datagram {
+    const char* data;
+    size_t length;
+    uint64_t receive_timestamp;  // Epoch ns, 0 = stamp from TscClock
+};
+
+// Message-oriented alternative to FeedSource: fills up to max views of
+// datagrams that remain valid until the next call, so they are parsed in
+// place. Returns the count, 0 when nothing is available yet, or -1 once
+// the feed has ended.
+using DatagramSource = std::function<ssize_t(Datagram* datagrams, size_t max)>;
+
+using FeedQueue = SpscQueue<MarketMessage, WaitStrategy::FUTEX>;
+
+struct FeedConfig {
+    std::string name;
+    FeedSource source;
+    DatagramSource datagram_source;      // Used instead of source when set
+    FramingMode framing = FramingMode::FIX;
+    bool verify_checksum = true;
+    int cpu = -1;                        // Core to pin the feed thread to, -1 = unpinned
+    int numa_node = -1;                  // Node for the feed's buffers, -1 = local to the thread
+    size_t queue_capacity = 1 << 16;     // Messages between the feed thread and the merge
+    size_t receive_buffer_size = StreamFramer::DEFAULT_BUFFER_SIZE;
+    ArenaConfig arena;                   // Queue and receive buffer memory; initial_size is raised to fit both
+    SymbolRegistry* symbol_registry = nullptr;  // Not owned; may be shared across feeds
+};
+
+struct FeedHandlerConfig {
+    // How long (receive time) the merge holds a message back while some live
+    // feed has nothing queued. Larger values order more strictly across
+    // feeds; smaller ones bound the latency a quiet feed adds to the others.
+    uint64_t max_merge_delay_ns = 1000000;
+    size_t merge_batch = 256;  // Messages taken from a feed's queue at a time
+};
+
+struct FeedStats {
+    uint64_t bytes = 0;
+    uint64_t messages = 0;      // Parsed and queued
+    uint64_t parse_errors = 0;  // Corrupt frames and messages that failed to parse
+    uint64_t queue_stalls = 0;  // Times the feed thread waited on a full queue
+};
+
+// Multi-feed runtime: one thread per feed, a timestamp-ordered fan-in.
+//
+// Each feed thread pins itself to its configured core, binds its memory
+// policy to the configured NUMA node, and only then allocates its
+// MessageParser, receive buffer and SPSC queue, so all of them are
+// first-touched on the feed's own node. Nothing on the receive path is
+// shared between feeds.
+//
+// A single consumer thread (the book) calls poll() or run() to merge the
+// queues by MarketMessage::timestamp; ties go to the feed added first. The
+// merge only emits a message once every live feed has a later one queued,
+// or once it has been held for max_merge_delay_ns; a quiet feed that then
+// delivers an older message has it counted in late_messages().
+//
+//   FeedHandler handler;
+//   handler.add_feed(venue_a);
+//   handler.add_feed(venue_b);
+//   handler.start();
+//   while (...) {
+//       size_t n = handler.poll(messages, 64);
+//       ...
+//   }
+class FeedHandler {
+public:
+    explicit FeedHandler(const FeedHandlerConfig& config = FeedHandlerConfig());
+    ~FeedHandler();
+
+    FeedHandler(const FeedHandler&) = delete;
+    FeedHandler& operator=(const FeedHandler&) = delete;
+
+    // Before start(); returns the feed's index
+    size_t add_feed(const FeedConfig& config);
+
+    // Starts every feed thread and waits for their setup. Returns false, with
+    // all threads stopped, if any feed could not be pinned or bound.
+    bool start();
+
+    // Stops the feed threads; whatever is already queued is still delivered
+    void stop();
+
+    // Consumer side. Up to max_messages in timestamp order; 0 when nothing
+    // can be released yet.
+    size_t poll(MarketMessage* messages, size_t max_messages);
+
+    // Delivers messages until every feed has ended and drained, the handler
+    // returns false, or stop(). Returns the number delivered.
+    uint64_t run(const std::function<bool(const MarketMessage&)>& handler);
+
+    // Every feed has ended and everything it queued has been delivered
+    bool finished() const;
+
+    size_t feed_count() const { return feeds_.size(); }
+    const std::string& feed_name(size_t index) const { return feeds_[index]->config.name; }
+    FeedStats feed_stats(size_t index) const;
+    uint64_t late_messages() const { return late_messages_; }
+
+    // Pins the calling thread to one core
+    static bool pin_current_thread(int cpu);
+
+    // Prefers memory from node for the calling thread's future allocations
+    static bool bind_current_thread_memory(int numa_node);
+
+private:
+    struct Feed {
+        FeedConfig config;
+        std::thread thread;
+        std::unique_ptr<MemoryArena> arena;  // Created by the feed thread, freed only after its queue
+        std::unique_ptr<FeedQueue> queue;    // Allocated by the feed thread
+
+        // Written by the feed thread only
+        alignas(CACHE_LINE_SIZE) std::atomic<uint64_t> bytes{0};
+        std::atomic<uint64_t> messages{0};
+        std::atomic<uint64_t> parse_errors{0};
+        std::atomic<uint64_t> queue_stalls{0};
+
+        // Merge-side view of the queue head, written by the consumer only
+        alignas(CACHE_LINE_SIZE) std::vector<MarketMessage> pending;
+        size_t pending_index = 0;
+        size_t pending_count = 0;
+        bool drained = false;  // Queue closed and emptied
+    };
+
+    void feed_loop(Feed& feed);
+    void datagram_loop(Feed& feed, MessageParser& parser);
+    bool parse_frames(Feed& feed, MessageParser& parser, const Frame* frames, size_t count,
+                      uint64_t receive_timestamp, MarketMessage* parsed);
+    bool publish(Feed& feed, const MarketMessage* messages, size_t count);
+    bool refill(Feed& feed);
+    void setup_done(bool ok);
+
+    FeedHandlerConfig config_;
+    std::vector<std::unique_ptr<Feed>> feeds_;
+    std::atomic<bool> stop_requested_;
+    bool started_;
+    const TscClock& clock_;
+
+    std::mutex setup_mutex_;
+    std::condition_variable setup_cv_;
+    size_t setup_pending_;
+    bool setup_failed_;
+
+    uint64_t last_timestamp_;
+    uint64_t late_messages_;
+};
+
+} // namespace ingestion
+} // namespace hft
@@ -0,0 +1,191 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+namespace hft {
+namespace ingestion {
+
+// Compile-time FIX schemas.
+//
+// A schema is a type whose static constexpr FIELDS array lists the tags a
+// venue's feed carries, what each one fills in MarketMessage, and whether a
+// message without it is rejected. MessageParser::parse_fix<Schema>() is
+// instantiated per schema, so the tag lookup is a constexpr table and each
+// field's conversion is selected at compile time:
+//
+//   struct MyVenueSchema {
+//       static constexpr FixField FIELDS[] = {
+//           {55, FixFieldKind::SYMBOL, true},
+//           {270, FixFieldKind::PRICE, true},
+//       };
+//   };
+//   parser.parse_fix<MyVenueSchema>(buffer, length, message, context);
+
+enum class FixFieldKind : uint8_t {
+    SYMBOL,        // MarketMessage::symbol (and symbol_id when interning)
+    SIDE,          // '1' buy, '2' sell
+    PRICE,         // Decimal price, per-symbol ticks in fixed-point builds
+    QUANTITY,      // MarketMessage::size
+    MSG_TYPE,      // D/F/G/8/S to MessageType
+    SENDING_TIME,  // UTCTimestamp to MarketMessage::timestamp
+    ORDER_ID,      // MarketMessage::order_id, unless an ORIG_ORDER_ID is present
+    ORIG_ORDER_ID, // MarketMessage::order_id; the order a cancel or replace refers to
+    ASK_PRICE,     // MarketMessage::ask_price, making it two-sided; PRICE is then the bid
+    ASK_QUANTITY   // MarketMessage::ask_size; QUANTITY is then the bid size
+};
+
+struct FixField {
+    uint32_t tag;
+    FixFieldKind kind;
+    bool required;  // Missing or empty rejects the message as INVALID_FORMAT
+};
+
+// Order entry and execution reports; what parse_message() uses for FIX
+struct DefaultFixSchema {
+    static constexpr FixField FIELDS[] = {
+        {55, FixFieldKind::SYMBOL, true},
+        {54, FixFieldKind::SIDE, false},
+        {44, FixFieldKind::PRICE, false},
+        {38, FixFieldKind::QUANTITY, false},
+        {35, FixFieldKind::MSG_TYPE, false},
+        {52, FixFieldKind::SENDING_TIME, false},
+        {11, FixFieldKind::ORDER_ID, false},       // ClOrdID
+        {41, FixFieldKind::ORIG_ORDER_ID, false},  // OrigClOrdID
+    };
+};
+
+// Single-entry market data (MDEntryPx/MDEntrySize) with mandatory SendingTime
+struct FixMarketDataSchema {
+    static constexpr FixField FIELDS[] = {
+        {55, FixFieldKind::SYMBOL, true},
+        {270, FixFieldKind::PRICE, true},
+        {271, FixFieldKind::QUANTITY, false},
+        {35, FixFieldKind::MSG_TYPE, false},
+        {52, FixFieldKind::SENDING_TIME, true},
+    };
+};
+
+// Two-sided quotes (BidPx/OfferPx/BidSize/OfferSize) with mandatory SendingTime
+struct FixQuoteSchema {
+    static constexpr FixField FIELDS[] = {
+        {55, FixFieldKind::SYMBOL, true},
+        {132, FixFieldKind::PRICE, true},
+        {133, FixFieldKind::ASK_PRICE, true},
+        {134, FixFieldKind::QUANTITY, false},
+        {135, FixFieldKind::ASK_QUANTITY, false},
+        {35, FixFieldKind::MSG_TYPE, false},
+        {52, FixFieldKind::SENDING_TIME, true},
+    };
+};
+
+namespace detail {
+
+constexpr uint32_t FIX_DIRECT_TAG_LIMIT = 1024;  // Tags below this resolve through a table
+constexpr uint8_t FIX_NO_SLOT = 0xFF;
+
+template <typename Schema>
+constexpr size_t fix_field_count() {
+    return sizeof(Schema::FIELDS) / sizeof(FixField);
+}
+
+template <typename Schema>
+constexpr uint32_t fix_table_size() {
+    uint32_t max_tag = 0;
+    for (const FixField& field : Schema::FIELDS) {
+        if (field.tag < FIX_DIRECT_TAG_LIMIT && field.tag > max_tag) {
+            max_tag = field.tag;
+        }
+    }
+    return max_tag + 1;
+}
+
+template <typename Schema>
+constexpr bool fix_has_large_tags() {
+    for (const FixField& field : Schema::FIELDS) {
+        if (field.tag >= FIX_DIRECT_TAG_LIMIT) {
+            return true;
+        }
+    }
+    return false;
+}
+
+template <typename Schema>
+constexpr std::array<uint8_t, fix_table_size<Schema>()> fix_slot_table() {
+    std::array<uint8_t, fix_table_size<Schema>()> table{};
+    for (auto& slot : table) {
+        slot = FIX_NO_SLOT;
+    }
+    for (size_t i = 0; i < fix_field_count<Schema>(); ++i) {
+        if (Schema::FIELDS[i].tag < FIX_DIRECT_TAG_LIMIT) {
+            table[Schema::FIELDS[i].tag] = static_cast<uint8_t>(i);
+        }
+    }
+    return table;
+}
+
+template <typename Schema>
+constexpr size_t fix_kind_slot(FixFieldKind kind) {
+    for (size_t i = 0; i < fix_field_count<Schema>(); ++i) {
+        if (Schema::FIELDS[i].kind == kind) {
+            return i;
+        }
+    }
+    return fix_field_count<Schema>();
+}
+
+template <typename Schema>
+constexpr bool fix_fields_unique() {
+    for (size_t i = 0; i < fix_field_count<Schema>(); ++i) {
+        for (size_t j = i + 1; j < fix_field_count<Schema>(); ++j) {
+            if (Schema::FIELDS[i].tag == Schema::FIELDS[j].tag || Schema::FIELDS[i].kind == Schema::FIELDS[j].kind) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+template <typename Schema>
+constexpr bool fix_has_kind(FixFieldKind kind) {
+    return fix_kind_slot<Schema>(kind) < fix_field_count<Schema>();
+}
+
+} // namespace detail
+
+// Everything MessageParser derives from a schema at compile time
+template <typename Schema>
+struct FixSchemaTraits {
+    static constexpr size_t FIELD_COUNT = detail::fix_field_count<Schema>();
+    static constexpr size_t SYMBOL_SLOT = detail::fix_kind_slot<Schema>(FixFieldKind::SYMBOL);
+    static constexpr bool HAS_LARGE_TAGS = detail::fix_has_large_tags<Schema>();
+    static constexpr auto SLOT_TABLE = detail::fix_slot_table<Schema>();
+
+    static_assert(FIELD_COUNT > 0 && FIELD_COUNT < detail::FIX_NO_SLOT, "schema needs 1 to 254 fields");
+    static_assert(SYMBOL_SLOT < FIELD_COUNT, "schema must pick out the symbol");
+    static_assert(detail::fix_fields_unique<Schema>(), "schema tags and field kinds must be unique");
+    static_assert(!detail::fix_has_kind<Schema>(FixFieldKind::ASK_PRICE) ||
+                      (!detail::fix_has_kind<Schema>(FixFieldKind::ORDER_ID) &&
+                       !detail::fix_has_kind<Schema>(FixFieldKind::ORIG_ORDER_ID)),
+                  "ask_price shares MarketMessage storage with order_id");
+
+    // Index into FIELDS for a tag, or FIELD_COUNT when the schema ignores it
+    static size_t slot(uint32_t tag) {
+        if (tag < SLOT_TABLE.size()) {
+            uint8_t slot = SLOT_TABLE[tag];
+            return slot == detail::FIX_NO_SLOT ? FIELD_COUNT : slot;
+        }
+        if constexpr (HAS_LARGE_TAGS) {
+            for (size_t i = 0; i < FIELD_COUNT; ++i) {
+                if (Schema::FIELDS[i].tag == tag) {
+                    return i;
+                }
+            }
+        }
+        return FIELD_COUNT;
+    }
+};
+
+} // namespace ingestion
+} // namespace hft
@@ -0,0 +1,87 @@
+#include "mapped_file.hpp"
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <utility>
+
+namespace hft {
+namespace ingestion {
+
+namespace {
+
+int to_madvise(AccessPattern pattern) {
+    switch (pattern) {
+        case AccessPattern::SEQUENTIAL: return MADV_SEQUENTIAL;
+        case AccessPattern::RANDOM: return MADV_RANDOM;
+        default: return MADV_NORMAL;
+    }
+}
+
+} // namespace
+
+MappedFile::~MappedFile() {
+    close();
+}
+
+MappedFile::MappedFile(MappedFile&& other) noexcept
+    : fd_(std::exchange(other.fd_, -1)),
+      data_(std::exchange(other.data_, nullptr)),
+      size_(std::exchange(other.size_, 0)) {}
+
+MappedFile& MappedFile::operator=(MappedFile&& other) noexcept {
+    if (this != &other) {
+        close();
+        fd_ = std::exchange(other.fd_, -1);
+        data_ = std::exchange(other.data_, nullptr);
+        size_ = std::exchange(other.size_, 0);
+    }
+    return *this;
+}
+
+bool MappedFile::open(const std::string& path, AccessPattern pattern) {
+    close();
+    int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        return false;
+    }
+    struct stat st;
+    if (::fstat(fd, &st) != 0) {
+        ::close(fd);
+        return false;
+    }
+    size_t size = static_cast<size_t>(st.st_size);
+    if (size > 0) {
+        void* data = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (data == MAP_FAILED) {
+            ::close(fd);
+            return false;
+        }
+        data_ = static_cast<char*>(data);
+    }
+    fd_ = fd;
+    size_ = size;
+    advise(pattern);
+    return true;
+}
+
+void MappedFile::close() {
+    if (data_) {
+        ::munmap(data_, size_);
+    }
+    if (fd_ >= 0) {
+        ::close(fd_);
+    }
+    fd_ = -1;
+    data_ = nullptr;
+    size_ = 0;
+}
+
+void MappedFile::advise(AccessPattern pattern) {
+    if (data_) {
+        ::madvise(data_, size_, to_madvise(pattern));
+    }
+}
+
+} // namespace ingestion
+} // namespace hft
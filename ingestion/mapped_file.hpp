@@ -0,0 +1,46 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace hft {
+namespace ingestion {
+
+// Kernel read-ahead hint passed to madvise()
+enum class AccessPattern : uint8_t {
+    NORMAL = 0,
+    SEQUENTIAL = 1,  // Aggressive read-ahead, pages dropped behind the reader
+    RANDOM = 2       // No read-ahead, for indexed lookups
+};
+
+// Read-only memory mapping of a whole file. Empty files open successfully
+// with a null data() and size() == 0.
+class MappedFile {
+public:
+    MappedFile() = default;
+    ~MappedFile();
+
+    MappedFile(MappedFile&& other) noexcept;
+    MappedFile& operator=(MappedFile&& other) noexcept;
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    bool open(const std::string& path, AccessPattern pattern = AccessPattern::SEQUENTIAL);
+    void close();
+
+    // Re-issues the read-ahead hint, e.g. RANDOM after a sequential scan
+    void advise(AccessPattern pattern);
+
+    const char* data() const { return data_; }
+    size_t size() const { return size_; }
+    bool is_open() const { return fd_ >= 0; }
+
+private:
+    int fd_ = -1;
+    char* data_ = nullptr;
+    size_t size_ = 0;
+};
+
+} // namespace ingestion
+} // namespace hft
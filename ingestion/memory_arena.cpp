@@ -0,0 +1,193 @@
+#include "memory_arena.hpp"
+#include <sys/mman.h>
+#include <unistd.h>
+#include <algorithm>
+
+namespace hft {
+namespace ingestion {
+
+namespace {
+
+inline size_t round_up(size_t value, size_t multiple) {
+    return (value + multiple - 1) / multiple * multiple;
+}
+
+inline char* align_up(char* pointer, size_t alignment) {
+    uintptr_t address = reinterpret_cast<uintptr_t>(pointer);
+    return reinterpret_cast<char*>((address + alignment - 1) & ~static_cast<uintptr_t>(alignment - 1));
+}
+
+size_t system_page_size() {
+    long page = ::sysconf(_SC_PAGESIZE);
+    return page > 0 ? static_cast<size_t>(page) : 4096;
+}
+
+} // namespace
+
+MemoryArena::MemoryArena(const ArenaConfig& config)
+    : config_(config),
+      current_(0),
+      cursor_(nullptr),
+      limit_(nullptr),
+      bytes_mapped_(0),
+      bytes_in_use_(0),
+      huge_page_regions_(0) {
+    free_lists_.fill(nullptr);
+    if (config_.region_size == 0) {
+        config_.region_size = ArenaConfig().region_size;
+    }
+    if (config_.initial_size > 0) {
+        map_region(config_.initial_size);
+    }
+}
+
+MemoryArena::~MemoryArena() {
+    for (const Region& region : regions_) {
+        ::munmap(region.base, region.size);
+    }
+}
+
+size_t MemoryArena::size_class(size_t size) {
+    size_t block = MIN_BLOCK;
+    size_t index = 0;
+    while (block < size) {
+        block <<= 1;
+        index++;
+    }
+    return index;
+}
+
+void* MemoryArena::allocate(size_t size, size_t alignment) {
+    if (alignment > MAX_ALIGNMENT || (alignment & (alignment - 1)) != 0) {
+        return nullptr;
+    }
+    size_t index = size_class(size);
+    if (index >= SIZE_CLASSES) {
+        return nullptr;
+    }
+    size_t block_size = MIN_BLOCK << index;
+
+    void*& free_list = free_lists_[index];
+    if (free_list && reinterpret_cast<uintptr_t>(free_list) % alignment == 0) {
+        void* block = free_list;
+        free_list = *static_cast<void**>(block);
+        bytes_in_use_ += block_size;
+        return block;
+    }
+
+    // Blocks are at least cache-line aligned once they span one, so reused
+    // blocks suit any alignment a cache-line sized type asks for
+    char* block = carve(block_size, std::max(alignment, std::min<size_t>(block_size, 64)));
+    if (block) {
+        bytes_in_use_ += block_size;
+    }
+    return block;
+}
+
+void MemoryArena::deallocate(void* block, size_t size) {
+    if (!block) {
+        return;
+    }
+    size_t index = size_class(size);
+    *static_cast<void**>(block) = free_lists_[index];
+    free_lists_[index] = block;
+    bytes_in_use_ -= MIN_BLOCK << index;
+}
+
+void MemoryArena::reset() {
+    free_lists_.fill(nullptr);
+    bytes_in_use_ = 0;
+    current_ = 0;
+    cursor_ = regions_.empty() ? nullptr : regions_[0].base;
+    limit_ = regions_.empty() ? nullptr : regions_[0].base + regions_[0].size;
+}
+
+char* MemoryArena::carve(size_t block_size, size_t alignment) {
+    for (;;) {
+        if (cursor_) {
+            char* block = align_up(cursor_, alignment);
+            if (block <= limit_ && static_cast<size_t>(limit_ - block) >= block_size) {
+                cursor_ = block + block_size;
+                return block;
+            }
+        }
+        // Continue into regions kept by reset() before mapping another
+        if (cursor_ && current_ + 1 < regions_.size()) {
+            current_++;
+            cursor_ = regions_[current_].base;
+            limit_ = cursor_ + regions_[current_].size;
+            continue;
+        }
+        if (!map_region(std::max(config_.region_size, block_size + alignment))) {
+            return nullptr;
+        }
+    }
+}
+
+bool MemoryArena::map_region(size_t size) {
+    const int protection = PROT_READ | PROT_WRITE;
+    const int flags = MAP_PRIVATE | MAP_ANONYMOUS;
+    void* base = MAP_FAILED;
+    size_t mapped = 0;
+    bool huge = false;
+
+    if (config_.huge_pages) {
+        // Fails here, rather than at fault time, when the hugetlb pool is short
+        mapped = round_up(size, HUGE_PAGE_SIZE);
+        base = ::mmap(nullptr, mapped, protection, flags | MAP_HUGETLB | (config_.prefault ? MAP_POPULATE : 0), -1, 0);
+        huge = base != MAP_FAILED;
+    }
+
+    if (base == MAP_FAILED) {
+        size_t page_size = system_page_size();
+        if (config_.huge_pages) {
+            // Map a huge page extra and trim both ends, so the region is
+            // huge-page aligned and transparent huge pages can back all of it
+            mapped = round_up(size, HUGE_PAGE_SIZE);
+            void* raw = ::mmap(nullptr, mapped + HUGE_PAGE_SIZE, protection, flags, -1, 0);
+            if (raw == MAP_FAILED) {
+                return false;
+            }
+            char* start = static_cast<char*>(raw);
+            char* aligned = align_up(start, HUGE_PAGE_SIZE);
+            if (aligned > start) {
+                ::munmap(start, static_cast<size_t>(aligned - start));
+            }
+            size_t tail = static_cast<size_t>(start + mapped + HUGE_PAGE_SIZE - (aligned + mapped));
+            if (tail > 0) {
+                ::munmap(aligned + mapped, tail);
+            }
+            base = aligned;
+#ifdef MADV_HUGEPAGE
+            ::madvise(base, mapped, MADV_HUGEPAGE);  // Before the first touch
+#endif
+        } else {
+            mapped = round_up(size, page_size);
+            base = ::mmap(nullptr, mapped, protection, flags, -1, 0);
+            if (base == MAP_FAILED) {
+                return false;
+            }
+        }
+        if (config_.prefault) {
+            // Writes, not reads: a read fault would only map the shared zero page
+            volatile char* bytes = static_cast<volatile char*>(base);
+            for (size_t offset = 0; offset < mapped; offset += page_size) {
+                bytes[offset] = 0;
+            }
+        }
+    }
+
+    if (config_.lock) {
+        ::mlock(base, mapped);  // Best effort, limited by RLIMIT_MEMLOCK
+    }
+    regions_.push_back(Region{static_cast<char*>(base), mapped});
+    current_ = regions_.size() - 1;
+    cursor_ = static_cast<char*>(base);
+    limit_ = cursor_ + mapped;
+    bytes_mapped_ += mapped;
+    huge_page_regions_ += huge ? 1 : 0;
+    return true;
+}
+
+} // namespace ingestion
+} // namespace hft
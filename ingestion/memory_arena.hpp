@@ -0,0 +1,127 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <vector>
+
+namespace hft {
+namespace ingestion {
+
+constexpr size_t HUGE_PAGE_SIZE = 2 << 20;
+
+struct ArenaConfig {
+    size_t region_size = HUGE_PAGE_SIZE;  // Bytes mapped whenever the arena runs out
+    size_t initial_size = 0;              // Mapped by the constructor, i.e. at startup
+    bool huge_pages = true;               // MAP_HUGETLB, else transparent huge page advice
+    bool prefault = true;                 // Fault every page in when mapping it
+    bool lock = false;                    // mlock regions (needs RLIMIT_MEMLOCK)
+};
+
+// Region-backed allocator for one thread's long-lived hot-path memory:
+// receive buffers, queue slots, order pools and level arrays.
+//
+// Memory is mapped in large regions (2MB huge pages when the hugetlb pool
+// has them, otherwise regular pages advised for THP) and faulted in when the
+// region is mapped, so the first message to touch a buffer doesn't take a
+// page fault. Allocations are carved off the current region; freed blocks go
+// to a power-of-two size class freelist and are handed out again before any
+// new space, so containers that shrink and regrow stop mapping memory once
+// warmed up. Sizing initial_size for the expected footprint keeps mmap and
+// page faults out of the steady state entirely.
+//
+// Not thread-safe: give each thread its own arena, created on that thread so
+// the regions land on its NUMA node. Memory is returned to the OS only when
+// the arena is destroyed, so the arena must outlive everything allocated
+// from it.
+class MemoryArena {
+public:
+    static constexpr size_t MIN_BLOCK = 16;
+    static constexpr size_t MAX_ALIGNMENT = 4096;
+
+    explicit MemoryArena(const ArenaConfig& config = ArenaConfig());
+    ~MemoryArena();
+
+    MemoryArena(const MemoryArena&) = delete;
+    MemoryArena& operator=(const MemoryArena&) = delete;
+
+    // nullptr if the OS refuses more memory or alignment exceeds MAX_ALIGNMENT
+    void* allocate(size_t size, size_t alignment = alignof(std::max_align_t));
+    // size must match the allocate() call; nullptr is ignored
+    void deallocate(void* block, size_t size);
+
+    // Forgets every allocation at once, keeping the regions mapped
+    void reset();
+
+    size_t bytes_mapped() const { return bytes_mapped_; }
+    size_t bytes_in_use() const { return bytes_in_use_; }
+    size_t region_count() const { return regions_.size(); }
+    size_t huge_page_regions() const { return huge_page_regions_; }
+
+private:
+    struct Region {
+        char* base;
+        size_t size;
+    };
+
+    static constexpr size_t SIZE_CLASSES = 48;
+
+    static size_t size_class(size_t size);
+    char* carve(size_t block_size, size_t alignment);
+    bool map_region(size_t size);
+
+    ArenaConfig config_;
+    std::vector<Region> regions_;
+    size_t current_;             // Region being carved
+    char* cursor_;
+    char* limit_;
+    std::array<void*, SIZE_CLASSES> free_lists_;
+    size_t bytes_mapped_;
+    size_t bytes_in_use_;
+    size_t huge_page_regions_;
+};
+
+// Standard allocator over a MemoryArena, for containers on the hot path.
+// A null arena falls back to the global heap.
+template <typename T>
+class ArenaAllocator {
+public:
+    using value_type = T;
+
+    ArenaAllocator(MemoryArena* arena = nullptr) noexcept : arena_(arena) {}
+    template <typename U>
+    ArenaAllocator(const ArenaAllocator<U>& other) noexcept : arena_(other.arena()) {}
+
+    T* allocate(size_t n) {
+        if (!arena_) {
+            return static_cast<T*>(::operator new(n * sizeof(T)));
+        }
+        void* block = arena_->allocate(n * sizeof(T), alignof(T));
+        if (!block) {
+            throw std::bad_alloc();  // Same contract as the default allocator
+        }
+        return static_cast<T*>(block);
+    }
+
+    void deallocate(T* block, size_t n) noexcept {
+        if (arena_) {
+            arena_->deallocate(block, n * sizeof(T));
+        } else {
+            ::operator delete(block);
+        }
+    }
+
+    MemoryArena* arena() const { return arena_; }
+
+    template <typename U>
+    bool operator==(const ArenaAllocator<U>& other) const { return arena_ == other.arena(); }
+    template <typename U>
+    bool operator!=(const ArenaAllocator<U>& other) const { return arena_ != other.arena(); }
+
+private:
+    MemoryArena* arena_;
+};
+
+} // namespace ingestion
+} // namespace hft
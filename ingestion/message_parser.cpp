@@ -1,29 +1,39 @@
 #include "message_parser.hpp"
-#include <algorithm>
-#include <sstream>
+#include "capture_file.hpp"
+#include "probes.hpp"
 #include <cstring>
-#include <cctype>
 
 namespace hft {
 namespace ingestion {
 
-MessageParser::MessageParser() : messages_parsed_(0), parse_errors_(0) {
-    // Initialize FIX tag mappings for common fields
-    fix_tag_names_["8"] = "BeginString";
-    fix_tag_names_["35"] = "MsgType";
-    fix_tag_names_["49"] = "SenderCompID";
-    fix_tag_names_["56"] = "TargetCompID";
-    fix_tag_names_["55"] = "Symbol";
-    fix_tag_names_["54"] = "Side";
-    fix_tag_names_["44"] = "Price";
-    fix_tag_names_["38"] = "OrderQty";
-    fix_tag_names_["52"] = "SendingTime";
-}
+MessageParser::MessageParser()
+    : symbol_registry_(nullptr), capture_writer_(nullptr), clock_(TscClock::instance()),
+      messages_parsed_(0), parse_errors_(0), metrics_(new ParserMetrics()) {}
 
 MessageParser::~MessageParser() = default;
 
 ParseResult MessageParser::parse_message(const char* buffer, size_t length, 
                                         MarketMessage& message, ParseContext& context) {
+    HFT_PROBE_SCOPE(PARSE_MESSAGE);
+    uint64_t start_ticks = clock_.ticks();
+    ParseResult result = route_message(buffer, length, message, context);
+    finish_parse(result, start_ticks, length, message, context);
+    return result;
+}
+
+ParseResult MessageParser::parse_json(const char* buffer, size_t length, MarketMessage& message,
+                                      ParseContext& context) {
+    uint64_t start_ticks = clock_.ticks();
+    context.detected_protocol = ProtocolType::WEBSOCKET_JSON;
+    ParseResult result = check_buffer(buffer, length, message);
+    if (result == ParseResult::SUCCESS) {
+        result = parse_json_fields(buffer, length, message);
+    }
+    finish_parse(result, start_ticks, length, message, context);
+    return result;
+}
+
+ParseResult MessageParser::check_buffer(const char* buffer, size_t length, MarketMessage& message) {
     if (!buffer || length == 0) {
         return ParseResult::INVALID_FORMAT;
     }
@@ -34,48 +44,74 @@ ParseResult MessageParser::parse_message(const char* buffer, size_t length,
     
     // Reset message for reuse
     message.reset();
+    return ParseResult::SUCCESS;
+}
+
+ParseResult MessageParser::route_message(const char* buffer, size_t length, 
+                                         MarketMessage& message, ParseContext& context) {
+    ParseResult checked = check_buffer(buffer, length, message);
+    if (checked != ParseResult::SUCCESS) {
+        return checked;
+    }
     
     // Detect protocol if not already known
     if (context.detected_protocol == ProtocolType::UNKNOWN) {
         context.detected_protocol = detect_protocol(buffer, length);
         if (context.detected_protocol == ProtocolType::UNKNOWN) {
-            parse_errors_++;
             return ParseResult::UNKNOWN_PROTOCOL;
         }
     }
     
-    ParseResult result;
-    
     // Route to appropriate parser
     switch (context.detected_protocol) {
         case ProtocolType::FIX:
-            result = parse_fix_message(buffer, length, message);
-            break;
+            return parse_fix_fields<DefaultFixSchema>(buffer, length, message);
         case ProtocolType::WEBSOCKET_JSON:
-            result = parse_websocket_json(buffer, length, message);
-            break;
+            return parse_json_fields(buffer, length, message);
         default:
-            result = ParseResult::UNKNOWN_PROTOCOL;
-            break;
+            return ParseResult::UNKNOWN_PROTOCOL;
     }
-    
+}
+
+void MessageParser::finish_parse(ParseResult result, uint64_t start_ticks, size_t length, MarketMessage& message,
+                                 ParseContext& context) {
     if (result == ParseResult::SUCCESS) {
         messages_parsed_++;
         context.message_complete = true;
         context.bytes_processed = length;
         
-        // Set timestamp if not provided in message
+        // Receive time is always local; it doubles as event time when the
+        // message carries none, so ordering falls back to arrival order
+        message.receive_timestamp = context.hardware_timestamp ? context.hardware_timestamp
+                                                               : clock_.to_epoch_ns(start_ticks);
         if (message.timestamp == 0) {
-            message.timestamp = get_current_timestamp_ns();
+            message.timestamp = message.receive_timestamp;
+        }
+        
+        if (capture_writer_) {
+            capture_writer_->append(message);
         }
     } else {
         parse_errors_++;
     }
     
-    return result;
+    metrics_->record(context.detected_protocol, result, clock_.ticks_to_ns(clock_.ticks() - start_ticks));
+}
+
+size_t MessageParser::parse_batch(const char* buffer, const uint32_t* offsets, size_t count,
+                                  MarketMessage* messages, ParseResult* results) {
+    size_t parsed = 0;
+    ParseContext context;
+    for (size_t i = 0; i < count; ++i) {
+        context.reset();
+        results[i] = parse_message(buffer + offsets[i], offsets[i + 1] - offsets[i], messages[i], context);
+        parsed += results[i] == ParseResult::SUCCESS;
+    }
+    return parsed;
 }
 
 ProtocolType MessageParser::detect_protocol(const char* buffer, size_t length) {
+    HFT_PROBE_SCOPE(DETECT_PROTOCOL);
     if (length < 2) {
         return ProtocolType::UNKNOWN;
     }
@@ -103,85 +139,7 @@ ProtocolType MessageParser::detect_protocol(const char* buffer, size_t length) {
 }
 
 ParseResult MessageParser::parse_fix_message(const char* buffer, size_t length, MarketMessage& message) {
-    return parse_fix_tag_value_pairs(buffer, length, message);
-}
-
-ParseResult MessageParser::parse_fix_tag_value_pairs(const char* buffer, size_t length, MarketMessage& message) {
-    std::string symbol, side_str, price_str, size_str, msgtype_str, timestamp_str;
-    
-    // Extract key fields
-    if (!extract_fix_field(buffer, length, "55", symbol)) {
-        return ParseResult::INVALID_FORMAT;  // Symbol is required
-    }
-    
-    extract_fix_field(buffer, length, "54", side_str);
-    extract_fix_field(buffer, length, "44", price_str);
-    extract_fix_field(buffer, length, "38", size_str);
-    extract_fix_field(buffer, length, "35", msgtype_str);
-    extract_fix_field(buffer, length, "52", timestamp_str);
-    
-    // Validate and convert fields
-    if (!is_valid_symbol(symbol)) {
-        return ParseResult::INVALID_FORMAT;
-    }
-    message.symbol = symbol;
-    
-    // Convert side
-    message.side = fix_side_to_enum(side_str);
-    
-    // Convert price
-    if (!price_str.empty()) {
-        try {
-            message.price = std::stod(price_str);
-            if (!is_valid_price(message.price)) {
-                return ParseResult::INVALID_FORMAT;
-            }
-        } catch (const std::exception&) {
-            return ParseResult::INVALID_FORMAT;
-        }
-    }
-    
-    // Convert size
-    if (!size_str.empty()) {
-        try {
-            message.size = std::stoi(size_str);
-            if (!is_valid_size(message.size)) {
-                return ParseResult::INVALID_FORMAT;
-            }
-        } catch (const std::exception&) {
-            return ParseResult::INVALID_FORMAT;
-        }
-    }
-    
-    // Convert message type
-    message.type = fix_msgtype_to_enum(msgtype_str);
-    
-    return ParseResult::SUCCESS;
-}
-
-bool MessageParser::extract_fix_field(const char* buffer, size_t length, 
-                                     const std::string& tag, std::string& value) {
-    value.clear();
-    
-    std::string search_pattern = tag + "=";
-    const char* pos = std::search(buffer, buffer + length, 
-                                 search_pattern.begin(), search_pattern.end());
-    
-    if (pos == buffer + length) {
-        return false;  // Tag not found
-    }
-    
-    // Move past the tag and '='
-    pos += search_pattern.length();
-    
-    // Extract value until delimiter or end
-    const char* value_start = pos;
-    while (pos < buffer + length && *pos != FIX_DELIMITER) {
-        pos++;
-    }
-    
-    value.assign(value_start, pos - value_start);
-    return true;
+    return parse_fix_fields<DefaultFixSchema>(buffer, length, message);
 }
 
 ParseResult MessageParser::parse_websocket_json(const char* buffer, size_t length, MarketMessage& message) {
@@ -189,39 +147,57 @@ ParseResult MessageParser::parse_websocket_json(const char* buffer, size_t lengt
 }
 
 ParseResult MessageParser::parse_json_fields(const char* buffer, size_t length, MarketMessage& message) {
-    std::string json(buffer, length);
-    std::string symbol, side_str, type_str;
-    double price = 0.0, bid = 0.0, ask = 0.0;
+    std::string_view fields[JSON_FIELD_COUNT];
+    if (!scan_json_object(buffer, length, fields)) {
+        return ParseResult::INVALID_FORMAT;
+    }
+    
+    std::string_view symbol = fields[JSON_SYMBOL];
+    std::string_view side_str = fields[JSON_SIDE];
+    std::string_view type_str = fields[JSON_TYPE];
+    Price price = 0, bid = 0, ask = 0;
     int32_t size = 0, bid_size = 0, ask_size = 0;
     
     // Extract required fields
-    if (!extract_json_field(json, "symbol", symbol)) {
+    if (!symbol.data()) {
         return ParseResult::INVALID_FORMAT;  // Symbol is required
     }
     
     if (!is_valid_symbol(symbol)) {
         return ParseResult::INVALID_FORMAT;
     }
-    message.symbol = symbol;
-    
-    // Extract optional fields
-    extract_json_field(json, "side", side_str);
-    extract_json_field(json, "type", type_str);
+    message.set_symbol(symbol);
+    if (symbol_registry_) {
+        message.symbol_id = symbol_registry_->intern(symbol);
+    }
     
-    // Handle different JSON formats
-    if (extract_json_double(json, "price", price)) {
+    // Handle different JSON formats; a field that is present but malformed rejects the message
+    if (fields[JSON_PRICE].data()) {
+        if (!parse_price(fields[JSON_PRICE], message.symbol_id, price)) {
+            return ParseResult::INVALID_FORMAT;
+        }
+        if (fields[JSON_SIZE].data() && !parse_int(fields[JSON_SIZE], size)) {
+            return ParseResult::INVALID_FORMAT;
+        }
         message.price = price;
-        extract_json_int(json, "size", size);
         message.size = size;
-    } else {
+    } else if (fields[JSON_BID].data() && fields[JSON_ASK].data()) {
         // Handle bid/ask format
-        if (extract_json_double(json, "bid", bid) && extract_json_double(json, "ask", ask)) {
-            message.price = (bid + ask) / 2.0;  // Use mid-price
-            extract_json_int(json, "bid_size", bid_size);
-            extract_json_int(json, "ask_size", ask_size);
-            message.size = bid_size + ask_size;  // Combined size
-            message.type = MessageType::QUOTE;
+        if (!parse_price(fields[JSON_BID], message.symbol_id, bid) ||
+            !parse_price(fields[JSON_ASK], message.symbol_id, ask)) {
+            return ParseResult::INVALID_FORMAT;
         }
+        if ((fields[JSON_BID_SIZE].data() && !parse_int(fields[JSON_BID_SIZE], bid_size)) ||
+            (fields[JSON_ASK_SIZE].data() && !parse_int(fields[JSON_ASK_SIZE], ask_size))) {
+            return ParseResult::INVALID_FORMAT;
+        }
+        // Both sides travel in the one message so consumers see the BBO, not a mid
+        message.price = bid;
+        message.size = bid_size;
+        message.ask_price = ask;
+        message.ask_size = ask_size;
+        message.flags |= MESSAGE_FLAG_TWO_SIDED;
+        message.type = MessageType::QUOTE;
     }
     
     // Convert side
@@ -240,128 +216,152 @@ ParseResult MessageParser::parse_json_fields(const char* buffer, size_t length,
         message.type = MessageType::QUOTE;
     } else if (type_str == "order") {
         message.type = MessageType::NEW_ORDER;
+    } else if (type_str == "cancel") {
+        message.type = MessageType::CANCEL_ORDER;
+    } else if (type_str == "modify") {
+        message.type = MessageType::MODIFY_ORDER;
     } else if (message.type == MessageType::UNKNOWN) {
         message.type = MessageType::MARKET_DATA;  // Default for market data
     }
     
+    // Event time: integer epoch nanoseconds, or a FIX-style UTCTimestamp string
+    std::string_view timestamp_str = fields[JSON_TIMESTAMP];
+    if (timestamp_str.data()) {
+        const char* first = timestamp_str.data();
+        const char* last = first + timestamp_str.size();
+        if (!parse_uint64(first, last, message.timestamp) && !parse_utc_timestamp(first, last, message.timestamp)) {
+            return ParseResult::INVALID_FORMAT;
+        }
+    }
+    
+    // Numeric or string order id; a two-sided quote keeps its ask in that slot
+    if (!message.two_sided() && !fields[JSON_ORDER_ID].empty() && fields[JSON_ORDER_ID] != "null") {
+        message.order_id = order_id_from(fields[JSON_ORDER_ID]);
+    }
+    
     // Validate converted data
-    if (!is_valid_price(message.price) || !is_valid_size(message.size)) {
+    if (!is_valid_price(message.price) || !is_valid_size(message.size) ||
+        (message.two_sided() && (!is_valid_price(message.ask_price) || !is_valid_size(message.ask_size)))) {
         return ParseResult::INVALID_FORMAT;
     }
     
     return ParseResult::SUCCESS;
 }
 
-bool MessageParser::extract_json_field(const std::string& json, const std::string& key, std::string& value) {
-    std::string search_key = "\"" + key + "\"";
-    size_t pos = json.find(search_key);
-    if (pos == std::string::npos) {
-        return false;
-    }
-    
-    // Find the colon after the key
-    pos = json.find(":", pos);
-    if (pos == std::string::npos) {
-        return false;
-    }
-    pos++;
-    
-    // Skip whitespace
-    while (pos < json.length() && std::isspace(json[pos])) pos++;
-    
-    if (pos >= json.length()) return false;
-    
-    // Extract string value (handle quotes)
-    if (json[pos] == '"') {
-        pos++;  // Skip opening quote
-        size_t end_pos = json.find('"', pos);
-        if (end_pos == std::string::npos) return false;
-        value = json.substr(pos, end_pos - pos);
-    } else {
-        // Non-string value, find end (comma, brace, or end)
-        size_t end_pos = pos;
-        while (end_pos < json.length() && 
-               json[end_pos] != ',' && 
-               json[end_pos] != '}' && 
-               json[end_pos] != ']') {
-            end_pos++;
-        }
-        value = json.substr(pos, end_pos - pos);
-        
-        // Trim whitespace
-        value.erase(0, value.find_first_not_of(" \t\n\r"));
-        value.erase(value.find_last_not_of(" \t\n\r") + 1);
-    }
-    
-    return true;
+namespace {
+
+inline bool is_json_whitespace(char c) {
+    return c == ' ' || c == '\t' || c == '\n' || c == '\r';
 }
 
-bool MessageParser::extract_json_double(const std::string& json, const std::string& key, double& value) {
-    std::string str_value;
-    if (!extract_json_field(json, key, str_value)) {
-        return false;
-    }
-    
-    try {
-        value = std::stod(str_value);
-        return true;
-    } catch (const std::exception&) {
-        return false;
+inline std::string_view trim_json_token(const char* begin, const char* end) {
+    while (begin < end && is_json_whitespace(*begin)) begin++;
+    while (end > begin && is_json_whitespace(end[-1])) end--;
+    return std::string_view(begin, end - begin);
+}
+
+} // namespace
+
+MessageParser::JsonField MessageParser::match_json_key(std::string_view key) {
+    switch (key.size()) {
+        case 3:
+            if (key == "bid") return JSON_BID;
+            if (key == "ask") return JSON_ASK;
+            break;
+        case 4:
+            if (key == "side") return JSON_SIDE;
+            if (key == "type") return JSON_TYPE;
+            if (key == "size") return JSON_SIZE;
+            break;
+        case 5:
+            if (key == "price") return JSON_PRICE;
+            break;
+        case 6:
+            if (key == "symbol") return JSON_SYMBOL;
+            break;
+        case 9:
+            if (key == "timestamp") return JSON_TIMESTAMP;
+            break;
+        case 8:
+            if (key == "bid_size") return JSON_BID_SIZE;
+            if (key == "ask_size") return JSON_ASK_SIZE;
+            if (key == "order_id") return JSON_ORDER_ID;
+            break;
+        default:
+            break;
     }
+    return JSON_FIELD_COUNT;
 }
 
-bool MessageParser::extract_json_int(const std::string& json, const std::string& key, int32_t& value) {
-    std::string str_value;
-    if (!extract_json_field(json, key, str_value)) {
+bool MessageParser::scan_json_object(const char* buffer, size_t length, std::string_view (&fields)[JSON_FIELD_COUNT]) {
+    // Driven by the SIMD structural index: every position returned is a quote or
+    // a structural character outside of string literals, so scalars are simply
+    // the text between two structurals.
+    simd::JsonStructuralScanner structurals(buffer, length);
+    
+    size_t pos = structurals.next();
+    if (pos == length || buffer[pos] != '{' || !trim_json_token(buffer, buffer + pos).empty()) {
         return false;
     }
     
-    try {
-        value = std::stoi(str_value);
-        return true;
-    } catch (const std::exception&) {
+    while (true) {
+        pos = structurals.next();
+        if (pos == length) return false;
+        if (buffer[pos] == '}') return true;  // Empty object or trailing comma
+        
+        // Key
+        if (buffer[pos] != '"') return false;
+        size_t key_end = structurals.next();
+        if (key_end == length) return false;
+        JsonField field = match_json_key(std::string_view(buffer + pos + 1, key_end - pos - 1));
+        
+        size_t colon = structurals.next();
+        if (colon == length || buffer[colon] != ':') return false;
+        
+        // Value: strings yield their raw contents, scalars their token, containers are skipped
+        std::string_view value;
+        size_t next = structurals.next();
+        if (next == length) return false;
+        if (buffer[next] == '"') {
+            size_t value_end = structurals.next();
+            if (value_end == length) return false;
+            value = std::string_view(buffer + next + 1, value_end - next - 1);
+            next = structurals.next();
+        } else if (buffer[next] == '{' || buffer[next] == '[') {
+            size_t value_start = next;
+            int depth = 1;
+            while (depth > 0) {
+                next = structurals.next();
+                if (next == length) return false;
+                char c = buffer[next];
+                if (c == '{' || c == '[') depth++;
+                else if (c == '}' || c == ']') depth--;
+            }
+            value = std::string_view(buffer + value_start, next - value_start + 1);
+            next = structurals.next();
+        } else {
+            value = trim_json_token(buffer + colon + 1, buffer + next);
+        }
+        
+        // First occurrence of a key wins
+        if (field != JSON_FIELD_COUNT && !fields[field].data()) {
+            fields[field] = value;
+        }
+        
+        if (next == length) return false;
+        if (buffer[next] == ',') continue;
+        if (buffer[next] == '}') return true;
         return false;
     }
 }
 
-Side MessageParser::fix_side_to_enum(const std::string& side_str) {
-    if (side_str == "1") return Side::BUY;
-    if (side_str == "2") return Side::SELL;
-    return Side::UNKNOWN;
-}
-
-MessageType MessageParser::fix_msgtype_to_enum(const std::string& msgtype_str) {
-    if (msgtype_str == "D") return MessageType::NEW_ORDER;
-    if (msgtype_str == "F") return MessageType::CANCEL_ORDER;
-    if (msgtype_str == "G") return MessageType::MODIFY_ORDER;
-    if (msgtype_str == "8") return MessageType::TRADE;
-    return MessageType::UNKNOWN;
-}
-
-bool MessageParser::is_valid_symbol(const std::string& symbol) {
-    return !symbol.empty() && 
-           symbol.length() <= MAX_SYMBOL_LENGTH &&
-           std::all_of(symbol.begin(), symbol.end(), 
-                      [](char c) { return std::isalnum(c) || c == '.'; });
-}
-
-bool MessageParser::is_valid_price(double price) {
-    return price >= 0.0 && std::isfinite(price);
-}
-
-bool MessageParser::is_valid_size(int32_t size) {
-    return size >= 0;
-}
-
 void MessageParser::reset_parser_state() {
     messages_parsed_ = 0;
     parse_errors_ = 0;
 }
 
 uint64_t MessageParser::get_current_timestamp_ns() {
-    auto now = std::chrono::high_resolution_clock::now();
-    auto duration = now.time_since_epoch();
-    return std::chrono::duration_cast<std::chrono::nanoseconds>(duration).count();
+    return clock_.now_ns();
 }
 
 } // namespace ingestion
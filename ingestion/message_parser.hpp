@@ -1,62 +1,328 @@
 #pragma once
 
+#include "fix_schema.hpp"
 #include "message_types.hpp"
+#include "numeric_parse.hpp"
+#include "parser_metrics.hpp"
+#include "simd_scan.hpp"
+#include "symbol_registry.hpp"
+#include "tsc_clock.hpp"
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <memory>
 #include <string_view>
-#include <unordered_map>
-#include <chrono>
+#include <utility>
 
 namespace hft {
 namespace ingestion {
 
+class CaptureWriter;
+
 class MessageParser {
 public:
     MessageParser();
     ~MessageParser();
     
-    // Main parsing interface
+    // Main parsing interface; every call, successful or not, is timed into metrics()
     ParseResult parse_message(const char* buffer, size_t length, MarketMessage& message, ParseContext& context);
     
-    // Protocol-specific parsers
+    // Batch interface: frame i is buffer[offsets[i], offsets[i + 1]), so offsets
+    // holds count + 1 entries. Each frame's protocol is detected independently.
+    // Fills messages[i] and results[i]; returns the number of successful parses.
+    size_t parse_batch(const char* buffer, const uint32_t* offsets, size_t count,
+                       MarketMessage* messages, ParseResult* results);
+    
+    // Known-protocol entry points for feeds whose protocol (and, for FIX, venue
+    // schema) is fixed: no detection and no dispatch, with the same stamping,
+    // capture and accounting as parse_message()
+    template <typename Schema = DefaultFixSchema>
+    ParseResult parse_fix(const char* buffer, size_t length, MarketMessage& message, ParseContext& context);
+    ParseResult parse_json(const char* buffer, size_t length, MarketMessage& message, ParseContext& context);
+    
+    // Protocol-specific field decoding only
     ParseResult parse_fix_message(const char* buffer, size_t length, MarketMessage& message);
     ParseResult parse_websocket_json(const char* buffer, size_t length, MarketMessage& message);
     
     // Protocol detection
     ProtocolType detect_protocol(const char* buffer, size_t length);
     
+    // Symbol interning; when set, parsed messages carry a dense symbol_id.
+    // The registry is not owned and must outlive the parser.
+    void set_symbol_registry(SymbolRegistry* registry) { symbol_registry_ = registry; }
+    
+    // Normalized capture; every successfully parsed message is appended.
+    // The writer is not owned and must outlive the parser.
+    void set_capture_writer(CaptureWriter* writer) { capture_writer_ = writer; }
+    
+    // Counters since construction or the last reset_parser_state()
+    size_t messages_parsed() const { return messages_parsed_; }
+    size_t parse_errors() const { return parse_errors_; }
+    
+    // Latency and result counts by protocol; also visible process-wide
+    // through ParserMetricsRegistry, and never reset
+    const ParserMetrics& metrics() const { return *metrics_; }
+    
     // Utility functions
     void reset_parser_state();
     uint64_t get_current_timestamp_ns();
     
+    // MarketMessage::order_id for a FIX ClOrdID/OrigClOrdID or JSON order_id:
+    // the number itself when it is a decimal below 2^63, otherwise a 64-bit
+    // hash with ORDER_ID_HASH_BIT set, so alphanumeric ids still key a book
+    static constexpr uint64_t ORDER_ID_HASH_BIT = 1ULL << 63;
+    static uint64_t order_id_from(std::string_view id);
+    
 private:
-    // FIX parsing helpers
-    ParseResult parse_fix_tag_value_pairs(const char* buffer, size_t length, MarketMessage& message);
-    bool extract_fix_field(const char* buffer, size_t length, const std::string& tag, std::string& value);
-    Side fix_side_to_enum(const std::string& side_str);
-    MessageType fix_msgtype_to_enum(const std::string& msgtype_str);
+    // Detection and routing, without stamping or accounting
+    ParseResult route_message(const char* buffer, size_t length, MarketMessage& message, ParseContext& context);
+    // Receive stamping, capture, counters and metrics shared by every entry point
+    void finish_parse(ParseResult result, uint64_t start_ticks, size_t length, MarketMessage& message,
+                      ParseContext& context);
+    // Rejects empty and oversized buffers; otherwise resets message and returns SUCCESS
+    ParseResult check_buffer(const char* buffer, size_t length, MarketMessage& message);
+    
+    // FIX parsing helpers, specialized per schema
+    template <typename Schema>
+    ParseResult parse_fix_fields(const char* buffer, size_t length, MarketMessage& message);
+    template <typename Schema, size_t... I>
+    bool convert_fix_fields(const std::string_view* values, MarketMessage& message, std::index_sequence<I...>);
+    template <typename Schema, size_t I>
+    bool convert_fix_field(std::string_view value, MarketMessage& message);
+    static Side fix_side_to_enum(std::string_view side_str);
+    static MessageType fix_msgtype_to_enum(std::string_view msgtype_str);
     
     // JSON parsing helpers
+    // Fixed set of JSON keys the parser understands
+    enum JsonField {
+        JSON_SYMBOL,
+        JSON_SIDE,
+        JSON_TYPE,
+        JSON_PRICE,
+        JSON_SIZE,
+        JSON_BID,
+        JSON_ASK,
+        JSON_BID_SIZE,
+        JSON_ASK_SIZE,
+        JSON_TIMESTAMP,
+        JSON_ORDER_ID,
+        JSON_FIELD_COUNT
+    };
+    
     ParseResult parse_json_fields(const char* buffer, size_t length, MarketMessage& message);
-    bool extract_json_field(const std::string& json, const std::string& key, std::string& value);
-    bool extract_json_double(const std::string& json, const std::string& key, double& value);
-    bool extract_json_int(const std::string& json, const std::string& key, int32_t& value);
+    // Walks the top-level object once; known keys are captured as views into the buffer
+    bool scan_json_object(const char* buffer, size_t length, std::string_view (&fields)[JSON_FIELD_COUNT]);
+    static JsonField match_json_key(std::string_view key);
+    
+    // Numeric conversion helpers (allocation- and exception-free)
+    static bool parse_double(std::string_view str, double& value);
+    static bool parse_int(std::string_view str, int32_t& value);
+    // Converts a decimal price into the configured Price representation,
+    // using the symbol's tick size for fixed-point builds
+    bool parse_price(std::string_view str, uint32_t symbol_id, Price& price);
     
     // Validation helpers
-    bool is_valid_symbol(const std::string& symbol);
-    bool is_valid_price(double price);
-    bool is_valid_size(int32_t size);
+    static bool is_valid_symbol(std::string_view symbol);
+    static bool is_valid_price(Price price);
+    static bool is_valid_size(int32_t size);
     
-    // FIX field mappings
-    std::unordered_map<std::string, std::string> fix_tag_names_;
+    // Optional symbol interning
+    SymbolRegistry* symbol_registry_;
+    CaptureWriter* capture_writer_;
+    
+    // Timestamp source for messages without one
+    const TscClock& clock_;
     
     // Performance tracking
     size_t messages_parsed_;
     size_t parse_errors_;
+    std::unique_ptr<ParserMetrics> metrics_;  // Heap-allocated so its registered address survives moves
     
     // Constants
     static constexpr char FIX_DELIMITER = '\x01';  // SOH character
     static constexpr size_t MAX_MESSAGE_SIZE = 4096;
-    static constexpr size_t MAX_SYMBOL_LENGTH = 16;
+    static constexpr size_t MAX_SYMBOL_LENGTH = MarketMessage::SYMBOL_CAPACITY;
 };
 
+// Inline so that each parse_fix<Schema>() instantiation compiles down to
+// one loop with the conversions for exactly that schema's fields
+
+template <typename Schema>
+ParseResult MessageParser::parse_fix(const char* buffer, size_t length, MarketMessage& message,
+                                     ParseContext& context) {
+    uint64_t start_ticks = clock_.ticks();
+    context.detected_protocol = ProtocolType::FIX;
+    ParseResult result = check_buffer(buffer, length, message);
+    if (result == ParseResult::SUCCESS) {
+        result = parse_fix_fields<Schema>(buffer, length, message);
+    }
+    finish_parse(result, start_ticks, length, message, context);
+    return result;
+}
+
+template <typename Schema>
+ParseResult MessageParser::parse_fix_fields(const char* buffer, size_t length, MarketMessage& message) {
+    using Traits = FixSchemaTraits<Schema>;
+    std::string_view values[Traits::FIELD_COUNT];
+    
+    // Walk the SOH-delimited tag=value pairs once, resolving each integer tag
+    // to its schema slot. Pair boundaries come from the SIMD delimiter
+    // bitmask, 64 bytes at a time.
+    simd::CharScanner delimiters(buffer, length, FIX_DELIMITER);
+    size_t pair_start = 0;
+    while (pair_start < length) {
+        size_t pair_end = delimiters.next();
+        const char* pos = buffer + pair_start;
+        const char* end = buffer + pair_end;
+        
+        uint32_t tag = 0;
+        const char* tag_start = pos;
+        while (pos < end && *pos >= '0' && *pos <= '9') {
+            tag = tag * 10 + static_cast<uint32_t>(*pos - '0');
+            pos++;
+        }
+        if (pos == tag_start && pos < end && (*pos == '\n' || *pos == '\r')) {
+            break;  // Trailing line terminator from file-based feeds
+        }
+        if (pos == tag_start || pos == end || *pos != '=') {
+            return ParseResult::INVALID_FORMAT;  // Malformed pair
+        }
+        pair_start = pair_end + 1;
+        
+        // First occurrence of a tag wins
+        size_t slot = Traits::slot(tag);
+        if (slot != Traits::FIELD_COUNT && !values[slot].data()) {
+            values[slot] = std::string_view(pos + 1, end - pos - 1);
+        }
+    }
+    
+    // The symbol goes first: fixed-point prices need its tick size
+    if (!convert_fix_field<Schema, Traits::SYMBOL_SLOT>(values[Traits::SYMBOL_SLOT], message) ||
+        !convert_fix_fields<Schema>(values, message, std::make_index_sequence<Traits::FIELD_COUNT>())) {
+        return ParseResult::INVALID_FORMAT;
+    }
+    return ParseResult::SUCCESS;
+}
+
+template <typename Schema, size_t... I>
+bool MessageParser::convert_fix_fields(const std::string_view* values, MarketMessage& message,
+                                       std::index_sequence<I...>) {
+    return ((I == FixSchemaTraits<Schema>::SYMBOL_SLOT || convert_fix_field<Schema, I>(values[I], message)) && ...);
+}
+
+template <typename Schema, size_t I>
+bool MessageParser::convert_fix_field(std::string_view value, MarketMessage& message) {
+    constexpr FixField field = Schema::FIELDS[I];
+    if (value.empty()) {
+        return !field.required;  // Absent or empty optional fields keep their reset value
+    }
+    if constexpr (field.kind == FixFieldKind::SYMBOL) {
+        if (!is_valid_symbol(value)) {
+            return false;
+        }
+        message.set_symbol(value);
+        if (symbol_registry_) {
+            message.symbol_id = symbol_registry_->intern(value);
+        }
+        return true;
+    } else if constexpr (field.kind == FixFieldKind::SIDE) {
+        message.side = fix_side_to_enum(value);
+        return true;
+    } else if constexpr (field.kind == FixFieldKind::PRICE) {
+        return parse_price(value, message.symbol_id, message.price) && is_valid_price(message.price);
+    } else if constexpr (field.kind == FixFieldKind::QUANTITY) {
+        return parse_int(value, message.size) && is_valid_size(message.size);
+    } else if constexpr (field.kind == FixFieldKind::MSG_TYPE) {
+        message.type = fix_msgtype_to_enum(value);
+        return true;
+    } else if constexpr (field.kind == FixFieldKind::SENDING_TIME) {
+        return parse_utc_timestamp(value.data(), value.data() + value.size(), message.timestamp);
+    } else if constexpr (field.kind == FixFieldKind::ORDER_ID) {
+        if (message.order_id == 0) {
+            message.order_id = order_id_from(value);
+        }
+        return true;
+    } else if constexpr (field.kind == FixFieldKind::ORIG_ORDER_ID) {
+        message.order_id = order_id_from(value);  // Takes precedence over ClOrdID
+        return true;
+    } else if constexpr (field.kind == FixFieldKind::ASK_PRICE) {
+        message.flags |= MESSAGE_FLAG_TWO_SIDED;
+        return parse_price(value, message.symbol_id, message.ask_price) && is_valid_price(message.ask_price);
+    } else {
+        static_assert(field.kind == FixFieldKind::ASK_QUANTITY, "unhandled FixFieldKind");
+        return parse_int(value, message.ask_size) && is_valid_size(message.ask_size);
+    }
+}
+
+inline uint64_t MessageParser::order_id_from(std::string_view id) {
+    uint64_t value;
+    if (parse_uint64(id.data(), id.data() + id.size(), value) && !(value & ORDER_ID_HASH_BIT)) {
+        return value;
+    }
+    // FNV-1a; the top bit keeps hashed ids apart from numeric ones
+    uint64_t hash = 14695981039346656037ULL;
+    for (char c : id) {
+        hash = (hash ^ static_cast<unsigned char>(c)) * 1099511628211ULL;
+    }
+    return hash | ORDER_ID_HASH_BIT;
+}
+
+inline Side MessageParser::fix_side_to_enum(std::string_view side_str) {
+    if (side_str == "1") return Side::BUY;
+    if (side_str == "2") return Side::SELL;
+    return Side::UNKNOWN;
+}
+
+inline MessageType MessageParser::fix_msgtype_to_enum(std::string_view msgtype_str) {
+    if (msgtype_str == "D") return MessageType::NEW_ORDER;
+    if (msgtype_str == "F") return MessageType::CANCEL_ORDER;
+    if (msgtype_str == "G") return MessageType::MODIFY_ORDER;
+    if (msgtype_str == "8") return MessageType::TRADE;
+    if (msgtype_str == "S") return MessageType::QUOTE;
+    return MessageType::UNKNOWN;
+}
+
+inline bool MessageParser::parse_double(std::string_view str, double& value) {
+    return ingestion::parse_double(str.data(), str.data() + str.size(), value);
+}
+
+inline bool MessageParser::parse_int(std::string_view str, int32_t& value) {
+    return parse_int32(str.data(), str.data() + str.size(), value);
+}
+
+inline bool MessageParser::parse_price(std::string_view str, uint32_t symbol_id, Price& price) {
+#ifdef HFT_FIXED_POINT_PRICES
+    int64_t raw;
+    if (!parse_fixed_point(str.data(), str.data() + str.size(), PRICE_DECIMALS, raw)) {
+        return false;
+    }
+    int64_t tick_units = symbol_registry_ ? symbol_registry_->tick_size(symbol_id) : DEFAULT_TICK_UNITS;
+    price = raw_to_ticks(raw, tick_units);
+    return true;
+#else
+    (void)symbol_id;
+    return parse_double(str, price);
+#endif
+}
+
+inline bool MessageParser::is_valid_symbol(std::string_view symbol) {
+    return !symbol.empty() && 
+           symbol.length() <= MAX_SYMBOL_LENGTH &&
+           std::all_of(symbol.begin(), symbol.end(), 
+                      [](char c) { return std::isalnum(static_cast<unsigned char>(c)) || c == '.'; });
+}
+
+inline bool MessageParser::is_valid_price(Price price) {
+#ifdef HFT_FIXED_POINT_PRICES
+    return price >= 0;
+#else
+    return price >= 0.0 && std::isfinite(price);
+#endif
+}
+
+inline bool MessageParser::is_valid_size(int32_t size) {
+    return size >= 0;
+}
+
 } // namespace ingestion
-} // namespace hft 
\ No newline at end of file
+} // namespace hft
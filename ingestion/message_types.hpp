@@ -1,20 +1,23 @@
 #pragma once
 
-#include <string>
+#include "price.hpp"
+#include <string_view>
+#include <type_traits>
 #include <cstdint>
+#include <cstring>
 
 namespace hft {
 namespace ingestion {
 
 // Trading side enumeration
-enum class Side {
+enum class Side : uint8_t {
     BUY = 1,
     SELL = 2,
     UNKNOWN = 0
 };
 
 // Message type classification
-enum class MessageType {
+enum class MessageType : uint8_t {
     NEW_ORDER = 1,
     CANCEL_ORDER = 2,
     MODIFY_ORDER = 3,
@@ -40,41 +43,83 @@ enum class ParseResult {
     BUFFER_OVERFLOW = 4
 };
 
+// Sentinel for messages whose symbol has not been interned
+constexpr uint32_t INVALID_SYMBOL_ID = 0xFFFFFFFF;
+
+// MarketMessage::flags
+constexpr uint8_t MESSAGE_FLAG_TWO_SIDED = 1u << 0;  // price/size are the bid, ask_price/ask_size the ask
+
 // Standardized market message structure
-struct MarketMessage {
-    uint64_t timestamp;        // Nanoseconds since epoch
-    std::string symbol;        // Trading symbol (e.g., "AAPL", "MSFT")
-    Side side;                // BUY/SELL/UNKNOWN
-    double price;             // Price level
-    int32_t size;             // Quantity/Size
-    MessageType type;         // Message classification
+// Trivially copyable and sized to one cache line so it can be memcpy'd
+// through queues and laid out in flat arrays without touching the heap.
+struct alignas(64) MarketMessage {
+    static constexpr size_t SYMBOL_CAPACITY = 16;
+    
+    uint64_t timestamp;             // Event time, nanoseconds since epoch (FIX SendingTime when present)
+    Price price;                    // Price level (ticks in fixed-point builds)
+    int32_t size;                   // Quantity/Size
+    uint32_t symbol_id;             // Dense id from SymbolRegistry, INVALID_SYMBOL_ID if not interned
+    Side side;                      // BUY/SELL/UNKNOWN
+    MessageType type;               // Message classification
+    char symbol[SYMBOL_CAPACITY];   // Trading symbol, NUL-padded (e.g., "AAPL", "MSFT")
+    uint8_t flags;                  // MESSAGE_FLAG_*
+    int32_t ask_size;               // Ask quantity of a two-sided quote
+    uint64_t receive_timestamp;     // Local receive time, nanoseconds since epoch
+    union {
+        uint64_t order_id;          // Order the event refers to, 0 if none (see MessageParser::order_id_from)
+        Price ask_price;            // Ask of a two-sided quote, which refers to no order
+    };
     
     // Constructor
-    MarketMessage() : timestamp(0), side(Side::UNKNOWN), price(0.0), size(0), type(MessageType::UNKNOWN) {}
+    MarketMessage() { reset(); }
     
     // Reset for object reuse
     void reset() {
-        timestamp = 0;
-        symbol.clear();
-        side = Side::UNKNOWN;
-        price = 0.0;
-        size = 0;
-        type = MessageType::UNKNOWN;
+        // Trivially copyable; zeroing through void* also clears the padding
+        std::memset(static_cast<void*>(this), 0, sizeof(*this));
+        symbol_id = INVALID_SYMBOL_ID;
+    }
+    
+    // Symbol accessors; symbols longer than SYMBOL_CAPACITY are truncated
+    void set_symbol(std::string_view value) {
+        size_t n = value.size() < SYMBOL_CAPACITY ? value.size() : SYMBOL_CAPACITY;
+        std::memcpy(symbol, value.data(), n);
+        std::memset(symbol + n, 0, SYMBOL_CAPACITY - n);
+    }
+    
+    bool two_sided() const { return (flags & MESSAGE_FLAG_TWO_SIDED) != 0; }
+    
+    std::string_view symbol_view() const {
+        const void* nul = std::memchr(symbol, '\0', SYMBOL_CAPACITY);
+        size_t n = nul ? static_cast<const char*>(nul) - symbol : SYMBOL_CAPACITY;
+        return std::string_view(symbol, n);
     }
 };
 
+static_assert(std::is_trivially_copyable<MarketMessage>::value, "MarketMessage must be trivially copyable");
+static_assert(sizeof(MarketMessage) == 64, "MarketMessage must occupy exactly one cache line");
+static_assert(sizeof(Price) == sizeof(uint64_t), "ask_price shares order_id's storage");
+
 // Parsing context for maintaining state
 struct ParseContext {
     ProtocolType detected_protocol;
     size_t bytes_processed;
     bool message_complete;
+    // Receive-path timestamp (e.g. NIC hardware timestamp from SO_TIMESTAMPING),
+    // epoch nanoseconds. Becomes MarketMessage::receive_timestamp, and the event
+    // timestamp for messages without their own; 0 means none, in which case the
+    // parser stamps the message from TscClock.
+    uint64_t hardware_timestamp;
     
-    ParseContext() : detected_protocol(ProtocolType::UNKNOWN), bytes_processed(0), message_complete(false) {}
+    ParseContext()
+        : detected_protocol(ProtocolType::UNKNOWN), bytes_processed(0), message_complete(false),
+          hardware_timestamp(0) {}
     
     void reset() {
         detected_protocol = ProtocolType::UNKNOWN;
         bytes_processed = 0;
         message_complete = false;
+        hardware_timestamp = 0;
     }
 };
 
@@ -0,0 +1,213 @@
+#pragma once
+
+#include <charconv>
+#include <cstddef>
+#include <cstdint>
+
+namespace hft {
+namespace ingestion {
+
+// Allocation- and exception-free numeric parsing for hot-path fields.
+// All functions take a [first, last) character range and return false on
+// malformed input, overflow, or trailing characters.
+
+constexpr uint32_t MAX_EXACT_POW10 = 22;  // Largest power of ten exactly representable as a double
+
+inline double pow10_exact(uint32_t exponent) {
+    static constexpr double table[MAX_EXACT_POW10 + 1] = {
+        1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+        1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+    };
+    return table[exponent];
+}
+
+constexpr uint32_t MAX_INT64_POW10 = 18;  // Largest power of ten that fits in int64_t
+
+inline int64_t pow10_int64(uint32_t exponent) {
+    static constexpr int64_t table[MAX_INT64_POW10 + 1] = {
+        1LL, 10LL, 100LL, 1000LL, 10000LL, 100000LL, 1000000LL, 10000000LL, 100000000LL, 1000000000LL,
+        10000000000LL, 100000000000LL, 1000000000000LL, 10000000000000LL, 100000000000000LL,
+        1000000000000000LL, 10000000000000000LL, 100000000000000000LL, 1000000000000000000LL
+    };
+    return table[exponent];
+}
+
+// Parses "[-]digits[.digits]" into an integer mantissa and the number of
+// fractional digits, e.g. "150.25" -> mantissa 15025, frac_digits 2.
+// Fails if the mantissa does not fit in 18 significant digits.
+inline bool parse_decimal(const char* first, const char* last, int64_t& mantissa, uint32_t& frac_digits) {
+    const char* pos = first;
+    bool negative = false;
+    if (pos < last && *pos == '-') {
+        negative = true;
+        pos++;
+    }
+
+    uint64_t value = 0;
+    uint32_t digits = 0;
+    uint32_t fraction = 0;
+    bool seen_point = false;
+    const char* digits_start = pos;
+    for (; pos < last; ++pos) {
+        char c = *pos;
+        if (c >= '0' && c <= '9') {
+            if (digits == 18) {
+                return false;  // Would overflow the mantissa
+            }
+            value = value * 10 + static_cast<uint64_t>(c - '0');
+            // Leading zeros do not count towards precision
+            if (value != 0) digits++;
+            if (seen_point) fraction++;
+        } else if (c == '.' && !seen_point) {
+            seen_point = true;
+        } else {
+            return false;
+        }
+    }
+    if (pos == digits_start || (seen_point && pos - digits_start == 1)) {
+        return false;  // No digits at all
+    }
+
+    mantissa = negative ? -static_cast<int64_t>(value) : static_cast<int64_t>(value);
+    frac_digits = fraction;
+    return true;
+}
+
+// Parses a decimal into fixed point with `decimals` implied places,
+// e.g. "150.25" with 8 decimals -> 15025000000. Digits beyond the
+// requested precision are rounded half away from zero.
+inline bool parse_fixed_point(const char* first, const char* last, uint32_t decimals, int64_t& value) {
+    int64_t mantissa;
+    uint32_t frac_digits;
+    if (!parse_decimal(first, last, mantissa, frac_digits)) {
+        return false;
+    }
+
+    if (frac_digits > decimals) {
+        // One division, so the dropped digits round once as a whole
+        uint32_t dropped = frac_digits - decimals;
+        if (dropped > MAX_INT64_POW10) {
+            mantissa = 0;  // Below half a unit: the mantissa has at most 18 digits
+        } else {
+            int64_t divisor = pow10_int64(dropped);
+            int64_t remainder = mantissa % divisor;
+            mantissa /= divisor;
+            if (remainder >= divisor - remainder) mantissa++;
+            else if (-remainder >= divisor + remainder) mantissa--;
+        }
+        frac_digits = decimals;
+    }
+    while (frac_digits < decimals) {
+        if (mantissa > INT64_MAX / 10 || mantissa < INT64_MIN / 10) {
+            return false;
+        }
+        mantissa *= 10;
+        frac_digits++;
+    }
+
+    value = mantissa;
+    return true;
+}
+
+// Decimal to double. Plain decimals whose mantissa is below 2^53 take the
+// exact mantissa / 10^n fast path (correctly rounded, one division);
+// everything else, including exponent notation, goes through std::from_chars.
+inline bool parse_double(const char* first, const char* last, double& value) {
+    int64_t mantissa;
+    uint32_t frac_digits;
+    if (parse_decimal(first, last, mantissa, frac_digits) &&
+        mantissa < (1LL << 53) && mantissa > -(1LL << 53) && frac_digits <= MAX_EXACT_POW10) {
+        value = static_cast<double>(mantissa) / pow10_exact(frac_digits);
+        return true;
+    }
+
+    auto result = std::from_chars(first, last, value);
+    return result.ec == std::errc() && result.ptr == last;
+}
+
+inline bool parse_int32(const char* first, const char* last, int32_t& value) {
+    auto result = std::from_chars(first, last, value);
+    return result.ec == std::errc() && result.ptr == last && first != last;
+}
+
+inline bool parse_uint64(const char* first, const char* last, uint64_t& value) {
+    auto result = std::from_chars(first, last, value);
+    return result.ec == std::errc() && result.ptr == last && first != last;
+}
+
+// Fixed-width run of ASCII digits, e.g. the "2024" of a date
+inline bool parse_fixed_digits(const char* pos, uint32_t count, uint32_t& value) {
+    uint32_t result = 0;
+    for (uint32_t i = 0; i < count; ++i) {
+        uint32_t digit = static_cast<uint32_t>(pos[i] - '0');
+        if (digit > 9) {
+            return false;
+        }
+        result = result * 10 + digit;
+    }
+    value = result;
+    return true;
+}
+
+// Days since 1970-01-01 for a proleptic Gregorian date (H. Hinnant's days_from_civil)
+constexpr int64_t days_from_civil(int64_t year, uint32_t month, uint32_t day) {
+    year -= month <= 2;
+    const int64_t era = (year >= 0 ? year : year - 399) / 400;
+    const uint32_t yoe = static_cast<uint32_t>(year - era * 400);
+    const uint32_t doy = (153 * (month > 2 ? month - 3 : month + 9) + 2) / 5 + day - 1;
+    const uint32_t doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+    return era * 146097 + static_cast<int64_t>(doe) - 719468;
+}
+
+// Parses a FIX UTCTimestamp, "YYYYMMDD-HH:MM:SS[.s...]" with up to nine
+// fractional digits (milli, micro, nano or anything in between), into
+// nanoseconds since the Unix epoch. A leap second (:60) is accepted and
+// folds into the following second.
+inline bool parse_utc_timestamp(const char* first, const char* last, uint64_t& ns) {
+    constexpr size_t BASE_LENGTH = 17;  // YYYYMMDD-HH:MM:SS
+    constexpr uint32_t MAX_FRACTION_DIGITS = 9;
+    size_t length = static_cast<size_t>(last - first);
+    if (length < BASE_LENGTH || first[8] != '-' || first[11] != ':' || first[14] != ':') {
+        return false;
+    }
+
+    uint32_t year, month, day, hour, minute, second;
+    if (!parse_fixed_digits(first, 4, year) || !parse_fixed_digits(first + 4, 2, month) ||
+        !parse_fixed_digits(first + 6, 2, day) || !parse_fixed_digits(first + 9, 2, hour) ||
+        !parse_fixed_digits(first + 12, 2, minute) || !parse_fixed_digits(first + 15, 2, second)) {
+        return false;
+    }
+    static constexpr uint8_t days_in_month[12] = {31, 29, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31};
+    bool leap_year = (year % 4 == 0 && year % 100 != 0) || year % 400 == 0;
+    if (year < 1970 || month < 1 || month > 12 || day < 1 || day > days_in_month[month - 1] ||
+        (month == 2 && day == 29 && !leap_year) || hour > 23 || minute > 59 || second > 60) {
+        return false;
+    }
+
+    uint64_t fraction = 0;
+    if (length > BASE_LENGTH) {
+        uint32_t digits = static_cast<uint32_t>(length - BASE_LENGTH - 1);
+        if (first[BASE_LENGTH] != '.' || digits == 0 || digits > MAX_FRACTION_DIGITS) {
+            return false;
+        }
+        uint32_t value;
+        if (!parse_fixed_digits(first + BASE_LENGTH + 1, digits, value)) {
+            return false;
+        }
+        fraction = value;
+        for (uint32_t i = digits; i < MAX_FRACTION_DIGITS; ++i) {
+            fraction *= 10;
+        }
+    }
+
+    uint64_t days = static_cast<uint64_t>(days_from_civil(year, month, day));
+    uint64_t seconds = days * 86400 + hour * 3600 + minute * 60 + second;
+    if (seconds >= UINT64_MAX / 1000000000ULL) {
+        return false;  // Past 2554, beyond 64-bit epoch nanoseconds
+    }
+    ns = seconds * 1000000000ULL + fraction;
+    return true;
+}
+
+} // namespace ingestion
+} // namespace hft
@@ -0,0 +1,211 @@
+#include "parser_metrics.hpp"
+#include <algorithm>
+#include <cinttypes>
+#include <cstdarg>
+#include <cstdio>
+
+namespace hft {
+namespace ingestion {
+
+namespace {
+
+// Histogram buckets exported to Prometheus: powers of two from 32 ns to
+// ~16.8 ms, which fall exactly on LatencyHistogram bucket boundaries
+constexpr uint32_t PROMETHEUS_MIN_EXPONENT = 5;
+constexpr uint32_t PROMETHEUS_MAX_EXPONENT = 24;
+constexpr double EXPORTED_QUANTILES[] = {0.5, 0.99, 0.999};
+
+const char* const PROTOCOL_LABELS[PROTOCOL_COUNT] = {"unknown", "fix", "json"};
+const char* const RESULT_LABELS[PARSE_RESULT_COUNT] = {
+    "success", "invalid_format", "incomplete_message", "unknown_protocol", "buffer_overflow"
+};
+
+void append_format(std::string& out, const char* format, ...) __attribute__((format(printf, 2, 3)));
+
+void append_format(std::string& out, const char* format, ...) {
+    char line[256];
+    va_list args;
+    va_start(args, format);
+    int n = std::vsnprintf(line, sizeof(line), format, args);
+    va_end(args);
+    if (n > 0) {
+        out.append(line, std::min(static_cast<size_t>(n), sizeof(line) - 1));
+    }
+}
+
+double ns_to_seconds(uint64_t ns) {
+    return static_cast<double>(ns) / 1e9;
+}
+
+} // namespace
+
+void HistogramSnapshot::merge(const LatencyHistogram& histogram) {
+    count += histogram.count();
+    sum += histogram.sum();
+    for (size_t i = 0; i < LatencyHistogram::BUCKET_COUNT; ++i) {
+        buckets[i] += histogram.bucket(i);
+    }
+}
+
+void HistogramSnapshot::merge(const HistogramSnapshot& other) {
+    count += other.count;
+    sum += other.sum;
+    for (size_t i = 0; i < LatencyHistogram::BUCKET_COUNT; ++i) {
+        buckets[i] += other.buckets[i];
+    }
+}
+
+uint64_t HistogramSnapshot::bucket_total() const {
+    uint64_t total = 0;
+    for (uint64_t bucket : buckets) {
+        total += bucket;
+    }
+    return total;
+}
+
+uint64_t HistogramSnapshot::count_below(uint64_t bound) const {
+    uint64_t total = 0;
+    for (size_t i = 0; i < LatencyHistogram::BUCKET_COUNT && LatencyHistogram::bucket_upper_bound(i) <= bound; ++i) {
+        total += buckets[i];
+    }
+    return total;
+}
+
+uint64_t HistogramSnapshot::value_at_quantile(double q) const {
+    uint64_t total = bucket_total();
+    if (total == 0) {
+        return 0;
+    }
+    uint64_t rank = static_cast<uint64_t>(std::max(0.0, std::min(q, 1.0)) * static_cast<double>(total - 1)) + 1;
+    uint64_t seen = 0;
+    for (size_t i = 0; i < LatencyHistogram::BUCKET_COUNT; ++i) {
+        seen += buckets[i];
+        if (seen >= rank) {
+            return LatencyHistogram::bucket_upper_bound(i);
+        }
+    }
+    return LatencyHistogram::bucket_upper_bound(LatencyHistogram::BUCKET_COUNT - 1);
+}
+
+void ParserMetricsSnapshot::merge(const ParserMetricsSnapshot& other) {
+    for (size_t p = 0; p < PROTOCOL_COUNT; ++p) {
+        for (size_t r = 0; r < PARSE_RESULT_COUNT; ++r) {
+            latency[p][r].merge(other.latency[p][r]);
+        }
+    }
+}
+
+uint64_t ParserMetricsSnapshot::count(ProtocolType protocol, ParseResult result) const {
+    return latency[static_cast<size_t>(protocol)][static_cast<size_t>(result)].count;
+}
+
+uint64_t ParserMetricsSnapshot::count(ParseResult result) const {
+    uint64_t total = 0;
+    for (size_t p = 0; p < PROTOCOL_COUNT; ++p) {
+        total += latency[p][static_cast<size_t>(result)].count;
+    }
+    return total;
+}
+
+ParserMetrics::ParserMetrics() {
+    ParserMetricsRegistry::instance().attach(this);
+}
+
+ParserMetrics::~ParserMetrics() {
+    ParserMetricsRegistry::instance().detach(this);
+}
+
+void ParserMetrics::snapshot_into(ParserMetricsSnapshot& snapshot) const {
+    for (size_t p = 0; p < PROTOCOL_COUNT; ++p) {
+        for (size_t r = 0; r < PARSE_RESULT_COUNT; ++r) {
+            snapshot.latency[p][r].merge(latency_[p][r]);
+        }
+    }
+}
+
+ParserMetricsRegistry& ParserMetricsRegistry::instance() {
+    // Never destroyed, so parsers with static storage can still detach at exit
+    static ParserMetricsRegistry* registry = new ParserMetricsRegistry();
+    return *registry;
+}
+
+void ParserMetricsRegistry::attach(const ParserMetrics* shard) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    shards_.push_back(shard);
+}
+
+void ParserMetricsRegistry::detach(const ParserMetrics* shard) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    shard->snapshot_into(retired_);
+    shards_.erase(std::remove(shards_.begin(), shards_.end(), shard), shards_.end());
+}
+
+ParserMetricsSnapshot ParserMetricsRegistry::snapshot() const {
+    ParserMetricsSnapshot snapshot;
+    std::lock_guard<std::mutex> lock(mutex_);
+    snapshot.merge(retired_);
+    for (const ParserMetrics* shard : shards_) {
+        shard->snapshot_into(snapshot);
+    }
+    return snapshot;
+}
+
+size_t ParserMetricsRegistry::shard_count() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return shards_.size();
+}
+
+void ParserMetricsRegistry::render_prometheus(std::string& out) const {
+    ParserMetricsSnapshot snap = snapshot();
+
+    out += "# HELP hft_parser_messages_total Messages handed to the parser, by protocol and result\n";
+    out += "# TYPE hft_parser_messages_total counter\n";
+    for (size_t p = 0; p < PROTOCOL_COUNT; ++p) {
+        for (size_t r = 0; r < PARSE_RESULT_COUNT; ++r) {
+            append_format(out, "hft_parser_messages_total{protocol=\"%s\",result=\"%s\"} %" PRIu64 "\n",
+                          PROTOCOL_LABELS[p], RESULT_LABELS[r], snap.latency[p][r].count);
+        }
+    }
+
+    // Histogram series only for (protocol, result) pairs that have occurred
+    out += "# HELP hft_parser_latency_seconds Time spent in MessageParser::parse_message\n";
+    out += "# TYPE hft_parser_latency_seconds histogram\n";
+    for (size_t p = 0; p < PROTOCOL_COUNT; ++p) {
+        for (size_t r = 0; r < PARSE_RESULT_COUNT; ++r) {
+            // Bucket totals keep +Inf and _count consistent with the le buckets
+            const HistogramSnapshot& histogram = snap.latency[p][r];
+            uint64_t total = histogram.bucket_total();
+            if (total == 0) {
+                continue;
+            }
+            for (uint32_t e = PROMETHEUS_MIN_EXPONENT; e <= PROMETHEUS_MAX_EXPONENT; ++e) {
+                append_format(out, "hft_parser_latency_seconds_bucket{protocol=\"%s\",result=\"%s\",le=\"%.9g\"} %" PRIu64 "\n",
+                              PROTOCOL_LABELS[p], RESULT_LABELS[r], ns_to_seconds(1ULL << e),
+                              histogram.count_below(1ULL << e));
+            }
+            append_format(out, "hft_parser_latency_seconds_bucket{protocol=\"%s\",result=\"%s\",le=\"+Inf\"} %" PRIu64 "\n",
+                          PROTOCOL_LABELS[p], RESULT_LABELS[r], total);
+            append_format(out, "hft_parser_latency_seconds_sum{protocol=\"%s\",result=\"%s\"} %.9g\n",
+                          PROTOCOL_LABELS[p], RESULT_LABELS[r], ns_to_seconds(histogram.sum));
+            append_format(out, "hft_parser_latency_seconds_count{protocol=\"%s\",result=\"%s\"} %" PRIu64 "\n",
+                          PROTOCOL_LABELS[p], RESULT_LABELS[r], total);
+        }
+    }
+
+    // Finer-grained quantiles than the exported buckets allow, successful parses only
+    out += "# HELP hft_parser_latency_quantile_seconds Successful parse latency quantiles since start\n";
+    out += "# TYPE hft_parser_latency_quantile_seconds gauge\n";
+    for (size_t p = 0; p < PROTOCOL_COUNT; ++p) {
+        const HistogramSnapshot& histogram = snap.latency[p][static_cast<size_t>(ParseResult::SUCCESS)];
+        if (histogram.count == 0) {
+            continue;
+        }
+        for (double q : EXPORTED_QUANTILES) {
+            append_format(out, "hft_parser_latency_quantile_seconds{protocol=\"%s\",quantile=\"%g\"} %.9g\n",
+                          PROTOCOL_LABELS[p], q, ns_to_seconds(histogram.value_at_quantile(q)));
+        }
+    }
+}
+
+} // namespace ingestion
+} // namespace hft
@@ -0,0 +1,155 @@
+#pragma once
+
+#include "message_types.hpp"
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace hft {
+namespace ingestion {
+
+// Lock-free parse instrumentation.
+//
+// Every MessageParser owns one ParserMetrics shard and is its only writer,
+// so recording a message is a few relaxed load/store pairs on memory no
+// other thread writes: no locked instructions, no shared cache lines.
+// Scrapers read all shards concurrently through ParserMetricsRegistry; a
+// snapshot may trail the writers by a few messages but never tears a value.
+
+constexpr size_t PROTOCOL_COUNT = 3;      // Indexed by ProtocolType
+constexpr size_t PARSE_RESULT_COUNT = 5;  // Indexed by ParseResult
+
+// Counters with a single writer thread; concurrent readers are fine
+inline void single_writer_add(std::atomic<uint64_t>& counter, uint64_t delta) {
+    counter.store(counter.load(std::memory_order_relaxed) + delta, std::memory_order_relaxed);
+}
+
+// HDR-style log-linear histogram of nanosecond latencies. Values below 16
+// are exact; above that each power of two is split into 8 linear
+// sub-buckets, so a value is known to within 12.5%. Values of 2^32 ns
+// (~4.3 s) and up share the last bucket.
+class LatencyHistogram {
+public:
+    static constexpr uint32_t SUB_BUCKET_BITS = 3;
+    static constexpr uint32_t SUB_BUCKETS = 1u << SUB_BUCKET_BITS;
+    static constexpr uint32_t MAX_EXPONENT = 32;
+    static constexpr size_t BUCKET_COUNT = (MAX_EXPONENT - SUB_BUCKET_BITS + 1) * SUB_BUCKETS;
+
+    static size_t bucket_index(uint64_t value) {
+        if (value < SUB_BUCKETS) {
+            return static_cast<size_t>(value);
+        }
+        if (value >> MAX_EXPONENT) {
+            return BUCKET_COUNT - 1;
+        }
+        uint32_t shift = static_cast<uint32_t>(63 - __builtin_clzll(value)) - SUB_BUCKET_BITS;
+        return ((shift + 1) << SUB_BUCKET_BITS) + static_cast<size_t>((value >> shift) & (SUB_BUCKETS - 1));
+    }
+
+    // Exclusive upper bound of the values counted in a bucket
+    static uint64_t bucket_upper_bound(size_t index) {
+        if (index < SUB_BUCKETS) {
+            return index + 1;
+        }
+        uint32_t shift = static_cast<uint32_t>(index >> SUB_BUCKET_BITS) - 1;
+        return (SUB_BUCKETS + (index & (SUB_BUCKETS - 1)) + 1) << shift;
+    }
+
+    void record(uint64_t value_ns) {
+        single_writer_add(buckets_[bucket_index(value_ns)], 1);
+        single_writer_add(count_, 1);
+        single_writer_add(sum_, value_ns);
+    }
+
+    uint64_t count() const { return count_.load(std::memory_order_relaxed); }
+    uint64_t sum() const { return sum_.load(std::memory_order_relaxed); }
+    uint64_t bucket(size_t index) const { return buckets_[index].load(std::memory_order_relaxed); }
+
+private:
+    std::atomic<uint64_t> buckets_[BUCKET_COUNT] = {};
+    std::atomic<uint64_t> count_{0};
+    std::atomic<uint64_t> sum_{0};
+};
+
+// Plain copy of one or more histograms, for reporting
+struct HistogramSnapshot {
+    uint64_t count = 0;
+    uint64_t sum = 0;
+    uint64_t buckets[LatencyHistogram::BUCKET_COUNT] = {};
+
+    void merge(const LatencyHistogram& histogram);
+    void merge(const HistogramSnapshot& other);
+
+    // Sum of the buckets; can run ahead of count in a concurrent snapshot
+    uint64_t bucket_total() const;
+
+    // Number of values below bound; exact when bound is a power of two
+    uint64_t count_below(uint64_t bound) const;
+
+    // Upper bound of the bucket holding the q-th quantile (0 <= q <= 1),
+    // 0 when empty
+    uint64_t value_at_quantile(double q) const;
+};
+
+struct ParserMetricsSnapshot {
+    HistogramSnapshot latency[PROTOCOL_COUNT][PARSE_RESULT_COUNT];
+
+    void merge(const ParserMetricsSnapshot& other);
+    uint64_t count(ProtocolType protocol, ParseResult result) const;
+    uint64_t count(ParseResult result) const;  // Across protocols
+};
+
+// One parser's shard: a latency histogram per (protocol, result) pair, whose
+// counts double as the per-protocol and per-error-reason message counters
+class alignas(64) ParserMetrics {
+public:
+    ParserMetrics();   // Registers with ParserMetricsRegistry
+    ~ParserMetrics();  // Folds this shard's totals into the registry
+
+    ParserMetrics(const ParserMetrics&) = delete;
+    ParserMetrics& operator=(const ParserMetrics&) = delete;
+
+    void record(ProtocolType protocol, ParseResult result, uint64_t latency_ns) {
+        latency_[static_cast<size_t>(protocol)][static_cast<size_t>(result)].record(latency_ns);
+    }
+
+    uint64_t count(ProtocolType protocol, ParseResult result) const {
+        return latency_[static_cast<size_t>(protocol)][static_cast<size_t>(result)].count();
+    }
+
+    void snapshot_into(ParserMetricsSnapshot& snapshot) const;
+
+private:
+    LatencyHistogram latency_[PROTOCOL_COUNT][PARSE_RESULT_COUNT];
+};
+
+// Process-wide view over every live parser's shard. Only parser
+// construction, destruction and scrapes take the lock.
+class ParserMetricsRegistry {
+public:
+    static ParserMetricsRegistry& instance();
+
+    // Live shards plus everything recorded by parsers already destroyed, so
+    // counters never go backwards
+    ParserMetricsSnapshot snapshot() const;
+    size_t shard_count() const;
+
+    // Appends the Prometheus text exposition of snapshot()
+    void render_prometheus(std::string& out) const;
+
+private:
+    friend class ParserMetrics;
+
+    ParserMetricsRegistry() = default;
+    void attach(const ParserMetrics* shard);
+    void detach(const ParserMetrics* shard);
+
+    mutable std::mutex mutex_;
+    std::vector<const ParserMetrics*> shards_;
+    ParserMetricsSnapshot retired_;
+};
+
+} // namespace ingestion
+} // namespace hft
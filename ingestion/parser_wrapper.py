@@ -3,12 +3,14 @@ Python wrapper for the HFT C++ message parser.
 Provides high-level Python interface for parsing FIX and WebSocket messages.
 """
 
+import calendar
 import ctypes
+import datetime
 import os
 import sys
 from enum import IntEnum
 from dataclasses import dataclass
-from typing import Optional, Tuple, Union
+from typing import List, Optional, Sequence, Tuple, Union
 import json
 import time
 import warnings
@@ -16,6 +18,12 @@ import warnings
 # Add the current directory to the path for loading the shared library
 sys.path.append(os.path.dirname(os.path.abspath(__file__)))
 
+# Native pybind11 module (python_bindings.cpp), used for NumPy batch parsing
+try:
+    import hft_ingestion_py as _native
+except ImportError:
+    _native = None
+
 
 class Side(IntEnum):
     """Trading side enumeration matching C++ enum"""
@@ -51,15 +59,49 @@ class ParseResult(IntEnum):
     BUFFER_OVERFLOW = 4
 
 
+MESSAGE_FLAG_TWO_SIDED = 1 << 0  # MarketMessage::flags, see message_types.hpp
+
+
+class _COrderOrAsk(ctypes.Union):
+    _fields_ = [
+        ('order_id', ctypes.c_uint64),
+        ('ask_price', ctypes.c_double),
+    ]
+
+
+class _CMarketMessage(ctypes.Structure):
+    """Mirror of hft_market_message in c_api.h (64 bytes, one cache line)"""
+    _anonymous_ = ('_order_or_ask',)
+    _fields_ = [
+        ('timestamp', ctypes.c_uint64),
+        ('price', ctypes.c_double),
+        ('size', ctypes.c_int32),
+        ('symbol_id', ctypes.c_uint32),
+        ('side', ctypes.c_uint8),
+        ('type', ctypes.c_uint8),
+        ('symbol', ctypes.c_char * 16),
+        ('flags', ctypes.c_uint8),
+        ('padding', ctypes.c_uint8),
+        ('ask_size', ctypes.c_int32),
+        ('receive_timestamp', ctypes.c_uint64),
+        ('_order_or_ask', _COrderOrAsk),
+    ]
+
+
 @dataclass
 class MarketMessage:
     """Python representation of parsed market message"""
-    timestamp: int = 0              # Nanoseconds since epoch
+    timestamp: int = 0              # Event time, nanoseconds since epoch (FIX SendingTime when present)
     symbol: str = ""                # Trading symbol
     side: Side = Side.UNKNOWN       # BUY/SELL/UNKNOWN
     price: float = 0.0              # Price level
     size: int = 0                   # Quantity
     message_type: MessageType = MessageType.UNKNOWN  # Message classification
+    receive_timestamp: int = 0      # Local receive time, nanoseconds since epoch
+    order_id: int = 0               # Order the event refers to, 0 if none
+    ask_price: float = 0.0          # Two-sided quotes: price/size are the bid
+    ask_size: int = 0
+    two_sided: bool = False
     
     def to_dict(self) -> dict:
         """Convert to dictionary for JSON serialization"""
@@ -69,7 +111,11 @@ class MarketMessage:
             'side': self.side.name,
             'price': self.price,
             'size': self.size,
-            'type': self.message_type.name
+            'type': self.message_type.name,
+            'receive_timestamp': self.receive_timestamp,
+            'order_id': self.order_id,
+            'ask_price': self.ask_price,
+            'ask_size': self.ask_size
         }
     
     def __str__(self) -> str:
@@ -110,9 +156,21 @@ class MessageParser:
                 warnings.warn(f"Failed to load C++ library, falling back to Python implementation: {e}")
                 self._use_cpp = False
         
-        # Statistics
-        self.messages_parsed = 0
-        self.parse_errors = 0
+        # Statistics for the Python implementation; the C++ parser keeps its own
+        self._py_messages_parsed = 0
+        self._py_parse_errors = 0
+    
+    @property
+    def messages_parsed(self) -> int:
+        if self._use_cpp:
+            return self._lib.hft_parser_messages_parsed(self._parser_instance)
+        return self._py_messages_parsed
+    
+    @property
+    def parse_errors(self) -> int:
+        if self._use_cpp:
+            return self._lib.hft_parser_parse_errors(self._parser_instance)
+        return self._py_parse_errors
         
     def _load_library(self, library_path: Optional[str]):
         """Load the C++ shared library"""
@@ -141,16 +199,104 @@ class MessageParser:
             raise RuntimeError(f"Failed to load library {library_path}: {e}")
     
     def _setup_function_signatures(self):
-        """Setup function signatures for proper C++ interface"""
-        # This is a simplified interface - in practice, you'd use pybind11 or similar
-        # For now, we'll implement the parsing logic in Python as a fallback
-        pass
+        """Setup function signatures for the C ABI declared in c_api.h"""
+        lib = self._lib
+        lib.hft_parser_create.argtypes = []
+        lib.hft_parser_create.restype = ctypes.c_void_p
+        lib.hft_parser_destroy.argtypes = [ctypes.c_void_p]
+        lib.hft_parser_destroy.restype = None
+        lib.hft_parse_message.argtypes = [ctypes.c_void_p, ctypes.c_char_p, ctypes.c_size_t,
+                                          ctypes.POINTER(_CMarketMessage)]
+        lib.hft_parse_message.restype = ctypes.c_int32
+        lib.hft_parse_batch.argtypes = [ctypes.c_void_p, ctypes.c_char_p, ctypes.POINTER(ctypes.c_uint32),
+                                        ctypes.c_size_t, ctypes.POINTER(_CMarketMessage),
+                                        ctypes.POINTER(ctypes.c_int32)]
+        lib.hft_parse_batch.restype = ctypes.c_size_t
+        lib.hft_parser_messages_parsed.argtypes = [ctypes.c_void_p]
+        lib.hft_parser_messages_parsed.restype = ctypes.c_uint64
+        lib.hft_parser_parse_errors.argtypes = [ctypes.c_void_p]
+        lib.hft_parser_parse_errors.restype = ctypes.c_uint64
+        lib.hft_parser_reset_stats.argtypes = [ctypes.c_void_p]
+        lib.hft_parser_reset_stats.restype = None
+        lib.hft_parser_result_count.argtypes = [ctypes.c_void_p, ctypes.c_int32]
+        lib.hft_parser_result_count.restype = ctypes.c_uint64
+        lib.hft_parser_latency_quantile_ns.argtypes = [ctypes.c_void_p, ctypes.c_double]
+        lib.hft_parser_latency_quantile_ns.restype = ctypes.c_uint64
+        lib.hft_market_message_size.argtypes = []
+        lib.hft_market_message_size.restype = ctypes.c_size_t
+        lib.hft_fixed_point_prices.argtypes = []
+        lib.hft_fixed_point_prices.restype = ctypes.c_int32
+
+        # The structure above only matches floating-point price builds
+        if lib.hft_market_message_size() != ctypes.sizeof(_CMarketMessage):
+            raise RuntimeError("MarketMessage layout mismatch between library and wrapper")
+        if lib.hft_fixed_point_prices():
+            raise RuntimeError("Library was built with HFT_FIXED_POINT_PRICES, unsupported by this wrapper")
     
     def _create_parser_instance(self):
         """Create C++ parser instance"""
-        # Placeholder for C++ instance creation
-        # In practice, this would create a C++ MessageParser object
-        self._parser_instance = True
+        self._parser_instance = self._lib.hft_parser_create()
+        if not self._parser_instance:
+            raise RuntimeError("hft_parser_create failed")
+
+    def __del__(self):
+        if self._parser_instance and self._lib is not None:
+            self._lib.hft_parser_destroy(self._parser_instance)
+            self._parser_instance = None
+
+    @staticmethod
+    def _from_c_message(raw: _CMarketMessage) -> MarketMessage:
+        """Convert the C layout to the Python dataclass"""
+        two_sided = bool(raw.flags & MESSAGE_FLAG_TWO_SIDED)
+        return MarketMessage(
+            timestamp=raw.timestamp,
+            symbol=raw.symbol.decode('utf-8', errors='replace'),
+            side=Side(raw.side),
+            price=raw.price,
+            size=raw.size,
+            message_type=MessageType(raw.type),
+            receive_timestamp=raw.receive_timestamp,
+            order_id=0 if two_sided else raw.order_id,
+            ask_price=raw.ask_price if two_sided else 0.0,
+            ask_size=raw.ask_size,
+            two_sided=two_sided,
+        )
+
+    def parse_batch(self, frames: Sequence[Union[str, bytes]]) -> List[Tuple[ParseResult, Optional[MarketMessage]]]:
+        """
+        Parse many complete messages with a single call into the C++ library.
+
+        Args:
+            frames: Raw messages (strings or bytes), one complete message each
+
+        Returns:
+            List of (parse_result, parsed_message), one per input frame
+        """
+        if not self._use_cpp:
+            return [self.parse_message(frame) for frame in frames]
+
+        encoded = [f.encode('utf-8') if isinstance(f, str) else bytes(f) for f in frames]
+        count = len(encoded)
+        if count == 0:
+            return []
+
+        offsets = (ctypes.c_uint32 * (count + 1))()
+        position = 0
+        for i, frame in enumerate(encoded):
+            offsets[i] = position
+            position += len(frame)
+        offsets[count] = position
+
+        messages = (_CMarketMessage * count)()
+        results = (ctypes.c_int32 * count)()
+        self._lib.hft_parse_batch(self._parser_instance, b''.join(encoded), offsets, count, messages, results)
+
+        output = []
+        for i in range(count):
+            result = ParseResult(results[i])
+            message = self._from_c_message(messages[i]) if result == ParseResult.SUCCESS else None
+            output.append((result, message))
+        return output
     
     def parse_message(self, data: Union[str, bytes]) -> Tuple[ParseResult, Optional[MarketMessage]]:
         """
@@ -164,12 +310,19 @@ class MessageParser:
         """
         if isinstance(data, str):
             data = data.encode('utf-8')
+
+        if self._use_cpp:
+            raw = _CMarketMessage()
+            result = ParseResult(self._lib.hft_parse_message(self._parser_instance, data, len(data),
+                                                             ctypes.byref(raw)))
+            message = self._from_c_message(raw) if result == ParseResult.SUCCESS else None
+            return result, message
         
         # Detect protocol
         protocol = self._detect_protocol(data)
         
         if protocol == ProtocolType.UNKNOWN:
-            self.parse_errors += 1
+            self._py_parse_errors += 1
             return ParseResult.UNKNOWN_PROTOCOL, None
         
         # Parse based on protocol (using Python implementation for now)
@@ -182,17 +335,19 @@ class MessageParser:
                 return ParseResult.UNKNOWN_PROTOCOL, None
             
             if result == ParseResult.SUCCESS:
-                self.messages_parsed += 1
-                # Set timestamp if not provided
-                if message and message.timestamp == 0:
-                    message.timestamp = self._get_current_timestamp_ns()
+                self._py_messages_parsed += 1
+                # Stamp receive time; it doubles as event time when the message has none
+                if message:
+                    message.receive_timestamp = self._get_current_timestamp_ns()
+                    if message.timestamp == 0:
+                        message.timestamp = message.receive_timestamp
             else:
-                self.parse_errors += 1
+                self._py_parse_errors += 1
                 
             return result, message
             
         except Exception as e:
-            self.parse_errors += 1
+            self._py_parse_errors += 1
             print(f"Parse error: {e}")
             return ParseResult.INVALID_FORMAT, None
     
@@ -263,6 +418,19 @@ class MessageParser:
                     message.message_type = MessageType.MODIFY_ORDER
                 elif msgtype == '8':
                     message.message_type = MessageType.TRADE
+                elif msgtype == 'S':
+                    message.message_type = MessageType.QUOTE
+            
+            # OrigClOrdID names the order a cancel/replace acts on, else ClOrdID
+            order_id = fields.get('41') or fields.get('11')
+            if order_id:
+                message.order_id = self._order_id_from(order_id)
+            
+            if '52' in fields:  # SendingTime
+                timestamp = self._parse_utc_timestamp(fields['52'])
+                if timestamp is None:
+                    return ParseResult.INVALID_FORMAT, None
+                message.timestamp = timestamp
             
             return ParseResult.SUCCESS, message
             
@@ -294,11 +462,12 @@ class MessageParser:
                 message.price = float(json_data['price'])
                 message.size = int(json_data.get('size', 0))
             elif 'bid' in json_data and 'ask' in json_data:
-                # Use mid-price for quotes
-                bid = float(json_data['bid'])
-                ask = float(json_data['ask'])
-                message.price = (bid + ask) / 2.0
-                message.size = int(json_data.get('bid_size', 0)) + int(json_data.get('ask_size', 0))
+                # Two-sided quote: price/size carry the bid
+                message.price = float(json_data['bid'])
+                message.size = int(json_data.get('bid_size', 0))
+                message.ask_price = float(json_data['ask'])
+                message.ask_size = int(json_data.get('ask_size', 0))
+                message.two_sided = True
                 message.message_type = MessageType.QUOTE
             
             # Set message type
@@ -309,35 +478,82 @@ class MessageParser:
                 message.message_type = MessageType.QUOTE
             elif msg_type == 'order':
                 message.message_type = MessageType.NEW_ORDER
+            elif msg_type == 'cancel':
+                message.message_type = MessageType.CANCEL_ORDER
+            elif msg_type == 'modify':
+                message.message_type = MessageType.MODIFY_ORDER
             elif message.message_type == MessageType.UNKNOWN:
                 message.message_type = MessageType.MARKET_DATA
             
-            # Extract timestamp if provided
+            # Event time: integer epoch nanoseconds, or a FIX-style UTCTimestamp string
             if 'timestamp' in json_data:
-                message.timestamp = int(json_data['timestamp'])
+                timestamp = json_data['timestamp']
+                if isinstance(timestamp, str) and not timestamp.isdigit():
+                    timestamp = self._parse_utc_timestamp(timestamp)
+                    if timestamp is None:
+                        return ParseResult.INVALID_FORMAT, None
+                message.timestamp = int(timestamp)
+            
+            if not message.two_sided and json_data.get('order_id') is not None:
+                message.order_id = self._order_id_from(str(json_data['order_id']))
             
             return ParseResult.SUCCESS, message
             
         except (json.JSONDecodeError, ValueError, KeyError):
             return ParseResult.INVALID_FORMAT, None
     
+    @staticmethod
+    def _order_id_from(value: str) -> int:
+        """Same mapping as MessageParser::order_id_from: decimal ids as-is, others hashed"""
+        hash_bit = 1 << 63
+        if value.isdigit() and value.isascii() and int(value) < hash_bit:
+            return int(value)
+        digest = 14695981039346656037
+        for byte in value.encode('utf-8'):
+            digest = ((digest ^ byte) * 1099511628211) & 0xFFFFFFFFFFFFFFFF
+        return digest | hash_bit
+    
+    @staticmethod
+    def _parse_utc_timestamp(value: str) -> Optional[int]:
+        """FIX UTCTimestamp (YYYYMMDD-HH:MM:SS[.fraction]) to epoch nanoseconds"""
+        base, point, fraction = value.partition('.')
+        if len(base) != 17 or (point and not (fraction.isdigit() and len(fraction) <= 9)):
+            return None
+        try:
+            moment = datetime.datetime.strptime(base[:-2] + min(base[-2:], '59'), '%Y%m%d-%H:%M:%S')
+        except ValueError:
+            return None
+        if moment.year < 1970:
+            return None
+        seconds = calendar.timegm(moment.utctimetuple()) + (base[-2:] == '60')
+        return seconds * 1_000_000_000 + int(fraction.ljust(9, '0') or 0)
+    
     def _get_current_timestamp_ns(self) -> int:
         """Get current timestamp in nanoseconds"""
         return int(time.time() * 1_000_000_000)
     
     def get_statistics(self) -> dict:
         """Get parser statistics"""
-        return {
+        stats = {
             'messages_parsed': self.messages_parsed,
             'parse_errors': self.parse_errors,
             'error_rate': self.parse_errors / max(1, self.messages_parsed + self.parse_errors),
             'implementation': 'C++' if self._use_cpp else 'Python'
         }
+        if self._use_cpp:
+            # Lifetime counts from the C++ instrumentation; not cleared by reset_statistics()
+            stats['results'] = {result.name: self._lib.hft_parser_result_count(self._parser_instance, result)
+                                for result in ParseResult}
+            stats['latency_ns'] = {name: self._lib.hft_parser_latency_quantile_ns(self._parser_instance, q)
+                                   for name, q in (('p50', 0.5), ('p99', 0.99), ('p999', 0.999))}
+        return stats
     
     def reset_statistics(self):
         """Reset parser statistics"""
-        self.messages_parsed = 0
-        self.parse_errors = 0
+        if self._use_cpp:
+            self._lib.hft_parser_reset_stats(self._parser_instance)
+        self._py_messages_parsed = 0
+        self._py_parse_errors = 0
 
 
 # Convenience functions for easy usage
@@ -353,6 +569,37 @@ def parse_websocket_message(data: Union[str, bytes]) -> Tuple[ParseResult, Optio
     return parser.parse_message(data)
 
 
+def parse_capture(raw: bytes, framing: str = 'fix', parser=None):
+    """
+    Parse a raw FIX or JSON capture into a NumPy structured array.
+
+    Uses the native module, so no Python object is created per message.
+
+    Args:
+        raw: Raw capture bytes (FIX stream, or JSON objects)
+        framing: 'fix', 'json' or 'length_prefixed'
+        parser: Optional hft_ingestion_py.Parser to reuse (keeps symbol ids stable)
+
+    Returns:
+        Tuple of (messages, results): a MESSAGE_DTYPE array and an int32 array
+        of ParseResult values, one entry per frame
+    """
+    if _native is None:
+        raise RuntimeError("hft_ingestion_py native module is not available")
+    import numpy as np
+
+    modes = {
+        'fix': _native.FramingMode.FIX,
+        'json': _native.FramingMode.JSON_BRACES,
+        'length_prefixed': _native.FramingMode.LENGTH_PREFIXED,
+    }
+    data, offsets = _native.pack_frames(raw, modes[framing])
+    messages = _native.empty_messages(len(offsets) - 1)
+    results = np.empty(len(messages), dtype=np.int32)
+    (parser or _native.Parser()).parse_batch(data, offsets, messages, results)
+    return messages, results
+
+
 def create_sample_messages():
     """Create sample messages for testing"""
     fix_message = "8=FIX.4.4\x019=178\x0135=D\x0149=SENDER\x0156=TARGET\x0155=AAPL\x0154=1\x0144=150.25\x0138=100\x01"
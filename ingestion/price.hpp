@@ -0,0 +1,66 @@
+#pragma once
+
+#include <cmath>
+#include <cstdint>
+
+namespace hft {
+namespace ingestion {
+
+// Price representation, selected at compile time with HFT_FIXED_POINT_PRICES.
+//
+// Tick sizes are expressed in raw fixed-point units of 10^-PRICE_DECIMALS,
+// e.g. a 0.01 tick is 1000000 units. In fixed-point builds a Price is an
+// integer count of the instrument's ticks, so order books can index price
+// levels directly; otherwise it is the decimal price as a double.
+constexpr uint32_t PRICE_DECIMALS = 8;
+constexpr int64_t PRICE_SCALE = 100000000;
+constexpr int64_t DEFAULT_TICK_UNITS = 1;  // One raw unit, i.e. lossless
+
+#ifdef HFT_FIXED_POINT_PRICES
+using Price = int64_t;
+constexpr bool FIXED_POINT_PRICES = true;
+#else
+using Price = double;
+constexpr bool FIXED_POINT_PRICES = false;
+#endif
+
+// Rounds a raw fixed-point value to the nearest tick
+inline int64_t raw_to_ticks(int64_t raw, int64_t tick_units) {
+    int64_t ticks = raw / tick_units;
+    int64_t remainder = raw % tick_units;
+    if (remainder * 2 >= tick_units) ticks++;
+    else if (remainder * 2 <= -tick_units) ticks--;
+    return ticks;
+}
+
+// Integer tick index of a price for the given tick size
+inline int64_t price_to_ticks(Price price, int64_t tick_units) {
+#ifdef HFT_FIXED_POINT_PRICES
+    (void)tick_units;
+    return price;
+#else
+    return std::llround(price * static_cast<double>(PRICE_SCALE) / static_cast<double>(tick_units));
+#endif
+}
+
+inline Price ticks_to_price(int64_t ticks, int64_t tick_units) {
+#ifdef HFT_FIXED_POINT_PRICES
+    (void)tick_units;
+    return ticks;
+#else
+    return static_cast<double>(ticks) * static_cast<double>(tick_units) / static_cast<double>(PRICE_SCALE);
+#endif
+}
+
+// Decimal value of a price, for display and analytics
+inline double price_to_double(Price price, int64_t tick_units) {
+#ifdef HFT_FIXED_POINT_PRICES
+    return static_cast<double>(price) * static_cast<double>(tick_units) / static_cast<double>(PRICE_SCALE);
+#else
+    (void)tick_units;
+    return price;
+#endif
+}
+
+} // namespace ingestion
+} // namespace hft
@@ -0,0 +1,84 @@
+#include "probes.hpp"
+#include <algorithm>
+
+namespace hft {
+namespace ingestion {
+
+namespace {
+
+const char* const STAGE_NAMES[PROBE_STAGE_COUNT] = {
+    "parse_message", "detect_protocol", "queue_push", "queue_pop", "book_add",
+    "book_cancel", "book_modify", "book_execute", "match_submit"
+};
+
+} // namespace
+
+const char* probe_stage_name(ProbeStage stage) {
+    size_t index = static_cast<size_t>(stage);
+    return index < PROBE_STAGE_COUNT ? STAGE_NAMES[index] : "unknown";
+}
+
+ProbeShard::ProbeShard() {
+    ProbeRegistry::instance().attach(this);
+}
+
+ProbeShard::~ProbeShard() {
+    ProbeRegistry::instance().detach(this);
+}
+
+void record_probe(ProbeStage stage, uint64_t cycles) {
+    static thread_local ProbeShard shard;
+    shard.cycles[static_cast<size_t>(stage)].record(cycles);
+}
+
+ProbeRegistry& ProbeRegistry::instance() {
+    // Never destroyed, so thread-exit folds still have somewhere to go
+    static ProbeRegistry* registry = new ProbeRegistry();
+    return *registry;
+}
+
+void ProbeRegistry::attach(const ProbeShard* shard) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    shards_.push_back(shard);
+}
+
+void ProbeRegistry::detach(const ProbeShard* shard) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (size_t s = 0; s < PROBE_STAGE_COUNT; ++s) {
+        retired_.cycles[s].merge(shard->cycles[s]);
+    }
+    shards_.erase(std::remove(shards_.begin(), shards_.end(), shard), shards_.end());
+}
+
+ProbeSnapshot ProbeRegistry::snapshot() const {
+    ProbeSnapshot snapshot;
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (size_t s = 0; s < PROBE_STAGE_COUNT; ++s) {
+        snapshot.cycles[s].merge(retired_.cycles[s]);
+        for (const ProbeShard* shard : shards_) {
+            snapshot.cycles[s].merge(shard->cycles[s]);
+        }
+    }
+    return snapshot;
+}
+
+#if defined(HFT_PROBES_ITT)
+__itt_domain* probe_itt_domain() {
+    static __itt_domain* domain = __itt_domain_create("hft");
+    return domain;
+}
+
+__itt_string_handle* probe_itt_name(ProbeStage stage) {
+    static __itt_string_handle* const* names = [] {
+        static __itt_string_handle* handles[PROBE_STAGE_COUNT];
+        for (size_t s = 0; s < PROBE_STAGE_COUNT; ++s) {
+            handles[s] = __itt_string_handle_create(STAGE_NAMES[s]);
+        }
+        return handles;
+    }();
+    return names[static_cast<size_t>(stage)];
+}
+#endif
+
+} // namespace ingestion
+} // namespace hft
@@ -0,0 +1,141 @@
+#pragma once
+
+#include "parser_metrics.hpp"
+#include "tsc_clock.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+#if defined(HFT_PROBES_USDT)
+#include <sys/sdt.h>
+#elif defined(HFT_PROBES_ITT)
+#include <ittnotify.h>
+#endif
+
+namespace hft {
+namespace ingestion {
+
+// Hot-path stages wrapped by HFT_PROBE_SCOPE. The value is the USDT probe
+// argument, so the profiling/ scripts key on it: append, never renumber.
+enum class ProbeStage : uint8_t {
+    PARSE_MESSAGE = 0,  // MessageParser::parse_message, detection included
+    DETECT_PROTOCOL,
+    QUEUE_PUSH,         // SpscQueue push, push_n
+    QUEUE_POP,          // SpscQueue pop, pop_n
+    BOOK_ADD,           // lob::OrderBook operations
+    BOOK_CANCEL,
+    BOOK_MODIFY,
+    BOOK_EXECUTE,
+    MATCH_SUBMIT        // lob::MatchingEngine::submit, book operations included
+};
+
+constexpr size_t PROBE_STAGE_COUNT = 9;
+
+// Lower-case name, as in the ITT task names and the stage reports
+const char* probe_stage_name(ProbeStage stage);
+
+// Whether this build times every probed stage (HFT_PROFILING)
+constexpr bool probe_timing_enabled() {
+#if defined(HFT_PROFILING)
+    return true;
+#else
+    return false;
+#endif
+}
+
+// Counter ticks (TscClock::read_counter) per call of each stage. A stage's
+// time includes the stages nested in it.
+struct ProbeSnapshot {
+    HistogramSnapshot cycles[PROBE_STAGE_COUNT];
+
+    const HistogramSnapshot& stage(ProbeStage stage) const { return cycles[static_cast<size_t>(stage)]; }
+};
+
+// One thread's stage histograms; only that thread writes them
+struct ProbeShard {
+    LatencyHistogram cycles[PROBE_STAGE_COUNT];
+
+    ProbeShard();   // Registers with ProbeRegistry
+    ~ProbeShard();  // Folds into the registry at thread exit
+};
+
+// Process-wide view over every thread's shard, in the manner of
+// ParserMetricsRegistry. Empty unless built with HFT_PROFILING.
+class ProbeRegistry {
+public:
+    static ProbeRegistry& instance();
+
+    ProbeSnapshot snapshot() const;
+
+private:
+    friend struct ProbeShard;
+
+    ProbeRegistry() = default;
+    void attach(const ProbeShard* shard);
+    void detach(const ProbeShard* shard);
+
+    mutable std::mutex mutex_;
+    std::vector<const ProbeShard*> shards_;
+    ProbeSnapshot retired_;
+};
+
+// Records one call of stage into the calling thread's shard
+void record_probe(ProbeStage stage, uint64_t cycles);
+
+#if defined(HFT_PROBES_ITT)
+__itt_domain* probe_itt_domain();
+__itt_string_handle* probe_itt_name(ProbeStage stage);
+#endif
+
+// Marks one call of a stage: hft:stage_begin/stage_end USDT probes or an
+// ITT task when built with HFT_PROBES, and a timing into the calling
+// thread's ProbeShard when built with HFT_PROFILING. Use HFT_PROBE_SCOPE,
+// which compiles to nothing in builds with neither.
+class ProbeScope {
+public:
+    explicit ProbeScope(ProbeStage stage) : stage_(stage) {
+#if defined(HFT_PROBES_USDT)
+        DTRACE_PROBE1(hft, stage_begin, static_cast<int>(stage));
+#elif defined(HFT_PROBES_ITT)
+        __itt_task_begin(probe_itt_domain(), __itt_null, __itt_null, probe_itt_name(stage));
+#endif
+#if defined(HFT_PROFILING)
+        start_ = TscClock::read_counter();
+#endif
+    }
+
+    ~ProbeScope() {
+#if defined(HFT_PROFILING)
+        record_probe(stage_, TscClock::read_counter() - start_);
+#endif
+#if defined(HFT_PROBES_USDT)
+        DTRACE_PROBE1(hft, stage_end, static_cast<int>(stage_));
+#elif defined(HFT_PROBES_ITT)
+        __itt_task_end(probe_itt_domain());
+#endif
+    }
+
+    ProbeScope(const ProbeScope&) = delete;
+    ProbeScope& operator=(const ProbeScope&) = delete;
+
+private:
+    ProbeStage stage_;
+#if defined(HFT_PROFILING)
+    uint64_t start_;
+#endif
+};
+
+} // namespace ingestion
+} // namespace hft
+
+#define HFT_PROBE_CONCAT_(a, b) a##b
+#define HFT_PROBE_CONCAT(a, b) HFT_PROBE_CONCAT_(a, b)
+
+// Probes the rest of the enclosing scope as ProbeStage::stage
+#if defined(HFT_PROFILING) || defined(HFT_PROBES_USDT) || defined(HFT_PROBES_ITT)
+#define HFT_PROBE_SCOPE(stage) \
+    ::hft::ingestion::ProbeScope HFT_PROBE_CONCAT(hft_probe_scope_, __LINE__)(::hft::ingestion::ProbeStage::stage)
+#else
+#define HFT_PROBE_SCOPE(stage) static_cast<void>(0)
+#endif
@@ -0,0 +1,247 @@
+// Native Python module (pybind11) for bulk parsing from backtests.
+//
+// Batches are written straight into preallocated NumPy structured arrays whose
+// dtype mirrors MarketMessage byte for byte, so no Python object is created
+// per message and the GIL is released for the whole batch.
+//
+//   import numpy as np, hft_ingestion_py as hi
+//   parser = hi.Parser()
+//   data, offsets = hi.pack_frames(raw, hi.FramingMode.FIX)
+//   out = np.empty(len(offsets) - 1, dtype=hi.MESSAGE_DTYPE)
+//   results = np.empty(len(out), dtype=np.int32)
+//   parsed = parser.parse_batch(data, offsets, out, results)
+
+#include "message_parser.hpp"
+#include "parser_metrics.hpp"
+#include "stream_framer.hpp"
+#include "symbol_registry.hpp"
+#include <pybind11/numpy.h>
+#include <pybind11/pybind11.h>
+#include <pybind11/stl.h>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace py = pybind11;
+using namespace hft::ingestion;
+
+namespace {
+
+constexpr size_t BATCH_CHUNK = 256;
+
+// Structured dtype laid out exactly like MarketMessage (64-byte records)
+py::dtype message_dtype() {
+    py::list names, formats, offsets;
+    auto field = [&](const char* name, const char* format, size_t offset) {
+        names.append(name);
+        formats.append(format);
+        offsets.append(offset);
+    };
+    field("timestamp", "<u8", offsetof(MarketMessage, timestamp));
+    field("price", FIXED_POINT_PRICES ? "<i8" : "<f8", offsetof(MarketMessage, price));
+    field("size", "<i4", offsetof(MarketMessage, size));
+    field("symbol_id", "<u4", offsetof(MarketMessage, symbol_id));
+    field("side", "u1", offsetof(MarketMessage, side));
+    field("type", "u1", offsetof(MarketMessage, type));
+    field("symbol", "S16", offsetof(MarketMessage, symbol));
+    field("flags", "u1", offsetof(MarketMessage, flags));
+    field("ask_size", "<i4", offsetof(MarketMessage, ask_size));
+    field("receive_timestamp", "<u8", offsetof(MarketMessage, receive_timestamp));
+    // Overlapping views of one slot; which is meaningful depends on flags
+    field("order_id", "<u8", offsetof(MarketMessage, order_id));
+    field("ask_price", FIXED_POINT_PRICES ? "<i8" : "<f8", offsetof(MarketMessage, ask_price));
+    return py::dtype(names, formats, offsets, static_cast<py::ssize_t>(sizeof(MarketMessage)));
+}
+
+void require_contiguous(const py::buffer_info& info, const char* what) {
+    if (info.ndim != 1 || (info.shape[0] > 1 && info.strides[0] != info.itemsize)) {
+        throw std::invalid_argument(std::string(what) + " must be a contiguous 1-D array");
+    }
+}
+
+// Parser plus an owned symbol registry so symbol_id columns are meaningful
+class PyParser {
+public:
+    explicit PyParser(size_t symbol_capacity)
+        : registry_(symbol_capacity),
+          scratch_messages_(BATCH_CHUNK),
+          scratch_results_(BATCH_CHUNK) {
+        parser_.set_symbol_registry(&registry_);
+    }
+
+    // Frame i is data[offsets[i], offsets[i + 1]). Fills out[i] and results[i]
+    // and returns the number of successful parses.
+    size_t parse_batch(py::buffer data, py::array_t<uint32_t, py::array::c_style> offsets,
+                       py::array out, py::array_t<int32_t, py::array::c_style> results) {
+        py::buffer_info data_info = data.request();
+        py::buffer_info out_info = out.request(true);
+        py::buffer_info results_info = results.request(true);
+        require_contiguous(out_info, "out");
+
+        if (out_info.itemsize != static_cast<py::ssize_t>(sizeof(MarketMessage))) {
+            throw std::invalid_argument("out must use hft_ingestion_py.MESSAGE_DTYPE");
+        }
+        if (offsets.size() == 0) {
+            return 0;
+        }
+        size_t count = static_cast<size_t>(offsets.size()) - 1;
+        if (static_cast<size_t>(out_info.shape[0]) < count || static_cast<size_t>(results.size()) < count) {
+            throw std::invalid_argument("out and results need at least len(offsets) - 1 entries");
+        }
+
+        const char* buffer = static_cast<const char*>(data_info.ptr);
+        size_t buffer_length = static_cast<size_t>(data_info.size * data_info.itemsize);
+        const uint32_t* offset_ptr = offsets.data();
+        char* out_ptr = static_cast<char*>(out_info.ptr);
+        int32_t* result_ptr = static_cast<int32_t*>(results_info.ptr);
+
+        size_t parsed = 0;
+        bool offsets_ok = true;
+        {
+            py::gil_scoped_release release;
+            for (size_t i = 0; i < count && offsets_ok; ++i) {
+                offsets_ok = offset_ptr[i] <= offset_ptr[i + 1];
+            }
+            offsets_ok = offsets_ok && offset_ptr[count] <= buffer_length;
+
+            // NumPy only guarantees 16-byte alignment, so parse into aligned
+            // scratch records and copy them out chunk by chunk
+            for (size_t begin = 0; offsets_ok && begin < count; begin += BATCH_CHUNK) {
+                size_t n = count - begin < BATCH_CHUNK ? count - begin : BATCH_CHUNK;
+                parsed += parser_.parse_batch(buffer, offset_ptr + begin, n,
+                                              scratch_messages_.data(), scratch_results_.data());
+                std::memcpy(out_ptr + begin * sizeof(MarketMessage), scratch_messages_.data(),
+                            n * sizeof(MarketMessage));
+                for (size_t i = 0; i < n; ++i) {
+                    result_ptr[begin + i] = static_cast<int32_t>(scratch_results_[i]);
+                }
+            }
+        }
+        if (!offsets_ok) {
+            throw std::invalid_argument("offsets must be non-decreasing and within the buffer");
+        }
+        return parsed;
+    }
+
+    // Convenience for interactive use; prefer parse_batch for volume
+    py::tuple parse_message(py::bytes data) {
+        std::string raw = data;
+        MarketMessage message;
+        ParseContext context;
+        ParseResult result = parser_.parse_message(raw.data(), raw.size(), message, context);
+        py::array record(message_dtype(), 1);
+        std::memcpy(record.mutable_data(), &message, sizeof(message));
+        return py::make_tuple(static_cast<int32_t>(result), record);
+    }
+
+    SymbolRegistry& registry() { return registry_; }
+    const MessageParser& parser() const { return parser_; }
+
+private:
+    SymbolRegistry registry_;
+    MessageParser parser_;
+    std::vector<MarketMessage> scratch_messages_;
+    std::vector<ParseResult> scratch_results_;
+};
+
+// Splits a raw capture into back-to-back frames in parse_batch() layout,
+// dropping garbage, newlines, length prefixes and corrupt frames in between
+py::tuple pack_frames(py::buffer data, FramingMode mode, bool verify_checksum) {
+    py::buffer_info info = data.request();
+    const char* buffer = static_cast<const char*>(info.ptr);
+    size_t length = static_cast<size_t>(info.size * info.itemsize);
+
+    std::string packed;
+    std::vector<uint32_t> offsets{0};
+    bool too_large = false;
+    {
+        py::gil_scoped_release release;
+        packed.reserve(length);
+        size_t pos = 0;
+        while (pos < length) {
+            size_t frame_offset = 0, frame_length = 0, consumed = 0;
+            ParseResult result = StreamFramer::find_frame(mode, buffer + pos, length - pos, frame_offset,
+                                                          frame_length, consumed, verify_checksum);
+            if (result == ParseResult::SUCCESS) {
+                if (packed.size() + frame_length > UINT32_MAX) {
+                    too_large = true;
+                    break;
+                }
+                packed.append(buffer + pos + frame_offset, frame_length);
+                offsets.push_back(static_cast<uint32_t>(packed.size()));
+            } else if (consumed == 0) {
+                break;  // Trailing partial frame
+            }
+            pos += consumed;
+        }
+    }
+    if (too_large) {
+        throw std::invalid_argument("frames exceed the 4 GiB offsets range; split the capture first");
+    }
+    py::array_t<uint32_t> offset_array(static_cast<py::ssize_t>(offsets.size()), offsets.data());
+    return py::make_tuple(py::bytes(packed), offset_array);
+}
+
+} // namespace
+
+PYBIND11_MODULE(hft_ingestion_py, m) {
+    m.doc() = "Native batch parser for FIX and WebSocket JSON market data";
+
+    py::enum_<ParseResult>(m, "ParseResult")
+        .value("SUCCESS", ParseResult::SUCCESS)
+        .value("INVALID_FORMAT", ParseResult::INVALID_FORMAT)
+        .value("INCOMPLETE_MESSAGE", ParseResult::INCOMPLETE_MESSAGE)
+        .value("UNKNOWN_PROTOCOL", ParseResult::UNKNOWN_PROTOCOL)
+        .value("BUFFER_OVERFLOW", ParseResult::BUFFER_OVERFLOW);
+
+    py::enum_<Side>(m, "Side")
+        .value("UNKNOWN", Side::UNKNOWN)
+        .value("BUY", Side::BUY)
+        .value("SELL", Side::SELL);
+
+    py::enum_<MessageType>(m, "MessageType")
+        .value("UNKNOWN", MessageType::UNKNOWN)
+        .value("NEW_ORDER", MessageType::NEW_ORDER)
+        .value("CANCEL_ORDER", MessageType::CANCEL_ORDER)
+        .value("MODIFY_ORDER", MessageType::MODIFY_ORDER)
+        .value("TRADE", MessageType::TRADE)
+        .value("QUOTE", MessageType::QUOTE)
+        .value("MARKET_DATA", MessageType::MARKET_DATA);
+
+    py::enum_<FramingMode>(m, "FramingMode")
+        .value("FIX", FramingMode::FIX)
+        .value("JSON_BRACES", FramingMode::JSON_BRACES)
+        .value("LENGTH_PREFIXED", FramingMode::LENGTH_PREFIXED);
+
+    m.attr("MESSAGE_DTYPE") = message_dtype();
+    m.attr("FIXED_POINT_PRICES") = FIXED_POINT_PRICES;
+
+    m.def("empty_messages", [](size_t count) { return py::array(message_dtype(), static_cast<py::ssize_t>(count)); },
+          py::arg("count"), "Uninitialised MESSAGE_DTYPE array for parse_batch output");
+
+    m.def("pack_frames", &pack_frames, py::arg("data"), py::arg("mode"), py::arg("verify_checksum") = true,
+          "Frame a raw capture, returning (packed bytes, uint32 offsets with len = frames + 1)");
+
+    py::class_<PyParser>(m, "Parser")
+        .def(py::init<size_t>(), py::arg("symbol_capacity") = SymbolRegistry::DEFAULT_CAPACITY)
+        .def("parse_batch", &PyParser::parse_batch, py::arg("data"), py::arg("offsets"), py::arg("out"),
+             py::arg("results"), "Parse frames data[offsets[i]:offsets[i+1]] into out; returns the success count")
+        .def("parse_message", &PyParser::parse_message, py::arg("data"),
+             "Parse one message, returning (result, 1-element MESSAGE_DTYPE array)")
+        .def("intern", [](PyParser& self, const std::string& symbol) { return self.registry().intern(symbol); })
+        .def("symbol", [](PyParser& self, uint32_t id) { return std::string(self.registry().symbol(id)); })
+        .def("load_universe_file",
+             [](PyParser& self, const std::string& path) { return self.registry().load_universe_file(path); })
+        .def_property_readonly("symbol_count", [](PyParser& self) { return self.registry().size(); })
+        .def_property_readonly("messages_parsed", [](const PyParser& self) { return self.parser().messages_parsed(); })
+        .def_property_readonly("parse_errors", [](const PyParser& self) { return self.parser().parse_errors(); });
+
+    m.def("prometheus_metrics", []() {
+        std::string out;
+        ParserMetricsRegistry::instance().render_prometheus(out);
+        return out;
+    }, "Every parser's metrics in the Prometheus text format, e.g. for a python-prometheus-client bridge");
+}
@@ -0,0 +1,343 @@
+#include "replay_engine.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <queue>
+#include <string_view>
+#include <thread>
+
+namespace hft {
+namespace ingestion {
+
+namespace {
+
+constexpr char FIX_DELIMITER = '\x01';
+constexpr std::string_view FIX_BEGIN_PREFIX = "8=FIX";
+constexpr size_t LENGTH_PREFIX_SIZE = 4;
+constexpr size_t ESTIMATED_MESSAGE_BYTES = 128;  // For reserving per-chunk output
+constexpr int64_t PACING_SLEEP_MARGIN_NS = 100000;  // Spin the final 100us for accuracy
+
+int64_t steady_now_ns() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// First FIX BeginString at or after pos that starts a message
+size_t next_fix_boundary(const char* data, size_t length, size_t pos) {
+    std::string_view text(data, length);
+    while (true) {
+        pos = text.find(FIX_BEGIN_PREFIX, pos);
+        if (pos == std::string_view::npos) {
+            return length;
+        }
+        if (pos == 0 || data[pos - 1] == FIX_DELIMITER || data[pos - 1] == '\n') {
+            return pos;
+        }
+        pos++;
+    }
+}
+
+// Start of the first line at or after pos whose first non-blank byte opens an object
+size_t next_json_boundary(const char* data, size_t length, size_t pos) {
+    while (pos < length) {
+        const void* newline = std::memchr(data + pos, '\n', length - pos);
+        if (!newline) {
+            return length;
+        }
+        size_t line = static_cast<const char*>(newline) - data + 1;
+        size_t first = line;
+        while (first < length && (data[first] == ' ' || data[first] == '\t' || data[first] == '\r')) {
+            first++;
+        }
+        if (first < length && data[first] == '{') {
+            return line;
+        }
+        pos = line;
+    }
+    return length;
+}
+
+} // namespace
+
+ReplayEngine::ReplayEngine(const ReplayConfig& config)
+    : config_(config),
+      stop_requested_(false),
+      max_chunks_ahead_(0),
+      shutting_down_(false),
+      pacing_started_(false),
+      pacing_first_timestamp_(0),
+      pacing_start_ns_(0) {
+    if (config_.worker_threads == 0) {
+        unsigned cores = std::thread::hardware_concurrency();
+        config_.worker_threads = cores > 1 ? cores - 1 : 1;
+    }
+    if (config_.chunk_size == 0) {
+        config_.chunk_size = ReplayConfig().chunk_size;
+    }
+    if (config_.speed <= 0.0) {
+        config_.speed = 1.0;
+    }
+    max_chunks_ahead_ = config_.max_chunks_ahead ? config_.max_chunks_ahead : 2 * config_.worker_threads;
+}
+
+ReplayEngine::~ReplayEngine() = default;
+
+bool ReplayEngine::add_file(const std::string& path) {
+    auto source = std::make_unique<Source>();
+    if (!source->file.open(path, AccessPattern::SEQUENTIAL)) {
+        return false;
+    }
+    source->boundaries = split_chunks(config_.framing, source->file.data(), source->file.size(), config_.chunk_size);
+    source->chunks.resize(source->boundaries.size() - 1);
+    for (auto& chunk : source->chunks) {
+        chunk = std::make_unique<ParsedChunk>();
+    }
+    sources_.push_back(std::move(source));
+    return true;
+}
+
+std::vector<size_t> ReplayEngine::split_chunks(FramingMode mode, const char* data, size_t length,
+                                               size_t chunk_size) {
+    std::vector<size_t> boundaries{0};
+    if (chunk_size == 0) {
+        chunk_size = length;
+    }
+
+    if (mode == FramingMode::LENGTH_PREFIXED) {
+        // No way to resynchronise mid-stream, so hop from prefix to prefix
+        size_t pos = 0;
+        size_t next_cut = chunk_size;
+        while (length - pos >= LENGTH_PREFIX_SIZE) {
+            const unsigned char* prefix = reinterpret_cast<const unsigned char*>(data + pos);
+            size_t payload = (static_cast<size_t>(prefix[0]) << 24) | (static_cast<size_t>(prefix[1]) << 16) |
+                             (static_cast<size_t>(prefix[2]) << 8) | static_cast<size_t>(prefix[3]);
+            if (payload > length - pos - LENGTH_PREFIX_SIZE) {
+                break;
+            }
+            pos += LENGTH_PREFIX_SIZE + payload;
+            if (pos >= next_cut && pos < length) {
+                boundaries.push_back(pos);
+                next_cut = pos + chunk_size;
+            }
+        }
+    } else {
+        for (size_t nominal = chunk_size; nominal < length; nominal = boundaries.back() + chunk_size) {
+            size_t cut = mode == FramingMode::FIX ? next_fix_boundary(data, length, nominal)
+                                                  : next_json_boundary(data, length, nominal);
+            if (cut >= length) {
+                break;
+            }
+            boundaries.push_back(cut);
+        }
+    }
+
+    boundaries.push_back(length);
+    return boundaries;
+}
+
+ReplayStats ReplayEngine::run(const ReplayHandler& handler) {
+    ReplayStats stats;
+    int64_t start_ns = steady_now_ns();
+    stop_requested_.store(false, std::memory_order_relaxed);
+    shutting_down_ = false;
+    pacing_started_ = false;
+    for (const auto& source : sources_) {
+        stats.bytes += source->file.size();
+        stats.chunks += source->chunk_count();
+    }
+
+    std::vector<std::thread> workers;
+    for (size_t i = 0; i < config_.worker_threads; ++i) {
+        workers.emplace_back(&ReplayEngine::worker_loop, this);
+    }
+
+    // Min-heap of (head timestamp, source index); each pop emits the winning
+    // source's run of messages up to the runner-up's timestamp
+    using HeapEntry = std::pair<uint64_t, size_t>;
+    std::priority_queue<HeapEntry, std::vector<HeapEntry>, std::greater<HeapEntry>> heap;
+    std::vector<Cursor> cursors(sources_.size());
+    for (size_t i = 0; i < sources_.size(); ++i) {
+        if (advance(i, cursors[i], stats)) {
+            heap.emplace(cursors[i].chunk->messages[cursors[i].index].timestamp, i);
+        }
+    }
+
+    bool stopped = false;
+    while (!heap.empty() && !stopped) {
+        size_t source_index = heap.top().second;
+        heap.pop();
+        uint64_t limit = heap.empty() ? UINT64_MAX : heap.top().first;
+        Cursor& cursor = cursors[source_index];
+
+        bool has_more = true;
+        while (true) {
+            const MarketMessage& message = cursor.chunk->messages[cursor.index];
+            // Ties go to the lower source index to keep the merge deterministic
+            if (message.timestamp > limit ||
+                (message.timestamp == limit && !heap.empty() && source_index > heap.top().second)) {
+                break;
+            }
+            if (config_.pacing == ReplayPacing::WALL_CLOCK) {
+                pace(message.timestamp);
+            }
+            stats.messages++;
+            if (!handler(message) || stop_requested_.load(std::memory_order_relaxed)) {
+                stopped = true;
+                break;
+            }
+            cursor.index++;
+            if (!advance(source_index, cursor, stats)) {
+                has_more = false;
+                break;
+            }
+        }
+        if (has_more && !stopped) {
+            heap.emplace(cursor.chunk->messages[cursor.index].timestamp, source_index);
+        }
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        shutting_down_ = true;
+    }
+    work_available_.notify_all();
+    for (auto& worker : workers) {
+        worker.join();
+    }
+
+    // Reset so the same files can be replayed again
+    for (auto& source : sources_) {
+        source->next_to_parse = 0;
+        source->next_to_consume = 0;
+        for (auto& chunk : source->chunks) {
+            chunk = std::make_unique<ParsedChunk>();
+        }
+    }
+
+    stats.elapsed_seconds = static_cast<double>(steady_now_ns() - start_ns) / 1e9;
+    return stats;
+}
+
+bool ReplayEngine::advance(size_t source_index, Cursor& cursor, ReplayStats& stats) {
+    Source& source = *sources_[source_index];
+    while (!cursor.chunk || cursor.index == cursor.chunk->messages.size()) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        if (cursor.chunk) {
+            // Release the drained chunk and let workers refill the window
+            stats.parse_errors += cursor.chunk->parse_errors;
+            source.chunks[source.next_to_consume].reset();
+            source.next_to_consume++;
+            cursor.chunk = nullptr;
+            work_available_.notify_all();
+        }
+        if (source.next_to_consume == source.chunk_count()) {
+            return false;
+        }
+        ParsedChunk* next = source.chunks[source.next_to_consume].get();
+        chunk_ready_.wait(lock, [&] { return next->ready; });
+        cursor.chunk = next;
+        cursor.index = 0;
+    }
+    return true;
+}
+
+bool ReplayEngine::pick_task(size_t& source_index, size_t& chunk_index) {
+    // Prefer the file whose parsed window is smallest, so a file that the
+    // merge is draining fastest never starves
+    size_t best_ahead = SIZE_MAX;
+    for (size_t i = 0; i < sources_.size(); ++i) {
+        Source& source = *sources_[i];
+        size_t ahead = source.next_to_parse - source.next_to_consume;
+        if (source.next_to_parse < source.chunk_count() && ahead < max_chunks_ahead_ && ahead < best_ahead) {
+            best_ahead = ahead;
+            source_index = i;
+        }
+    }
+    if (best_ahead == SIZE_MAX) {
+        return false;
+    }
+    chunk_index = sources_[source_index]->next_to_parse++;
+    return true;
+}
+
+void ReplayEngine::worker_loop() {
+    MessageParser parser;
+    parser.set_symbol_registry(config_.symbol_registry);
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (true) {
+        size_t source_index = 0, chunk_index = 0;
+        work_available_.wait(lock, [&] { return shutting_down_ || pick_task(source_index, chunk_index); });
+        if (shutting_down_) {
+            return;
+        }
+        Source& source = *sources_[source_index];
+        ParsedChunk* chunk = source.chunks[chunk_index].get();
+
+        lock.unlock();
+        parse_chunk(parser, source, chunk_index, *chunk);
+        lock.lock();
+
+        chunk->ready = true;
+        chunk_ready_.notify_all();
+    }
+}
+
+void ReplayEngine::parse_chunk(MessageParser& parser, const Source& source, size_t chunk_index,
+                               ParsedChunk& chunk) {
+    const char* data = source.file.data() + source.boundaries[chunk_index];
+    size_t length = source.boundaries[chunk_index + 1] - source.boundaries[chunk_index];
+    chunk.messages.reserve(length / ESTIMATED_MESSAGE_BYTES + 1);
+
+    MarketMessage message;
+    ParseContext context;
+    size_t pos = 0;
+    while (pos < length && !stop_requested_.load(std::memory_order_relaxed)) {
+        size_t frame_offset = 0, frame_length = 0, consumed = 0;
+        ParseResult framed = StreamFramer::find_frame(config_.framing, data + pos, length - pos, frame_offset,
+                                                      frame_length, consumed, config_.verify_checksum);
+        if (framed == ParseResult::SUCCESS) {
+            context.reset();
+            if (parser.parse_message(data + pos + frame_offset, frame_length, message, context) ==
+                ParseResult::SUCCESS) {
+                chunk.messages.push_back(message);
+            } else {
+                chunk.parse_errors++;
+            }
+        } else if (framed == ParseResult::INVALID_FORMAT) {
+            chunk.parse_errors++;
+        } else if (consumed == 0) {
+            // Truncated trailing message; whitespace-only tails are not errors
+            while (pos < length && (data[pos] == ' ' || data[pos] == '\t' || data[pos] == '\r' || data[pos] == '\n')) {
+                pos++;
+            }
+            chunk.parse_errors += pos < length;
+            break;
+        }
+        pos += consumed;
+    }
+}
+
+void ReplayEngine::pace(uint64_t timestamp) {
+    if (!pacing_started_) {
+        pacing_started_ = true;
+        pacing_first_timestamp_ = timestamp;
+        pacing_start_ns_ = steady_now_ns();
+        return;
+    }
+    if (timestamp <= pacing_first_timestamp_) {
+        return;
+    }
+    int64_t offset = static_cast<int64_t>(static_cast<double>(timestamp - pacing_first_timestamp_) / config_.speed);
+    int64_t target = pacing_start_ns_ + offset;
+    int64_t remaining = target - steady_now_ns();
+    if (remaining > PACING_SLEEP_MARGIN_NS) {
+        std::this_thread::sleep_for(std::chrono::nanoseconds(remaining - PACING_SLEEP_MARGIN_NS));
+    }
+    while (steady_now_ns() < target) {
+        // Spin for the last stretch; sleep granularity is far coarser
+    }
+}
+
+} // namespace ingestion
+} // namespace hft
@@ -0,0 +1,121 @@
+#pragma once
+
+#include "mapped_file.hpp"
+#include "message_parser.hpp"
+#include "stream_framer.hpp"
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace hft {
+namespace ingestion {
+
+enum class ReplayPacing : uint8_t {
+    AS_FAST_AS_POSSIBLE = 1,
+    WALL_CLOCK = 2  // Reproduce the recorded inter-message gaps, scaled by speed
+};
+
+struct ReplayConfig {
+    FramingMode framing = FramingMode::FIX;
+    size_t worker_threads = 0;          // 0 = one per core, minus the consumer
+    size_t chunk_size = 8 << 20;        // Nominal bytes per parse task
+    size_t max_chunks_ahead = 0;        // Parsed-but-unconsumed chunks per file, 0 = 2 x workers
+    ReplayPacing pacing = ReplayPacing::AS_FAST_AS_POSSIBLE;
+    double speed = 1.0;                 // WALL_CLOCK only: 2.0 replays twice as fast
+    bool verify_checksum = true;
+    SymbolRegistry* symbol_registry = nullptr;  // Shared by all workers, not owned
+};
+
+struct ReplayStats {
+    uint64_t messages = 0;
+    uint64_t parse_errors = 0;  // Corrupt frames and messages that failed to parse
+    uint64_t bytes = 0;
+    uint64_t chunks = 0;
+    double elapsed_seconds = 0.0;
+};
+
+// Return false to stop the replay early
+using ReplayHandler = std::function<bool(const MarketMessage&)>;
+
+// Replays historical capture files through the parser.
+//
+// Each file is mmap'd with MADV_SEQUENTIAL and split into chunks on message
+// boundaries. Worker threads, each with its own MessageParser, parse chunks
+// ahead of the consumer in parallel. The calling thread then
+// delivers messages in order: file order within a file, and a k-way merge
+// on timestamp across files (ties go to the file added first). Only a
+// bounded window of parsed chunks per file is held in memory.
+//
+// FIX captures may be split anywhere a BeginString follows SOH or a
+// newline; JSON captures are expected one object per line; length-prefixed
+// captures are walked prefix by prefix to find chunk boundaries.
+class ReplayEngine {
+public:
+    explicit ReplayEngine(const ReplayConfig& config = ReplayConfig());
+    ~ReplayEngine();
+
+    ReplayEngine(const ReplayEngine&) = delete;
+    ReplayEngine& operator=(const ReplayEngine&) = delete;
+
+    // Adds a capture to the next run(); several files are merged by timestamp
+    bool add_file(const std::string& path);
+
+    // Blocks until every file is replayed, the handler returns false, or stop()
+    ReplayStats run(const ReplayHandler& handler);
+
+    // Safe from the handler or any other thread
+    void stop() { stop_requested_.store(true, std::memory_order_relaxed); }
+
+    // Chunk start offsets on message boundaries, always beginning with 0 and
+    // ending with length
+    static std::vector<size_t> split_chunks(FramingMode mode, const char* data, size_t length, size_t chunk_size);
+
+private:
+    struct ParsedChunk {
+        std::vector<MarketMessage> messages;
+        uint64_t parse_errors = 0;
+        bool ready = false;
+    };
+
+    struct Source {
+        MappedFile file;
+        std::vector<size_t> boundaries;
+        std::vector<std::unique_ptr<ParsedChunk>> chunks;
+        size_t next_to_parse = 0;
+        size_t next_to_consume = 0;
+        size_t chunk_count() const { return chunks.size(); }
+    };
+
+    // Consumer-side position in a source's current chunk
+    struct Cursor {
+        ParsedChunk* chunk = nullptr;
+        size_t index = 0;
+    };
+
+    void worker_loop();
+    void parse_chunk(MessageParser& parser, const Source& source, size_t chunk_index, ParsedChunk& chunk);
+    bool advance(size_t source_index, Cursor& cursor, ReplayStats& stats);
+    bool pick_task(size_t& source_index, size_t& chunk_index);
+    void pace(uint64_t timestamp);
+
+    ReplayConfig config_;
+    std::vector<std::unique_ptr<Source>> sources_;
+    std::atomic<bool> stop_requested_;
+
+    std::mutex mutex_;
+    std::condition_variable work_available_;
+    std::condition_variable chunk_ready_;
+    size_t max_chunks_ahead_;
+    bool shutting_down_;
+
+    bool pacing_started_;
+    uint64_t pacing_first_timestamp_;
+    int64_t pacing_start_ns_;
+};
+
+} // namespace ingestion
+} // namespace hft
@@ -0,0 +1,238 @@
+#include "simd_scan.hpp"
+
+#if defined(__x86_64__) || defined(__i386__)
+#define HFT_SIMD_X86 1
+#include <immintrin.h>
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#define HFT_SIMD_NEON 1
+#include <arm_neon.h>
+#endif
+
+namespace hft {
+namespace ingestion {
+namespace simd {
+
+namespace {
+
+// Scalar fallback
+
+uint64_t match_mask_scalar(const char* block, char c) {
+    uint64_t mask = 0;
+    for (size_t i = 0; i < BLOCK_SIZE; ++i) {
+        mask |= static_cast<uint64_t>(block[i] == c) << i;
+    }
+    return mask;
+}
+
+void json_masks_scalar(const char* block, JsonBlockMasks& masks) {
+    uint64_t quote = 0, backslash = 0, structural = 0;
+    for (size_t i = 0; i < BLOCK_SIZE; ++i) {
+        char c = block[i];
+        quote |= static_cast<uint64_t>(c == '"') << i;
+        backslash |= static_cast<uint64_t>(c == '\\') << i;
+        bool is_structural = c == ',' || c == ':' || c == '{' || c == '}' || c == '[' || c == ']';
+        structural |= static_cast<uint64_t>(is_structural) << i;
+    }
+    masks.quote = quote;
+    masks.backslash = backslash;
+    masks.structural = structural;
+}
+
+#if defined(HFT_SIMD_X86)
+
+// SSE4.2: four 16-byte lanes per block
+
+__attribute__((target("sse4.2")))
+inline uint64_t movemask_sse(__m128i a, __m128i b, __m128i c, __m128i d) {
+    uint64_t m0 = static_cast<uint32_t>(_mm_movemask_epi8(a));
+    uint64_t m1 = static_cast<uint32_t>(_mm_movemask_epi8(b));
+    uint64_t m2 = static_cast<uint32_t>(_mm_movemask_epi8(c));
+    uint64_t m3 = static_cast<uint32_t>(_mm_movemask_epi8(d));
+    return m0 | (m1 << 16) | (m2 << 32) | (m3 << 48);
+}
+
+__attribute__((target("sse4.2")))
+uint64_t match_mask_sse42(const char* block, char c) {
+    const __m128i needle = _mm_set1_epi8(c);
+    const __m128i* p = reinterpret_cast<const __m128i*>(block);
+    return movemask_sse(_mm_cmpeq_epi8(_mm_loadu_si128(p), needle),
+                        _mm_cmpeq_epi8(_mm_loadu_si128(p + 1), needle),
+                        _mm_cmpeq_epi8(_mm_loadu_si128(p + 2), needle),
+                        _mm_cmpeq_epi8(_mm_loadu_si128(p + 3), needle));
+}
+
+__attribute__((target("sse4.2")))
+inline __m128i structural_sse(__m128i v) {
+    // '[' and ']' differ from '{' and '}' only in bit 0x20, so fold them together
+    __m128i folded = _mm_or_si128(v, _mm_set1_epi8(0x20));  // '[' -> '{', ']' -> '}'
+    __m128i m = _mm_or_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8(',')), _mm_cmpeq_epi8(v, _mm_set1_epi8(':')));
+    m = _mm_or_si128(m, _mm_cmpeq_epi8(folded, _mm_set1_epi8('{')));
+    return _mm_or_si128(m, _mm_cmpeq_epi8(folded, _mm_set1_epi8('}')));
+}
+
+__attribute__((target("sse4.2")))
+void json_masks_sse42(const char* block, JsonBlockMasks& masks) {
+    const __m128i* p = reinterpret_cast<const __m128i*>(block);
+    __m128i v0 = _mm_loadu_si128(p);
+    __m128i v1 = _mm_loadu_si128(p + 1);
+    __m128i v2 = _mm_loadu_si128(p + 2);
+    __m128i v3 = _mm_loadu_si128(p + 3);
+
+    const __m128i quote = _mm_set1_epi8('"');
+    const __m128i backslash = _mm_set1_epi8('\\');
+    masks.quote = movemask_sse(_mm_cmpeq_epi8(v0, quote), _mm_cmpeq_epi8(v1, quote),
+                               _mm_cmpeq_epi8(v2, quote), _mm_cmpeq_epi8(v3, quote));
+    masks.backslash = movemask_sse(_mm_cmpeq_epi8(v0, backslash), _mm_cmpeq_epi8(v1, backslash),
+                                   _mm_cmpeq_epi8(v2, backslash), _mm_cmpeq_epi8(v3, backslash));
+    masks.structural = movemask_sse(structural_sse(v0), structural_sse(v1),
+                                    structural_sse(v2), structural_sse(v3));
+}
+
+// AVX2: two 32-byte lanes per block
+
+__attribute__((target("avx2")))
+inline uint64_t movemask_avx2(__m256i lo, __m256i hi) {
+    uint64_t m0 = static_cast<uint32_t>(_mm256_movemask_epi8(lo));
+    uint64_t m1 = static_cast<uint32_t>(_mm256_movemask_epi8(hi));
+    return m0 | (m1 << 32);
+}
+
+__attribute__((target("avx2")))
+uint64_t match_mask_avx2(const char* block, char c) {
+    const __m256i needle = _mm256_set1_epi8(c);
+    const __m256i* p = reinterpret_cast<const __m256i*>(block);
+    return movemask_avx2(_mm256_cmpeq_epi8(_mm256_loadu_si256(p), needle),
+                         _mm256_cmpeq_epi8(_mm256_loadu_si256(p + 1), needle));
+}
+
+__attribute__((target("avx2")))
+inline __m256i structural_avx2(__m256i v) {
+    __m256i folded = _mm256_or_si256(v, _mm256_set1_epi8(0x20));  // '[' -> '{', ']' -> '}'
+    __m256i m = _mm256_or_si256(_mm256_cmpeq_epi8(v, _mm256_set1_epi8(',')),
+                                _mm256_cmpeq_epi8(v, _mm256_set1_epi8(':')));
+    m = _mm256_or_si256(m, _mm256_cmpeq_epi8(folded, _mm256_set1_epi8('{')));
+    return _mm256_or_si256(m, _mm256_cmpeq_epi8(folded, _mm256_set1_epi8('}')));
+}
+
+__attribute__((target("avx2")))
+void json_masks_avx2(const char* block, JsonBlockMasks& masks) {
+    const __m256i* p = reinterpret_cast<const __m256i*>(block);
+    __m256i lo = _mm256_loadu_si256(p);
+    __m256i hi = _mm256_loadu_si256(p + 1);
+
+    const __m256i quote = _mm256_set1_epi8('"');
+    const __m256i backslash = _mm256_set1_epi8('\\');
+    masks.quote = movemask_avx2(_mm256_cmpeq_epi8(lo, quote), _mm256_cmpeq_epi8(hi, quote));
+    masks.backslash = movemask_avx2(_mm256_cmpeq_epi8(lo, backslash), _mm256_cmpeq_epi8(hi, backslash));
+    masks.structural = movemask_avx2(structural_avx2(lo), structural_avx2(hi));
+}
+
+#endif // HFT_SIMD_X86
+
+#if defined(HFT_SIMD_NEON)
+
+// NEON: four 16-byte lanes per block, narrowed to a 64-bit mask
+
+inline uint64_t movemask_neon(uint8x16_t a, uint8x16_t b, uint8x16_t c, uint8x16_t d) {
+    const uint8x16_t bit_mask = {0x01, 0x02, 0x4, 0x8, 0x10, 0x20, 0x40, 0x80,
+                                 0x01, 0x02, 0x4, 0x8, 0x10, 0x20, 0x40, 0x80};
+    uint8x16_t sum0 = vpaddq_u8(vandq_u8(a, bit_mask), vandq_u8(b, bit_mask));
+    uint8x16_t sum1 = vpaddq_u8(vandq_u8(c, bit_mask), vandq_u8(d, bit_mask));
+    sum0 = vpaddq_u8(sum0, sum1);
+    sum0 = vpaddq_u8(sum0, sum0);
+    return vgetq_lane_u64(vreinterpretq_u64_u8(sum0), 0);
+}
+
+uint64_t match_mask_neon(const char* block, char c) {
+    const uint8_t* p = reinterpret_cast<const uint8_t*>(block);
+    const uint8x16_t needle = vdupq_n_u8(static_cast<uint8_t>(c));
+    return movemask_neon(vceqq_u8(vld1q_u8(p), needle), vceqq_u8(vld1q_u8(p + 16), needle),
+                         vceqq_u8(vld1q_u8(p + 32), needle), vceqq_u8(vld1q_u8(p + 48), needle));
+}
+
+inline uint8x16_t structural_neon(uint8x16_t v) {
+    uint8x16_t folded = vorrq_u8(v, vdupq_n_u8(0x20));  // '[' -> '{', ']' -> '}'
+    uint8x16_t m = vorrq_u8(vceqq_u8(v, vdupq_n_u8(',')), vceqq_u8(v, vdupq_n_u8(':')));
+    m = vorrq_u8(m, vceqq_u8(folded, vdupq_n_u8('{')));
+    return vorrq_u8(m, vceqq_u8(folded, vdupq_n_u8('}')));
+}
+
+void json_masks_neon(const char* block, JsonBlockMasks& masks) {
+    const uint8_t* p = reinterpret_cast<const uint8_t*>(block);
+    uint8x16_t v0 = vld1q_u8(p);
+    uint8x16_t v1 = vld1q_u8(p + 16);
+    uint8x16_t v2 = vld1q_u8(p + 32);
+    uint8x16_t v3 = vld1q_u8(p + 48);
+
+    const uint8x16_t quote = vdupq_n_u8('"');
+    const uint8x16_t backslash = vdupq_n_u8('\\');
+    masks.quote = movemask_neon(vceqq_u8(v0, quote), vceqq_u8(v1, quote),
+                                vceqq_u8(v2, quote), vceqq_u8(v3, quote));
+    masks.backslash = movemask_neon(vceqq_u8(v0, backslash), vceqq_u8(v1, backslash),
+                                    vceqq_u8(v2, backslash), vceqq_u8(v3, backslash));
+    masks.structural = movemask_neon(structural_neon(v0), structural_neon(v1),
+                                     structural_neon(v2), structural_neon(v3));
+}
+
+#endif // HFT_SIMD_NEON
+
+Kernels make_kernels(Isa isa) {
+    switch (isa) {
+#if defined(HFT_SIMD_X86)
+        case Isa::AVX2:
+            return Kernels{match_mask_avx2, json_masks_avx2, Isa::AVX2};
+        case Isa::SSE42:
+            return Kernels{match_mask_sse42, json_masks_sse42, Isa::SSE42};
+#endif
+#if defined(HFT_SIMD_NEON)
+        case Isa::NEON:
+            return Kernels{match_mask_neon, json_masks_neon, Isa::NEON};
+#endif
+        default:
+            return Kernels{match_mask_scalar, json_masks_scalar, Isa::SCALAR};
+    }
+}
+
+Kernels& active_kernels() {
+    static Kernels active = make_kernels(detected_isa());
+    return active;
+}
+
+} // namespace
+
+Isa detected_isa() {
+#if defined(HFT_SIMD_X86)
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) return Isa::AVX2;
+    if (__builtin_cpu_supports("sse4.2")) return Isa::SSE42;
+    return Isa::SCALAR;
+#elif defined(HFT_SIMD_NEON)
+    return Isa::NEON;
+#else
+    return Isa::SCALAR;
+#endif
+}
+
+const Kernels& kernels() {
+    return active_kernels();
+}
+
+void set_isa(Isa isa) {
+    Isa best = detected_isa();
+    bool supported = isa == Isa::SCALAR || isa == best ||
+                     (isa == Isa::SSE42 && best == Isa::AVX2);
+    active_kernels() = make_kernels(supported ? isa : best);
+}
+
+const char* isa_name(Isa isa) {
+    switch (isa) {
+        case Isa::SSE42: return "sse4.2";
+        case Isa::AVX2: return "avx2";
+        case Isa::NEON: return "neon";
+        default: return "scalar";
+    }
+}
+
+} // namespace simd
+} // namespace ingestion
+} // namespace hft
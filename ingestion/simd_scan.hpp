@@ -0,0 +1,173 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+namespace hft {
+namespace ingestion {
+namespace simd {
+
+// Instruction set used by the block classification kernels
+enum class Isa : uint8_t {
+    SCALAR = 0,
+    SSE42 = 1,
+    AVX2 = 2,
+    NEON = 3
+};
+
+// Input is classified in 64-byte blocks, one bit per byte
+constexpr size_t BLOCK_SIZE = 64;
+
+struct JsonBlockMasks {
+    uint64_t quote;       // '"'
+    uint64_t backslash;   // '\\'
+    uint64_t structural;  // , : { } [ ]
+};
+
+// Block kernels; callers guarantee BLOCK_SIZE readable bytes
+struct Kernels {
+    uint64_t (*match_mask)(const char* block, char c);
+    void (*json_masks)(const char* block, JsonBlockMasks& masks);
+    Isa isa;
+};
+
+// Kernels selected at startup from CPUID (or compile-time target on ARM)
+const Kernels& kernels();
+
+// Best instruction set supported by this CPU
+Isa detected_isa();
+
+// Force a specific instruction set, clamped to what the CPU supports.
+// Intended for tests and benchmarks; not thread-safe against concurrent scanning.
+void set_isa(Isa isa);
+
+const char* isa_name(Isa isa);
+
+// Yields the positions of a single delimiter character in increasing order
+class CharScanner {
+public:
+    CharScanner(const char* data, size_t length, char c)
+        : data_(data), length_(length), c_(c), base_(0), next_block_(0), mask_(0),
+          match_mask_(kernels().match_mask) {}
+
+    // Position of the next match, or length when exhausted
+    size_t next() {
+        while (mask_ == 0) {
+            if (next_block_ >= length_) {
+                return length_;
+            }
+            base_ = next_block_;
+            next_block_ += BLOCK_SIZE;
+            mask_ = load_block();
+        }
+        size_t pos = base_ + static_cast<size_t>(__builtin_ctzll(mask_));
+        mask_ &= mask_ - 1;
+        return pos;
+    }
+
+private:
+    uint64_t load_block() const {
+        size_t remaining = length_ - base_;
+        if (remaining >= BLOCK_SIZE) {
+            return match_mask_(data_ + base_, c_);
+        }
+        char tail[BLOCK_SIZE] = {};
+        std::memcpy(tail, data_ + base_, remaining);
+        return match_mask_(tail, c_) & ((1ULL << remaining) - 1);
+    }
+
+    const char* data_;
+    size_t length_;
+    char c_;
+    size_t base_;
+    size_t next_block_;
+    uint64_t mask_;
+    uint64_t (*match_mask_)(const char*, char);
+};
+
+// Yields the positions of JSON structural characters that lie outside
+// string literals, plus every unescaped quote, in increasing order
+// (simdjson stage 1 style: escapes and string regions are resolved with
+// carry-propagating bit arithmetic across blocks).
+class JsonStructuralScanner {
+public:
+    JsonStructuralScanner(const char* data, size_t length)
+        : data_(data), length_(length), base_(0), next_block_(0), mask_(0),
+          prev_escaped_(0), prev_in_string_(0), json_masks_(kernels().json_masks) {}
+
+    // Position of the next structural character, or length when exhausted
+    size_t next() {
+        while (mask_ == 0) {
+            if (next_block_ >= length_) {
+                return length_;
+            }
+            base_ = next_block_;
+            next_block_ += BLOCK_SIZE;
+            mask_ = load_block();
+        }
+        size_t pos = base_ + static_cast<size_t>(__builtin_ctzll(mask_));
+        mask_ &= mask_ - 1;
+        return pos;
+    }
+
+private:
+    static constexpr uint64_t ODD_BITS = 0xAAAAAAAAAAAAAAAAULL;
+
+    static uint64_t prefix_xor(uint64_t bits) {
+        bits ^= bits << 1;
+        bits ^= bits << 2;
+        bits ^= bits << 4;
+        bits ^= bits << 8;
+        bits ^= bits << 16;
+        bits ^= bits << 32;
+        return bits;
+    }
+
+    // Bits of characters preceded by an odd-length run of backslashes
+    uint64_t escaped_bits(uint64_t backslash) {
+        if (backslash == 0) {
+            uint64_t escaped = prev_escaped_;
+            prev_escaped_ = 0;
+            return escaped;
+        }
+        uint64_t potential_escape = backslash & ~prev_escaped_;
+        uint64_t maybe_escaped_and_odd = (potential_escape << 1) | ODD_BITS;
+        uint64_t escape_and_terminal = (maybe_escaped_and_odd - potential_escape) ^ ODD_BITS;
+        uint64_t escaped = escape_and_terminal ^ (backslash | prev_escaped_);
+        prev_escaped_ = (escape_and_terminal & backslash) >> 63;
+        return escaped;
+    }
+
+    uint64_t load_block() {
+        JsonBlockMasks masks;
+        size_t remaining = length_ - base_;
+        uint64_t valid = ~0ULL;
+        if (remaining >= BLOCK_SIZE) {
+            json_masks_(data_ + base_, masks);
+        } else {
+            char tail[BLOCK_SIZE] = {};
+            std::memcpy(tail, data_ + base_, remaining);
+            json_masks_(tail, masks);
+            valid = (1ULL << remaining) - 1;
+        }
+
+        uint64_t quote = masks.quote & ~escaped_bits(masks.backslash);
+        uint64_t in_string = prefix_xor(quote) ^ prev_in_string_;
+        prev_in_string_ = static_cast<uint64_t>(static_cast<int64_t>(in_string) >> 63);
+        return ((masks.structural & ~in_string) | quote) & valid;
+    }
+
+    const char* data_;
+    size_t length_;
+    size_t base_;
+    size_t next_block_;
+    uint64_t mask_;
+    uint64_t prev_escaped_;
+    uint64_t prev_in_string_;
+    void (*json_masks_)(const char*, JsonBlockMasks&);
+};
+
+} // namespace simd
+} // namespace ingestion
+} // namespace hft
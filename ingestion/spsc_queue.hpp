@@ -0,0 +1,304 @@
+#pragma once
+
+#include "memory_arena.hpp"
+#include "probes.hpp"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <type_traits>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif
+
+#ifdef __linux__
+#include <climits>
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#else
+#include <thread>
+#endif
+
+namespace hft {
+namespace ingestion {
+
+constexpr size_t CACHE_LINE_SIZE = 64;
+
+// How the blocking push_wait()/pop_wait() calls wait for the other side
+enum class WaitStrategy : uint8_t {
+    BUSY_SPIN = 1,  // Spin with a pause hint; lowest latency, burns a core
+    FUTEX = 2       // Spin briefly, then sleep in the kernel until woken
+};
+
+inline void cpu_relax() {
+#if defined(__x86_64__) || defined(__i386__)
+    _mm_pause();
+#elif defined(__aarch64__)
+    asm volatile("yield");
+#endif
+}
+
+namespace detail {
+
+inline void futex_wait(std::atomic<uint32_t>& word, uint32_t expected) {
+#ifdef __linux__
+    syscall(SYS_futex, reinterpret_cast<uint32_t*>(&word), FUTEX_WAIT_PRIVATE, expected, nullptr, nullptr, 0);
+#else
+    if (word.load(std::memory_order_acquire) == expected) {
+        std::this_thread::yield();
+    }
+#endif
+}
+
+inline void futex_wake(std::atomic<uint32_t>& word) {
+#ifdef __linux__
+    syscall(SYS_futex, reinterpret_cast<uint32_t*>(&word), FUTEX_WAKE_PRIVATE, INT_MAX, nullptr, nullptr, 0);
+#else
+    (void)word;
+#endif
+}
+
+} // namespace detail
+
+// Bounded lock-free single-producer/single-consumer ring, used to hand parsed
+// MarketMessages from a feed-handler thread to a book thread.
+//
+// The slot array is allocated once at construction (capacity rounded up to a
+// power of two) and items are copied in and out, so the hot path never
+// allocates. Head and tail live on separate cache lines, and each side keeps
+// a cached copy of the other's index so it only touches the shared line when
+// the ring looks full (producer) or empty (consumer).
+//
+// Exactly one thread may call the push functions and one thread the pop
+// functions. With WaitStrategy::FUTEX every push/pop pays one full fence so
+// a sleeping peer is never missed; BUSY_SPIN queues have no such cost.
+template <typename T, WaitStrategy Wait = WaitStrategy::BUSY_SPIN>
+class SpscQueue {
+    static_assert(std::is_trivially_copyable<T>::value, "SpscQueue items are copied as plain bytes");
+
+public:
+    static constexpr uint32_t SPIN_LIMIT = 1024;  // Pause iterations before a futex sleep
+
+    // Slots come from the arena when one is given (it must outlive the
+    // queue), e.g. the producer thread's prefaulted huge-page arena
+    explicit SpscQueue(size_t capacity, MemoryArena* arena = nullptr)
+        : capacity_(round_up_pow2(capacity)),
+          mask_(capacity_ - 1),
+          arena_(arena),
+          slots_(allocate_slots()) {}
+
+    ~SpscQueue() {
+        if (arena_) {
+            arena_->deallocate(slots_, capacity_ * sizeof(T));
+        } else {
+            delete[] slots_;
+        }
+    }
+
+    SpscQueue(const SpscQueue&) = delete;
+    SpscQueue& operator=(const SpscQueue&) = delete;
+
+    // Producer side. Returns false if the ring is full.
+    bool push(const T& item) {
+        HFT_PROBE_SCOPE(QUEUE_PUSH);
+        size_t tail = producer_.tail.load(std::memory_order_relaxed);
+        if (tail - producer_.cached_head == capacity_) {
+            producer_.cached_head = consumer_.head.load(std::memory_order_acquire);
+            if (tail - producer_.cached_head == capacity_) {
+                return false;
+            }
+        }
+        slots_[tail & mask_] = item;
+        producer_.tail.store(tail + 1, std::memory_order_release);
+        notify(consumer_waiting_, tail_epoch_);
+        return true;
+    }
+
+    // Pushes as many of the count items as fit, publishing them with a single
+    // release store. Returns the number pushed.
+    size_t push_n(const T* items, size_t count) {
+        HFT_PROBE_SCOPE(QUEUE_PUSH);
+        size_t tail = producer_.tail.load(std::memory_order_relaxed);
+        size_t free_slots = capacity_ - (tail - producer_.cached_head);
+        if (free_slots < count) {
+            producer_.cached_head = consumer_.head.load(std::memory_order_acquire);
+            free_slots = capacity_ - (tail - producer_.cached_head);
+        }
+        size_t n = count < free_slots ? count : free_slots;
+        if (n == 0) {
+            return 0;
+        }
+        for (size_t i = 0; i < n; ++i) {
+            slots_[(tail + i) & mask_] = items[i];
+        }
+        producer_.tail.store(tail + n, std::memory_order_release);
+        notify(consumer_waiting_, tail_epoch_);
+        return n;
+    }
+
+    // Consumer side. Returns false if the ring is empty.
+    bool pop(T& item) {
+        HFT_PROBE_SCOPE(QUEUE_POP);
+        size_t head = consumer_.head.load(std::memory_order_relaxed);
+        if (head == consumer_.cached_tail) {
+            consumer_.cached_tail = producer_.tail.load(std::memory_order_acquire);
+            if (head == consumer_.cached_tail) {
+                return false;
+            }
+        }
+        item = slots_[head & mask_];
+        consumer_.head.store(head + 1, std::memory_order_release);
+        notify(producer_waiting_, head_epoch_);
+        return true;
+    }
+
+    // Pops up to max_items, releasing their slots with a single store.
+    // Returns the number popped.
+    size_t pop_n(T* items, size_t max_items) {
+        HFT_PROBE_SCOPE(QUEUE_POP);
+        size_t head = consumer_.head.load(std::memory_order_relaxed);
+        size_t available = consumer_.cached_tail - head;
+        if (available < max_items) {
+            consumer_.cached_tail = producer_.tail.load(std::memory_order_acquire);
+            available = consumer_.cached_tail - head;
+        }
+        size_t n = max_items < available ? max_items : available;
+        if (n == 0) {
+            return 0;
+        }
+        for (size_t i = 0; i < n; ++i) {
+            items[i] = slots_[(head + i) & mask_];
+        }
+        consumer_.head.store(head + n, std::memory_order_release);
+        notify(producer_waiting_, head_epoch_);
+        return n;
+    }
+
+    // Blocking variants. They return false only once the queue is closed
+    // (pop_wait additionally drains everything pushed before close()).
+    bool push_wait(const T& item) {
+        while (!push(item)) {
+            if (closed()) {
+                return false;
+            }
+            wait_for(producer_waiting_, head_epoch_, [this] { return !full() || closed(); });
+        }
+        return true;
+    }
+
+    bool pop_wait(T& item) {
+        while (!pop(item)) {
+            if (closed()) {
+                return pop(item);  // An item may have landed just before close()
+            }
+            wait_for(consumer_waiting_, tail_epoch_, [this] { return !empty() || closed(); });
+        }
+        return true;
+    }
+
+    // Wakes any blocked waiter; subsequent waits return instead of blocking
+    void close() {
+        closed_.store(true, std::memory_order_seq_cst);
+        wake(tail_epoch_);
+        wake(head_epoch_);
+    }
+
+    bool closed() const { return closed_.load(std::memory_order_acquire); }
+
+    // Approximate when called concurrently with the other side
+    size_t size() const {
+        return producer_.tail.load(std::memory_order_acquire) - consumer_.head.load(std::memory_order_acquire);
+    }
+    bool empty() const { return size() == 0; }
+    bool full() const { return size() >= capacity_; }
+    size_t capacity() const { return capacity_; }
+
+private:
+    struct alignas(CACHE_LINE_SIZE) ProducerState {
+        std::atomic<size_t> tail{0};
+        size_t cached_head = 0;
+    };
+
+    struct alignas(CACHE_LINE_SIZE) ConsumerState {
+        std::atomic<size_t> head{0};
+        size_t cached_tail = 0;
+    };
+
+    // Futex words are 32-bit, so each direction gets a wake epoch and a
+    // waiter flag instead of sleeping on the 64-bit indices themselves
+    struct alignas(CACHE_LINE_SIZE) WaitWord {
+        std::atomic<uint32_t> value{0};
+    };
+
+    static size_t round_up_pow2(size_t n) {
+        size_t capacity = 1;
+        while (capacity < n) {
+            capacity <<= 1;
+        }
+        return capacity;
+    }
+
+    T* allocate_slots() {
+        void* block = arena_ ? arena_->allocate(capacity_ * sizeof(T), alignof(T)) : nullptr;
+        if (!block) {
+            arena_ = nullptr;  // No arena, or it is out of memory: use the heap
+            return new T[capacity_];
+        }
+        T* slots = static_cast<T*>(block);
+        for (size_t i = 0; i < capacity_; ++i) {
+            new (&slots[i]) T();
+        }
+        return slots;
+    }
+
+    // Called after publishing an index. The fence pairs with the one in
+    // wait_for(): either the waiter sees the new index, or we see its flag.
+    static void notify(WaitWord& waiting, WaitWord& epoch) {
+        if (Wait != WaitStrategy::FUTEX) {
+            return;
+        }
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (waiting.value.load(std::memory_order_relaxed) != 0) {
+            wake(epoch);
+        }
+    }
+
+    static void wake(WaitWord& epoch) {
+        epoch.value.fetch_add(1, std::memory_order_release);
+        detail::futex_wake(epoch.value);
+    }
+
+    template <typename Ready>
+    static void wait_for(WaitWord& waiting, WaitWord& epoch, Ready ready) {
+        for (uint32_t spin = 0; spin < SPIN_LIMIT || Wait != WaitStrategy::FUTEX; ++spin) {
+            if (ready()) {
+                return;
+            }
+            cpu_relax();
+        }
+        uint32_t observed = epoch.value.load(std::memory_order_acquire);
+        waiting.value.store(1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (!ready()) {
+            detail::futex_wait(epoch.value, observed);
+        }
+        waiting.value.store(0, std::memory_order_relaxed);
+    }
+
+    ProducerState producer_;
+    ConsumerState consumer_;
+    WaitWord consumer_waiting_;
+    WaitWord tail_epoch_;   // Bumped by the producer to wake the consumer
+    WaitWord producer_waiting_;
+    WaitWord head_epoch_;   // Bumped by the consumer to wake the producer
+    std::atomic<bool> closed_{false};
+    const size_t capacity_;
+    const size_t mask_;
+    MemoryArena* arena_;
+    T* slots_;
+};
+
+} // namespace ingestion
+} // namespace hft
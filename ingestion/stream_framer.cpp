@@ -0,0 +1,281 @@
+#include "stream_framer.hpp"
+#include "simd_scan.hpp"
+#include <cstring>
+
+namespace hft {
+namespace ingestion {
+
+namespace {
+
+constexpr char FIX_DELIMITER = '\x01';
+constexpr const char FIX_BEGIN_PREFIX[] = "8=FIX";
+constexpr size_t FIX_BEGIN_PREFIX_LENGTH = sizeof(FIX_BEGIN_PREFIX) - 1;
+constexpr size_t FIX_CHECKSUM_FIELD_LENGTH = 7;  // "10=ddd" + SOH
+constexpr size_t MAX_FIX_BODY_LENGTH = 1 << 20;
+constexpr size_t LENGTH_PREFIX_SIZE = 4;
+
+} // namespace
+
+StreamFramer::StreamFramer(FramingMode mode, size_t buffer_size, bool verify_checksum, MemoryArena* arena)
+    : mode_(mode),
+      verify_checksum_(verify_checksum),
+      capacity_(buffer_size),
+      arena_(arena),
+      buffer_(arena ? static_cast<char*>(arena->allocate(buffer_size)) : nullptr),
+      begin_(0),
+      end_(0),
+      frames_dropped_(0) {
+    if (!buffer_) {
+        arena_ = nullptr;  // No arena, or it is out of memory: use the heap
+        buffer_ = new char[buffer_size];
+    }
+}
+
+StreamFramer::~StreamFramer() {
+    if (arena_) {
+        arena_->deallocate(buffer_, capacity_);
+    } else {
+        delete[] buffer_;
+    }
+}
+
+char* StreamFramer::write_ptr() {
+    // Carry the unconsumed remainder (at most one partial message) to the front
+    if (begin_ > 0) {
+        size_t remaining = end_ - begin_;
+        if (remaining > 0) {
+            std::memmove(buffer_, buffer_ + begin_, remaining);
+        }
+        begin_ = 0;
+        end_ = remaining;
+    }
+    return buffer_ + end_;
+}
+
+void StreamFramer::commit(size_t bytes) {
+    end_ += bytes < writable() ? bytes : writable();
+}
+
+size_t StreamFramer::feed(const char* data, size_t length) {
+    char* dest = write_ptr();
+    size_t n = length < writable() ? length : writable();
+    std::memcpy(dest, data, n);
+    commit(n);
+    return n;
+}
+
+ParseResult StreamFramer::next_frame(Frame& frame) {
+    if (begin_ == end_) {
+        return ParseResult::INCOMPLETE_MESSAGE;
+    }
+
+    size_t frame_offset = 0, frame_length = 0, consumed = 0;
+    const char* data = buffer_ + begin_;
+    ParseResult result = find_frame(mode_, data, end_ - begin_, frame_offset, frame_length,
+                                    consumed, verify_checksum_);
+    begin_ += consumed;
+
+    switch (result) {
+        case ParseResult::SUCCESS:
+            frame.data = data + frame_offset;
+            frame.length = frame_length;
+            return result;
+        case ParseResult::INCOMPLETE_MESSAGE:
+            if (begin_ == 0 && end_ == capacity_) {
+                // A single message larger than the whole buffer can never complete
+                frames_dropped_++;
+                begin_ = end_ = 0;
+                return ParseResult::BUFFER_OVERFLOW;
+            }
+            return result;
+        default:
+            frames_dropped_++;
+            return result;
+    }
+}
+
+size_t StreamFramer::next_frames(Frame* frames, size_t max_frames) {
+    size_t count = 0;
+    while (count < max_frames) {
+        ParseResult result = next_frame(frames[count]);
+        if (result == ParseResult::SUCCESS) {
+            count++;
+        } else if (result != ParseResult::INVALID_FORMAT) {
+            break;
+        }
+    }
+    return count;
+}
+
+void StreamFramer::reset() {
+    begin_ = end_ = 0;
+    frames_dropped_ = 0;
+}
+
+ParseResult StreamFramer::find_frame(FramingMode mode, const char* data, size_t length,
+                                     size_t& frame_offset, size_t& frame_length, size_t& consumed,
+                                     bool verify_checksum) {
+    consumed = 0;
+    switch (mode) {
+        case FramingMode::FIX:
+            return find_fix_frame(data, length, frame_offset, frame_length, consumed, verify_checksum);
+        case FramingMode::JSON_BRACES:
+            return find_json_frame(data, length, frame_offset, frame_length, consumed);
+        case FramingMode::LENGTH_PREFIXED:
+            return find_length_prefixed_frame(data, length, frame_offset, frame_length, consumed);
+        default:
+            return ParseResult::UNKNOWN_PROTOCOL;
+    }
+}
+
+ParseResult StreamFramer::find_fix_frame(const char* data, size_t length, size_t& frame_offset,
+                                         size_t& frame_length, size_t& consumed, bool verify_checksum) {
+    // Resynchronise on the BeginString prefix, skipping any garbage before it
+    size_t start = 0;
+    while (start < length) {
+        size_t n = length - start < FIX_BEGIN_PREFIX_LENGTH ? length - start : FIX_BEGIN_PREFIX_LENGTH;
+        if (std::memcmp(data + start, FIX_BEGIN_PREFIX, n) == 0) {
+            break;  // Full match, or a partial one at the end of the span
+        }
+        start++;
+    }
+    consumed = start;
+    if (length - start <= FIX_BEGIN_PREFIX_LENGTH) {
+        return ParseResult::INCOMPLETE_MESSAGE;
+    }
+
+    // BeginString
+    const void* soh = std::memchr(data + start, FIX_DELIMITER, length - start);
+    if (!soh) {
+        return ParseResult::INCOMPLETE_MESSAGE;
+    }
+    size_t pos = static_cast<const char*>(soh) - data + 1;
+
+    // BodyLength must be the second field
+    if (pos + 2 > length) {
+        return ParseResult::INCOMPLETE_MESSAGE;
+    }
+    if (data[pos] != '9' || data[pos + 1] != '=') {
+        consumed = start + 1;
+        return ParseResult::INVALID_FORMAT;
+    }
+    pos += 2;
+
+    size_t body_length = 0;
+    size_t digits_start = pos;
+    while (pos < length && data[pos] >= '0' && data[pos] <= '9') {
+        body_length = body_length * 10 + static_cast<size_t>(data[pos] - '0');
+        pos++;
+        if (body_length > MAX_FIX_BODY_LENGTH) {
+            consumed = start + 1;
+            return ParseResult::INVALID_FORMAT;
+        }
+    }
+    if (pos == length) {
+        return ParseResult::INCOMPLETE_MESSAGE;
+    }
+    if (pos == digits_start || data[pos] != FIX_DELIMITER) {
+        consumed = start + 1;
+        return ParseResult::INVALID_FORMAT;
+    }
+    pos++;
+
+    // Body, then the CheckSum trailer
+    size_t checksum_start = pos + body_length;
+    size_t frame_end = checksum_start + FIX_CHECKSUM_FIELD_LENGTH;
+    if (frame_end > length) {
+        return ParseResult::INCOMPLETE_MESSAGE;
+    }
+    const char* trailer = data + checksum_start;
+    bool trailer_ok = trailer[0] == '1' && trailer[1] == '0' && trailer[2] == '=' &&
+                      trailer[3] >= '0' && trailer[3] <= '9' &&
+                      trailer[4] >= '0' && trailer[4] <= '9' &&
+                      trailer[5] >= '0' && trailer[5] <= '9' &&
+                      trailer[6] == FIX_DELIMITER;
+    if (!trailer_ok) {
+        consumed = start + 1;  // BodyLength lied; rescan from the next byte
+        return ParseResult::INVALID_FORMAT;
+    }
+
+    if (verify_checksum) {
+        unsigned sum = 0;
+        for (size_t i = start; i < checksum_start; ++i) {
+            sum += static_cast<unsigned char>(data[i]);
+        }
+        unsigned expected = static_cast<unsigned>(trailer[3] - '0') * 100 +
+                            static_cast<unsigned>(trailer[4] - '0') * 10 +
+                            static_cast<unsigned>(trailer[5] - '0');
+        if ((sum & 0xFF) != expected) {
+            consumed = frame_end;  // Boundaries are sound, drop the whole frame
+            return ParseResult::INVALID_FORMAT;
+        }
+    }
+
+    frame_offset = start;
+    frame_length = frame_end - start;
+    consumed = frame_end;
+    return ParseResult::SUCCESS;
+}
+
+ParseResult StreamFramer::find_json_frame(const char* data, size_t length, size_t& frame_offset,
+                                          size_t& frame_length, size_t& consumed) {
+    // Skip whitespace, newlines and any garbage before the next object
+    const void* open = std::memchr(data, '{', length);
+    if (!open) {
+        consumed = length;
+        return ParseResult::INCOMPLETE_MESSAGE;
+    }
+    size_t start = static_cast<const char*>(open) - data;
+    consumed = start;
+
+    // Structural positions exclude string contents, so braces inside values are ignored
+    simd::JsonStructuralScanner structurals(data + start, length - start);
+    size_t span = length - start;
+    int depth = 0;
+    while (true) {
+        size_t pos = structurals.next();
+        if (pos == span) {
+            return ParseResult::INCOMPLETE_MESSAGE;
+        }
+        char c = data[start + pos];
+        if (c == '{' || c == '[') {
+            depth++;
+        } else if (c == '}' || c == ']') {
+            if (--depth == 0) {
+                frame_offset = start;
+                frame_length = pos + 1;
+                consumed = start + pos + 1;
+                return ParseResult::SUCCESS;
+            }
+        }
+    }
+}
+
+ParseResult StreamFramer::find_length_prefixed_frame(const char* data, size_t length, size_t& frame_offset,
+                                                     size_t& frame_length, size_t& consumed) {
+    size_t pos = 0;
+    while (true) {
+        if (length - pos < LENGTH_PREFIX_SIZE) {
+            consumed = pos;
+            return ParseResult::INCOMPLETE_MESSAGE;
+        }
+        const unsigned char* prefix = reinterpret_cast<const unsigned char*>(data + pos);
+        size_t payload_length = (static_cast<size_t>(prefix[0]) << 24) | (static_cast<size_t>(prefix[1]) << 16) |
+                                (static_cast<size_t>(prefix[2]) << 8) | static_cast<size_t>(prefix[3]);
+        if (payload_length == 0) {
+            pos += LENGTH_PREFIX_SIZE;  // Heartbeat
+            continue;
+        }
+        consumed = pos;
+        if (length - pos - LENGTH_PREFIX_SIZE < payload_length) {
+            return ParseResult::INCOMPLETE_MESSAGE;
+        }
+        frame_offset = pos + LENGTH_PREFIX_SIZE;
+        frame_length = payload_length;
+        consumed = frame_offset + payload_length;
+        return ParseResult::SUCCESS;
+    }
+}
+
+} // namespace ingestion
+} // namespace hft
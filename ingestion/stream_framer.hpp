@@ -0,0 +1,92 @@
+#pragma once
+
+#include "memory_arena.hpp"
+#include "message_types.hpp"
+#include <cstddef>
+
+namespace hft {
+namespace ingestion {
+
+// How message boundaries are found in a byte stream
+enum class FramingMode : uint8_t {
+    FIX = 1,              // BodyLength (tag 9) and CheckSum (tag 10)
+    JSON_BRACES = 2,      // Balanced top-level object, string aware
+    LENGTH_PREFIXED = 3   // 4-byte big-endian payload length before each message
+};
+
+// View of one complete message inside the framer's buffer
+struct Frame {
+    const char* data;
+    size_t length;
+};
+
+// Splits an arbitrary chunked byte stream (e.g. TCP reads) into complete
+// messages. Bytes are received directly into a fixed, reusable buffer via
+// write_ptr()/commit(), frames are returned as zero-copy views, and any
+// trailing partial message is carried over to the front of the buffer.
+//
+// Frames stay valid until the next call to write_ptr(), feed() or reset().
+class StreamFramer {
+public:
+    static constexpr size_t DEFAULT_BUFFER_SIZE = 1 << 16;
+
+    // The buffer comes from the arena when one is given; it must outlive the framer
+    explicit StreamFramer(FramingMode mode, size_t buffer_size = DEFAULT_BUFFER_SIZE, bool verify_checksum = true,
+                          MemoryArena* arena = nullptr);
+    ~StreamFramer();
+
+    StreamFramer(const StreamFramer&) = delete;
+    StreamFramer& operator=(const StreamFramer&) = delete;
+
+    // Receive interface: recv(fd, write_ptr(), writable(), 0) then commit(n)
+    char* write_ptr();
+    size_t writable() const { return capacity_ - end_; }
+    void commit(size_t bytes);
+
+    // Copies data in for sources that cannot write into the buffer directly.
+    // Returns the number of bytes accepted.
+    size_t feed(const char* data, size_t length);
+
+    // Next complete frame. Returns INCOMPLETE_MESSAGE when more bytes are
+    // needed, INVALID_FORMAT after skipping a corrupt frame (call again to
+    // continue), or BUFFER_OVERFLOW if a single message exceeds the buffer.
+    ParseResult next_frame(Frame& frame);
+
+    // Collects up to max_frames complete frames, skipping corrupt ones
+    size_t next_frames(Frame* frames, size_t max_frames);
+
+    void reset();
+
+    size_t buffered() const { return end_ - begin_; }
+    size_t capacity() const { return capacity_; }
+    FramingMode mode() const { return mode_; }
+    size_t frames_dropped() const { return frames_dropped_; }
+
+    // Stateless framing over an arbitrary span, shared by the stream framer and
+    // file replay. On SUCCESS the frame is [frame_offset, frame_offset + frame_length).
+    // `consumed` is always the number of leading bytes the caller may discard:
+    // the end of the frame, leading garbage, or a corrupt frame header.
+    static ParseResult find_frame(FramingMode mode, const char* data, size_t length,
+                                  size_t& frame_offset, size_t& frame_length, size_t& consumed,
+                                  bool verify_checksum = true);
+
+private:
+    static ParseResult find_fix_frame(const char* data, size_t length, size_t& frame_offset,
+                                      size_t& frame_length, size_t& consumed, bool verify_checksum);
+    static ParseResult find_json_frame(const char* data, size_t length, size_t& frame_offset,
+                                       size_t& frame_length, size_t& consumed);
+    static ParseResult find_length_prefixed_frame(const char* data, size_t length, size_t& frame_offset,
+                                                  size_t& frame_length, size_t& consumed);
+
+    FramingMode mode_;
+    bool verify_checksum_;
+    size_t capacity_;
+    MemoryArena* arena_;
+    char* buffer_;
+    size_t begin_;  // First unconsumed byte
+    size_t end_;    // One past the last received byte
+    size_t frames_dropped_;
+};
+
+} // namespace ingestion
+} // namespace hft
@@ -0,0 +1,179 @@
+#include "symbol_registry.hpp"
+#include "numeric_parse.hpp"
+#include <cctype>
+#include <fstream>
+
+namespace hft {
+namespace ingestion {
+
+namespace {
+
+size_t next_power_of_two(size_t value) {
+    size_t result = 1;
+    while (result < value) {
+        result <<= 1;
+    }
+    return result;
+}
+
+} // namespace
+
+SymbolRegistry::SymbolRegistry(size_t capacity)
+    : capacity_(capacity),
+      // Keep the load factor at or below 0.5 so probe sequences stay short
+      slot_mask_(next_power_of_two(capacity * 2) - 1),
+      slots_(new Slot[slot_mask_ + 1]),
+      symbols_(new SymbolKey[capacity]),
+      tick_units_(new std::atomic<int64_t>[capacity]),
+      size_(0) {
+    for (size_t i = 0; i <= slot_mask_; ++i) {
+        slots_[i].id_plus_one.store(0, std::memory_order_relaxed);
+        std::memset(slots_[i].symbol, 0, sizeof(SymbolKey));
+    }
+    for (size_t i = 0; i < capacity_; ++i) {
+        tick_units_[i].store(DEFAULT_TICK_UNITS, std::memory_order_relaxed);
+    }
+}
+
+SymbolRegistry::~SymbolRegistry() = default;
+
+uint64_t SymbolRegistry::hash_key(const SymbolKey& key) {
+    // FNV-1a over the NUL-padded key
+    uint64_t hash = 14695981039346656037ULL;
+    for (size_t i = 0; i < sizeof(SymbolKey) && key[i] != '\0'; ++i) {
+        hash ^= static_cast<unsigned char>(key[i]);
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+bool SymbolRegistry::make_key(std::string_view symbol, SymbolKey& key) {
+    if (symbol.empty() || symbol.size() > sizeof(SymbolKey)) {
+        return false;
+    }
+    std::memcpy(key, symbol.data(), symbol.size());
+    std::memset(key + symbol.size(), 0, sizeof(SymbolKey) - symbol.size());
+    return true;
+}
+
+uint32_t SymbolRegistry::find_key(const SymbolKey& key, uint64_t hash, size_t& slot_index) const {
+    slot_index = hash & slot_mask_;
+    while (true) {
+        const Slot& slot = slots_[slot_index];
+        uint32_t id_plus_one = slot.id_plus_one.load(std::memory_order_acquire);
+        if (id_plus_one == 0) {
+            return INVALID_SYMBOL_ID;
+        }
+        // Slot symbols are written before id_plus_one is published and never change afterwards
+        if (std::memcmp(slot.symbol, key, sizeof(SymbolKey)) == 0) {
+            return id_plus_one - 1;
+        }
+        slot_index = (slot_index + 1) & slot_mask_;
+    }
+}
+
+uint32_t SymbolRegistry::find(std::string_view symbol) const {
+    SymbolKey key;
+    if (!make_key(symbol, key)) {
+        return INVALID_SYMBOL_ID;
+    }
+    size_t slot_index;
+    return find_key(key, hash_key(key), slot_index);
+}
+
+uint32_t SymbolRegistry::intern(std::string_view symbol) {
+    SymbolKey key;
+    if (!make_key(symbol, key)) {
+        return INVALID_SYMBOL_ID;
+    }
+
+    uint64_t hash = hash_key(key);
+    size_t slot_index;
+    uint32_t id = find_key(key, hash, slot_index);
+    if (id != INVALID_SYMBOL_ID) {
+        return id;
+    }
+
+    std::lock_guard<std::mutex> lock(write_mutex_);
+
+    // Another writer may have inserted it, or claimed our empty slot, meanwhile
+    id = find_key(key, hash, slot_index);
+    if (id != INVALID_SYMBOL_ID) {
+        return id;
+    }
+
+    uint32_t next_id = size_.load(std::memory_order_relaxed);
+    if (next_id >= capacity_) {
+        return INVALID_SYMBOL_ID;
+    }
+
+    // Publish the reverse mapping first so any reader that finds the slot can resolve the id
+    std::memcpy(symbols_[next_id], key, sizeof(SymbolKey));
+    size_.store(next_id + 1, std::memory_order_release);
+    std::memcpy(slots_[slot_index].symbol, key, sizeof(SymbolKey));
+    slots_[slot_index].id_plus_one.store(next_id + 1, std::memory_order_release);
+    return next_id;
+}
+
+std::string_view SymbolRegistry::symbol(uint32_t id) const {
+    if (id >= size()) {
+        return std::string_view();
+    }
+    const SymbolKey& key = symbols_[id];
+    const void* nul = std::memchr(key, '\0', sizeof(SymbolKey));
+    size_t n = nul ? static_cast<const char*>(nul) - key : sizeof(SymbolKey);
+    return std::string_view(key, n);
+}
+
+bool SymbolRegistry::set_tick_size(uint32_t id, int64_t tick_units) {
+    if (id >= size() || tick_units <= 0) {
+        return false;
+    }
+    tick_units_[id].store(tick_units, std::memory_order_relaxed);
+    return true;
+}
+
+bool SymbolRegistry::load_universe_file(const std::string& path) {
+    std::ifstream file(path);
+    if (!file) {
+        return false;
+    }
+
+    std::string line;
+    while (std::getline(file, line)) {
+        size_t comment = line.find('#');
+        if (comment != std::string::npos) {
+            line.resize(comment);
+        }
+
+        size_t begin = 0;
+        while (begin < line.size() && std::isspace(static_cast<unsigned char>(line[begin]))) begin++;
+        size_t end = begin;
+        while (end < line.size() && !std::isspace(static_cast<unsigned char>(line[end]))) end++;
+        if (begin == end) {
+            continue;
+        }
+
+        uint32_t id = intern(std::string_view(line).substr(begin, end - begin));
+        if (id == INVALID_SYMBOL_ID) {
+            return false;
+        }
+
+        // Optional tick size column
+        size_t tick_begin = end;
+        while (tick_begin < line.size() && std::isspace(static_cast<unsigned char>(line[tick_begin]))) tick_begin++;
+        size_t tick_end = tick_begin;
+        while (tick_end < line.size() && !std::isspace(static_cast<unsigned char>(line[tick_end]))) tick_end++;
+        if (tick_begin != tick_end) {
+            int64_t tick_units;
+            if (!parse_fixed_point(line.data() + tick_begin, line.data() + tick_end, PRICE_DECIMALS, tick_units) ||
+                !set_tick_size(id, tick_units)) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+} // namespace ingestion
+} // namespace hft
@@ -0,0 +1,73 @@
+#pragma once
+
+#include "message_types.hpp"
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+
+namespace hft {
+namespace ingestion {
+
+// Maps trading symbols to dense uint32_t ids so per-symbol state can live
+// in flat arrays. Lookups of already-interned symbols are lock-free; only
+// the first sighting of a new symbol takes the writer mutex. Capacity is
+// fixed at construction so the tables never reallocate under readers.
+class SymbolRegistry {
+public:
+    static constexpr size_t DEFAULT_CAPACITY = 1 << 16;
+
+    explicit SymbolRegistry(size_t capacity = DEFAULT_CAPACITY);
+    ~SymbolRegistry();
+
+    SymbolRegistry(const SymbolRegistry&) = delete;
+    SymbolRegistry& operator=(const SymbolRegistry&) = delete;
+
+    // Lock-free lookup, returns INVALID_SYMBOL_ID if the symbol is unknown
+    uint32_t find(std::string_view symbol) const;
+
+    // Returns the existing id or assigns the next dense id.
+    // Returns INVALID_SYMBOL_ID if the symbol is too long or the registry is full.
+    uint32_t intern(std::string_view symbol);
+
+    // Reverse lookup, empty view for unknown ids
+    std::string_view symbol(uint32_t id) const;
+
+    // Per-instrument tick size in raw fixed-point units (see price.hpp).
+    // Unknown ids report DEFAULT_TICK_UNITS.
+    int64_t tick_size(uint32_t id) const {
+        return id < capacity_ ? tick_units_[id].load(std::memory_order_relaxed) : DEFAULT_TICK_UNITS;
+    }
+    bool set_tick_size(uint32_t id, int64_t tick_units);
+
+    // Pre-load a universe file: one symbol per line with an optional decimal
+    // tick size in the second column (e.g. "AAPL 0.01"); '#' starts a comment
+    bool load_universe_file(const std::string& path);
+
+    size_t size() const { return size_.load(std::memory_order_acquire); }
+    size_t capacity() const { return capacity_; }
+
+private:
+    using SymbolKey = char[MarketMessage::SYMBOL_CAPACITY];
+
+    struct Slot {
+        std::atomic<uint32_t> id_plus_one;  // 0 marks an empty slot
+        SymbolKey symbol;
+    };
+
+    static uint64_t hash_key(const SymbolKey& key);
+    static bool make_key(std::string_view symbol, SymbolKey& key);
+    uint32_t find_key(const SymbolKey& key, uint64_t hash, size_t& slot_index) const;
+
+    size_t capacity_;
+    size_t slot_mask_;
+    std::unique_ptr<Slot[]> slots_;
+    std::unique_ptr<SymbolKey[]> symbols_;  // Indexed by id
+    std::unique_ptr<std::atomic<int64_t>[]> tick_units_;  // Indexed by id
+    std::atomic<uint32_t> size_;
+    std::mutex write_mutex_;
+};
+
+} // namespace ingestion
+} // namespace hft
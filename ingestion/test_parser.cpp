@@ -0,0 +1,794 @@
+// Unit tests for the ingestion module. Plain asserts, no framework: each
+// CHECK failure is reported and the process exits non-zero for ctest.
+
+#include "bbo_tracker.hpp"
+#include "capture_file.hpp"
+#include "feed_handler.hpp"
+#include "fix_schema.hpp"
+#include "memory_arena.hpp"
+#include "message_parser.hpp"
+#include "numeric_parse.hpp"
+#include "replay_engine.hpp"
+#include "simd_scan.hpp"
+#include "spsc_queue.hpp"
+#include "stream_framer.hpp"
+#include "symbol_registry.hpp"
+#include "tsc_clock.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace hft::ingestion;
+
+static int g_failures = 0;
+
+#define CHECK(cond)                                                           \
+    do {                                                                      \
+        if (!(cond)) {                                                        \
+            std::fprintf(stderr, "%s:%d: CHECK failed: %s\n", __FILE__, __LINE__, #cond); \
+            g_failures++;                                                     \
+        }                                                                     \
+    } while (0)
+
+namespace {
+
+ParseResult parse(MessageParser& parser, const std::string& raw, MarketMessage& message) {
+    ParseContext context;
+    return parser.parse_message(raw.data(), raw.size(), message, context);
+}
+
+double price_of(const MarketMessage& message) {
+    return price_to_double(message.price, DEFAULT_TICK_UNITS);
+}
+
+std::string make_fix_frame(const std::string& body) {
+    std::string frame = "8=FIX.4.4\x01" "9=" + std::to_string(body.size()) + "\x01" + body;
+    unsigned sum = 0;
+    for (unsigned char c : frame) {
+        sum += c;
+    }
+    char trailer[8];
+    std::snprintf(trailer, sizeof(trailer), "10=%03u\x01", sum & 0xFF);
+    return frame + trailer;
+}
+
+void test_fix_parsing() {
+    MessageParser parser;
+    MarketMessage message;
+
+    std::string order = "8=FIX.4.4\x01" "9=178\x01" "35=D\x01" "49=SENDER\x01" "56=TARGET\x01"
+                        "55=AAPL\x01" "54=1\x01" "44=150.25\x01" "38=100\x01";
+    CHECK(parse(parser, order, message) == ParseResult::SUCCESS);
+    CHECK(message.symbol_view() == "AAPL");
+    CHECK(message.side == Side::BUY);
+    CHECK(std::fabs(price_of(message) - 150.25) < 1e-9);
+    CHECK(message.size == 100);
+    CHECK(message.type == MessageType::NEW_ORDER);
+
+    // Tags that merely end in a known tag number must not match it
+    std::string lookalike = "8=FIX.4.4\x01" "35=8\x01" "155=XXX\x01" "55=MSFT\x01" "54=2\x01" "44=300.5\x01";
+    CHECK(parse(parser, lookalike, message) == ParseResult::SUCCESS);
+    CHECK(message.symbol_view() == "MSFT");
+    CHECK(message.side == Side::SELL);
+    CHECK(message.type == MessageType::TRADE);
+
+    std::string no_symbol = "8=FIX.4.4\x01" "35=D\x01" "54=1\x01";
+    CHECK(parse(parser, no_symbol, message) == ParseResult::INVALID_FORMAT);
+
+    std::string bad_price = "8=FIX.4.4\x01" "35=D\x01" "55=AAPL\x01" "44=15x.2\x01";
+    CHECK(parse(parser, bad_price, message) == ParseResult::INVALID_FORMAT);
+
+    // SendingTime is the event time; receive time is stamped separately
+    std::string sent = "8=FIX.4.4\x01" "35=8\x01" "52=20240115-14:30:00.123\x01" "55=AAPL\x01";
+    CHECK(parse(parser, sent, message) == ParseResult::SUCCESS);
+    CHECK(message.timestamp == 1705329000123000000ULL);
+    CHECK(message.receive_timestamp > message.timestamp);
+
+    std::string bad_time = "8=FIX.4.4\x01" "35=8\x01" "52=20240115-25:30:00\x01" "55=AAPL\x01";
+    CHECK(parse(parser, bad_time, message) == ParseResult::INVALID_FORMAT);
+
+    // A cancel refers to its OrigClOrdID, whichever order the tags come in
+    std::string cancel = "8=FIX.4.4\x01" "35=F\x01" "11=9002\x01" "41=9001\x01" "55=AAPL\x01";
+    CHECK(parse(parser, cancel, message) == ParseResult::SUCCESS);
+    CHECK(message.type == MessageType::CANCEL_ORDER && message.order_id == 9001);
+    CHECK(parse(parser, order, message) == ParseResult::SUCCESS && message.order_id == 0);
+    std::string named = "8=FIX.4.4\x01" "35=D\x01" "11=ABC-1\x01" "55=AAPL\x01";
+    CHECK(parse(parser, named, message) == ParseResult::SUCCESS);
+    CHECK(message.order_id == MessageParser::order_id_from("ABC-1"));
+    CHECK((message.order_id & MessageParser::ORDER_ID_HASH_BIT) && MessageParser::order_id_from("42") == 42);
+}
+
+// A venue whose only large tag exercises the out-of-table lookup
+struct LargeTagSchema {
+    static constexpr FixField FIELDS[] = {
+        {55, FixFieldKind::SYMBOL, true},
+        {9001, FixFieldKind::QUANTITY, true},
+    };
+};
+
+void test_fix_schema() {
+    using Traits = FixSchemaTraits<FixMarketDataSchema>;
+    static_assert(Traits::FIELD_COUNT == 5 && Traits::SYMBOL_SLOT == 0, "schema traits");
+    CHECK(Traits::slot(270) == 1 && Traits::slot(44) == Traits::FIELD_COUNT && Traits::slot(99999) == Traits::FIELD_COUNT);
+    CHECK(FixSchemaTraits<LargeTagSchema>::slot(9001) == 1);
+
+    MessageParser parser;
+    MarketMessage message;
+    ParseContext context;
+    auto parse_md = [&](const std::string& raw) {
+        context.reset();
+        return parser.parse_fix<FixMarketDataSchema>(raw.data(), raw.size(), message, context);
+    };
+
+    std::string entry = "8=FIX.4.4\x01" "35=X\x01" "52=20240115-14:30:00.250\x01" "55=MSFT\x01"
+                        "270=300.5\x01" "271=40\x01" "44=1.0\x01";
+    CHECK(parse_md(entry) == ParseResult::SUCCESS);
+    CHECK(message.symbol_view() == "MSFT" && message.size == 40);
+    CHECK(std::fabs(price_of(message) - 300.5) < 1e-9);  // 270, not 44
+    CHECK(message.timestamp == 1705329000250000000ULL);
+    CHECK(context.detected_protocol == ProtocolType::FIX && context.message_complete);
+
+    // Required fields: this venue always sends SendingTime and MDEntryPx
+    CHECK(parse_md("8=FIX.4.4\x01" "55=MSFT\x01" "270=300.5\x01") == ParseResult::INVALID_FORMAT);
+    CHECK(parse_md("8=FIX.4.4\x01" "52=20240115-14:30:00\x01" "55=MSFT\x01" "270=\x01") ==
+          ParseResult::INVALID_FORMAT);
+    CHECK(parser.metrics().count(ProtocolType::FIX, ParseResult::INVALID_FORMAT) == 2);
+
+    // The default schema through the known-protocol entry matches parse_message
+    std::string order = "8=FIX.4.4\x01" "35=D\x01" "55=AAPL\x01" "54=2\x01" "44=10.5\x01" "38=7\x01";
+    context.reset();
+    CHECK(parser.parse_fix(order.data(), order.size(), message, context) == ParseResult::SUCCESS);
+    CHECK(message.side == Side::SELL && message.size == 7 && message.type == MessageType::NEW_ORDER);
+
+    std::string quote = "8=FIX.4.4\x01" "35=S\x01" "52=20240115-14:30:00\x01" "55=MSFT\x01"
+                        "132=300.45\x01" "133=300.55\x01" "134=75\x01" "135=25\x01";
+    context.reset();
+    CHECK(parser.parse_fix<FixQuoteSchema>(quote.data(), quote.size(), message, context) == ParseResult::SUCCESS);
+    CHECK(message.type == MessageType::QUOTE && message.two_sided());
+    CHECK(std::fabs(price_of(message) - 300.45) < 1e-9 && message.size == 75);
+    CHECK(std::fabs(price_to_double(message.ask_price, DEFAULT_TICK_UNITS) - 300.55) < 1e-9 && message.ask_size == 25);
+
+    std::string large = "8=FIX.4.4\x01" "55=AAPL\x01" "9001=12\x01";
+    context.reset();
+    CHECK(parser.parse_fix<LargeTagSchema>(large.data(), large.size(), message, context) == ParseResult::SUCCESS);
+    CHECK(message.size == 12);
+
+    std::string json = "{\"symbol\":\"AAPL\",\"price\":2.5}";
+    context.reset();
+    CHECK(parser.parse_json(json.data(), json.size(), message, context) == ParseResult::SUCCESS);
+    CHECK(context.detected_protocol == ProtocolType::WEBSOCKET_JSON);
+}
+
+void test_json_parsing() {
+    MessageParser parser;
+    MarketMessage message;
+
+    std::string trade = "{\"type\":\"trade\",\"symbol\":\"AAPL\",\"side\":\"buy\",\"price\":150.25,\"size\":100}";
+    CHECK(parse(parser, trade, message) == ParseResult::SUCCESS);
+    CHECK(message.symbol_view() == "AAPL");
+    CHECK(message.side == Side::BUY);
+    CHECK(std::fabs(price_of(message) - 150.25) < 1e-9);
+    CHECK(message.size == 100);
+    CHECK(message.type == MessageType::TRADE);
+
+    std::string quote = "{\"type\":\"quote\",\"symbol\":\"MSFT\",\"bid\":300.45,\"ask\":300.55,"
+                        "\"bid_size\":75,\"ask_size\":25}";
+    CHECK(parse(parser, quote, message) == ParseResult::SUCCESS);
+    CHECK(message.type == MessageType::QUOTE && message.two_sided());
+    CHECK(std::fabs(price_of(message) - 300.45) < 1e-9 && message.size == 75);  // Bid
+    CHECK(std::fabs(price_to_double(message.ask_price, DEFAULT_TICK_UNITS) - 300.55) < 1e-9);
+    CHECK(message.ask_size == 25);
+    // The ask occupies the order id slot, so an order_id key cannot clobber it
+    std::string quote_with_id = "{\"type\":\"quote\",\"symbol\":\"MSFT\",\"bid\":1,\"ask\":2,\"order_id\":7}";
+    CHECK(parse(parser, quote_with_id, message) == ParseResult::SUCCESS);
+    CHECK(std::fabs(price_to_double(message.ask_price, DEFAULT_TICK_UNITS) - 2.0) < 1e-9);
+    std::string negative_ask = "{\"type\":\"quote\",\"symbol\":\"MSFT\",\"bid\":1,\"ask\":-2}";
+    CHECK(parse(parser, negative_ask, message) == ParseResult::INVALID_FORMAT);
+
+    // Nested values and braces inside strings are skipped
+    std::string nested = "{\"meta\":{\"note\":\"}{\\\"\",\"list\":[1,{\"symbol\":\"BAD\"}]},"
+                         "\"symbol\":\"TSLA\",\"price\":1.5,\"size\":3}";
+    CHECK(parse(parser, nested, message) == ParseResult::SUCCESS);
+    CHECK(message.symbol_view() == "TSLA");
+
+    std::string no_symbol = "{\"type\":\"trade\",\"price\":1.0}";
+    CHECK(parse(parser, no_symbol, message) == ParseResult::INVALID_FORMAT);
+
+    std::string bad_size = "{\"symbol\":\"AAPL\",\"price\":1.0,\"size\":\"ten\"}";
+    CHECK(parse(parser, bad_size, message) == ParseResult::INVALID_FORMAT);
+
+    std::string stamped = "{\"symbol\":\"AAPL\",\"price\":1.0,\"timestamp\":1705329000123456789}";
+    CHECK(parse(parser, stamped, message) == ParseResult::SUCCESS);
+    CHECK(message.timestamp == 1705329000123456789ULL && message.receive_timestamp != 0);
+    std::string utc = "{\"symbol\":\"AAPL\",\"price\":1.0,\"timestamp\":\"20240115-14:30:00.5\"}";
+    CHECK(parse(parser, utc, message) == ParseResult::SUCCESS);
+    CHECK(message.timestamp == 1705329000500000000ULL);
+
+    std::string cancel = "{\"type\":\"cancel\",\"symbol\":\"AAPL\",\"order_id\":77}";
+    CHECK(parse(parser, cancel, message) == ParseResult::SUCCESS);
+    CHECK(message.type == MessageType::CANCEL_ORDER && message.order_id == 77);
+    std::string named = "{\"type\":\"modify\",\"symbol\":\"AAPL\",\"order_id\":\"x7\",\"price\":2.0,\"size\":5}";
+    CHECK(parse(parser, named, message) == ParseResult::SUCCESS);
+    CHECK(message.type == MessageType::MODIFY_ORDER && message.order_id == MessageParser::order_id_from("x7"));
+}
+
+void test_protocol_detection() {
+    MessageParser parser;
+    MarketMessage message;
+    CHECK(parser.detect_protocol("8=FIX.4.4", 9) == ProtocolType::FIX);
+    CHECK(parser.detect_protocol("  {\"a\":1}", 9) == ProtocolType::WEBSOCKET_JSON);
+    CHECK(parser.detect_protocol("hello", 5) == ProtocolType::UNKNOWN);
+    CHECK(parse(parser, "garbage", message) == ParseResult::UNKNOWN_PROTOCOL);
+    CHECK(parse(parser, std::string(8192, '{'), message) == ParseResult::BUFFER_OVERFLOW);
+}
+
+void test_numeric_parsing() {
+    double value = 0;
+    const char* text = "123.456";
+    CHECK(parse_double(text, text + 7, value) && value == 123.456);
+    const char* bad = "1.2.3";
+    CHECK(!parse_double(bad, bad + 5, value));
+
+    int64_t fixed = 0;
+    const char* price = "0.015";
+    CHECK(parse_fixed_point(price, price + 5, 2, fixed) && fixed == 2);  // Rounds half away from zero
+    auto fixed8 = [&](const char* s) { return parse_fixed_point(s, s + std::strlen(s), 8, fixed); };
+    CHECK(fixed8("0.0000000049") && fixed == 0);  // Dropped digits round once, not digit by digit
+    CHECK(fixed8("1.234567894999") && fixed == 123456789);
+    CHECK(fixed8("1.234567895") && fixed == 123456790);
+    CHECK(fixed8("-0.000000015") && fixed == -2);
+    CHECK(fixed8("-0.0000000149") && fixed == -1);
+    CHECK(fixed8("0.000000000000000000000000000009") && fixed == 0);  // Beyond any int64 divisor
+
+    int32_t number = 0;
+    const char* qty = "-42";
+    CHECK(parse_int32(qty, qty + 3, number) && number == -42);
+    const char* overflow = "99999999999";
+    CHECK(!parse_int32(overflow, overflow + 11, number));
+
+    uint64_t ns = 0;
+    auto utc = [&](const char* s) { return parse_utc_timestamp(s, s + std::strlen(s), ns); };
+    CHECK(utc("19700101-00:00:00") && ns == 0);
+    CHECK(utc("20240229-23:59:59.000001") && ns == 1709251199000001000ULL);
+    CHECK(utc("20240115-14:30:00.123456789") && ns == 1705329000123456789ULL);
+    CHECK(utc("20161231-23:59:60") && ns == 1483228800000000000ULL);  // Leap second
+    CHECK(!utc("20230229-00:00:00"));
+    CHECK(!utc("20240115-14:30:00."));
+    CHECK(!utc("20240115-14:30:00.1234567890"));
+    CHECK(!utc("20240115 14:30:00"));
+    CHECK(!utc("2024011-14:30:00"));
+}
+
+void test_symbol_registry() {
+    SymbolRegistry registry(16);
+    uint32_t aapl = registry.intern("AAPL");
+    uint32_t msft = registry.intern("MSFT");
+    CHECK(aapl == 0 && msft == 1);
+    CHECK(registry.intern("AAPL") == aapl);
+    CHECK(registry.find("MSFT") == msft);
+    CHECK(registry.find("GOOG") == INVALID_SYMBOL_ID);
+    CHECK(registry.symbol(msft) == "MSFT");
+    CHECK(registry.intern("THIS_SYMBOL_IS_TOO_LONG") == INVALID_SYMBOL_ID);
+    CHECK(registry.tick_size(aapl) == DEFAULT_TICK_UNITS);
+    CHECK(registry.set_tick_size(aapl, 1000000) && registry.tick_size(aapl) == 1000000);
+
+    MessageParser parser;
+    parser.set_symbol_registry(&registry);
+    MarketMessage message;
+    CHECK(parse(parser, "{\"symbol\":\"MSFT\",\"price\":1.0}", message) == ParseResult::SUCCESS);
+    CHECK(message.symbol_id == msft);
+}
+
+void test_stream_framer() {
+    std::string first = make_fix_frame("35=D\x01" "55=AAPL\x01" "54=1\x01" "44=10.5\x01" "38=7\x01");
+    std::string second = make_fix_frame("35=8\x01" "55=MSFT\x01" "54=2\x01" "44=20\x01" "38=9\x01");
+    std::string stream = "junk" + first + second;
+
+    // Byte-at-a-time delivery still yields exactly the two frames, intact
+    StreamFramer framer(FramingMode::FIX, 1024);
+    std::vector<std::string> frames;
+    for (char c : stream) {
+        framer.feed(&c, 1);
+        Frame frame;
+        while (framer.next_frame(frame) == ParseResult::SUCCESS) {
+            frames.emplace_back(frame.data, frame.length);
+        }
+    }
+    CHECK(frames.size() == 2);
+    CHECK(frames.size() == 2 && frames[0] == first && frames[1] == second);
+
+    std::string corrupt = first;
+    corrupt[corrupt.size() - 2] = corrupt[corrupt.size() - 2] == '0' ? '1' : '0';  // Wrong CheckSum
+    StreamFramer checked(FramingMode::FIX, 1024);
+    checked.feed(corrupt.data(), corrupt.size());
+    Frame frame;
+    CHECK(checked.next_frame(frame) == ParseResult::INVALID_FORMAT);
+    CHECK(checked.frames_dropped() == 1);
+
+    StreamFramer json(FramingMode::JSON_BRACES, 1024);
+    std::string objects = "{\"a\":\"}\",\"b\":{\"c\":1}}\n{\"d\":2}";
+    json.feed(objects.data(), objects.size());
+    CHECK(json.next_frame(frame) == ParseResult::SUCCESS && std::string(frame.data, frame.length) == "{\"a\":\"}\",\"b\":{\"c\":1}}");
+    CHECK(json.next_frame(frame) == ParseResult::SUCCESS && std::string(frame.data, frame.length) == "{\"d\":2}");
+    CHECK(json.next_frame(frame) == ParseResult::INCOMPLETE_MESSAGE);
+
+    StreamFramer small(FramingMode::JSON_BRACES, 8);
+    small.feed("{\"abcdefgh", 10);
+    CHECK(small.next_frame(frame) == ParseResult::BUFFER_OVERFLOW);
+}
+
+void test_parse_batch() {
+    std::vector<std::string> frames = {
+        "8=FIX.4.4\x01" "35=D\x01" "55=AAPL\x01" "44=1.25\x01" "38=5\x01",
+        "{\"symbol\":\"MSFT\",\"price\":2.5,\"size\":6}",
+        "not a message",
+    };
+    std::string buffer;
+    std::vector<uint32_t> offsets = {0};
+    for (const std::string& frame : frames) {
+        buffer += frame;
+        offsets.push_back(static_cast<uint32_t>(buffer.size()));
+    }
+
+    MessageParser parser;
+    MarketMessage messages[3];
+    ParseResult results[3];
+    CHECK(parser.parse_batch(buffer.data(), offsets.data(), 3, messages, results) == 2);
+    CHECK(results[0] == ParseResult::SUCCESS && messages[0].symbol_view() == "AAPL");
+    CHECK(results[1] == ParseResult::SUCCESS && messages[1].symbol_view() == "MSFT" && messages[1].size == 6);
+    CHECK(results[2] == ParseResult::UNKNOWN_PROTOCOL);
+}
+
+std::vector<size_t> json_structurals(const std::string& text) {
+    std::vector<size_t> positions;
+    simd::JsonStructuralScanner scanner(text.data(), text.size());
+    for (size_t pos = scanner.next(); pos < text.size(); pos = scanner.next()) {
+        positions.push_back(pos);
+    }
+    return positions;
+}
+
+// Byte-at-a-time statement of the scanner's contract
+std::vector<size_t> json_structurals_reference(const std::string& text) {
+    std::vector<size_t> positions;
+    bool escaped = false;
+    bool in_string = false;
+    for (size_t i = 0; i < text.size(); ++i) {
+        char c = text[i];
+        if (c == '"' && !escaped) {
+            positions.push_back(i);
+            in_string = !in_string;
+        } else if (!in_string && c != '\0' && std::strchr(",:{}[]", c)) {
+            positions.push_back(i);
+        }
+        escaped = c == '\\' && !escaped;
+    }
+    return positions;
+}
+
+void test_simd_scanners() {
+    // Every available ISA must agree with the scalar kernels
+    std::string text = "8=FIX\x01" "35=D\x01" + std::string(100, 'x') + "\x01" "55=AAPL\x01";
+    for (simd::Isa isa : {simd::Isa::SCALAR, simd::Isa::SSE42, simd::Isa::AVX2, simd::Isa::NEON}) {
+        simd::set_isa(isa);
+        simd::CharScanner scanner(text.data(), text.size(), '\x01');
+        size_t count = 0;
+        for (size_t pos = scanner.next(); pos < text.size(); pos = scanner.next()) {
+            CHECK(text[pos] == '\x01');
+            count++;
+        }
+        CHECK(count == 4);
+    }
+
+    // JSON: escaped quotes, backslash runs, and strings and numbers that
+    // straddle the 64-byte block boundaries where the carries matter
+    std::vector<std::string> inputs = {
+        "{\"a\":\"x\\\"y\",\"b\":[1,2]}",
+        std::string(62, ' ') + "\"\\\\\",\"k\":1}",          // Backslash pair straddles blocks 0 and 1
+        std::string(63, ' ') + "\\\"" + std::string(70, ','),  // Escape carried into block 1
+        "{\"s\":\"" + std::string(120, 'z') + "{,}\",\"n\":" + std::string(90, '7') + "}",
+    };
+    std::mt19937_64 rng(5);
+    const char alphabet[] = "\"\"\\\\\\,:{}[]ab1. ";
+    for (int i = 0; i < 2000; ++i) {
+        std::string input(rng() % 300, ' ');
+        for (char& c : input) {
+            c = alphabet[rng() % (sizeof(alphabet) - 1)];
+        }
+        inputs.push_back(input);
+    }
+
+    simd::set_isa(simd::Isa::SCALAR);
+    std::vector<std::vector<size_t>> expected;
+    bool matches_reference = true;
+    for (const std::string& input : inputs) {
+        expected.push_back(json_structurals(input));
+        matches_reference = matches_reference && expected.back() == json_structurals_reference(input);
+    }
+    CHECK(matches_reference);
+    for (simd::Isa isa : {simd::Isa::SSE42, simd::Isa::AVX2, simd::Isa::NEON}) {
+        simd::set_isa(isa);
+        bool agrees = true;
+        for (size_t i = 0; i < inputs.size(); ++i) {
+            agrees = agrees && json_structurals(inputs[i]) == expected[i];
+        }
+        CHECK(agrees);
+    }
+    simd::set_isa(simd::detected_isa());
+}
+
+void test_spsc_queue() {
+    SpscQueue<MarketMessage> queue(3);
+    CHECK(queue.capacity() == 4);
+
+    MarketMessage message;
+    for (uint64_t i = 0; i < 4; ++i) {
+        message.timestamp = i;
+        CHECK(queue.push(message));
+    }
+    CHECK(!queue.push(message));
+    CHECK(queue.pop(message) && message.timestamp == 0);
+
+    MarketMessage batch[8];
+    CHECK(queue.pop_n(batch, 8) == 3 && batch[2].timestamp == 3);
+    CHECK(queue.empty() && !queue.pop(message));
+    CHECK(queue.push_n(batch, 8) == 4);
+
+    // Ordered handoff across threads, including the futex sleep/wake path
+    SpscQueue<uint64_t, WaitStrategy::FUTEX> handoff(64);
+    const uint64_t count = 20000;
+    bool ordered = true;
+    std::thread consumer([&] {
+        uint64_t value = 0;
+        for (uint64_t expected = 0; handoff.pop_wait(value); ++expected) {
+            ordered = ordered && value == expected;
+        }
+    });
+    for (uint64_t i = 0; i < count; ++i) {
+        handoff.push_wait(i);
+    }
+    handoff.close();
+    consumer.join();
+    CHECK(ordered);
+}
+
+void test_replay_engine() {
+    const std::string path = "replay_engine_test.fix";
+    {
+        std::ofstream file(path, std::ios::binary);
+        for (int i = 1; i <= 5000; ++i) {
+            file << make_fix_frame("35=8\x01" "55=SYM" + std::to_string(i % 10) + "\x01" "44=10\x01" "38=" +
+                                   std::to_string(i) + "\x01");
+            if (i % 100 == 0) {
+                file << "\n";
+            }
+        }
+    }
+
+    std::vector<size_t> cuts = ReplayEngine::split_chunks(FramingMode::FIX, "8=FIX\x01" "8=FIX", 11, 3);
+    CHECK(cuts.size() == 3 && cuts[1] == 6 && cuts[2] == 11);
+
+    // Small chunks across several workers must still come back in file order
+    ReplayConfig config;
+    config.worker_threads = 3;
+    config.chunk_size = 2048;
+    ReplayEngine engine(config);
+    CHECK(engine.add_file(path));
+    int32_t expected = 1;
+    bool ordered = true;
+    ReplayStats stats = engine.run([&](const MarketMessage& message) {
+        ordered = ordered && message.size == expected++;
+        return true;
+    });
+    CHECK(stats.messages == 5000 && stats.parse_errors == 0 && stats.chunks > 1);
+    CHECK(ordered);
+
+    size_t seen = 0;
+    stats = engine.run([&](const MarketMessage&) { return ++seen < 10; });
+    CHECK(stats.messages == 10);
+    std::remove(path.c_str());
+
+    // Two feeds interleaved by SendingTime merge back into event order
+    const std::string paths[2] = {"replay_engine_test_a.fix", "replay_engine_test_b.fix"};
+    for (int f = 0; f < 2; ++f) {
+        std::ofstream file(paths[f], std::ios::binary);
+        for (int i = 0; i < 500; ++i) {
+            int ms = 2 * i + f;
+            char sending_time[32];
+            std::snprintf(sending_time, sizeof(sending_time), "20240115-14:30:%02d.%03d", ms / 1000, ms % 1000);
+            file << make_fix_frame("35=8\x01" "52=" + std::string(sending_time) + "\x01" "55=SYM\x01" "38=" +
+                                   std::to_string(ms) + "\x01");
+        }
+    }
+    ReplayEngine merged(config);
+    CHECK(merged.add_file(paths[0]) && merged.add_file(paths[1]));
+    expected = 0;
+    ordered = true;
+    stats = merged.run([&](const MarketMessage& message) {
+        ordered = ordered && message.size == expected++;
+        return true;
+    });
+    CHECK(stats.messages == 1000 && ordered);
+    for (const std::string& p : paths) {
+        std::remove(p.c_str());
+    }
+}
+
+void test_feed_handler() {
+    // Two venues interleaved by SendingTime, delivered in small reads
+    std::string streams[2];
+    for (int f = 0; f < 2; ++f) {
+        for (int i = 0; i < 400; ++i) {
+            int ms = 2 * i + f;
+            char sending_time[32];
+            std::snprintf(sending_time, sizeof(sending_time), "20240115-14:30:%02d.%03d", ms / 1000, ms % 1000);
+            streams[f] += make_fix_frame("35=8\x01" "52=" + std::string(sending_time) + "\x01" "55=SYM\x01" "38=" +
+                                         std::to_string(ms) + "\x01");
+        }
+    }
+    streams[1] += make_fix_frame("35=8\x01" "38=1\x01");  // No symbol: a parse error
+
+    FeedHandlerConfig handler_config;
+    handler_config.max_merge_delay_ns = 1000000000;  // Strict order even when a feed thread is descheduled
+    FeedHandler handler(handler_config);
+    size_t offsets[2] = {0, 0};
+    for (int f = 0; f < 2; ++f) {
+        FeedConfig config;
+        config.name = f == 0 ? "venue_a" : "venue_b";
+        config.cpu = f == 0 ? 0 : -1;
+        config.queue_capacity = 16;  // Forces back-pressure
+        config.source = [&, f](char* buffer, size_t capacity, uint64_t&) -> ssize_t {
+            size_t n = std::min<size_t>({capacity, 37, streams[f].size() - offsets[f]});
+            if (n == 0) {
+                return -1;
+            }
+            std::memcpy(buffer, streams[f].data() + offsets[f], n);
+            offsets[f] += n;
+            return static_cast<ssize_t>(n);
+        };
+        CHECK(handler.add_feed(config) == static_cast<size_t>(f));
+    }
+    CHECK(handler.start());
+
+    int32_t expected = 0;
+    bool ordered = true;
+    uint64_t delivered = handler.run([&](const MarketMessage& message) {
+        ordered = ordered && message.size == expected++ && message.receive_timestamp != 0;
+        return true;
+    });
+    CHECK(delivered == 800 && ordered && handler.finished());
+    CHECK(handler.late_messages() == 0);
+    CHECK(handler.feed_stats(0).messages == 400 && handler.feed_stats(0).bytes == streams[0].size());
+    CHECK(handler.feed_stats(1).messages == 400 && handler.feed_stats(1).parse_errors == 1);
+    handler.stop();
+
+    // Restarting replaces each feed's queue and arena, queue first
+    offsets[0] = offsets[1] = 0;
+    CHECK(handler.start());
+    expected = 0;
+    delivered = handler.run([&](const MarketMessage& message) {
+        ordered = ordered && message.size == expected++;
+        return true;
+    });
+    CHECK(delivered == 800 && ordered && handler.finished());
+    handler.stop();
+
+    // A feed that cannot be pinned fails start() cleanly
+    FeedHandler unpinnable;
+    FeedConfig bad;
+    bad.cpu = CPU_SETSIZE;
+    bad.source = [](char*, size_t, uint64_t&) -> ssize_t { return -1; };
+    unpinnable.add_feed(bad);
+    CHECK(!unpinnable.start());
+    MarketMessage message;
+    CHECK(unpinnable.poll(&message, 1) == 0 && unpinnable.finished());
+}
+
+void test_capture_file() {
+    const std::string path = "capture_file_test.cap";
+    MessageParser parser;
+    CaptureWriter writer;
+    CHECK(writer.open(path, 16));
+    parser.set_capture_writer(&writer);
+
+    MarketMessage message;
+    for (int i = 0; i < 100; ++i) {
+        std::string symbol = i % 10 == 0 ? "RARE" : "COMMON";
+        std::string raw = "{\"symbol\":\"" + symbol + "\",\"price\":1.5,\"size\":" + std::to_string(i) + "}";
+        CHECK(parse(parser, raw, message) == ParseResult::SUCCESS);
+    }
+    CHECK(parse(parser, "{\"price\":1.5}", message) == ParseResult::INVALID_FORMAT);  // Not captured
+    CHECK(writer.record_count() == 100);
+    CHECK(writer.close());
+
+    CaptureReader reader;
+    CHECK(reader.open(path));
+    CHECK(reader.size() == 100 && reader.symbol_count() == 2);
+    CHECK(reader[42].size == 42 && reader.symbol(reader[42].symbol_id) == "COMMON");
+    CHECK(reinterpret_cast<uintptr_t>(reader.records()) % alignof(MarketMessage) == 0);
+
+    // The parser stamps receive time, so timestamps are non-decreasing
+    CHECK(reader.time_sorted());
+    CHECK(reader.lower_bound(reader[57].timestamp) <= 57);
+    CHECK(reader.lower_bound(reader.header().max_timestamp + 1) == reader.size());
+
+    uint32_t rare = reader.find_symbol("RARE");
+    int32_t size_sum = 0;
+    size_t matches = reader.for_each_symbol(rare, 0, UINT64_MAX, [&](const MarketMessage& m) { size_sum += m.size; });
+    CHECK(matches == 10 && size_sum == 450);
+    CHECK(reader.find_symbol("MISSING") == INVALID_SYMBOL_ID);
+    reader.close();
+    std::remove(path.c_str());
+}
+
+void test_tsc_clock() {
+    const TscClock& clock = TscClock::instance();
+    uint64_t system = TscClock::system_now_ns();
+    uint64_t stamped = clock.now_ns();
+    // Calibrated against CLOCK_REALTIME, so within a millisecond of it
+    CHECK(stamped + 1000000 > system && stamped < system + 1000000);
+    uint64_t later = clock.now_ns();
+    CHECK(later >= stamped);
+
+    TscClock fallback_check(1);
+    CHECK(!fallback_check.using_counter() || fallback_check.counter_hz() > 1e6);
+
+    // A receive-path hardware timestamp takes precedence over the clock
+    MessageParser parser;
+    MarketMessage message;
+    ParseContext context;
+    context.hardware_timestamp = 1700000000123456789ULL;
+    std::string raw = "{\"symbol\":\"AAPL\",\"price\":1.0}";
+    CHECK(parser.parse_message(raw.data(), raw.size(), message, context) == ParseResult::SUCCESS);
+    CHECK(message.timestamp == 1700000000123456789ULL && message.receive_timestamp == message.timestamp);
+    context.reset();
+    CHECK(context.hardware_timestamp == 0);
+}
+
+void test_memory_arena() {
+    ArenaConfig config;
+    config.region_size = 1 << 16;
+    config.initial_size = 1 << 16;
+    config.huge_pages = false;
+    MemoryArena arena(config);
+    CHECK(arena.region_count() == 1);
+    CHECK(arena.bytes_mapped() == (1u << 16));
+
+    void* a = arena.allocate(24);
+    void* b = arena.allocate(100, 64);
+    CHECK(a && b && reinterpret_cast<uintptr_t>(b) % 64 == 0);
+    CHECK(arena.bytes_in_use() == 32 + 128);  // Power-of-two blocks
+    arena.deallocate(b, 100);
+    CHECK(arena.allocate(128, 64) == b);  // Same size class comes back first
+    CHECK(!arena.allocate(1, 8192));      // Beyond MAX_ALIGNMENT
+
+    // Oversized blocks get a region of their own
+    void* large = arena.allocate(1 << 17);
+    CHECK(large && arena.region_count() == 2);
+
+    // Containers that regrow after warm-up map nothing new
+    {
+        std::vector<MarketMessage, ArenaAllocator<MarketMessage>> messages{ArenaAllocator<MarketMessage>(&arena)};
+        for (int round = 0; round < 3; ++round) {
+            messages.assign(200, MarketMessage());
+            CHECK(reinterpret_cast<uintptr_t>(messages.data()) % 64 == 0);
+            messages.clear();
+            messages.shrink_to_fit();
+        }
+    }
+    size_t mapped = arena.bytes_mapped();
+    {
+        std::vector<MarketMessage, ArenaAllocator<MarketMessage>> messages{ArenaAllocator<MarketMessage>(&arena)};
+        messages.assign(200, MarketMessage());
+    }
+    CHECK(arena.bytes_mapped() == mapped);
+
+    {
+        SpscQueue<MarketMessage> queue(64, &arena);
+        MarketMessage message;
+        message.size = 5;
+        CHECK(queue.push(message));
+        MarketMessage popped;
+        CHECK(queue.pop(popped) && popped.size == 5);
+
+        StreamFramer framer(FramingMode::JSON_BRACES, 4096, true, &arena);
+        std::string json = "{\"a\":1}";
+        framer.feed(json.data(), json.size());
+        Frame frame;
+        CHECK(framer.next_frame(frame) == ParseResult::SUCCESS && frame.length == json.size());
+    }
+
+    size_t regions = arena.region_count();
+    arena.reset();
+    CHECK(arena.bytes_in_use() == 0);
+    CHECK(arena.allocate(16) != nullptr);
+    CHECK(arena.region_count() == regions);  // Regions are kept and reused
+
+    // Huge pages fall back to THP-advised regular pages without a hugetlb pool
+    ArenaConfig huge;
+    huge.initial_size = 1;
+    MemoryArena huge_arena(huge);
+    CHECK(huge_arena.bytes_mapped() == HUGE_PAGE_SIZE);
+    CHECK(huge_arena.allocate(64) != nullptr);
+}
+
+void test_bbo_tracker() {
+    SymbolRegistry registry(16);
+    MessageParser parser;
+    parser.set_symbol_registry(&registry);
+    BboTracker tracker(16);
+    std::vector<BboEvent> seen;
+    tracker.subscribe([&](const BboEvent& event) { seen.push_back(event); });
+
+    std::vector<MarketMessage> messages(6);
+    std::string frames[] = {
+        "{\"type\":\"quote\",\"symbol\":\"AAPL\",\"bid\":10,\"ask\":11,\"bid_size\":5,\"ask_size\":7}",
+        "{\"type\":\"quote\",\"symbol\":\"AAPL\",\"bid\":10,\"ask\":11,\"bid_size\":5,\"ask_size\":7}",
+        "{\"type\":\"quote\",\"symbol\":\"AAPL\",\"bid\":10,\"ask\":11,\"bid_size\":5,\"ask_size\":9}",
+        "{\"type\":\"trade\",\"symbol\":\"AAPL\",\"side\":\"sell\",\"price\":10,\"size\":2}",
+        "{\"type\":\"quote\",\"symbol\":\"MSFT\",\"side\":\"buy\",\"price\":20,\"size\":1}",
+        "{\"type\":\"order\",\"symbol\":\"MSFT\",\"side\":\"buy\",\"price\":19,\"size\":1,\"order_id\":3}",
+    };
+    for (size_t i = 0; i < messages.size(); ++i) {
+        CHECK(parse(parser, frames[i], messages[i]) == ParseResult::SUCCESS);
+    }
+
+    BboEvent events[6];
+    CHECK(tracker.apply(messages.data(), messages.size(), events) == 4);
+    CHECK(seen.size() == 4 && tracker.quotes_suppressed() == 1 && tracker.messages_applied() == 6);
+    uint32_t aapl = registry.find("AAPL");
+    CHECK(events[0].type == BboEventType::QUOTE && events[0].symbol_id == aapl);
+    CHECK(events[0].changed == (BBO_BID_PRICE | BBO_BID_SIZE | BBO_ASK_PRICE | BBO_ASK_SIZE));
+    CHECK(events[1].changed == BBO_ASK_SIZE && events[1].bbo.ask_size == 9 && events[1].bbo.bid_size == 5);
+    CHECK(events[2].type == BboEventType::TRADE && events[2].trade_size == 2 && events[2].trade_side == Side::SELL);
+    CHECK(events[2].bbo.ask_size == 9);  // Trades carry the BBO unchanged
+    // One-sided quotes update only their side
+    CHECK(events[3].symbol_id == registry.find("MSFT") && events[3].changed == (BBO_BID_PRICE | BBO_BID_SIZE));
+    CHECK(events[3].bbo.bid_size == 1 && events[3].bbo.ask_size == 0);
+
+    const BboState* state = tracker.state(aapl);
+    CHECK(state && state->quote_changes == 2 && state->last_trade_size == 2);
+    CHECK(std::fabs(price_to_double(state->bbo.ask_price, DEFAULT_TICK_UNITS) - 11.0) < 1e-9);
+    CHECK(tracker.state(16) == nullptr);
+
+    MarketMessage untracked = messages[0];
+    untracked.symbol_id = INVALID_SYMBOL_ID;
+    CHECK(!tracker.apply(untracked));
+    tracker.clear();
+    CHECK(tracker.state(aapl)->quote_changes == 0);
+    CHECK(tracker.apply(messages[1]));  // Cleared state makes the quote new again
+}
+
+} // namespace
+
+int main() {
+    test_fix_parsing();
+    test_fix_schema();
+    test_json_parsing();
+    test_protocol_detection();
+    test_numeric_parsing();
+    test_symbol_registry();
+    test_stream_framer();
+    test_parse_batch();
+    test_simd_scanners();
+    test_spsc_queue();
+    test_replay_engine();
+    test_feed_handler();
+    test_capture_file();
+    test_tsc_clock();
+    test_memory_arena();
+    test_bbo_tracker();
+
+    if (g_failures > 0) {
+        std::fprintf(stderr, "%d check(s) failed\n", g_failures);
+        return 1;
+    }
+    std::printf("All ingestion tests passed\n");
+    return 0;
+}
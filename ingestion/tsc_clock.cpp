@@ -0,0 +1,101 @@
+#include "tsc_clock.hpp"
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <thread>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <cpuid.h>
+#endif
+
+namespace hft {
+namespace ingestion {
+
+namespace {
+
+constexpr int CALIBRATION_SAMPLES = 5;
+constexpr double MIN_COUNTER_HZ = 1e6;
+constexpr double MAX_COUNTER_HZ = 1e11;
+
+// A (counter, realtime) pair taken as close together as possible: the
+// tightest of several counter readings bracketing a clock_gettime call
+void sample_pair(uint64_t& ticks, uint64_t& ns) {
+    uint64_t best_gap = UINT64_MAX;
+    for (int i = 0; i < CALIBRATION_SAMPLES; ++i) {
+        uint64_t before = TscClock::read_counter();
+        uint64_t now = TscClock::system_now_ns();
+        uint64_t after = TscClock::read_counter();
+        if (after - before < best_gap) {
+            best_gap = after - before;
+            ticks = before + (after - before) / 2;
+            ns = now;
+        }
+    }
+}
+
+bool counter_disabled_by_env() {
+    const char* value = std::getenv("HFT_DISABLE_TSC");
+    return value && std::strcmp(value, "0") != 0 && value[0] != '\0';
+}
+
+} // namespace
+
+const TscClock& TscClock::instance() {
+    static const TscClock clock;
+    return clock;
+}
+
+TscClock::TscClock(uint32_t calibration_ms)
+    : use_counter_(false), base_ticks_(0), base_ns_(0), mult_(0), counter_hz_(0.0) {
+    if (!invariant_counter_supported() || counter_disabled_by_env()) {
+        return;
+    }
+
+    uint64_t start_ticks = 0, start_ns = 0, end_ticks = 0, end_ns = 0;
+    sample_pair(start_ticks, start_ns);
+    std::this_thread::sleep_for(std::chrono::milliseconds(calibration_ms));
+    sample_pair(end_ticks, end_ns);
+
+    if (end_ticks <= start_ticks || end_ns <= start_ns) {
+        return;
+    }
+    double hz = static_cast<double>(end_ticks - start_ticks) * 1e9 / static_cast<double>(end_ns - start_ns);
+    if (hz < MIN_COUNTER_HZ || hz > MAX_COUNTER_HZ) {
+        return;  // Implausible rate, e.g. a clock step during calibration
+    }
+
+    counter_hz_ = hz;
+    mult_ = static_cast<uint64_t>(1e9 / hz * static_cast<double>(1ULL << SHIFT) + 0.5);
+    base_ticks_ = end_ticks;
+    base_ns_ = end_ns;
+    use_counter_ = true;
+}
+
+uint64_t TscClock::system_now_ns() {
+    struct timespec ts;
+    clock_gettime(CLOCK_REALTIME, &ts);
+    return static_cast<uint64_t>(ts.tv_sec) * 1000000000ULL + static_cast<uint64_t>(ts.tv_nsec);
+}
+
+bool TscClock::invariant_counter_supported() {
+#if defined(__x86_64__) || defined(__i386__)
+    unsigned int eax, ebx, ecx, edx;
+    if (!__get_cpuid(0x80000000, &eax, &ebx, &ecx, &edx) || eax < 0x80000007) {
+        return false;
+    }
+    // Invariant TSC: CPUID.80000007H:EDX[8]
+    __get_cpuid(0x80000007, &eax, &ebx, &ecx, &edx);
+    bool invariant = (edx & (1u << 8)) != 0;
+    // RDTSCP: CPUID.80000001H:EDX[27]
+    __get_cpuid(0x80000001, &eax, &ebx, &ecx, &edx);
+    return invariant && (edx & (1u << 27)) != 0;
+#elif defined(__aarch64__)
+    return true;  // The generic timer runs at a fixed frequency by specification
+#else
+    return false;
+#endif
+}
+
+} // namespace ingestion
+} // namespace hft
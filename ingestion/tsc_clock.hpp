@@ -0,0 +1,80 @@
+#pragma once
+
+#include <cstdint>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+namespace hft {
+namespace ingestion {
+
+// Epoch-nanosecond timestamps from the CPU's cycle counter.
+//
+// At startup the counter is calibrated against CLOCK_REALTIME; after that a
+// timestamp is one rdtscp (or CNTVCT_EL0 read on ARM) plus a multiply-shift,
+// with no vDSO call. The TSC is only used when CPUID reports it invariant
+// (constant rate across P/C-states); otherwise, on other architectures, or
+// with HFT_DISABLE_TSC=1 in the environment, now_ns() falls back to
+// clock_gettime(CLOCK_REALTIME).
+//
+// The conversion is fixed at calibration, so long-running processes drift
+// by the calibration error (typically well under 1 ppm over the window).
+class TscClock {
+public:
+    static constexpr uint32_t DEFAULT_CALIBRATION_MS = 20;
+
+    // Process-wide clock, calibrated on first use
+    static const TscClock& instance();
+
+    explicit TscClock(uint32_t calibration_ms = DEFAULT_CALIBRATION_MS);
+
+    uint64_t now_ns() const { return to_epoch_ns(ticks()); }
+
+    // Raw readings for intervals and deferred stamping: counter ticks when
+    // calibrated, otherwise CLOCK_REALTIME nanoseconds
+    uint64_t ticks() const { return use_counter_ ? read_counter() : system_now_ns(); }
+
+    uint64_t ticks_to_ns(uint64_t ticks) const {
+        if (!use_counter_) {
+            return ticks;
+        }
+        return static_cast<uint64_t>((static_cast<unsigned __int128>(ticks) * mult_) >> SHIFT);
+    }
+
+    uint64_t to_epoch_ns(uint64_t ticks) const {
+        return use_counter_ ? base_ns_ + ticks_to_ns(ticks - base_ticks_) : ticks;
+    }
+
+    // Raw cycle counter, ordered after preceding instructions
+    static uint64_t read_counter() {
+#if defined(__x86_64__) || defined(__i386__)
+        unsigned int aux;
+        return __rdtscp(&aux);
+#elif defined(__aarch64__)
+        uint64_t value;
+        asm volatile("isb; mrs %0, cntvct_el0" : "=r"(value));
+        return value;
+#else
+        return 0;
+#endif
+    }
+
+    static uint64_t system_now_ns();
+    static bool invariant_counter_supported();
+
+    bool using_counter() const { return use_counter_; }
+    double counter_hz() const { return counter_hz_; }
+
+private:
+    static constexpr uint32_t SHIFT = 32;
+
+    bool use_counter_;
+    uint64_t base_ticks_;
+    uint64_t base_ns_;
+    uint64_t mult_;  // Nanoseconds per tick in 32.32 fixed point
+    double counter_hz_;
+};
+
+} // namespace ingestion
+} // namespace hft
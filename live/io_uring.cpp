@@ -0,0 +1,184 @@
+#include "io_uring.hpp"
+#include "spsc_queue.hpp"
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstring>
+
+namespace hft {
+namespace live {
+
+namespace {
+
+int io_uring_setup(unsigned entries, io_uring_params* params) {
+    return static_cast<int>(::syscall(__NR_io_uring_setup, entries, params));
+}
+
+int io_uring_enter(int fd, unsigned to_submit, unsigned min_complete, unsigned flags) {
+    return static_cast<int>(::syscall(__NR_io_uring_enter, fd, to_submit, min_complete, flags, nullptr, 0));
+}
+
+template <typename T>
+T* ring_field(void* ring, uint32_t offset) {
+    return reinterpret_cast<T*>(static_cast<char*>(ring) + offset);
+}
+
+} // namespace
+
+IoUring::IoUring()
+    : fd_(-1), sqpoll_(false), sq_ring_(nullptr), sq_ring_size_(0), cq_ring_(nullptr), cq_ring_size_(0),
+      sqes_(nullptr), sqes_size_(0), sq_head_(nullptr), sq_tail_(nullptr), sq_flags_(nullptr),
+      sq_array_(nullptr), sq_mask_(0), sq_entries_(0), sq_local_tail_(0), cq_head_(nullptr),
+      cq_tail_(nullptr), cq_mask_(0), cqes_(nullptr) {}
+
+IoUring::~IoUring() {
+    destroy();
+}
+
+bool IoUring::init(unsigned entries, bool sqpoll) {
+    if (ready()) {
+        return false;
+    }
+    io_uring_params params;
+    std::memset(&params, 0, sizeof(params));
+    if (sqpoll) {
+        params.flags |= IORING_SETUP_SQPOLL;
+        params.sq_thread_idle = SQPOLL_IDLE_MS;
+    }
+    int fd = io_uring_setup(entries, &params);
+    if (fd < 0) {
+        return false;
+    }
+    fd_ = fd;
+    sqpoll_ = sqpoll;
+
+    sq_ring_size_ = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+    cq_ring_size_ = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+    bool single_mmap = params.features & IORING_FEAT_SINGLE_MMAP;
+    if (single_mmap) {
+        sq_ring_size_ = cq_ring_size_ = sq_ring_size_ > cq_ring_size_ ? sq_ring_size_ : cq_ring_size_;
+    }
+    sq_ring_ = ::mmap(nullptr, sq_ring_size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd,
+                      IORING_OFF_SQ_RING);
+    if (sq_ring_ == MAP_FAILED) {
+        sq_ring_ = nullptr;
+        destroy();
+        return false;
+    }
+    cq_ring_ = single_mmap ? sq_ring_
+                           : ::mmap(nullptr, cq_ring_size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                                    fd, IORING_OFF_CQ_RING);
+    if (cq_ring_ == MAP_FAILED) {
+        cq_ring_ = nullptr;
+        destroy();
+        return false;
+    }
+    sqes_size_ = params.sq_entries * sizeof(io_uring_sqe);
+    void* sqes = ::mmap(nullptr, sqes_size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd,
+                        IORING_OFF_SQES);
+    if (sqes == MAP_FAILED) {
+        destroy();
+        return false;
+    }
+    sqes_ = static_cast<io_uring_sqe*>(sqes);
+
+    sq_head_ = ring_field<unsigned>(sq_ring_, params.sq_off.head);
+    sq_tail_ = ring_field<unsigned>(sq_ring_, params.sq_off.tail);
+    sq_flags_ = ring_field<unsigned>(sq_ring_, params.sq_off.flags);
+    sq_array_ = ring_field<unsigned>(sq_ring_, params.sq_off.array);
+    sq_mask_ = *ring_field<unsigned>(sq_ring_, params.sq_off.ring_mask);
+    sq_entries_ = params.sq_entries;
+    sq_local_tail_ = *sq_tail_;
+    cq_head_ = ring_field<unsigned>(cq_ring_, params.cq_off.head);
+    cq_tail_ = ring_field<unsigned>(cq_ring_, params.cq_off.tail);
+    cq_mask_ = *ring_field<unsigned>(cq_ring_, params.cq_off.ring_mask);
+    cqes_ = ring_field<io_uring_cqe>(cq_ring_, params.cq_off.cqes);
+    return true;
+}
+
+void IoUring::destroy() {
+    if (sqes_) {
+        ::munmap(sqes_, sqes_size_);
+        sqes_ = nullptr;
+    }
+    if (cq_ring_ && cq_ring_ != sq_ring_) {
+        ::munmap(cq_ring_, cq_ring_size_);
+    }
+    cq_ring_ = nullptr;
+    if (sq_ring_) {
+        ::munmap(sq_ring_, sq_ring_size_);
+        sq_ring_ = nullptr;
+    }
+    if (fd_ >= 0) {
+        ::close(fd_);
+        fd_ = -1;
+    }
+}
+
+io_uring_sqe* IoUring::next_sqe() {
+    unsigned head = __atomic_load_n(sq_head_, __ATOMIC_ACQUIRE);
+    if (sq_local_tail_ - head >= sq_entries_) {
+        return nullptr;
+    }
+    unsigned index = sq_local_tail_ & sq_mask_;
+    sq_array_[index] = index;
+    sq_local_tail_++;
+    std::memset(&sqes_[index], 0, sizeof(io_uring_sqe));
+    return &sqes_[index];
+}
+
+unsigned IoUring::cq_ready() const {
+    return __atomic_load_n(cq_tail_, __ATOMIC_ACQUIRE) - *cq_head_;
+}
+
+bool IoUring::submit(unsigned wait_for) {
+    unsigned to_submit = sq_local_tail_ - *sq_tail_;
+    __atomic_store_n(sq_tail_, sq_local_tail_, __ATOMIC_RELEASE);
+
+    if (!sqpoll_) {
+        unsigned flags = wait_for ? IORING_ENTER_GETEVENTS : 0;
+        while (to_submit > 0 || cq_ready() < wait_for) {
+            int submitted = io_uring_enter(fd_, to_submit, wait_for, flags);
+            if (submitted < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                return false;
+            }
+            unsigned done = static_cast<unsigned>(submitted);
+            to_submit = done < to_submit ? to_submit - done : 0;
+        }
+        return true;
+    }
+
+    // The kernel thread parks after SQPOLL_IDLE_MS without work and must be woken
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (to_submit > 0 && (__atomic_load_n(sq_flags_, __ATOMIC_RELAXED) & IORING_SQ_NEED_WAKEUP)) {
+        if (io_uring_enter(fd_, 0, 0, IORING_ENTER_SQ_WAKEUP) < 0 && errno != EINTR) {
+            return false;
+        }
+    }
+    for (uint32_t spin = 0; spin < SPIN_LIMIT && cq_ready() < wait_for; ++spin) {
+        ingestion::cpu_relax();
+    }
+    while (cq_ready() < wait_for) {
+        if (io_uring_enter(fd_, 0, wait_for, IORING_ENTER_GETEVENTS) < 0 && errno != EINTR) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool IoUring::pop_cqe(io_uring_cqe& cqe) {
+    unsigned head = *cq_head_;
+    if (head == __atomic_load_n(cq_tail_, __ATOMIC_ACQUIRE)) {
+        return false;
+    }
+    cqe = cqes_[head & cq_mask_];
+    __atomic_store_n(cq_head_, head + 1, __ATOMIC_RELEASE);
+    return true;
+}
+
+} // namespace live
+} // namespace hft
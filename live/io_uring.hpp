@@ -0,0 +1,71 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <linux/io_uring.h>
+
+namespace hft {
+namespace live {
+
+// Minimal io_uring over the raw syscalls, so liburing is not a dependency.
+// Only what the receivers need: queue SQEs, submit, and reap CQEs.
+//
+// With SQPOLL a kernel thread picks submissions up from the shared ring, and
+// completions are polled in user space, so a receive needs no syscall at
+// all while traffic flows; waits fall back to io_uring_enter after a short
+// spin, as SpscQueue does with its futex.
+class IoUring {
+public:
+    static constexpr uint32_t SPIN_LIMIT = 1024;       // CQ polls before blocking in the kernel
+    static constexpr uint32_t SQPOLL_IDLE_MS = 1000;   // Kernel thread sleeps after this long idle
+
+    IoUring();
+    ~IoUring();
+
+    IoUring(const IoUring&) = delete;
+    IoUring& operator=(const IoUring&) = delete;
+
+    // False when the kernel lacks io_uring or it is blocked (seccomp, sysctl)
+    bool init(unsigned entries, bool sqpoll = false);
+    void destroy();
+
+    bool ready() const { return fd_ >= 0; }
+    bool sqpoll() const { return sqpoll_; }
+
+    // Zeroed SQE to fill in, nullptr if the submission ring is full
+    io_uring_sqe* next_sqe();
+
+    // Publishes the queued SQEs and waits until at least wait_for completions
+    // are available. Returns false on error.
+    bool submit(unsigned wait_for);
+
+    // Copies out and consumes the next completion, if any
+    bool pop_cqe(io_uring_cqe& cqe);
+
+private:
+    unsigned cq_ready() const;
+
+    int fd_;
+    bool sqpoll_;
+    void* sq_ring_;
+    size_t sq_ring_size_;
+    void* cq_ring_;  // Same mapping as sq_ring_ with IORING_FEAT_SINGLE_MMAP
+    size_t cq_ring_size_;
+    io_uring_sqe* sqes_;
+    size_t sqes_size_;
+
+    unsigned* sq_head_;
+    unsigned* sq_tail_;
+    unsigned* sq_flags_;
+    unsigned* sq_array_;
+    unsigned sq_mask_;
+    unsigned sq_entries_;
+    unsigned sq_local_tail_;   // Queued but not yet published
+    unsigned* cq_head_;
+    unsigned* cq_tail_;
+    unsigned cq_mask_;
+    io_uring_cqe* cqes_;
+};
+
+} // namespace live
+} // namespace hft
@@ -0,0 +1,54 @@
+#include "socket_timestamps.hpp"
+#include <linux/net_tstamp.h>
+#include <linux/sockios.h>
+#include <net/if.h>
+#include <sys/ioctl.h>
+#include <cstring>
+
+namespace hft {
+namespace live {
+
+namespace {
+
+uint64_t timespec_ns(const timespec& ts) {
+    return static_cast<uint64_t>(ts.tv_sec) * 1000000000ULL + static_cast<uint64_t>(ts.tv_nsec);
+}
+
+} // namespace
+
+bool enable_rx_timestamps(int fd) {
+    int flags = SOF_TIMESTAMPING_RX_HARDWARE | SOF_TIMESTAMPING_RAW_HARDWARE |
+                SOF_TIMESTAMPING_RX_SOFTWARE | SOF_TIMESTAMPING_SOFTWARE;
+    return ::setsockopt(fd, SOL_SOCKET, SO_TIMESTAMPING, &flags, sizeof(flags)) == 0;
+}
+
+bool enable_nic_rx_timestamping(int fd, const std::string& device) {
+    if (device.empty() || device.size() >= IFNAMSIZ) {
+        return false;
+    }
+    hwtstamp_config config{};
+    config.tx_type = HWTSTAMP_TX_OFF;
+    config.rx_filter = HWTSTAMP_FILTER_ALL;
+    ifreq request{};
+    std::memcpy(request.ifr_name, device.c_str(), device.size());
+    request.ifr_data = reinterpret_cast<char*>(&config);
+    return ::ioctl(fd, SIOCSHWTSTAMP, &request) == 0;
+}
+
+uint64_t rx_timestamp(const msghdr& message) {
+    for (const cmsghdr* cmsg = CMSG_FIRSTHDR(&message); cmsg;
+         cmsg = CMSG_NXTHDR(const_cast<msghdr*>(&message), const_cast<cmsghdr*>(cmsg))) {
+        if (cmsg->cmsg_level != SOL_SOCKET || cmsg->cmsg_type != SCM_TIMESTAMPING) {
+            continue;
+        }
+        scm_timestamping stamps;
+        std::memcpy(&stamps, CMSG_DATA(cmsg), sizeof(stamps));
+        // ts[2] is the raw hardware stamp, ts[0] the software one
+        uint64_t hardware = timespec_ns(stamps.ts[2]);
+        return hardware != 0 ? hardware : timespec_ns(stamps.ts[0]);
+    }
+    return 0;
+}
+
+} // namespace live
+} // namespace hft
@@ -0,0 +1,37 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <ctime>
+#include <string>
+#include <sys/socket.h>
+#include <linux/errqueue.h>  // After <ctime>: scm_timestamping needs struct timespec
+
+namespace hft {
+namespace live {
+
+// SO_TIMESTAMPING receive timestamps, shared by the UDP and TCP receivers.
+//
+// The kernel attaches an SCM_TIMESTAMPING control message to each receive:
+// the NIC's raw hardware timestamp when the device has RX timestamping
+// enabled, otherwise the software timestamp taken when the packet entered
+// the stack. Either way it is earlier and steadier than stamping after the
+// syscall returns. Hardware timestamps are in the NIC clock's domain; run
+// phc2sys so that domain is CLOCK_REALTIME.
+
+// Control buffer large enough for one SCM_TIMESTAMPING message
+constexpr size_t RX_TIMESTAMP_CONTROL_SIZE = CMSG_SPACE(sizeof(scm_timestamping));
+
+// Requests hardware and software receive timestamps on a socket
+bool enable_rx_timestamps(int fd);
+
+// Turns on RX hardware timestamping for all packets on a NIC (SIOCSHWTSTAMP,
+// needs CAP_NET_ADMIN). Without it only software timestamps are reported.
+bool enable_nic_rx_timestamping(int fd, const std::string& device);
+
+// Epoch ns from a received message's control data, preferring the hardware
+// stamp; 0 when there is none
+uint64_t rx_timestamp(const msghdr& message);
+
+} // namespace live
+} // namespace hft
@@ -0,0 +1,183 @@
+#include "tcp_receiver.hpp"
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/time.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstring>
+
+namespace hft {
+namespace live {
+
+namespace {
+
+constexpr unsigned RING_ENTRIES = 4;   // One RECVMSG and its linked timeout in flight
+constexpr uint64_t RECV_TAG = 1;
+constexpr uint64_t TIMEOUT_TAG = 2;
+
+} // namespace
+
+TcpReceiver::TcpReceiver(const TcpReceiverConfig& config)
+    : config_(config), fd_(-1), backend_(config.backend), message_(), iov_(), timeout_(), control_() {}
+
+TcpReceiver::~TcpReceiver() {
+    close();
+}
+
+bool TcpReceiver::connect() {
+    if (is_open()) {
+        return false;
+    }
+    sockaddr_in address{};
+    address.sin_family = AF_INET;
+    address.sin_port = htons(config_.port);
+    if (::inet_pton(AF_INET, config_.host.c_str(), &address.sin_addr) != 1) {
+        return false;
+    }
+    int fd = ::socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (fd < 0) {
+        return false;
+    }
+    // Buffer size must be set before connecting for the window to scale
+    ::setsockopt(fd, SOL_SOCKET, SO_RCVBUF, &config_.socket_buffer_bytes, sizeof(config_.socket_buffer_bytes));
+    if (::connect(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0) {
+        ::close(fd);
+        return false;
+    }
+    return adopt(fd);
+}
+
+bool TcpReceiver::adopt(int fd) {
+    if (is_open() || fd < 0) {
+        return false;
+    }
+    if (!setup_socket(fd)) {
+        ::close(fd);
+        return false;
+    }
+    fd_ = fd;
+    return true;
+}
+
+bool TcpReceiver::setup_socket(int fd) {
+    if (config_.timestamps) {
+        if (!config_.device.empty()) {
+            enable_nic_rx_timestamping(fd, config_.device);  // Falls back to software stamps
+        }
+        enable_rx_timestamps(fd);
+    }
+    timeout_.tv_sec = config_.timeout_ms / 1000;
+    timeout_.tv_nsec = static_cast<long long>(config_.timeout_ms % 1000) * 1000000;
+
+    backend_ = config_.backend;
+    if (backend_ != TcpBackend::SYSCALL) {
+        if (ring_.init(RING_ENTRIES, config_.sqpoll)) {
+            backend_ = TcpBackend::IO_URING;
+            return true;
+        }
+        if (backend_ == TcpBackend::IO_URING) {
+            return false;
+        }
+        backend_ = TcpBackend::SYSCALL;
+    }
+    timeval timeout{config_.timeout_ms / 1000, (config_.timeout_ms % 1000) * 1000};
+    return ::setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout)) == 0;
+}
+
+void TcpReceiver::close() {
+    ring_.destroy();
+    if (fd_ >= 0) {
+        ::close(fd_);
+        fd_ = -1;
+    }
+}
+
+void TcpReceiver::prepare_message(char* buffer, size_t capacity) {
+    iov_.iov_base = buffer;
+    iov_.iov_len = capacity;
+    std::memset(&message_, 0, sizeof(message_));
+    message_.msg_iov = &iov_;
+    message_.msg_iovlen = 1;
+    if (config_.timestamps) {
+        message_.msg_control = control_;
+        message_.msg_controllen = sizeof(control_);
+    }
+}
+
+ssize_t TcpReceiver::receive(char* buffer, size_t capacity, uint64_t& receive_timestamp) {
+    if (!is_open()) {
+        return -1;
+    }
+    if (capacity == 0) {
+        return 0;
+    }
+    return backend_ == TcpBackend::IO_URING ? receive_uring(buffer, capacity, receive_timestamp)
+                                            : receive_syscall(buffer, capacity, receive_timestamp);
+}
+
+ssize_t TcpReceiver::receive_syscall(char* buffer, size_t capacity, uint64_t& receive_timestamp) {
+    prepare_message(buffer, capacity);
+    ssize_t received = ::recvmsg(fd_, &message_, 0);
+    if (received < 0) {
+        return errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR ? 0 : -1;
+    }
+    if (received == 0) {
+        return -1;  // Peer closed
+    }
+    if (config_.timestamps) {
+        receive_timestamp = rx_timestamp(message_);
+    }
+    return received;
+}
+
+ssize_t TcpReceiver::receive_uring(char* buffer, size_t capacity, uint64_t& receive_timestamp) {
+    prepare_message(buffer, capacity);
+    io_uring_sqe* recv = ring_.next_sqe();
+    io_uring_sqe* timeout = recv ? ring_.next_sqe() : nullptr;
+    if (!timeout) {
+        return -1;
+    }
+    recv->opcode = IORING_OP_RECVMSG;
+    recv->fd = fd_;
+    recv->addr = reinterpret_cast<uint64_t>(&message_);
+    recv->len = 1;
+    recv->flags = IOSQE_IO_LINK;
+    recv->user_data = RECV_TAG;
+    timeout->opcode = IORING_OP_LINK_TIMEOUT;
+    timeout->fd = -1;
+    timeout->addr = reinterpret_cast<uint64_t>(&timeout_);
+    timeout->len = 1;
+    timeout->user_data = TIMEOUT_TAG;
+
+    // Both complete together: the receive cancels the timeout or vice versa
+    if (!ring_.submit(2)) {
+        return -1;
+    }
+    int32_t result = -ECANCELED;
+    io_uring_cqe cqe;
+    for (int reaped = 0; reaped < 2 && ring_.pop_cqe(cqe); ++reaped) {
+        if (cqe.user_data == RECV_TAG) {
+            result = cqe.res;
+        }
+    }
+
+    if (result > 0) {
+        if (config_.timestamps) {
+            receive_timestamp = rx_timestamp(message_);
+        }
+        return result;
+    }
+    if (result == -ECANCELED || result == -EINTR || result == -EAGAIN) {
+        return 0;  // Timed out
+    }
+    return -1;  // Peer closed (0) or socket error
+}
+
+ingestion::FeedSource TcpReceiver::source() {
+    return [this](char* buffer, size_t capacity, uint64_t& receive_timestamp) {
+        return receive(buffer, capacity, receive_timestamp);
+    };
+}
+
+} // namespace live
+} // namespace hft
@@ -0,0 +1,89 @@
+#pragma once
+
+#include "feed_handler.hpp"
+#include "io_uring.hpp"
+#include "socket_timestamps.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <linux/time_types.h>
+#include <string>
+#include <sys/socket.h>
+#include <sys/uio.h>
+
+namespace hft {
+namespace live {
+
+enum class TcpBackend : uint8_t {
+    AUTO = 0,      // io_uring when the kernel allows it, else SYSCALL
+    IO_URING = 1,
+    SYSCALL = 2    // recvmsg with SO_RCVTIMEO
+};
+
+struct TcpReceiverConfig {
+    std::string host = "127.0.0.1";
+    uint16_t port = 0;
+    TcpBackend backend = TcpBackend::AUTO;
+    bool sqpoll = false;               // io_uring only: kernel-side submission polling, no syscall per receive
+    std::string device;                // NIC to enable hardware RX timestamps on, empty = software only
+    int socket_buffer_bytes = 8 << 20; // SO_RCVBUF
+    int timeout_ms = 100;              // Longest receive() blocks, so stop requests are noticed
+    bool timestamps = true;            // SO_TIMESTAMPING receive timestamps
+};
+
+// TCP feed receive straight into the caller's buffer.
+//
+// receive() matches FeedSource, so the feed thread passes the StreamFramer's
+// write_ptr() and the kernel copies socket data directly into the framer:
+// no intermediate buffer. With the io_uring backend each receive is a
+// RECVMSG linked to a timeout, submitted and reaped through the shared
+// rings; with sqpoll the submission side needs no syscall either.
+//
+//   TcpReceiver receiver(config);
+//   receiver.connect();
+//   feed.source = receiver.source();
+class TcpReceiver {
+public:
+    explicit TcpReceiver(const TcpReceiverConfig& config = TcpReceiverConfig());
+    ~TcpReceiver();
+
+    TcpReceiver(const TcpReceiver&) = delete;
+    TcpReceiver& operator=(const TcpReceiver&) = delete;
+
+    bool connect();
+
+    // Takes ownership of an already connected socket
+    bool adopt(int fd);
+
+    void close();
+
+    bool is_open() const { return fd_ >= 0; }
+    int fd() const { return fd_; }
+    TcpBackend backend() const { return backend_; }  // The one in use once open
+
+    // Bytes received into buffer, 0 on timeout, -1 once the peer closes or
+    // the socket fails
+    ssize_t receive(char* buffer, size_t capacity, uint64_t& receive_timestamp);
+
+    // Adapter for FeedConfig::source; the receiver must outlive it
+    ingestion::FeedSource source();
+
+private:
+    bool setup_socket(int fd);
+    ssize_t receive_uring(char* buffer, size_t capacity, uint64_t& receive_timestamp);
+    ssize_t receive_syscall(char* buffer, size_t capacity, uint64_t& receive_timestamp);
+    void prepare_message(char* buffer, size_t capacity);
+
+    TcpReceiverConfig config_;
+    int fd_;
+    TcpBackend backend_;
+    IoUring ring_;
+
+    // Stay valid while a submitted RECVMSG is in flight
+    msghdr message_;
+    iovec iov_;
+    __kernel_timespec timeout_;
+    alignas(cmsghdr) char control_[RX_TIMESTAMP_CONTROL_SIZE];
+};
+
+} // namespace live
+} // namespace hft
@@ -0,0 +1,146 @@
+#include "udp_receiver.hpp"
+#include "socket_timestamps.hpp"
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/time.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstring>
+
+namespace hft {
+namespace live {
+
+UdpReceiver::UdpReceiver(const UdpReceiverConfig& config)
+    : config_(config), fd_(-1), port_(0), datagrams_(0), truncated_(0) {
+    if (config_.batch_size == 0) {
+        config_.batch_size = UdpReceiverConfig().batch_size;
+    }
+    if (config_.datagram_size == 0) {
+        config_.datagram_size = UdpReceiverConfig().datagram_size;
+    }
+}
+
+UdpReceiver::~UdpReceiver() {
+    close();
+}
+
+bool UdpReceiver::open() {
+    if (is_open()) {
+        return false;
+    }
+    sockaddr_in address{};
+    address.sin_family = AF_INET;
+    address.sin_port = htons(config_.port);
+    in_addr interface{};
+    if (::inet_pton(AF_INET, config_.group.c_str(), &address.sin_addr) != 1 ||
+        ::inet_pton(AF_INET, config_.interface_address.c_str(), &interface) != 1) {
+        return false;
+    }
+    bool multicast = IN_MULTICAST(ntohl(address.sin_addr.s_addr));
+
+    int fd = ::socket(AF_INET, SOCK_DGRAM | SOCK_CLOEXEC, 0);
+    if (fd < 0) {
+        return false;
+    }
+    int reuse = 1;
+    ::setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+    // Best effort: the kernel caps this at net.core.rmem_max
+    ::setsockopt(fd, SOL_SOCKET, SO_RCVBUF, &config_.socket_buffer_bytes, sizeof(config_.socket_buffer_bytes));
+    timeval timeout{config_.timeout_ms / 1000, (config_.timeout_ms % 1000) * 1000};
+    ::setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+    if (config_.timestamps) {
+        if (!config_.device.empty()) {
+            enable_nic_rx_timestamping(fd, config_.device);  // Falls back to software stamps
+        }
+        enable_rx_timestamps(fd);
+    }
+
+    // Binding the group address filters out other groups on the same port
+    socklen_t address_length = sizeof(address);
+    bool ok = ::bind(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) == 0;
+    if (ok && multicast) {
+        ip_mreq membership{};
+        membership.imr_multiaddr = address.sin_addr;
+        membership.imr_interface = interface;
+        ok = ::setsockopt(fd, IPPROTO_IP, IP_ADD_MEMBERSHIP, &membership, sizeof(membership)) == 0;
+    }
+    ok = ok && ::getsockname(fd, reinterpret_cast<sockaddr*>(&address), &address_length) == 0;
+    if (!ok) {
+        ::close(fd);
+        return false;
+    }
+
+    fd_ = fd;
+    port_ = ntohs(address.sin_port);
+    return true;
+}
+
+void UdpReceiver::allocate_slots() {
+    // One slot and one control buffer per datagram in the batch
+    size_t batch = config_.batch_size;
+    slots_.reset(new char[batch * config_.datagram_size]);
+    control_.reset(new char[batch * RX_TIMESTAMP_CONTROL_SIZE]);
+    iovecs_.assign(batch, iovec{});
+    headers_.assign(batch, mmsghdr{});
+    for (size_t i = 0; i < batch; ++i) {
+        iovecs_[i].iov_base = slots_.get() + i * config_.datagram_size;
+        iovecs_[i].iov_len = config_.datagram_size;
+    }
+}
+
+void UdpReceiver::close() {
+    if (fd_ >= 0) {
+        ::close(fd_);
+        fd_ = -1;
+    }
+}
+
+ssize_t UdpReceiver::receive(ingestion::Datagram* datagrams, size_t max) {
+    if (!is_open()) {
+        return -1;
+    }
+    if (!slots_) {
+        allocate_slots();  // On the first call, i.e. on the (pinned) feed thread
+    }
+    size_t batch = max < headers_.size() ? max : headers_.size();
+    for (size_t i = 0; i < batch; ++i) {
+        // recvmmsg overwrites the lengths, so reset them for every call
+        msghdr& header = headers_[i].msg_hdr;
+        header.msg_name = nullptr;
+        header.msg_namelen = 0;
+        header.msg_iov = &iovecs_[i];
+        header.msg_iovlen = 1;
+        header.msg_control = config_.timestamps ? control_.get() + i * RX_TIMESTAMP_CONTROL_SIZE : nullptr;
+        header.msg_controllen = config_.timestamps ? RX_TIMESTAMP_CONTROL_SIZE : 0;
+        header.msg_flags = 0;
+    }
+
+    // Blocks (up to SO_RCVTIMEO) for the first datagram, then takes whatever
+    // else is already queued without waiting
+    int received = ::recvmmsg(fd_, headers_.data(), static_cast<unsigned>(batch), MSG_WAITFORONE, nullptr);
+    if (received < 0) {
+        return errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR ? 0 : -1;
+    }
+
+    size_t count = 0;
+    for (int i = 0; i < received; ++i) {
+        const mmsghdr& header = headers_[i];
+        if (header.msg_hdr.msg_flags & MSG_TRUNC) {
+            truncated_++;
+            continue;
+        }
+        datagrams[count].data = static_cast<const char*>(iovecs_[i].iov_base);
+        datagrams[count].length = header.msg_len;
+        datagrams[count].receive_timestamp = config_.timestamps ? rx_timestamp(header.msg_hdr) : 0;
+        count++;
+    }
+    datagrams_ += count;
+    return static_cast<ssize_t>(count);
+}
+
+ingestion::DatagramSource UdpReceiver::source() {
+    return [this](ingestion::Datagram* datagrams, size_t max) { return receive(datagrams, max); };
+}
+
+} // namespace live
+} // namespace hft
@@ -0,0 +1,77 @@
+#pragma once
+
+#include "feed_handler.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <vector>
+
+namespace hft {
+namespace live {
+
+struct UdpReceiverConfig {
+    std::string group = "0.0.0.0";         // Multicast group to join, or a unicast address to bind
+    uint16_t port = 0;                     // 0 picks an ephemeral port
+    std::string interface_address = "0.0.0.0";  // Local interface for the multicast join
+    std::string device;                    // NIC to enable hardware RX timestamps on, empty = software only
+    size_t batch_size = 64;                // Datagrams per recvmmsg
+    size_t datagram_size = 2048;           // Slot size; longer datagrams are counted and dropped
+    int socket_buffer_bytes = 8 << 20;     // SO_RCVBUF, absorbs bursts while the feed thread parses
+    int timeout_ms = 100;                  // Longest receive() blocks, so stop requests are noticed
+    bool timestamps = true;                // SO_TIMESTAMPING receive timestamps
+};
+
+// Batched UDP (multicast) receive with recvmmsg.
+//
+// One syscall fills up to batch_size fixed slots, each with its own kernel
+// receive timestamp; receive() hands out views of the slots, which the feed
+// thread frames and parses in place. The slots are reused by the next call,
+// and allocated by the first, so they are first-touched on the feed thread.
+//
+//   UdpReceiver receiver(config);
+//   receiver.open();
+//   feed.datagram_source = receiver.source();
+class UdpReceiver {
+public:
+    explicit UdpReceiver(const UdpReceiverConfig& config = UdpReceiverConfig());
+    ~UdpReceiver();
+
+    UdpReceiver(const UdpReceiver&) = delete;
+    UdpReceiver& operator=(const UdpReceiver&) = delete;
+
+    bool open();
+    void close();
+
+    bool is_open() const { return fd_ >= 0; }
+    int fd() const { return fd_; }
+    uint16_t port() const { return port_; }  // Bound port, useful with port 0
+
+    // Up to max datagrams from a single recvmmsg; valid until the next call.
+    // Returns the count, 0 on timeout, or -1 once the socket is closed or fails.
+    ssize_t receive(ingestion::Datagram* datagrams, size_t max);
+
+    // Adapter for FeedConfig::datagram_source; the receiver must outlive it
+    ingestion::DatagramSource source();
+
+    uint64_t datagrams() const { return datagrams_; }
+    uint64_t truncated() const { return truncated_; }  // Dropped for exceeding datagram_size
+
+private:
+    void allocate_slots();
+
+    UdpReceiverConfig config_;
+    int fd_;
+    uint16_t port_;
+    std::unique_ptr<char[]> slots_;
+    std::unique_ptr<char[]> control_;
+    std::vector<iovec> iovecs_;
+    std::vector<mmsghdr> headers_;
+    uint64_t datagrams_;
+    uint64_t truncated_;
+};
+
+} // namespace live
+} // namespace hft
@@ -0,0 +1,248 @@
+#include "book_snapshot.hpp"
+#include "spsc_queue.hpp"
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cstring>
+
+namespace hft {
+namespace lob {
+
+using ingestion::Side;
+
+namespace {
+
+inline SnapshotSlotHeader* slot_header(char* slot) {
+    return reinterpret_cast<SnapshotSlotHeader*>(slot);
+}
+
+inline SnapshotLevel* slot_levels(char* slot) {
+    return reinterpret_cast<SnapshotLevel*>(slot + sizeof(SnapshotSlotHeader));
+}
+
+bool same_levels(const SnapshotLevel* published, const BookLevel* levels, uint32_t count) {
+    for (uint32_t i = 0; i < count; ++i) {
+        if (published[i].price != levels[i].price || published[i].quantity != levels[i].quantity ||
+            published[i].orders != levels[i].orders) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void write_levels(SnapshotLevel* published, const BookLevel* levels, uint32_t count, uint32_t depth) {
+    for (uint32_t i = 0; i < count; ++i) {
+        published[i] = SnapshotLevel{levels[i].price, levels[i].quantity, levels[i].orders, 0};
+    }
+    // Zero the rest so whole-array NumPy views show empty levels
+    if (count < depth) {
+        std::memset(published + count, 0, (depth - count) * sizeof(SnapshotLevel));
+    }
+}
+
+} // namespace
+
+SnapshotPublisher::SnapshotPublisher()
+    : base_(nullptr), mapped_size_(0), depth_(0), symbol_capacity_(0), slot_size_(0), updates_(0) {}
+
+SnapshotPublisher::~SnapshotPublisher() {
+    close();
+}
+
+bool SnapshotPublisher::open(const std::string& path, uint32_t symbol_capacity, uint32_t depth) {
+    close();
+    if (symbol_capacity == 0) {
+        return false;
+    }
+    depth = std::min(std::max(depth, 1u), MAX_SNAPSHOT_DEPTH);
+    size_t slot_size = snapshot_slot_size(depth);
+    size_t size = sizeof(SnapshotHeader) + static_cast<size_t>(symbol_capacity) * slot_size;
+
+    // Truncating first leaves every slot zeroed, i.e. sequence 0: never published
+    int fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (fd < 0) {
+        return false;
+    }
+    void* data = MAP_FAILED;
+    if (::ftruncate(fd, static_cast<off_t>(size)) == 0) {
+        data = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    }
+    ::close(fd);
+    if (data == MAP_FAILED) {
+        return false;
+    }
+
+    base_ = static_cast<char*>(data);
+    mapped_size_ = size;
+    depth_ = depth;
+    symbol_capacity_ = symbol_capacity;
+    slot_size_ = slot_size;
+    scratch_.assign(2 * static_cast<size_t>(depth), BookLevel{0, 0, 0});
+    updates_ = 0;
+
+    SnapshotHeader* header = reinterpret_cast<SnapshotHeader*>(base_);
+    header->version = SNAPSHOT_VERSION;
+    header->header_size = sizeof(SnapshotHeader);
+    header->depth = depth;
+    header->symbol_capacity = symbol_capacity;
+    header->slot_size = static_cast<uint32_t>(slot_size);
+    header->flags = ingestion::FIXED_POINT_PRICES ? SNAPSHOT_FLAG_FIXED_POINT : 0;
+    header->publisher_pid = static_cast<uint64_t>(::getpid());
+    // Readers reject the file until the magic appears
+    std::atomic_thread_fence(std::memory_order_release);
+    std::memcpy(header->magic, SNAPSHOT_MAGIC, sizeof(SNAPSHOT_MAGIC));
+    return true;
+}
+
+void SnapshotPublisher::close() {
+    if (base_) {
+        ::munmap(base_, mapped_size_);
+        base_ = nullptr;
+        mapped_size_ = 0;
+    }
+}
+
+bool SnapshotPublisher::publish(uint32_t symbol_id, const OrderBook& book, uint64_t timestamp) {
+    if (!base_ || symbol_id >= symbol_capacity_) {
+        return false;
+    }
+    BookLevel* bids = scratch_.data();
+    BookLevel* asks = bids + depth_;
+    uint32_t bid_count = static_cast<uint32_t>(book.depth(Side::BUY, bids, depth_));
+    uint32_t ask_count = static_cast<uint32_t>(book.depth(Side::SELL, asks, depth_));
+
+    char* target = slot(symbol_id);
+    SnapshotSlotHeader* header = slot_header(target);
+    SnapshotLevel* levels = slot_levels(target);
+
+    // This is the slot's only writer, so it can compare without the seqlock
+    uint64_t sequence = header->sequence.load(std::memory_order_relaxed);
+    if (sequence != 0 && header->bid_count == bid_count && header->ask_count == ask_count &&
+        header->tick_units == book.tick_units() && header->last_trade_price == book.last_trade_price() &&
+        header->last_trade_size == book.last_trade_size() && same_levels(levels, bids, bid_count) &&
+        same_levels(levels + depth_, asks, ask_count)) {
+        return false;
+    }
+
+    header->sequence.store(sequence + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);  // Odd sequence before any data
+    header->timestamp = timestamp;
+    header->tick_units = book.tick_units();
+    header->last_trade_price = book.last_trade_price();
+    header->last_trade_size = book.last_trade_size();
+    header->bid_count = bid_count;
+    header->ask_count = ask_count;
+    write_levels(levels, bids, bid_count, depth_);
+    write_levels(levels + depth_, asks, ask_count, depth_);
+    header->sequence.store(sequence + 2, std::memory_order_release);
+    updates_++;
+    return true;
+}
+
+size_t SnapshotPublisher::publish(const BookManager& books, const ingestion::MarketMessage* messages, size_t count) {
+    size_t published = 0;
+    for (size_t i = 0; i < count; ++i) {
+        const OrderBook* book = books.book(messages[i].symbol_id);
+        if (book && publish(messages[i].symbol_id, *book, messages[i].timestamp)) {
+            published++;
+        }
+    }
+    return published;
+}
+
+SnapshotReader::SnapshotReader() : base_(nullptr), mapped_size_(0) {}
+
+SnapshotReader::~SnapshotReader() {
+    close();
+}
+
+bool SnapshotReader::open(const std::string& path) {
+    close();
+    int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        return false;
+    }
+    struct stat st;
+    void* data = MAP_FAILED;
+    size_t size = 0;
+    if (::fstat(fd, &st) == 0 && static_cast<size_t>(st.st_size) >= sizeof(SnapshotHeader)) {
+        size = static_cast<size_t>(st.st_size);
+        data = ::mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+    }
+    ::close(fd);
+    if (data == MAP_FAILED) {
+        return false;
+    }
+
+    const SnapshotHeader* header = static_cast<const SnapshotHeader*>(data);
+    bool ok = std::memcmp(header->magic, SNAPSHOT_MAGIC, sizeof(SNAPSHOT_MAGIC)) == 0;
+    std::atomic_thread_fence(std::memory_order_acquire);  // Pairs with the publisher's magic write
+    ok = ok && header->version == SNAPSHOT_VERSION && header->header_size >= sizeof(SnapshotHeader) &&
+         header->depth >= 1 && header->depth <= MAX_SNAPSHOT_DEPTH &&
+         header->slot_size == snapshot_slot_size(header->depth) &&
+         size >= header->header_size + static_cast<size_t>(header->symbol_capacity) * header->slot_size &&
+         (header->flags & SNAPSHOT_FLAG_FIXED_POINT) == (ingestion::FIXED_POINT_PRICES ? SNAPSHOT_FLAG_FIXED_POINT : 0u);
+    if (!ok) {
+        ::munmap(data, size);
+        return false;
+    }
+    base_ = static_cast<const char*>(data);
+    mapped_size_ = size;
+    return true;
+}
+
+void SnapshotReader::close() {
+    if (base_) {
+        ::munmap(const_cast<char*>(base_), mapped_size_);
+        base_ = nullptr;
+        mapped_size_ = 0;
+    }
+}
+
+bool SnapshotReader::read(uint32_t symbol_id, BookSnapshot& snapshot, uint32_t max_retries) const {
+    if (!base_ || symbol_id >= symbol_capacity()) {
+        return false;
+    }
+    const char* source = slot(symbol_id);
+    const SnapshotSlotHeader* header = reinterpret_cast<const SnapshotSlotHeader*>(source);
+    const SnapshotLevel* levels = reinterpret_cast<const SnapshotLevel*>(source + sizeof(SnapshotSlotHeader));
+    uint32_t depth = this->depth();
+
+    for (uint32_t attempt = 0; attempt <= max_retries; ++attempt) {
+        uint64_t before = header->sequence.load(std::memory_order_acquire);
+        if (before == 0) {
+            return false;
+        }
+        if (before & 1) {
+            ingestion::cpu_relax();  // Publisher mid-write
+            continue;
+        }
+        snapshot.timestamp = header->timestamp;
+        snapshot.tick_units = header->tick_units;
+        snapshot.last_trade_price = header->last_trade_price;
+        snapshot.last_trade_size = header->last_trade_size;
+        // Counts from a torn read are discarded below, but must not overrun first
+        snapshot.bid_count = std::min(header->bid_count, depth);
+        snapshot.ask_count = std::min(header->ask_count, depth);
+        std::memcpy(snapshot.bids.data(), levels, snapshot.bid_count * sizeof(SnapshotLevel));
+        std::memcpy(snapshot.asks.data(), levels + depth, snapshot.ask_count * sizeof(SnapshotLevel));
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (header->sequence.load(std::memory_order_relaxed) == before) {
+            snapshot.sequence = before;
+            return true;
+        }
+    }
+    return false;
+}
+
+uint64_t SnapshotReader::sequence(uint32_t symbol_id) const {
+    if (!base_ || symbol_id >= symbol_capacity()) {
+        return 0;
+    }
+    return reinterpret_cast<const SnapshotSlotHeader*>(slot(symbol_id))->sequence.load(std::memory_order_acquire);
+}
+
+} // namespace lob
+} // namespace hft
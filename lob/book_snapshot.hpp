@@ -0,0 +1,167 @@
+#pragma once
+
+#include "order_book.hpp"
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace hft {
+namespace lob {
+
+// Shared-memory top-of-book snapshots, one fixed slot per symbol id.
+//
+//   [SnapshotHeader, 64 bytes]
+//   [symbol_capacity x slot]    slot_size bytes each, 64-byte aligned:
+//       SnapshotSlotHeader, depth bid levels (best first), depth ask levels
+//
+// One publisher (the book thread) rewrites a symbol's slot under that
+// slot's seqlock: the sequence is odd while a write is in progress and
+// advances by two per update. Readers in other processes copy the slot and
+// retry if the sequence was odd or changed meanwhile, so they never block
+// the publisher and never see a torn book. The file is meant for /dev/shm;
+// lob/book_snapshot.py maps it into NumPy.
+constexpr char SNAPSHOT_MAGIC[8] = {'H', 'F', 'T', 'B', 'O', 'O', 'K', '1'};
+constexpr uint32_t SNAPSHOT_VERSION = 1;
+constexpr uint32_t SNAPSHOT_FLAG_FIXED_POINT = 1u << 0;  // Built with HFT_FIXED_POINT_PRICES
+constexpr uint32_t MAX_SNAPSHOT_DEPTH = 64;
+
+struct SnapshotHeader {
+    char magic[8];               // Written last, once the file is initialized
+    uint32_t version;
+    uint32_t header_size;        // Offset of the first slot
+    uint32_t depth;              // Levels per side in every slot
+    uint32_t symbol_capacity;
+    uint32_t slot_size;
+    uint32_t flags;
+    uint64_t publisher_pid;
+    uint8_t reserved[24];
+};
+
+static_assert(sizeof(SnapshotHeader) == 64, "Slots start on a cache line");
+
+struct SnapshotLevel {
+    int64_t price;               // Ticks of tick_units
+    int64_t quantity;
+    uint32_t orders;
+    uint32_t reserved;
+};
+
+static_assert(sizeof(SnapshotLevel) == 24, "Mirrored by the NumPy dtype");
+
+struct SnapshotSlotHeader {
+    std::atomic<uint64_t> sequence;  // Odd while being written, 0 = never published
+    uint64_t timestamp;              // Event time of the update, ns since epoch
+    int64_t tick_units;              // See price.hpp
+    int64_t last_trade_price;        // Ticks
+    int32_t last_trade_size;
+    uint32_t bid_count;              // Valid levels per side, at most depth
+    uint32_t ask_count;
+    uint32_t reserved;
+};
+
+static_assert(sizeof(SnapshotSlotHeader) == 48, "Mirrored by the NumPy dtype");
+
+// Reader-side copy of one slot
+struct BookSnapshot {
+    uint64_t sequence = 0;
+    uint64_t timestamp = 0;
+    int64_t tick_units = 0;
+    int64_t last_trade_price = 0;
+    int32_t last_trade_size = 0;
+    uint32_t bid_count = 0;
+    uint32_t ask_count = 0;
+    std::array<SnapshotLevel, MAX_SNAPSHOT_DEPTH> bids;
+    std::array<SnapshotLevel, MAX_SNAPSHOT_DEPTH> asks;
+};
+
+// Slot bytes for a depth, rounded up to whole cache lines
+inline size_t snapshot_slot_size(uint32_t depth) {
+    size_t bytes = sizeof(SnapshotSlotHeader) + 2 * static_cast<size_t>(depth) * sizeof(SnapshotLevel);
+    return (bytes + 63) / 64 * 64;
+}
+
+// Single writer of a snapshot file, called from the book thread after
+// applying events. A publish whose top-N levels and last trade match the
+// slot's current contents is skipped, so deep-book churn and repeated
+// publishes of the same symbol cost a compare, not a seqlock write.
+class SnapshotPublisher {
+public:
+    static constexpr uint32_t DEFAULT_DEPTH = 10;
+
+    SnapshotPublisher();
+    ~SnapshotPublisher();
+
+    SnapshotPublisher(const SnapshotPublisher&) = delete;
+    SnapshotPublisher& operator=(const SnapshotPublisher&) = delete;
+
+    // Creates (or truncates) and maps the file; depth is capped at MAX_SNAPSHOT_DEPTH
+    bool open(const std::string& path, uint32_t symbol_capacity, uint32_t depth = DEFAULT_DEPTH);
+    void close();
+
+    // Returns true if the slot was rewritten; false if unchanged, or the
+    // symbol is beyond the capacity
+    bool publish(uint32_t symbol_id, const OrderBook& book, uint64_t timestamp);
+
+    // Publishes each book touched by a batch just given to BookManager::apply()
+    size_t publish(const BookManager& books, const ingestion::MarketMessage* messages, size_t count);
+
+    bool is_open() const { return base_ != nullptr; }
+    uint32_t depth() const { return depth_; }
+    uint32_t symbol_capacity() const { return symbol_capacity_; }
+    uint64_t updates() const { return updates_; }
+
+private:
+    char* slot(uint32_t symbol_id) const {
+        return base_ + sizeof(SnapshotHeader) + static_cast<size_t>(symbol_id) * slot_size_;
+    }
+
+    char* base_;
+    size_t mapped_size_;
+    uint32_t depth_;
+    uint32_t symbol_capacity_;
+    size_t slot_size_;
+    std::vector<BookLevel> scratch_;  // depth levels per side, sized by open()
+    uint64_t updates_;
+};
+
+// Read-only view of a snapshot file, usable from any process
+class SnapshotReader {
+public:
+    static constexpr uint32_t DEFAULT_MAX_RETRIES = 1000;
+
+    SnapshotReader();
+    ~SnapshotReader();
+
+    SnapshotReader(const SnapshotReader&) = delete;
+    SnapshotReader& operator=(const SnapshotReader&) = delete;
+
+    // Fails on a missing, foreign, incompatible or uninitialized file
+    bool open(const std::string& path);
+    void close();
+
+    // Consistent copy of a symbol's slot. False if the id is out of range,
+    // the symbol was never published, or writes kept racing the copy.
+    bool read(uint32_t symbol_id, BookSnapshot& snapshot, uint32_t max_retries = DEFAULT_MAX_RETRIES) const;
+
+    // Current sequence, to poll for changes without copying
+    uint64_t sequence(uint32_t symbol_id) const;
+
+    bool is_open() const { return base_ != nullptr; }
+    const SnapshotHeader& header() const { return *reinterpret_cast<const SnapshotHeader*>(base_); }
+    uint32_t depth() const { return header().depth; }
+    uint32_t symbol_capacity() const { return header().symbol_capacity; }
+
+private:
+    const char* slot(uint32_t symbol_id) const {
+        return base_ + header().header_size + static_cast<size_t>(symbol_id) * header().slot_size;
+    }
+
+    const char* base_;
+    size_t mapped_size_;
+};
+
+} // namespace lob
+} // namespace hft
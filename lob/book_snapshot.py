@@ -0,0 +1,128 @@
+"""
+Zero-copy NumPy reader for the shared-memory book snapshots written by
+hft::lob::SnapshotPublisher (book_snapshot.hpp).
+
+The file is mapped read-only and exposed as a structured array with one
+record per symbol id, so strategies can look at any symbol's top-N levels
+without IPC or deserialization. Use read() for a consistent copy: it
+follows the same seqlock protocol as the C++ SnapshotReader.
+"""
+
+import mmap
+import time
+from typing import Optional
+
+import numpy as np
+
+SNAPSHOT_MAGIC = b'HFTBOOK1'
+SNAPSHOT_VERSION = 1
+SNAPSHOT_FLAG_FIXED_POINT = 1 << 0
+PRICE_SCALE = 100_000_000  # Tick sizes are in units of 1e-8 (price.hpp)
+
+HEADER_DTYPE = np.dtype([
+    ('magic', 'S8'),
+    ('version', '<u4'),
+    ('header_size', '<u4'),
+    ('depth', '<u4'),
+    ('symbol_capacity', '<u4'),
+    ('slot_size', '<u4'),
+    ('flags', '<u4'),
+    ('publisher_pid', '<u8'),
+    ('reserved', 'u1', (24,)),
+])
+
+LEVEL_DTYPE = np.dtype([
+    ('price', '<i8'),      # Ticks of tick_units
+    ('quantity', '<i8'),
+    ('orders', '<u4'),
+    ('reserved', '<u4'),
+])
+
+assert HEADER_DTYPE.itemsize == 64 and LEVEL_DTYPE.itemsize == 24
+
+
+def slot_dtype(depth: int) -> np.dtype:
+    """Structured dtype of one symbol slot, padded to whole cache lines"""
+    fields = np.dtype([
+        ('sequence', '<u8'),   # Odd while being written, 0 = never published
+        ('timestamp', '<u8'),
+        ('tick_units', '<i8'),
+        ('last_trade_price', '<i8'),
+        ('last_trade_size', '<i4'),
+        ('bid_count', '<u4'),
+        ('ask_count', '<u4'),
+        ('reserved', '<u4'),
+        ('bids', LEVEL_DTYPE, (depth,)),   # Best first
+        ('asks', LEVEL_DTYPE, (depth,)),
+    ])
+    itemsize = (fields.itemsize + 63) // 64 * 64
+    return np.dtype({
+        'names': list(fields.names),
+        'formats': [fields.fields[name][0] for name in fields.names],
+        'offsets': [fields.fields[name][1] for name in fields.names],
+        'itemsize': itemsize,
+    })
+
+
+class BookSnapshotReader:
+    """Read-only view of a snapshot file (typically under /dev/shm)"""
+
+    def __init__(self, path: str):
+        with open(path, 'rb') as f:
+            self._map = mmap.mmap(f.fileno(), 0, access=mmap.ACCESS_READ)
+        header = np.frombuffer(self._map, dtype=HEADER_DTYPE, count=1)[0]
+        if bytes(header['magic']) != SNAPSHOT_MAGIC:
+            raise ValueError(f"{path} is not an initialized book snapshot file")
+        if int(header['version']) != SNAPSHOT_VERSION:
+            raise ValueError(f"unsupported snapshot version {int(header['version'])}")
+
+        self.depth = int(header['depth'])
+        self.symbol_capacity = int(header['symbol_capacity'])
+        self.fixed_point = bool(int(header['flags']) & SNAPSHOT_FLAG_FIXED_POINT)
+        self.dtype = slot_dtype(self.depth)
+        if self.dtype.itemsize != int(header['slot_size']):
+            raise ValueError("snapshot slot layout does not match this reader")
+
+        # Live, zero-copy view; values may change under you, see read()
+        self.slots = np.frombuffer(self._map, dtype=self.dtype, count=self.symbol_capacity,
+                                   offset=int(header['header_size']))
+        self._sequences = self.slots['sequence']
+
+    def sequence(self, symbol_id: int) -> int:
+        """Current sequence: changes on every update, 0 if never published"""
+        return int(self._sequences[symbol_id])
+
+    def read(self, symbol_id: int, max_retries: int = 1000) -> Optional[np.void]:
+        """
+        Consistent copy of one symbol's slot, or None if it was never
+        published or the publisher kept racing the copy.
+        """
+        for _ in range(max_retries + 1):
+            before = int(self._sequences[symbol_id])
+            if before == 0:
+                return None
+            if before & 1:
+                time.sleep(0)  # Publisher mid-write
+                continue
+            snapshot = self.slots[symbol_id].copy()
+            if int(self._sequences[symbol_id]) == before:
+                return snapshot
+        return None
+
+    @staticmethod
+    def to_prices(snapshot: np.void, side: str = 'bids') -> np.ndarray:
+        """Decimal prices of a copied snapshot's valid levels"""
+        count = int(snapshot['bid_count' if side == 'bids' else 'ask_count'])
+        ticks = snapshot[side]['price'][:count]
+        return ticks * (float(snapshot['tick_units']) / PRICE_SCALE)
+
+    def close(self) -> None:
+        self.slots = None
+        self._sequences = None
+        self._map.close()
+
+    def __enter__(self) -> 'BookSnapshotReader':
+        return self
+
+    def __exit__(self, *exc) -> None:
+        self.close()
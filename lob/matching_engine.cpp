@@ -0,0 +1,211 @@
+#include "matching_engine.hpp"
+#include "probes.hpp"
+#include <algorithm>
+
+namespace hft {
+namespace lob {
+
+using ingestion::MarketMessage;
+using ingestion::MessageType;
+using ingestion::Side;
+
+MatchingEngine::MatchingEngine(const MatchingEngineConfig& config)
+    : config_(config),
+      book_(config.book),
+      clock_(ingestion::TscClock::instance()),
+      orders_submitted_(0),
+      trade_count_(0),
+      traded_quantity_(0) {}
+
+MatchResult MatchingEngine::submit(const OrderRequest& request, Trade* trades, size_t max_trades) {
+    HFT_PROBE_SCOPE(MATCH_SUBMIT);
+    uint64_t start = config_.measure_latency ? clock_.ticks() : 0;
+    MatchResult result = match(request, trades, max_trades);
+    if (config_.measure_latency) {
+        latency_.record(clock_.ticks_to_ns(clock_.ticks() - start));
+    }
+    return result;
+}
+
+MatchResult MatchingEngine::cancel(uint64_t id) {
+    MatchResult result;
+    BookResult outcome = book_.cancel(id);
+    if (outcome != BookResult::APPLIED) {
+        result.status = outcome == BookResult::INVALID ? MatchStatus::INVALID : MatchStatus::UNKNOWN_ORDER;
+    }
+    return result;
+}
+
+MatchResult MatchingEngine::modify(uint64_t id, int64_t price, int32_t quantity, Trade* trades, size_t max_trades) {
+    uint64_t start = config_.measure_latency ? clock_.ticks() : 0;
+    MatchResult result;
+    const Order* order = book_.find_order(id);
+    if (!order) {
+        result.status = id == 0 ? MatchStatus::INVALID : MatchStatus::UNKNOWN_ORDER;
+    } else if (quantity <= 0) {
+        result.status = quantity == 0 ? MatchStatus::ACCEPTED : MatchStatus::INVALID;
+        if (quantity == 0) {
+            book_.cancel(id);
+        }
+    } else if (price == order->price && quantity <= order->quantity) {
+        book_.modify(id, price, quantity);  // Keeps priority, cannot cross
+        result.resting = quantity;
+    } else {
+        OrderRequest request;
+        request.id = id;
+        request.price = price;
+        request.quantity = quantity;
+        request.side = order->side;
+        request.owner = order->owner;
+        book_.cancel(id);
+        result = match(request, trades, max_trades);
+    }
+    if (config_.measure_latency) {
+        latency_.record(clock_.ticks_to_ns(clock_.ticks() - start));
+    }
+    return result;
+}
+
+MatchResult MatchingEngine::apply(const MarketMessage& message, Trade* trades, size_t max_trades) {
+    switch (message.type) {
+        case MessageType::NEW_ORDER: {
+            OrderRequest request;
+            request.id = message.order_id;
+            request.price = book_.to_ticks(message.price);
+            request.quantity = message.size;
+            request.side = message.side;
+            return submit(request, trades, max_trades);
+        }
+        case MessageType::CANCEL_ORDER:
+            return cancel(message.order_id);
+        case MessageType::MODIFY_ORDER: {
+            const Order* order = book_.find_order(message.order_id);
+            // A modify without a price keeps the resting one, as in OrderBook::apply()
+            int64_t price = message.price != ingestion::Price(0) || !order ? book_.to_ticks(message.price) : order->price;
+            return modify(message.order_id, price, message.size, trades, max_trades);
+        }
+        default: {
+            MatchResult result;
+            result.status = MatchStatus::INVALID;
+            return result;
+        }
+    }
+}
+
+MatchResult MatchingEngine::match(const OrderRequest& request, Trade* trades, size_t max_trades) {
+    MatchResult result;
+    bool market = (request.flags & ORDER_MARKET) != 0;
+    bool post_only = (request.flags & ORDER_POST_ONLY) != 0;
+    if (request.id == 0 || request.quantity <= 0 ||
+        (request.side != Side::BUY && request.side != Side::SELL) ||
+        (post_only && (request.flags & (ORDER_IOC | ORDER_FOK | ORDER_MARKET)))) {
+        result.status = MatchStatus::INVALID;
+        return result;
+    }
+    if (book_.index_.find(request.id) != NULL_ORDER) {
+        result.status = MatchStatus::DUPLICATE_ORDER;
+        return result;
+    }
+    orders_submitted_++;
+
+    LevelVector& opposite = book_.levels(request.side == Side::BUY ? Side::SELL : Side::BUY);
+    if (post_only) {
+        if (!opposite.empty() && crosses(request, opposite.back().price)) {
+            result.status = MatchStatus::POST_ONLY_REJECTED;
+            result.cancelled = request.quantity;
+            return result;
+        }
+    } else if ((request.flags & ORDER_FOK) && !fully_fillable(request, max_trades)) {
+        result.status = MatchStatus::FOK_KILLED;
+        result.cancelled = request.quantity;
+        return result;
+    }
+
+    int32_t remaining = request.quantity;
+    bool stopped = false;
+    while (remaining > 0 && !opposite.empty() && crosses(request, opposite.back().price)) {
+        if (result.trades == max_trades) {
+            result.status = MatchStatus::TRADE_LIMIT;
+            stopped = true;
+            break;
+        }
+        uint32_t slot = opposite.back().head;
+        const Order& resting = book_.pool_[slot];
+        Trade& trade = trades[result.trades++];
+        trade.aggressor_id = request.id;
+        trade.resting_id = resting.id;
+        trade.price = resting.price;
+        trade.aggressor_side = request.side;
+
+        if (request.owner != 0 && resting.owner == request.owner) {
+            if (request.stp == SelfTradePrevention::CANCEL_NEWEST) {
+                result.trades--;  // Nothing to report on the resting side
+                result.status = MatchStatus::SELF_TRADE;
+                stopped = true;
+                break;
+            }
+            trade.quantity = resting.quantity;
+            trade.flags = TRADE_STP_CANCEL;
+            book_.remove(slot);
+            if (request.stp == SelfTradePrevention::CANCEL_BOTH) {
+                result.status = MatchStatus::SELF_TRADE;
+                stopped = true;
+                break;
+            }
+            continue;
+        }
+
+        int32_t fill = std::min(remaining, resting.quantity);
+        trade.quantity = fill;
+        remaining -= fill;
+        trade_count_++;
+        traded_quantity_ += static_cast<uint64_t>(fill);
+        if (fill == resting.quantity) {
+            trade.flags = TRADE_RESTING_FILLED;
+            book_.remove(slot);
+        } else {
+            trade.flags = 0;
+            book_.reduce(slot, fill);
+        }
+    }
+
+    result.filled = request.quantity - remaining;
+    if (remaining > 0) {
+        if (stopped || market || (request.flags & (ORDER_IOC | ORDER_FOK))) {
+            result.cancelled = remaining;
+        } else {
+            book_.add(request.id, request.side, request.price, remaining, request.owner);
+            result.resting = remaining;
+        }
+    }
+    return result;
+}
+
+bool MatchingEngine::fully_fillable(const OrderRequest& request, size_t max_trades) const {
+    const LevelVector& opposite = book_.levels(request.side == Side::BUY ? Side::SELL : Side::BUY);
+    int64_t needed = request.quantity;
+    size_t records = 0;
+    for (size_t i = opposite.size(); i-- > 0 && crosses(request, opposite[i].price);) {
+        for (uint32_t slot = opposite[i].head; slot != NULL_ORDER; slot = book_.pool_[slot].next) {
+            if (records == max_trades) {
+                return false;
+            }
+            const Order& resting = book_.pool_[slot];
+            records++;
+            if (request.owner != 0 && resting.owner == request.owner) {
+                if (request.stp != SelfTradePrevention::CANCEL_OLDEST) {
+                    return false;  // Matching would stop here
+                }
+                continue;
+            }
+            needed -= resting.quantity;
+            if (needed <= 0) {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+} // namespace lob
+} // namespace hft
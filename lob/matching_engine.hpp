@@ -0,0 +1,135 @@
+#pragma once
+
+#include "order_book.hpp"
+#include "parser_metrics.hpp"
+#include "tsc_clock.hpp"
+#include <cstddef>
+#include <cstdint>
+
+namespace hft {
+namespace lob {
+
+// OrderRequest::flags
+constexpr uint8_t ORDER_IOC = 1u << 0;        // Cancel whatever does not fill immediately
+constexpr uint8_t ORDER_FOK = 1u << 1;        // Fill completely at once or not at all
+constexpr uint8_t ORDER_POST_ONLY = 1u << 2;  // Reject instead of taking liquidity
+constexpr uint8_t ORDER_MARKET = 1u << 3;     // No limit price; never rests
+
+// What happens when an order would trade with its own owner's resting order
+enum class SelfTradePrevention : uint8_t {
+    CANCEL_NEWEST = 0,  // Cancel the incoming remainder
+    CANCEL_OLDEST,      // Cancel the resting order and keep matching
+    CANCEL_BOTH         // Cancel both
+};
+
+struct OrderRequest {
+    uint64_t id;
+    int64_t price;       // Ticks; ignored for ORDER_MARKET
+    int32_t quantity;
+    ingestion::Side side;
+    uint8_t flags = 0;
+    uint16_t owner = 0;  // Self-trade prevention group, 0 = never prevented
+    SelfTradePrevention stp = SelfTradePrevention::CANCEL_NEWEST;
+};
+
+// Trade::flags
+constexpr uint8_t TRADE_RESTING_FILLED = 1u << 0;  // The resting order is fully filled and gone
+constexpr uint8_t TRADE_STP_CANCEL = 1u << 1;      // Not a fill: resting order cancelled by STP
+
+// One fill, at the resting order's price. Self-trade cancels of resting
+// orders are reported in the same stream (TRADE_STP_CANCEL, quantity is
+// what was cancelled) so a venue can notify the resting side in order.
+struct Trade {
+    uint64_t aggressor_id;
+    uint64_t resting_id;
+    int64_t price;       // Ticks
+    int32_t quantity;
+    ingestion::Side aggressor_side;
+    uint8_t flags;
+};
+
+static_assert(sizeof(Trade) == 32, "Two trades per cache line");
+
+enum class MatchStatus : uint8_t {
+    ACCEPTED = 0,        // Filled, rested and/or (IOC, market) cancelled as requested
+    INVALID,             // Missing id, side, price or quantity, or conflicting flags
+    DUPLICATE_ORDER,     // Id already resting
+    POST_ONLY_REJECTED,  // Would have taken liquidity
+    FOK_KILLED,          // Could not fill completely; nothing traded
+    SELF_TRADE,          // Remainder cancelled by self-trade prevention
+    TRADE_LIMIT,         // Trade output full; remainder cancelled
+    UNKNOWN_ORDER        // Cancel/modify of an id not resting
+};
+
+struct MatchResult {
+    MatchStatus status = MatchStatus::ACCEPTED;
+    int32_t filled = 0;
+    int32_t resting = 0;     // Left in the book
+    int32_t cancelled = 0;   // Of the incoming order, not rested
+    size_t trades = 0;       // Records written to the output
+};
+
+struct MatchingEngineConfig {
+    OrderBookConfig book;
+    bool measure_latency = true;  // Time every submit into latency()
+};
+
+// Price-time priority matching on top of OrderBook.
+//
+// An incoming order walks the opposite side from the touch, filling
+// against each level's FIFO at the resting price, and rests any limit
+// remainder. Fills go to a caller-provided array (e.g. arena-allocated and
+// reused for every call) rather than an allocated container; matching stops
+// with TRADE_LIMIT before writing past max_trades, so size it for the
+// deepest sweep you accept. FOK orders are checked against the same limit
+// up front and killed if they could not complete within it.
+//
+// Single-threaded: one engine per matching thread.
+class MatchingEngine {
+public:
+    explicit MatchingEngine(const MatchingEngineConfig& config = MatchingEngineConfig());
+
+    MatchResult submit(const OrderRequest& request, Trade* trades, size_t max_trades);
+    MatchResult cancel(uint64_t id);
+    // Reducing quantity at the same price keeps priority; anything else is a
+    // cancel and resubmit as a limit order (same id and owner), which may trade
+    MatchResult modify(uint64_t id, int64_t price, int32_t quantity, Trade* trades, size_t max_trades);
+
+    // Simulated venue over a message stream: NEW_ORDER submits a limit order,
+    // CANCEL_ORDER and MODIFY_ORDER amend, anything else is INVALID
+    MatchResult apply(const ingestion::MarketMessage& message, Trade* trades, size_t max_trades);
+
+    const OrderBook& book() const { return book_; }
+
+    // Nanoseconds per submit/modify, matching included
+    const ingestion::LatencyHistogram& latency() const { return latency_; }
+    uint64_t orders_submitted() const { return orders_submitted_; }
+    uint64_t trade_count() const { return trade_count_; }
+    uint64_t traded_quantity() const { return traded_quantity_; }
+
+private:
+    using PriceLevel = OrderBook::PriceLevel;
+    using LevelVector = OrderBook::LevelVector;
+
+    MatchResult match(const OrderRequest& request, Trade* trades, size_t max_trades);
+    // Dry run of the walk for FOK: whether quantity fills within max_trades records
+    bool fully_fillable(const OrderRequest& request, size_t max_trades) const;
+
+    bool crosses(const OrderRequest& request, int64_t level_price) const {
+        if (request.flags & ORDER_MARKET) {
+            return true;
+        }
+        return request.side == ingestion::Side::BUY ? level_price <= request.price : level_price >= request.price;
+    }
+
+    MatchingEngineConfig config_;
+    OrderBook book_;
+    const ingestion::TscClock& clock_;
+    ingestion::LatencyHistogram latency_;
+    uint64_t orders_submitted_;
+    uint64_t trade_count_;
+    uint64_t traded_quantity_;
+};
+
+} // namespace lob
+} // namespace hft
@@ -0,0 +1,298 @@
+#include "order_book.hpp"
+#include "probes.hpp"
+#include <algorithm>
+
+namespace hft {
+namespace lob {
+
+using ingestion::MarketMessage;
+using ingestion::MessageType;
+using ingestion::Side;
+
+namespace {
+
+// Levels checked one by one from the touch before falling back to a binary
+// search; most adds and cancels land within a few ticks of the best price
+constexpr size_t TOUCH_SCAN_LEVELS = 8;
+
+// Whether level_price sorts in front of (is worse than) price on a side
+inline bool worse(Side side, int64_t level_price, int64_t price) {
+    return side == Side::BUY ? level_price < price : level_price > price;
+}
+
+} // namespace
+
+OrderBook::OrderBook(const OrderBookConfig& config)
+    : pool_(config.expected_orders, config.arena),
+      index_(config.expected_orders, config.arena),
+      bids_(ingestion::ArenaAllocator<PriceLevel>(config.arena)),
+      asks_(ingestion::ArenaAllocator<PriceLevel>(config.arena)),
+      tick_units_(config.tick_units > 0 ? config.tick_units : ingestion::DEFAULT_TICK_UNITS),
+      last_trade_price_(0),
+      last_trade_size_(0) {
+    bids_.reserve(config.expected_levels);
+    asks_.reserve(config.expected_levels);
+}
+
+BookResult OrderBook::apply(const MarketMessage& message) {
+    switch (message.type) {
+        case MessageType::NEW_ORDER:
+            return add(message.order_id, message.side, to_ticks(message.price), message.size);
+        case MessageType::CANCEL_ORDER:
+            return cancel(message.order_id);
+        case MessageType::MODIFY_ORDER: {
+            if (message.price != ingestion::Price(0)) {
+                return modify(message.order_id, to_ticks(message.price), message.size);
+            }
+            const Order* order = find_order(message.order_id);
+            if (!order) {
+                return message.order_id == 0 ? BookResult::INVALID : BookResult::UNKNOWN_ORDER;
+            }
+            return modify(message.order_id, order->price, message.size);
+        }
+        case MessageType::TRADE:
+            last_trade_price_ = to_ticks(message.price);
+            last_trade_size_ = message.size;
+            // Prints without an order id (e.g. off-book trades) do not touch resting orders
+            return message.order_id == 0 ? BookResult::APPLIED : execute(message.order_id, message.size);
+        default:
+            return BookResult::IGNORED;
+    }
+}
+
+BookResult OrderBook::add(uint64_t id, Side side, int64_t price, int32_t quantity, uint16_t owner) {
+    HFT_PROBE_SCOPE(BOOK_ADD);
+    if (id == 0 || quantity <= 0 || (side != Side::BUY && side != Side::SELL)) {
+        return BookResult::INVALID;
+    }
+    uint32_t slot = pool_.allocate();
+    if (!index_.insert(id, slot)) {
+        pool_.release(slot);
+        return BookResult::DUPLICATE_ORDER;
+    }
+    pool_[slot] = Order{id, price, quantity, NULL_ORDER, NULL_ORDER, side, owner};
+    link(slot);
+    return BookResult::APPLIED;
+}
+
+BookResult OrderBook::cancel(uint64_t id) {
+    HFT_PROBE_SCOPE(BOOK_CANCEL);
+    if (id == 0) {
+        return BookResult::INVALID;
+    }
+    uint32_t slot = index_.find(id);
+    if (slot == NULL_ORDER) {
+        return BookResult::UNKNOWN_ORDER;
+    }
+    remove(slot);
+    return BookResult::APPLIED;
+}
+
+BookResult OrderBook::modify(uint64_t id, int64_t price, int32_t quantity) {
+    HFT_PROBE_SCOPE(BOOK_MODIFY);
+    if (quantity == 0) {
+        return cancel(id);
+    }
+    if (id == 0 || quantity < 0) {
+        return BookResult::INVALID;
+    }
+    uint32_t slot = index_.find(id);
+    if (slot == NULL_ORDER) {
+        return BookResult::UNKNOWN_ORDER;
+    }
+    Order& order = pool_[slot];
+    if (price == order.price && quantity <= order.quantity) {
+        reduce(slot, order.quantity - quantity);
+        return BookResult::APPLIED;
+    }
+    // Price change or size increase loses priority
+    unlink(slot);
+    order.price = price;
+    order.quantity = quantity;
+    link(slot);
+    return BookResult::APPLIED;
+}
+
+BookResult OrderBook::execute(uint64_t id, int32_t quantity) {
+    HFT_PROBE_SCOPE(BOOK_EXECUTE);
+    if (id == 0 || quantity <= 0) {
+        return BookResult::INVALID;
+    }
+    uint32_t slot = index_.find(id);
+    if (slot == NULL_ORDER) {
+        return BookResult::UNKNOWN_ORDER;
+    }
+    if (quantity >= pool_[slot].quantity) {
+        remove(slot);
+    } else {
+        reduce(slot, quantity);
+    }
+    return BookResult::APPLIED;
+}
+
+void OrderBook::clear() {
+    for (LevelVector* side : {&bids_, &asks_}) {
+        for (const PriceLevel& level : *side) {
+            for (uint32_t slot = level.head; slot != NULL_ORDER;) {
+                uint32_t next = pool_[slot].next;
+                index_.erase(pool_[slot].id);
+                pool_.release(slot);
+                slot = next;
+            }
+        }
+        side->clear();
+    }
+    last_trade_price_ = 0;
+    last_trade_size_ = 0;
+}
+
+size_t OrderBook::depth(Side side, BookLevel* out, size_t max) const {
+    const LevelVector& side_levels = levels(side);
+    size_t count = std::min(max, side_levels.size());
+    for (size_t i = 0; i < count; ++i) {
+        const PriceLevel& level = side_levels[side_levels.size() - 1 - i];
+        out[i] = BookLevel{level.price, level.quantity, level.order_count};
+    }
+    return count;
+}
+
+const Order* OrderBook::find_order(uint64_t id) const {
+    uint32_t slot = index_.find(id);
+    return slot == NULL_ORDER ? nullptr : &pool_[slot];
+}
+
+bool OrderBook::best(const LevelVector& levels, BookLevel& level) {
+    if (levels.empty()) {
+        return false;
+    }
+    const PriceLevel& touch = levels.back();
+    level = BookLevel{touch.price, touch.quantity, touch.order_count};
+    return true;
+}
+
+size_t OrderBook::locate(const LevelVector& levels, Side side, int64_t price) {
+    size_t i = levels.size();
+    for (size_t step = 0; step < TOUCH_SCAN_LEVELS; ++step) {
+        if (i == 0 || worse(side, levels[i - 1].price, price)) {
+            return i;
+        }
+        --i;
+    }
+    // Deep in the book: binary search the rest
+    auto it = std::lower_bound(levels.begin(), levels.begin() + i, price,
+                               [side](const PriceLevel& level, int64_t p) { return worse(side, level.price, p); });
+    return static_cast<size_t>(it - levels.begin());
+}
+
+void OrderBook::link(uint32_t slot) {
+    Order& order = pool_[slot];
+    LevelVector& side = levels(order.side);
+    size_t i = locate(side, order.side, order.price);
+    if (i == side.size() || side[i].price != order.price) {
+        side.insert(side.begin() + i, PriceLevel{order.price, 0, 0, NULL_ORDER, NULL_ORDER});
+    }
+    PriceLevel& level = side[i];
+    order.prev = level.tail;
+    order.next = NULL_ORDER;
+    if (level.tail != NULL_ORDER) {
+        pool_[level.tail].next = slot;
+    } else {
+        level.head = slot;
+    }
+    level.tail = slot;
+    level.quantity += order.quantity;
+    level.order_count++;
+}
+
+void OrderBook::unlink(uint32_t slot) {
+    Order& order = pool_[slot];
+    LevelVector& side = levels(order.side);
+    size_t i = locate(side, order.side, order.price);
+    PriceLevel& level = side[i];
+    if (order.prev != NULL_ORDER) {
+        pool_[order.prev].next = order.next;
+    } else {
+        level.head = order.next;
+    }
+    if (order.next != NULL_ORDER) {
+        pool_[order.next].prev = order.prev;
+    } else {
+        level.tail = order.prev;
+    }
+    level.quantity -= order.quantity;
+    if (--level.order_count == 0) {
+        side.erase(side.begin() + i);
+    }
+}
+
+void OrderBook::remove(uint32_t slot) {
+    unlink(slot);
+    index_.erase(pool_[slot].id);
+    pool_.release(slot);
+}
+
+void OrderBook::reduce(uint32_t slot, int32_t quantity) {
+    Order& order = pool_[slot];
+    LevelVector& side = levels(order.side);
+    side[locate(side, order.side, order.price)].quantity -= quantity;
+    order.quantity -= quantity;
+}
+
+BookManager::BookManager(const OrderBookConfig& config, const ingestion::SymbolRegistry* registry)
+    : config_(config), registry_(registry), book_count_(0) {
+    results_.fill(0);
+}
+
+BookResult BookManager::apply(const MarketMessage& message) {
+    BookResult result;
+    switch (message.type) {
+        case MessageType::NEW_ORDER:
+        case MessageType::CANCEL_ORDER:
+        case MessageType::MODIFY_ORDER:
+        case MessageType::TRADE:
+            result = message.symbol_id == ingestion::INVALID_SYMBOL_ID
+                         ? BookResult::INVALID
+                         : book_for(message.symbol_id).apply(message);
+            break;
+        default:
+            result = BookResult::IGNORED;  // Without creating a book
+            break;
+    }
+    results_[static_cast<size_t>(result)]++;
+    return result;
+}
+
+size_t BookManager::apply(const MarketMessage* messages, size_t count) {
+    size_t applied = 0;
+    for (size_t i = 0; i < count; ++i) {
+        applied += apply(messages[i]) == BookResult::APPLIED;
+    }
+    return applied;
+}
+
+OrderBook* BookManager::book(uint32_t symbol_id) {
+    return symbol_id < books_.size() ? books_[symbol_id].get() : nullptr;
+}
+
+const OrderBook* BookManager::book(uint32_t symbol_id) const {
+    return symbol_id < books_.size() ? books_[symbol_id].get() : nullptr;
+}
+
+OrderBook& BookManager::book_for(uint32_t symbol_id) {
+    if (symbol_id >= books_.size()) {
+        books_.resize(symbol_id + 1);
+    }
+    std::unique_ptr<OrderBook>& slot = books_[symbol_id];
+    if (!slot) {
+        OrderBookConfig config = config_;
+        if (registry_) {
+            config.tick_units = registry_->tick_size(symbol_id);
+        }
+        slot.reset(new OrderBook(config));
+        book_count_++;
+    }
+    return *slot;
+}
+
+} // namespace lob
+} // namespace hft
@@ -0,0 +1,154 @@
+#pragma once
+
+#include "message_types.hpp"
+#include "order_pool.hpp"
+#include "price.hpp"
+#include "symbol_registry.hpp"
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace hft {
+namespace lob {
+
+// Outcome of applying one event to a book
+enum class BookResult : uint8_t {
+    APPLIED = 0,
+    IGNORED,            // Message type the book does not track
+    UNKNOWN_ORDER,      // Cancel/modify/execute of an id not resting in the book
+    DUPLICATE_ORDER,    // New order with an id already resting
+    INVALID             // Missing id, side, symbol or non-positive quantity
+};
+
+constexpr size_t BOOK_RESULT_COUNT = 5;
+
+// Aggregated view of one price level
+struct BookLevel {
+    int64_t price;      // Ticks
+    int64_t quantity;
+    uint32_t orders;
+};
+
+struct OrderBookConfig {
+    size_t expected_orders = 4096;     // Pool and id index presized for this many resting orders
+    size_t expected_levels = 256;      // Per side
+    int64_t tick_units = ingestion::DEFAULT_TICK_UNITS;  // Converts MarketMessage prices to ticks
+    ingestion::MemoryArena* arena = nullptr;  // Orders, id index and levels; must outlive the book
+};
+
+// Order-by-order limit order book for a single instrument.
+//
+// Each side keeps its price levels in a sorted vector with the best price
+// at the back, so lookups start at the touch and new levels near it shift
+// only a few entries. Orders rest in an intrusive FIFO per level, stored in
+// a preallocated OrderPool and found by id through an open-addressing
+// OrderIndex, so the steady state does no allocation. All prices are ticks.
+class OrderBook {
+public:
+    explicit OrderBook(const OrderBookConfig& config = OrderBookConfig());
+
+    // NEW_ORDER adds, CANCEL_ORDER removes, MODIFY_ORDER amends (a zero price
+    // keeps the resting price) and TRADE executes against order_id when it
+    // names a resting order. Trades always update the last trade.
+    BookResult apply(const ingestion::MarketMessage& message);
+
+    BookResult add(uint64_t id, ingestion::Side side, int64_t price, int32_t quantity, uint16_t owner = 0);
+    BookResult cancel(uint64_t id);
+    // Same price and no more quantity keeps queue priority; anything else
+    // re-queues the order at the back of its (new) level. Zero cancels.
+    BookResult modify(uint64_t id, int64_t price, int32_t quantity);
+    // Fill against a resting order, removing it once fully filled
+    BookResult execute(uint64_t id, int32_t quantity);
+    void clear();
+
+    // False when the side is empty
+    bool best_bid(BookLevel& level) const { return best(bids_, level); }
+    bool best_ask(BookLevel& level) const { return best(asks_, level); }
+
+    // Up to max levels from the touch outwards, returns the count written
+    size_t depth(ingestion::Side side, BookLevel* out, size_t max) const;
+
+    // Resting order by id, nullptr if unknown; invalidated by the next add
+    const Order* find_order(uint64_t id) const;
+
+    size_t order_count() const { return pool_.size(); }
+    size_t level_count(ingestion::Side side) const { return levels(side).size(); }
+
+    int64_t last_trade_price() const { return last_trade_price_; }
+    int32_t last_trade_size() const { return last_trade_size_; }
+
+    int64_t tick_units() const { return tick_units_; }
+    ingestion::Price to_price(int64_t ticks) const { return ingestion::ticks_to_price(ticks, tick_units_); }
+    int64_t to_ticks(ingestion::Price price) const { return ingestion::price_to_ticks(price, tick_units_); }
+
+private:
+    friend class MatchingEngine;  // Walks the opposite side's FIFOs directly
+
+    struct PriceLevel {
+        int64_t price;
+        int64_t quantity;
+        uint32_t order_count;
+        uint32_t head;
+        uint32_t tail;
+    };
+
+    using LevelVector = std::vector<PriceLevel, ingestion::ArenaAllocator<PriceLevel>>;
+
+    LevelVector& levels(ingestion::Side side) {
+        return side == ingestion::Side::BUY ? bids_ : asks_;
+    }
+    const LevelVector& levels(ingestion::Side side) const {
+        return side == ingestion::Side::BUY ? bids_ : asks_;
+    }
+
+    static bool best(const LevelVector& levels, BookLevel& level);
+    // Index of the level at price if present, otherwise where it would be inserted
+    static size_t locate(const LevelVector& levels, ingestion::Side side, int64_t price);
+
+    void link(uint32_t slot);        // Append to the tail of its level, creating the level
+    void unlink(uint32_t slot);      // Remove from its level, erasing the level once empty
+    void remove(uint32_t slot);      // Unlink, drop from the index and free
+    void reduce(uint32_t slot, int32_t quantity);  // In place, keeps queue priority
+
+    OrderPool pool_;
+    OrderIndex index_;
+    LevelVector bids_;               // Ascending price, best bid at the back
+    LevelVector asks_;               // Descending price, best ask at the back
+    int64_t tick_units_;
+    int64_t last_trade_price_;
+    int32_t last_trade_size_;
+};
+
+// One OrderBook per symbol id, created on first use, for applying a
+// FeedHandler's merged stream. Book tick sizes come from the registry when
+// one is given, else from the config.
+class BookManager {
+public:
+    explicit BookManager(const OrderBookConfig& config = OrderBookConfig(),
+                         const ingestion::SymbolRegistry* registry = nullptr);
+
+    BookResult apply(const ingestion::MarketMessage& message);
+    // Returns how many messages were APPLIED
+    size_t apply(const ingestion::MarketMessage* messages, size_t count);
+
+    // nullptr until the symbol has seen a message
+    OrderBook* book(uint32_t symbol_id);
+    const OrderBook* book(uint32_t symbol_id) const;
+    size_t book_count() const { return book_count_; }
+
+    uint64_t result_count(BookResult result) const { return results_[static_cast<size_t>(result)]; }
+
+private:
+    OrderBook& book_for(uint32_t symbol_id);
+
+    OrderBookConfig config_;
+    const ingestion::SymbolRegistry* registry_;
+    std::vector<std::unique_ptr<OrderBook>> books_;
+    size_t book_count_;
+    std::array<uint64_t, BOOK_RESULT_COUNT> results_;
+};
+
+} // namespace lob
+} // namespace hft
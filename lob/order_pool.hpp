@@ -0,0 +1,189 @@
+#pragma once
+
+#include "memory_arena.hpp"
+#include "message_types.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace hft {
+namespace lob {
+
+// Null link / not-found value for pool indices
+constexpr uint32_t NULL_ORDER = 0xFFFFFFFF;
+
+// Resting order, two per cache line. Orders at a price level form an
+// intrusive FIFO through prev/next, which are pool indices rather than
+// pointers so the pool can grow without fixing up links.
+struct Order {
+    uint64_t id;
+    int64_t price;       // Ticks
+    int32_t quantity;    // Remaining
+    uint32_t prev;
+    uint32_t next;
+    ingestion::Side side;
+    uint16_t owner;      // Self-trade prevention group, 0 = none
+};
+
+static_assert(sizeof(Order) == 32, "Order should stay half a cache line");
+
+// Preallocated slab of orders with an intrusive free list, optionally carved
+// from a MemoryArena. Growing past the initial capacity reallocates, so
+// references into the pool must not be held across allocate().
+class OrderPool {
+public:
+    explicit OrderPool(size_t capacity, ingestion::MemoryArena* arena = nullptr)
+        : orders_(ingestion::ArenaAllocator<Order>(arena)), free_head_(NULL_ORDER), live_(0) {
+        orders_.reserve(capacity);
+        while (orders_.size() < capacity) {
+            release_slot(push_slot());
+        }
+    }
+
+    uint32_t allocate() {
+        if (free_head_ == NULL_ORDER) {
+            release_slot(push_slot());  // Exhausted: amortized growth off the steady state
+        }
+        uint32_t index = free_head_;
+        free_head_ = orders_[index].next;
+        live_++;
+        return index;
+    }
+
+    void release(uint32_t index) {
+        release_slot(index);
+        live_--;
+    }
+
+    Order& operator[](uint32_t index) { return orders_[index]; }
+    const Order& operator[](uint32_t index) const { return orders_[index]; }
+
+    size_t size() const { return live_; }
+    size_t capacity() const { return orders_.size(); }
+
+private:
+    uint32_t push_slot() {
+        orders_.push_back(Order{});
+        return static_cast<uint32_t>(orders_.size() - 1);
+    }
+
+    void release_slot(uint32_t index) {
+        orders_[index].next = free_head_;
+        free_head_ = index;
+    }
+
+    std::vector<Order, ingestion::ArenaAllocator<Order>> orders_;
+    uint32_t free_head_;
+    size_t live_;
+};
+
+// Open-addressing order id -> pool index map: linear probing over a flat
+// power-of-two table with Fibonacci hashing, and backward-shift deletion so
+// there are no tombstones to degrade probes. Id 0 marks an empty slot.
+class OrderIndex {
+public:
+    static constexpr double MAX_LOAD = 0.5;
+
+    explicit OrderIndex(size_t expected_orders, ingestion::MemoryArena* arena = nullptr)
+        : entries_(ingestion::ArenaAllocator<Entry>(arena)), shift_(64), size_(0) {
+        size_t capacity = 16;
+        while (capacity * MAX_LOAD < expected_orders) {
+            capacity <<= 1;
+        }
+        resize(capacity);
+    }
+
+    // False if the id is already present or 0
+    bool insert(uint64_t id, uint32_t slot) {
+        if (id == 0) {
+            return false;
+        }
+        if (static_cast<double>(size_ + 1) > static_cast<double>(entries_.size()) * MAX_LOAD) {
+            resize(entries_.size() * 2);
+        }
+        size_t i = home(id);
+        while (entries_[i].id != 0) {
+            if (entries_[i].id == id) {
+                return false;
+            }
+            i = (i + 1) & mask_;
+        }
+        entries_[i] = Entry{id, slot};
+        size_++;
+        return true;
+    }
+
+    uint32_t find(uint64_t id) const {
+        if (id == 0) {
+            return NULL_ORDER;
+        }
+        for (size_t i = home(id);; i = (i + 1) & mask_) {
+            if (entries_[i].id == id) {
+                return entries_[i].slot;
+            }
+            if (entries_[i].id == 0) {
+                return NULL_ORDER;
+            }
+        }
+    }
+
+    bool erase(uint64_t id) {
+        if (id == 0) {
+            return false;
+        }
+        size_t i = home(id);
+        while (entries_[i].id != id) {
+            if (entries_[i].id == 0) {
+                return false;
+            }
+            i = (i + 1) & mask_;
+        }
+        // Pull back any later entry of the run whose home is not in (i, j]
+        for (size_t j = (i + 1) & mask_; entries_[j].id != 0; j = (j + 1) & mask_) {
+            size_t k = home(entries_[j].id);
+            bool stays = i < j ? (i < k && k <= j) : (i < k || k <= j);
+            if (!stays) {
+                entries_[i] = entries_[j];
+                i = j;
+            }
+        }
+        entries_[i].id = 0;
+        size_--;
+        return true;
+    }
+
+    size_t size() const { return size_; }
+    size_t capacity() const { return entries_.size(); }
+
+private:
+    struct Entry {
+        uint64_t id;
+        uint32_t slot;
+    };
+
+    size_t home(uint64_t id) const {
+        return static_cast<size_t>((id * 0x9E3779B97F4A7C15ULL) >> shift_);
+    }
+
+    void resize(size_t capacity) {
+        std::vector<Entry, ingestion::ArenaAllocator<Entry>> old(entries_.get_allocator());
+        old.swap(entries_);
+        entries_.assign(capacity, Entry{0, 0});
+        mask_ = capacity - 1;
+        shift_ = 64 - static_cast<uint32_t>(__builtin_ctzll(capacity));
+        size_ = 0;
+        for (const Entry& entry : old) {
+            if (entry.id != 0) {
+                insert(entry.id, entry.slot);
+            }
+        }
+    }
+
+    std::vector<Entry, ingestion::ArenaAllocator<Entry>> entries_;
+    size_t mask_;
+    uint32_t shift_;
+    size_t size_;
+};
+
+} // namespace lob
+} // namespace hft
@@ -0,0 +1,517 @@
+// Unit tests for the limit order book, its order pool and id index.
+
+#include "book_snapshot.hpp"
+#include "matching_engine.hpp"
+#include "message_parser.hpp"
+#include "order_book.hpp"
+#include <cstdio>
+#include <cstdint>
+#include <atomic>
+#include <map>
+#include <random>
+#include <string>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+using namespace hft::ingestion;
+using namespace hft::lob;
+
+static int g_failures = 0;
+
+#define CHECK(cond)                                                           \
+    do {                                                                      \
+        if (!(cond)) {                                                        \
+            std::fprintf(stderr, "%s:%d: CHECK failed: %s\n", __FILE__, __LINE__, #cond); \
+            g_failures++;                                                     \
+        }                                                                     \
+    } while (0)
+
+namespace {
+
+void test_order_index() {
+    OrderIndex index(4);
+    CHECK(!index.insert(0, 1));  // 0 is the empty marker
+    for (uint64_t id = 1; id <= 1000; ++id) {
+        CHECK(index.insert(id * 7919, static_cast<uint32_t>(id)));
+    }
+    CHECK(index.size() == 1000);
+    CHECK(index.capacity() >= 2000);  // Grew to stay at or under half full
+    CHECK(!index.insert(7919, 5));
+    CHECK(index.find(7919) == 1);
+
+    // Erase every other id; backward shifting must keep the rest reachable
+    for (uint64_t id = 1; id <= 1000; id += 2) {
+        CHECK(index.erase(id * 7919));
+    }
+    CHECK(!index.erase(7919));
+    CHECK(index.size() == 500);
+    for (uint64_t id = 1; id <= 1000; ++id) {
+        uint32_t expected = id % 2 ? NULL_ORDER : static_cast<uint32_t>(id);
+        CHECK(index.find(id * 7919) == expected);
+    }
+}
+
+void test_order_pool() {
+    OrderPool pool(2);
+    uint32_t a = pool.allocate();
+    uint32_t b = pool.allocate();
+    uint32_t c = pool.allocate();  // Past the preallocated capacity
+    CHECK(a != b && b != c && a != c);
+    CHECK(pool.size() == 3);
+    CHECK(pool.capacity() == 3);
+    pool.release(b);
+    CHECK(pool.allocate() == b);  // Free slots are reused first
+    CHECK(pool.capacity() == 3);
+}
+
+void test_levels_and_priority() {
+    OrderBook book;
+    BookLevel level;
+    CHECK(!book.best_bid(level));
+    CHECK(!book.best_ask(level));
+
+    CHECK(book.add(1, Side::BUY, 100, 10) == BookResult::APPLIED);
+    CHECK(book.add(2, Side::BUY, 101, 5) == BookResult::APPLIED);
+    CHECK(book.add(3, Side::BUY, 100, 7) == BookResult::APPLIED);
+    CHECK(book.add(4, Side::SELL, 103, 4) == BookResult::APPLIED);
+    CHECK(book.add(5, Side::SELL, 102, 6) == BookResult::APPLIED);
+    CHECK(book.add(6, Side::SELL, 110, 1) == BookResult::APPLIED);
+    CHECK(book.add(1, Side::SELL, 105, 1) == BookResult::DUPLICATE_ORDER);
+    CHECK(book.add(0, Side::BUY, 100, 1) == BookResult::INVALID);
+    CHECK(book.add(7, Side::UNKNOWN, 100, 1) == BookResult::INVALID);
+    CHECK(book.add(7, Side::BUY, 100, 0) == BookResult::INVALID);
+    CHECK(book.order_count() == 6);
+    CHECK(book.level_count(Side::BUY) == 2);
+    CHECK(book.level_count(Side::SELL) == 3);
+
+    CHECK(book.best_bid(level) && level.price == 101 && level.quantity == 5 && level.orders == 1);
+    CHECK(book.best_ask(level) && level.price == 102 && level.quantity == 6);
+
+    BookLevel asks[4];
+    CHECK(book.depth(Side::SELL, asks, 4) == 3);
+    CHECK(asks[0].price == 102 && asks[1].price == 103 && asks[2].price == 110);
+    BookLevel bids[1];
+    CHECK(book.depth(Side::BUY, bids, 1) == 1 && bids[0].price == 101);
+
+    // Cancelling the only order at the touch removes the level
+    CHECK(book.cancel(2) == BookResult::APPLIED);
+    CHECK(book.cancel(2) == BookResult::UNKNOWN_ORDER);
+    CHECK(book.best_bid(level) && level.price == 100 && level.quantity == 17 && level.orders == 2);
+
+    // Executions consume the level in arrival order
+    CHECK(book.execute(1, 4) == BookResult::APPLIED);
+    CHECK(book.find_order(1) && book.find_order(1)->quantity == 6);
+    CHECK(book.execute(1, 6) == BookResult::APPLIED);
+    CHECK(!book.find_order(1));
+    CHECK(book.best_bid(level) && level.quantity == 7 && level.orders == 1);
+
+    // Reducing in place keeps priority, growing re-queues behind later orders
+    CHECK(book.add(8, Side::BUY, 100, 3) == BookResult::APPLIED);
+    CHECK(book.modify(3, 100, 2) == BookResult::APPLIED);
+    CHECK(book.best_bid(level) && level.quantity == 5);
+    CHECK(book.modify(3, 100, 9) == BookResult::APPLIED);
+    CHECK(book.execute(8, 3) == BookResult::APPLIED);  // 8 was ahead of 3 now
+    CHECK(book.find_order(3) && book.find_order(3)->quantity == 9);
+
+    // Price changes move the order between levels
+    CHECK(book.modify(3, 99, 9) == BookResult::APPLIED);
+    CHECK(book.level_count(Side::BUY) == 1);
+    CHECK(book.best_bid(level) && level.price == 99 && level.quantity == 9);
+    CHECK(book.modify(3, 99, 0) == BookResult::APPLIED);  // Zero cancels
+    CHECK(book.level_count(Side::BUY) == 0);
+    CHECK(book.modify(42, 99, 1) == BookResult::UNKNOWN_ORDER);
+
+    book.clear();
+    CHECK(book.order_count() == 0);
+    CHECK(book.level_count(Side::SELL) == 0);
+    CHECK(book.add(4, Side::SELL, 103, 4) == BookResult::APPLIED);  // Ids are free again
+}
+
+// Random adds, cancels, modifies and executions against a std::map model,
+// with prices spread wide enough to exercise the binary search
+void test_against_model() {
+    struct ModelOrder {
+        Side side;
+        int64_t price;
+        int32_t quantity;
+    };
+    OrderBookConfig config;
+    config.expected_orders = 64;  // Force pool and index growth
+    config.expected_levels = 4;
+    OrderBook book(config);
+    std::map<uint64_t, ModelOrder> orders;
+    std::mt19937_64 rng(12345);
+    uint64_t next_id = 1;
+
+    for (int step = 0; step < 20000; ++step) {
+        unsigned action = rng() % 10;
+        if (action < 4 || orders.empty()) {
+            Side side = rng() % 2 ? Side::BUY : Side::SELL;
+            int64_t price = side == Side::BUY ? 1000 - static_cast<int64_t>(rng() % 64)
+                                              : 1001 + static_cast<int64_t>(rng() % 64);
+            int32_t quantity = 1 + static_cast<int32_t>(rng() % 100);
+            uint64_t id = next_id++ * 0x10001;  // Spread ids across the index
+            CHECK(book.add(id, side, price, quantity) == BookResult::APPLIED);
+            orders[id] = ModelOrder{side, price, quantity};
+            continue;
+        }
+        auto it = orders.begin();
+        std::advance(it, rng() % orders.size());
+        uint64_t id = it->first;
+        ModelOrder& order = it->second;
+        if (action < 6) {
+            CHECK(book.cancel(id) == BookResult::APPLIED);
+            orders.erase(it);
+        } else if (action < 8) {
+            int64_t price = order.price + static_cast<int64_t>(rng() % 3) - 1;
+            int32_t quantity = static_cast<int32_t>(rng() % 120);
+            CHECK(book.modify(id, price, quantity) == BookResult::APPLIED);
+            if (quantity == 0) {
+                orders.erase(it);
+            } else {
+                order.price = price;
+                order.quantity = quantity;
+            }
+        } else {
+            int32_t quantity = 1 + static_cast<int32_t>(rng() % 60);
+            CHECK(book.execute(id, quantity) == BookResult::APPLIED);
+            if (quantity >= order.quantity) {
+                orders.erase(it);
+            } else {
+                order.quantity -= quantity;
+            }
+        }
+    }
+
+    // Rebuild the aggregated book from the model and compare every level
+    std::map<int64_t, int64_t> bid_levels;
+    std::map<int64_t, int64_t> ask_levels;
+    for (const auto& entry : orders) {
+        (entry.second.side == Side::BUY ? bid_levels : ask_levels)[entry.second.price] += entry.second.quantity;
+        const Order* resting = book.find_order(entry.first);
+        CHECK(resting && resting->price == entry.second.price && resting->quantity == entry.second.quantity);
+    }
+    CHECK(book.order_count() == orders.size());
+    CHECK(book.level_count(Side::BUY) == bid_levels.size());
+    CHECK(book.level_count(Side::SELL) == ask_levels.size());
+
+    std::vector<BookLevel> levels(256);
+    size_t count = book.depth(Side::BUY, levels.data(), levels.size());
+    CHECK(count == bid_levels.size());
+    auto bid = bid_levels.rbegin();
+    for (size_t i = 0; i < count && bid != bid_levels.rend(); ++i, ++bid) {
+        CHECK(levels[i].price == bid->first && levels[i].quantity == bid->second);
+    }
+    count = book.depth(Side::SELL, levels.data(), levels.size());
+    CHECK(count == ask_levels.size());
+    auto ask = ask_levels.begin();
+    for (size_t i = 0; i < count && ask != ask_levels.end(); ++i, ++ask) {
+        CHECK(levels[i].price == ask->first && levels[i].quantity == ask->second);
+    }
+}
+
+// Order churn on an arena-backed book maps nothing once warmed up
+void test_arena_backed_book() {
+    ArenaConfig arena_config;
+    arena_config.initial_size = 1 << 20;
+    MemoryArena arena(arena_config);
+    OrderBookConfig config;
+    config.expected_orders = 256;
+    config.expected_levels = 16;
+    config.arena = &arena;
+    OrderBook book(config);
+    size_t mapped = arena.bytes_mapped();
+    size_t in_use = arena.bytes_in_use();
+    CHECK(in_use > 0);
+
+    for (int round = 0; round < 50; ++round) {
+        for (uint64_t id = 1; id <= 200; ++id) {
+            Side side = id % 2 ? Side::BUY : Side::SELL;
+            int64_t price = side == Side::BUY ? 100 - static_cast<int64_t>(id % 10) : 101 + static_cast<int64_t>(id % 10);
+            CHECK(book.add(id, side, price, 10) == BookResult::APPLIED);
+        }
+        for (uint64_t id = 1; id <= 200; ++id) {
+            CHECK(book.cancel(id) == BookResult::APPLIED);
+        }
+    }
+    CHECK(book.order_count() == 0);
+    CHECK(arena.bytes_mapped() == mapped);
+    CHECK(arena.bytes_in_use() == in_use);  // Pool, index and level arrays never grew
+}
+
+OrderRequest limit(uint64_t id, Side side, int64_t price, int32_t quantity, uint8_t flags = 0, uint16_t owner = 0) {
+    OrderRequest request;
+    request.id = id;
+    request.side = side;
+    request.price = price;
+    request.quantity = quantity;
+    request.flags = flags;
+    request.owner = owner;
+    return request;
+}
+
+void test_matching_engine() {
+    MatchingEngine engine;
+    Trade trades[8];
+    BookLevel level;
+
+    // Resting liquidity: asks 101 x (5, 5), 102 x 10
+    CHECK(engine.submit(limit(1, Side::SELL, 101, 5), trades, 8).resting == 5);
+    CHECK(engine.submit(limit(2, Side::SELL, 101, 5), trades, 8).resting == 5);
+    CHECK(engine.submit(limit(3, Side::SELL, 102, 10), trades, 8).resting == 10);
+    CHECK(engine.submit(limit(3, Side::BUY, 99, 1), trades, 8).status == MatchStatus::DUPLICATE_ORDER);
+    CHECK(engine.submit(limit(0, Side::BUY, 99, 1), trades, 8).status == MatchStatus::INVALID);
+
+    // A crossing buy sweeps in price-time order at resting prices, then rests
+    MatchResult result = engine.submit(limit(10, Side::BUY, 102, 14), trades, 8);
+    CHECK(result.status == MatchStatus::ACCEPTED && result.filled == 14 && result.resting == 0);
+    CHECK(result.trades == 3);
+    CHECK(trades[0].resting_id == 1 && trades[0].price == 101 && trades[0].quantity == 5);
+    CHECK(trades[0].flags == TRADE_RESTING_FILLED && trades[0].aggressor_id == 10);
+    CHECK(trades[1].resting_id == 2 && trades[1].quantity == 5);
+    CHECK(trades[2].resting_id == 3 && trades[2].price == 102 && trades[2].quantity == 4 && trades[2].flags == 0);
+    CHECK(engine.book().best_ask(level) && level.price == 102 && level.quantity == 6);
+
+    result = engine.submit(limit(11, Side::BUY, 103, 10), trades, 8);
+    CHECK(result.filled == 6 && result.resting == 4 && result.trades == 1);
+    CHECK(engine.book().best_bid(level) && level.price == 103 && level.quantity == 4);
+    CHECK(!engine.book().best_ask(level));
+
+    // IOC cancels its remainder, market orders never rest
+    CHECK(engine.submit(limit(20, Side::SELL, 110, 5), trades, 8).resting == 5);
+    result = engine.submit(limit(21, Side::BUY, 110, 8, ORDER_IOC), trades, 8);
+    CHECK(result.filled == 5 && result.cancelled == 3 && result.resting == 0);
+    result = engine.submit(limit(22, Side::SELL, 0, 6, ORDER_MARKET), trades, 8);
+    CHECK(result.filled == 4 && result.cancelled == 2 && trades[0].resting_id == 11 && trades[0].price == 103);
+    CHECK(engine.book().order_count() == 0);
+
+    // FOK: all or nothing, including against the output limit
+    engine.submit(limit(30, Side::SELL, 100, 3), trades, 8);
+    engine.submit(limit(31, Side::SELL, 100, 3), trades, 8);
+    result = engine.submit(limit(32, Side::BUY, 100, 7, ORDER_FOK), trades, 8);
+    CHECK(result.status == MatchStatus::FOK_KILLED && result.filled == 0 && result.trades == 0);
+    result = engine.submit(limit(33, Side::BUY, 100, 6, ORDER_FOK), trades, 1);
+    CHECK(result.status == MatchStatus::FOK_KILLED);  // Needs two trade records
+    CHECK(engine.book().order_count() == 2);
+    result = engine.submit(limit(34, Side::BUY, 100, 4, ORDER_FOK), trades, 8);
+    CHECK(result.status == MatchStatus::ACCEPTED && result.filled == 4 && result.trades == 2);
+
+    // Post-only rests when passive and is rejected when it would take
+    CHECK(engine.submit(limit(40, Side::BUY, 100, 1, ORDER_POST_ONLY), trades, 8).status ==
+          MatchStatus::POST_ONLY_REJECTED);
+    CHECK(engine.submit(limit(41, Side::BUY, 99, 1, ORDER_POST_ONLY), trades, 8).resting == 1);
+    CHECK(engine.submit(limit(42, Side::BUY, 99, 1, ORDER_POST_ONLY | ORDER_IOC), trades, 8).status ==
+          MatchStatus::INVALID);
+
+    // Trade output limit stops matching and cancels the rest
+    engine.submit(limit(50, Side::SELL, 100, 1), trades, 8);
+    engine.submit(limit(51, Side::SELL, 100, 1), trades, 8);
+    result = engine.submit(limit(52, Side::BUY, 100, 4), trades, 2);
+    CHECK(result.status == MatchStatus::TRADE_LIMIT && result.trades == 2 && result.filled == 3);
+    CHECK(result.cancelled == 1 && result.resting == 0);
+
+    CHECK(engine.trade_count() == 10);
+    CHECK(engine.latency().count() == 21);  // Every submit, rejected ones included
+}
+
+void test_self_trade_prevention() {
+    Trade trades[8];
+    for (SelfTradePrevention mode : {SelfTradePrevention::CANCEL_NEWEST, SelfTradePrevention::CANCEL_OLDEST,
+                                     SelfTradePrevention::CANCEL_BOTH}) {
+        MatchingEngineConfig config;
+        config.measure_latency = false;
+        MatchingEngine engine(config);
+        engine.submit(limit(1, Side::SELL, 100, 5, 0, 7), trades, 8);   // Own order at the front
+        engine.submit(limit(2, Side::SELL, 100, 5, 0, 8), trades, 8);
+
+        OrderRequest request = limit(3, Side::BUY, 100, 5, 0, 7);
+        request.stp = mode;
+        MatchResult result = engine.submit(request, trades, 8);
+        if (mode == SelfTradePrevention::CANCEL_NEWEST) {
+            CHECK(result.status == MatchStatus::SELF_TRADE && result.cancelled == 5 && result.trades == 0);
+            CHECK(engine.book().order_count() == 2);
+        } else if (mode == SelfTradePrevention::CANCEL_OLDEST) {
+            CHECK(result.status == MatchStatus::ACCEPTED && result.filled == 5 && result.trades == 2);
+            CHECK(trades[0].resting_id == 1 && trades[0].flags == TRADE_STP_CANCEL && trades[0].quantity == 5);
+            CHECK(trades[1].resting_id == 2 && trades[1].flags == TRADE_RESTING_FILLED);
+            CHECK(engine.book().order_count() == 0);
+        } else {
+            CHECK(result.status == MatchStatus::SELF_TRADE && result.cancelled == 5 && result.trades == 1);
+            CHECK(trades[0].flags == TRADE_STP_CANCEL);
+            CHECK(engine.book().order_count() == 1 && engine.book().find_order(2));
+        }
+        CHECK(engine.latency().count() == 0);
+    }
+
+    // Owner 0 never self-trades, and FOK accounts for prevention
+    MatchingEngine engine;
+    engine.submit(limit(1, Side::SELL, 100, 5, 0, 7), trades, 8);
+    CHECK(engine.submit(limit(2, Side::BUY, 100, 5, ORDER_FOK, 7), trades, 8).status == MatchStatus::FOK_KILLED);
+    CHECK(engine.submit(limit(3, Side::BUY, 100, 5, ORDER_FOK), trades, 8).filled == 5);
+}
+
+void test_engine_modify_and_messages() {
+    MatchingEngine engine;
+    Trade trades[4];
+    engine.submit(limit(1, Side::BUY, 100, 5), trades, 4);
+    engine.submit(limit(2, Side::BUY, 100, 5), trades, 4);
+    engine.submit(limit(3, Side::SELL, 102, 5), trades, 4);
+
+    // A reduce keeps priority; repricing through the spread trades
+    CHECK(engine.modify(2, 100, 3, trades, 4).resting == 3);
+    MatchResult result = engine.modify(1, 102, 6, trades, 4);
+    CHECK(result.filled == 5 && result.resting == 1 && trades[0].aggressor_id == 1 && trades[0].resting_id == 3);
+    CHECK(engine.modify(9, 100, 1, trades, 4).status == MatchStatus::UNKNOWN_ORDER);
+    CHECK(engine.cancel(2).status == MatchStatus::ACCEPTED);
+    CHECK(engine.cancel(2).status == MatchStatus::UNKNOWN_ORDER);
+
+    MarketMessage message;
+    message.type = MessageType::NEW_ORDER;
+    message.order_id = 100;
+    message.side = Side::SELL;
+    message.price = engine.book().to_price(101);
+    message.size = 2;
+    result = engine.apply(message, trades, 4);
+    CHECK(result.filled == 1 && result.resting == 1 && trades[0].price == 102);
+    message.type = MessageType::CANCEL_ORDER;
+    CHECK(engine.apply(message, trades, 4).status == MatchStatus::ACCEPTED);
+    CHECK(engine.book().order_count() == 0);
+    message.type = MessageType::QUOTE;
+    CHECK(engine.apply(message, trades, 4).status == MatchStatus::INVALID);
+}
+
+void test_book_snapshot() {
+    std::string path = "/tmp/hft_book_snapshot_test_" + std::to_string(::getpid());
+    SnapshotReader reader;
+    CHECK(!reader.open(path));
+
+    SnapshotPublisher publisher;
+    CHECK(publisher.open(path, 4, 2));
+    CHECK(reader.open(path));
+    CHECK(reader.depth() == 2 && reader.symbol_capacity() == 4);
+    BookSnapshot snapshot;
+    CHECK(!reader.read(1, snapshot));  // Never published
+    CHECK(!reader.read(9, snapshot));
+
+    OrderBook book;
+    book.add(1, Side::BUY, 100, 5);
+    book.add(2, Side::BUY, 99, 6);
+    book.add(3, Side::BUY, 98, 7);   // Beyond the published depth
+    book.add(4, Side::SELL, 101, 8);
+    CHECK(publisher.publish(1, book, 1000));
+    CHECK(reader.read(1, snapshot));
+    CHECK(snapshot.sequence == 2 && snapshot.timestamp == 1000);
+    CHECK(snapshot.bid_count == 2 && snapshot.ask_count == 1);
+    CHECK(snapshot.bids[0].price == 100 && snapshot.bids[1].price == 99 && snapshot.bids[1].quantity == 6);
+    CHECK(snapshot.asks[0].price == 101 && snapshot.asks[0].orders == 1);
+
+    // Changes below the published depth are not republished
+    book.add(5, Side::BUY, 97, 1);
+    CHECK(!publisher.publish(1, book, 2000));
+    CHECK(reader.sequence(1) == 2);
+    book.cancel(4);
+    CHECK(publisher.publish(1, book, 3000));
+    CHECK(reader.read(1, snapshot) && snapshot.sequence == 4 && snapshot.ask_count == 0);
+    CHECK(!publisher.publish(4, book, 3000));  // Beyond the capacity
+
+    // A concurrent reader never sees a half-written book: every update
+    // keeps the best bid and ask quantities equal
+    std::atomic<bool> done{false};
+    std::atomic<int> torn{0};
+    std::thread reader_thread([&] {
+        BookSnapshot seen;
+        while (!done.load(std::memory_order_acquire)) {
+            if (reader.read(2, seen) && seen.bid_count == 1 && seen.ask_count == 1 &&
+                seen.bids[0].quantity != seen.asks[0].quantity) {
+                torn++;
+            }
+        }
+    });
+    OrderBook pair;
+    for (int i = 1; i <= 2000; ++i) {
+        pair.clear();
+        pair.add(1, Side::BUY, 100, i);
+        pair.add(2, Side::SELL, 101, i);
+        publisher.publish(2, pair, static_cast<uint64_t>(i));
+    }
+    done.store(true, std::memory_order_release);
+    reader_thread.join();
+    CHECK(torn.load() == 0);
+    CHECK(reader.read(2, snapshot) && snapshot.bids[0].quantity == 2000 && snapshot.timestamp == 2000);
+
+    publisher.close();
+    reader.close();
+    std::remove(path.c_str());
+}
+
+// Parsed FIX events applied through the BookManager
+void test_book_manager() {
+    SymbolRegistry registry;
+    uint32_t aapl = registry.intern("AAPL");
+    CHECK(registry.set_tick_size(aapl, 1000000));  // 0.01
+    MessageParser parser;
+    parser.set_symbol_registry(&registry);
+    BookManager books(OrderBookConfig(), &registry);
+
+    auto parse = [&](const std::string& body) {
+        std::string frame = "8=FIX.4.4\x01" + body;
+        MarketMessage message;
+        ParseContext context;
+        CHECK(parser.parse_message(frame.data(), frame.size(), message, context) == ParseResult::SUCCESS);
+        return message;
+    };
+
+    std::vector<MarketMessage> stream;
+    stream.push_back(parse("35=D\x01" "11=1\x01" "55=AAPL\x01" "54=1\x01" "44=150.25\x01" "38=100\x01"));
+    stream.push_back(parse("35=D\x01" "11=2\x01" "55=AAPL\x01" "54=1\x01" "44=150.25\x01" "38=50\x01"));
+    stream.push_back(parse("35=D\x01" "11=ORD-3\x01" "55=AAPL\x01" "54=2\x01" "44=150.27\x01" "38=10\x01"));
+    stream.push_back(parse("35=G\x01" "11=9\x01" "41=1\x01" "55=AAPL\x01" "54=1\x01" "44=150.24\x01" "38=100\x01"));
+    stream.push_back(parse("35=F\x01" "11=10\x01" "41=ORD-3\x01" "55=AAPL\x01" "54=2\x01"));
+    stream.push_back(parse("35=8\x01" "11=2\x01" "55=AAPL\x01" "44=150.25\x01" "38=20\x01"));
+    stream.push_back(parse("35=F\x01" "41=77\x01" "55=AAPL\x01"));
+    CHECK(books.apply(stream.data(), stream.size()) == 6);
+    CHECK(books.result_count(BookResult::UNKNOWN_ORDER) == 1);
+    CHECK(books.book_count() == 1);
+
+    const OrderBook* book = books.book(aapl);
+    CHECK(book != nullptr);
+    CHECK(book->tick_units() == 1000000);
+    BookLevel level;
+    CHECK(!book->best_ask(level));
+    CHECK(book->best_bid(level) && level.quantity == 30 && level.orders == 1);
+    CHECK(level.price == book->to_ticks(stream[0].price));  // 150.25 in ticks of 0.01
+    CHECK(book->level_count(Side::BUY) == 2);
+    CHECK(book->last_trade_size() == 20);
+
+    MarketMessage orphan = stream[0];
+    orphan.symbol_id = INVALID_SYMBOL_ID;
+    CHECK(books.apply(orphan) == BookResult::INVALID);
+    MarketMessage quote = stream[0];
+    quote.type = MessageType::QUOTE;
+    quote.symbol_id = aapl + 1;
+    CHECK(books.apply(quote) == BookResult::IGNORED);
+    CHECK(books.book(aapl + 1) == nullptr);
+}
+
+} // namespace
+
+int main() {
+    test_order_index();
+    test_order_pool();
+    test_levels_and_priority();
+    test_against_model();
+    test_arena_backed_book();
+    test_matching_engine();
+    test_self_trade_prevention();
+    test_engine_modify_and_messages();
+    test_book_snapshot();
+    test_book_manager();
+
+    if (g_failures > 0) {
+        std::fprintf(stderr, "%d check(s) failed\n", g_failures);
+        return 1;
+    }
+    std::printf("All order book tests passed\n");
+    return 0;
+}
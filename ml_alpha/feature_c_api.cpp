@@ -0,0 +1,92 @@
+#include "feature_c_api.h"
+#include "feature_engine.hpp"
+#include <cstdint>
+#include <cstring>
+#include <new>
+
+using hft::ingestion::MarketMessage;
+using hft::ml_alpha::FeatureConfig;
+using hft::ml_alpha::FeatureEngine;
+
+// Layout equality is checked field by field in ingestion/c_api.cpp
+static_assert(sizeof(hft_market_message) == sizeof(MarketMessage), "C message layout out of sync");
+
+struct hft_feature_engine {
+    explicit hft_feature_engine(const FeatureConfig& config) : engine(config) {}
+    FeatureEngine engine;
+};
+
+namespace {
+
+constexpr size_t BATCH_CHUNK = 256;
+
+} // namespace
+
+extern "C" {
+
+hft_feature_engine* hft_feature_engine_create(size_t symbol_capacity, uint64_t bucket_ns, uint32_t window_buckets,
+                                              int64_t tick_units) {
+    FeatureConfig config;
+    if (symbol_capacity) {
+        config.symbol_capacity = symbol_capacity;
+    }
+    if (bucket_ns) {
+        config.bucket_ns = bucket_ns;
+    }
+    if (window_buckets) {
+        config.window_buckets = window_buckets;
+    }
+    if (tick_units) {
+        config.tick_units = tick_units;
+    }
+    return new (std::nothrow) hft_feature_engine(config);
+}
+
+void hft_feature_engine_destroy(hft_feature_engine* engine) {
+    delete engine;
+}
+
+size_t hft_feature_engine_update(hft_feature_engine* engine, const hft_market_message* messages, size_t count) {
+    if (reinterpret_cast<uintptr_t>(messages) % alignof(MarketMessage) == 0) {
+        return engine->engine.update(reinterpret_cast<const MarketMessage*>(messages), count);
+    }
+    // NumPy buffers need not be cache-line aligned: go through an aligned copy, as c_api.cpp does
+    MarketMessage chunk[BATCH_CHUNK];
+    size_t changed = 0;
+    for (size_t first = 0; first < count; first += BATCH_CHUNK) {
+        size_t n = count - first < BATCH_CHUNK ? count - first : BATCH_CHUNK;
+        std::memcpy(static_cast<void*>(chunk), messages + first, n * sizeof(MarketMessage));
+        changed += engine->engine.update(chunk, n);
+    }
+    return changed;
+}
+
+void hft_feature_engine_advance(hft_feature_engine* engine, uint64_t now_ns) {
+    engine->engine.advance(now_ns);
+}
+
+void hft_feature_engine_clear(hft_feature_engine* engine) {
+    engine->engine.clear();
+}
+
+const double* hft_feature_engine_matrix(const hft_feature_engine* engine) {
+    return engine->engine.matrix();
+}
+
+size_t hft_feature_engine_stride(const hft_feature_engine* engine) {
+    return engine->engine.stride();
+}
+
+size_t hft_feature_engine_symbol_capacity(const hft_feature_engine* engine) {
+    return engine->engine.symbol_capacity();
+}
+
+uint64_t hft_feature_engine_now_ns(const hft_feature_engine* engine) {
+    return engine->engine.now_ns();
+}
+
+size_t hft_feature_count(void) {
+    return hft::ml_alpha::FEATURE_COUNT;
+}
+
+} // extern "C"
@@ -0,0 +1,42 @@
+/*
+ * C ABI for the streaming feature engine, used by features.py through
+ * ctypes. Messages are the ingestion parser's hft_market_message records
+ * (ingestion/c_api.h), so parsed batches go in without conversion, and the
+ * feature matrix comes back as a pointer NumPy can wrap without copying.
+ */
+#ifndef HFT_ML_ALPHA_FEATURE_C_API_H
+#define HFT_ML_ALPHA_FEATURE_C_API_H
+
+#include "c_api.h"
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct hft_feature_engine hft_feature_engine;
+
+/* Zero arguments take the FeatureConfig defaults; NULL on allocation failure */
+hft_feature_engine* hft_feature_engine_create(size_t symbol_capacity, uint64_t bucket_ns, uint32_t window_buckets,
+                                              int64_t tick_units);
+void hft_feature_engine_destroy(hft_feature_engine* engine);
+
+/* Returns the number of messages that changed features */
+size_t hft_feature_engine_update(hft_feature_engine* engine, const hft_market_message* messages, size_t count);
+void hft_feature_engine_advance(hft_feature_engine* engine, uint64_t now_ns);
+void hft_feature_engine_clear(hft_feature_engine* engine);
+
+/* Feature-major matrix of hft_feature_count() rows, hft_feature_engine_stride()
+ * doubles apart; valid until the engine is destroyed */
+const double* hft_feature_engine_matrix(const hft_feature_engine* engine);
+size_t hft_feature_engine_stride(const hft_feature_engine* engine);
+size_t hft_feature_engine_symbol_capacity(const hft_feature_engine* engine);
+uint64_t hft_feature_engine_now_ns(const hft_feature_engine* engine);
+size_t hft_feature_count(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* HFT_ML_ALPHA_FEATURE_C_API_H */
@@ -0,0 +1,202 @@
+#include "feature_engine.hpp"
+#include <algorithm>
+#include <cmath>
+#include <initializer_list>
+#include <limits>
+
+namespace hft {
+namespace ml_alpha {
+
+namespace {
+
+constexpr size_t DOUBLES_PER_LINE = 64 / sizeof(double);
+
+// Subtracts an expired bucket from the window sums and empties it. One
+// accumulator per call: with a single pair of arrays the compiler's alias
+// check stays simple enough to vectorize.
+void retire(double* sums, double* expired, size_t count) {
+    for (size_t i = 0; i < count; ++i) {
+        sums[i] -= expired[i];
+        expired[i] = 0.0;
+    }
+}
+
+FeatureConfig sanitize(FeatureConfig config) {
+    config.bucket_ns = std::max<uint64_t>(config.bucket_ns, 1);
+    config.window_buckets = std::max<uint32_t>(config.window_buckets, 1);
+    config.tick_units = std::max<int64_t>(config.tick_units, 1);
+    return config;
+}
+
+} // namespace
+
+FeatureEngine::FeatureEngine(const FeatureConfig& config, const ingestion::SymbolRegistry* registry)
+    : config_(sanitize(config)),
+      registry_(registry),
+      stride_((config_.symbol_capacity + DOUBLES_PER_LINE - 1) / DOUBLES_PER_LINE * DOUBLES_PER_LINE),
+      trades_per_second_(1e9 / static_cast<double>(config_.bucket_ns * config_.window_buckets)),
+      tracker_(config_.symbol_capacity),
+      matrix_(FEATURE_COUNT * stride_),
+      bid_(stride_),
+      ask_(stride_),
+      bid_size_(stride_),
+      ask_size_(stride_),
+      ofi_buckets_(config_.window_buckets * stride_),
+      variance_buckets_(config_.window_buckets * stride_),
+      trade_buckets_(config_.window_buckets * stride_),
+      variance_(stride_),
+      trades_(stride_) {
+    clear();
+}
+
+bool FeatureEngine::update(const ingestion::MarketMessage& message) {
+    ingestion::BboEvent event;
+    if (!tracker_.apply(message, &event)) {
+        return false;  // Unchanged quote, order-level message or unknown symbol
+    }
+    on_event(event);
+    return true;
+}
+
+size_t FeatureEngine::update(const ingestion::MarketMessage* messages, size_t count) {
+    size_t changed = 0;
+    for (size_t i = 0; i < count; ++i) {
+        if (update(messages[i])) {
+            changed++;
+        }
+    }
+    return changed;
+}
+
+void FeatureEngine::on_event(const ingestion::BboEvent& event) {
+    if (event.symbol_id >= config_.symbol_capacity) {
+        return;
+    }
+    roll(event.timestamp);
+    if (event.type == ingestion::BboEventType::QUOTE) {
+        on_quote(event.symbol_id, event.bbo);
+    } else {
+        on_trade(event.symbol_id);
+    }
+}
+
+void FeatureEngine::advance(uint64_t now_ns) {
+    roll(now_ns);
+}
+
+void FeatureEngine::clear() {
+    tracker_.clear();
+    const double nan = std::numeric_limits<double>::quiet_NaN();
+    std::fill(matrix_.begin(), matrix_.end(), 0.0);
+    std::fill(row(Feature::MID), row(Feature::MID) + stride_, nan);
+    std::fill(row(Feature::MICROPRICE), row(Feature::MICROPRICE) + stride_, nan);
+    std::fill(row(Feature::SPREAD), row(Feature::SPREAD) + stride_, nan);
+    for (std::vector<double>* values : {&bid_, &ask_, &bid_size_, &ask_size_, &ofi_buckets_, &variance_buckets_,
+                                        &trade_buckets_, &variance_, &trades_}) {
+        std::fill(values->begin(), values->end(), 0.0);
+    }
+    bucket_ = 0;
+    now_ns_ = 0;
+}
+
+// Retires every bucket that fell out of the window. Each retirement is one
+// pass over all symbols per accumulator, with no per-symbol branching.
+void FeatureEngine::roll(uint64_t now_ns) {
+    if (now_ns <= now_ns_) {
+        return;
+    }
+    now_ns_ = now_ns;
+    uint64_t bucket = now_ns / config_.bucket_ns;
+    if (bucket == bucket_) {
+        return;
+    }
+
+    double* ofi = row(Feature::OFI);
+    double* variance = variance_.data();
+    double* trades = trades_.data();
+    if (bucket - bucket_ >= config_.window_buckets) {
+        std::fill(ofi, ofi + stride_, 0.0);  // The whole window expired
+        std::fill(variance_.begin(), variance_.end(), 0.0);
+        std::fill(trades_.begin(), trades_.end(), 0.0);
+        std::fill(ofi_buckets_.begin(), ofi_buckets_.end(), 0.0);
+        std::fill(variance_buckets_.begin(), variance_buckets_.end(), 0.0);
+        std::fill(trade_buckets_.begin(), trade_buckets_.end(), 0.0);
+        bucket_ = bucket;
+    }
+    while (bucket_ < bucket) {
+        bucket_++;
+        retire(ofi, ofi_buckets_.data() + slot(), stride_);
+        retire(variance, variance_buckets_.data() + slot(), stride_);
+        retire(trades, trade_buckets_.data() + slot(), stride_);
+    }
+    for (size_t i = 0; i < stride_; ++i) {
+        variance[i] = std::max(variance[i], 0.0);  // No rounding residue below 0
+    }
+    refresh_windowed();
+}
+
+void FeatureEngine::refresh_windowed() {
+    double* volatility = row(Feature::VOLATILITY);
+    double* intensity = row(Feature::TRADE_INTENSITY);
+    const double* variance = variance_.data();
+    const double* trades = trades_.data();
+    for (size_t i = 0; i < stride_; ++i) {
+        volatility[i] = std::sqrt(variance[i]);
+        intensity[i] = trades[i] * trades_per_second_;
+    }
+}
+
+void FeatureEngine::on_quote(uint32_t symbol_id, const ingestion::Bbo& bbo) {
+    int64_t tick_units = registry_ ? registry_->tick_size(symbol_id) : config_.tick_units;
+    double bid = ingestion::price_to_double(bbo.bid_price, tick_units);
+    double ask = ingestion::price_to_double(bbo.ask_price, tick_units);
+    double bid_size = bbo.bid_size;
+    double ask_size = bbo.ask_size;
+    double previous_bid = bid_[symbol_id];
+    double previous_ask = ask_[symbol_id];
+
+    double flow = 0.0;
+    if (bid > 0.0 && previous_bid > 0.0) {
+        flow += (bid >= previous_bid ? bid_size : 0.0) - (bid <= previous_bid ? bid_size_[symbol_id] : 0.0);
+    }
+    if (ask > 0.0 && previous_ask > 0.0) {
+        flow -= (ask <= previous_ask ? ask_size : 0.0) - (ask >= previous_ask ? ask_size_[symbol_id] : 0.0);
+    }
+    if (flow != 0.0) {
+        ofi_buckets_[slot() + symbol_id] += flow;
+        row(Feature::OFI)[symbol_id] += flow;
+    }
+    bid_[symbol_id] = bid;
+    ask_[symbol_id] = ask;
+    bid_size_[symbol_id] = bid_size;
+    ask_size_[symbol_id] = ask_size;
+
+    if (bid <= 0.0 || ask <= 0.0) {
+        const double nan = std::numeric_limits<double>::quiet_NaN();
+        row(Feature::MID)[symbol_id] = nan;
+        row(Feature::MICROPRICE)[symbol_id] = nan;
+        row(Feature::SPREAD)[symbol_id] = nan;
+        return;
+    }
+    double mid = (bid + ask) * 0.5;
+    double previous_mid = row(Feature::MID)[symbol_id];
+    if (previous_mid > 0.0 && mid != previous_mid) {  // False for NaN: no return across a gap in the quote
+        double r = std::log(mid / previous_mid);
+        variance_buckets_[slot() + symbol_id] += r * r;
+        variance_[symbol_id] += r * r;
+        row(Feature::VOLATILITY)[symbol_id] = std::sqrt(variance_[symbol_id]);
+    }
+    row(Feature::MID)[symbol_id] = mid;
+    row(Feature::MICROPRICE)[symbol_id] =
+        bid_size + ask_size > 0.0 ? (bid * ask_size + ask * bid_size) / (bid_size + ask_size) : mid;
+    row(Feature::SPREAD)[symbol_id] = ask - bid;
+}
+
+void FeatureEngine::on_trade(uint32_t symbol_id) {
+    trade_buckets_[slot() + symbol_id] += 1.0;
+    trades_[symbol_id] += 1.0;
+    row(Feature::TRADE_INTENSITY)[symbol_id] = trades_[symbol_id] * trades_per_second_;
+}
+
+} // namespace ml_alpha
+} // namespace hft
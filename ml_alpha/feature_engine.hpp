@@ -0,0 +1,103 @@
+#pragma once
+
+#include "bbo_tracker.hpp"
+#include "message_types.hpp"
+#include "price.hpp"
+#include "symbol_registry.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace hft {
+namespace ml_alpha {
+
+// Rows of the feature matrix
+enum class Feature : uint8_t {
+    MID = 0,          // (bid + ask) / 2, NaN until both sides are quoted
+    MICROPRICE,       // Size-weighted mid: (bid * ask_size + ask * bid_size) / (bid_size + ask_size)
+    SPREAD,           // ask - bid
+    OFI,              // Order-flow imbalance summed over the window, in shares
+    VOLATILITY,       // Realized volatility of log mid returns over the window (not annualized)
+    TRADE_INTENSITY   // Trades per second over the window
+};
+
+constexpr size_t FEATURE_COUNT = 6;
+
+struct FeatureConfig {
+    size_t symbol_capacity = 4096;       // Symbol ids tracked
+    uint64_t bucket_ns = 100000000;      // Rolling windows advance in 100 ms buckets
+    uint32_t window_buckets = 50;        // Window length: 5 s by default
+    int64_t tick_units = ingestion::DEFAULT_TICK_UNITS;  // Converts prices to decimals when there is no registry
+};
+
+// Streaming feature extraction over the parsed message stream.
+//
+// State is struct-of-arrays: every feature, BBO field and window
+// accumulator is its own array indexed by symbol id. A message touches one
+// symbol's entries; rolling a window bucket retires the oldest bucket of
+// every symbol at once, a contiguous pass that the compiler vectorizes
+// across symbols. Features are current after each update, so readers
+// never recompute them.
+//
+// OFI follows Cont, Kukanov and Stoikov: each BBO change adds the bid-side
+// size gained minus the ask-side size gained, comparing the new touch with
+// the previous one.
+//
+// Time is the message timestamps (never earlier than the latest seen);
+// advance() rolls the windows forward when the feed is quiet.
+// Single-threaded, like BboTracker.
+//
+// With a registry, each symbol's prices are read at its own tick size, as
+// the parser priced them; config.tick_units then goes unused.
+class FeatureEngine {
+public:
+    explicit FeatureEngine(const FeatureConfig& config = FeatureConfig(),
+                           const ingestion::SymbolRegistry* registry = nullptr);
+
+    // QUOTE, MARKET_DATA and TRADE messages; returns true if features changed
+    bool update(const ingestion::MarketMessage& message);
+    size_t update(const ingestion::MarketMessage* messages, size_t count);
+
+    // For a BboTracker the caller already runs: subscribe a listener calling this
+    void on_event(const ingestion::BboEvent& event);
+
+    void advance(uint64_t now_ns);
+
+    // Feature-major matrix: row f holds feature f for every symbol id, and
+    // rows start stride() values apart. Stable for the engine's lifetime.
+    const double* matrix() const { return matrix_.data(); }
+    const double* row(Feature feature) const { return matrix_.data() + static_cast<size_t>(feature) * stride_; }
+    double value(uint32_t symbol_id, Feature feature) const {
+        return symbol_id < config_.symbol_capacity ? row(feature)[symbol_id] : 0.0;
+    }
+    size_t stride() const { return stride_; }
+    size_t symbol_capacity() const { return config_.symbol_capacity; }
+
+    uint64_t now_ns() const { return now_ns_; }
+    uint64_t window_ns() const { return config_.bucket_ns * config_.window_buckets; }
+    void clear();
+
+private:
+    double* row(Feature feature) { return matrix_.data() + static_cast<size_t>(feature) * stride_; }
+    void roll(uint64_t now_ns);
+    void refresh_windowed();  // VOLATILITY and TRADE_INTENSITY of every symbol from the rolling sums
+    void on_quote(uint32_t symbol_id, const ingestion::Bbo& bbo);
+    void on_trade(uint32_t symbol_id);
+    size_t slot() const { return static_cast<size_t>(bucket_ % config_.window_buckets) * stride_; }
+
+    FeatureConfig config_;
+    const ingestion::SymbolRegistry* registry_;
+    size_t stride_;             // symbol_capacity rounded up to a cache line of doubles
+    double trades_per_second_;  // Window trade count -> TRADE_INTENSITY
+    ingestion::BboTracker tracker_;
+
+    std::vector<double> matrix_;                       // FEATURE_COUNT x stride
+    std::vector<double> bid_, ask_, bid_size_, ask_size_;
+    std::vector<double> ofi_buckets_, variance_buckets_, trade_buckets_;  // window_buckets x stride
+    std::vector<double> variance_, trades_;            // Window sums; OFI's is its matrix row
+    uint64_t bucket_;           // Index of the current bucket, now_ns / bucket_ns
+    uint64_t now_ns_;
+};
+
+} // namespace ml_alpha
+} // namespace hft
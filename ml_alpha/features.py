@@ -0,0 +1,125 @@
+"""
+Zero-copy NumPy access to the C++ streaming feature engine
+(feature_engine.hpp) through the C ABI in feature_c_api.h.
+
+Features are computed in C++ as messages go in; `matrix` is a read-only
+view of the engine's own feature matrix, so a model can read features for
+every symbol after each batch without Python recomputing or copying them.
+Batches are MESSAGE_DTYPE arrays from the ingestion parser
+(hft_ingestion_py.Parser.parse_batch) or any buffer of hft_market_message
+records.
+"""
+
+import ctypes
+import os
+from typing import Optional, Sequence
+
+import numpy as np
+
+# Rows of the matrix, in hft::ml_alpha::Feature order
+FEATURE_NAMES = ('mid', 'microprice', 'spread', 'ofi', 'volatility', 'trade_intensity')
+MESSAGE_SIZE = 64  # sizeof(hft_market_message)
+
+_LIBRARY_NAMES = ('libhft_features.so', 'libhft_features.dylib', 'hft_features.dll')
+
+
+def _load(library_path: Optional[str]) -> ctypes.CDLL:
+    candidates: Sequence[str]
+    if library_path is not None:
+        candidates = (library_path,)
+    else:
+        here = os.path.dirname(os.path.abspath(__file__))
+        candidates = [os.path.join(directory, name)
+                      for directory in (here, '.', './build', './build/ml_alpha')
+                      for name in _LIBRARY_NAMES]
+    for path in candidates:
+        if os.path.exists(path):
+            return ctypes.CDLL(path)
+    raise RuntimeError(f"hft_features library not found (tried {', '.join(candidates)})")
+
+
+class FeatureEngine:
+    """Owns one hft::ml_alpha::FeatureEngine; zero arguments mean the C++ defaults"""
+
+    def __init__(self, symbol_capacity: int = 0, bucket_ns: int = 0, window_buckets: int = 0,
+                 tick_units: int = 0, library_path: Optional[str] = None):
+        lib = _load(library_path)
+        lib.hft_feature_engine_create.argtypes = [ctypes.c_size_t, ctypes.c_uint64, ctypes.c_uint32,
+                                                  ctypes.c_int64]
+        lib.hft_feature_engine_create.restype = ctypes.c_void_p
+        lib.hft_feature_engine_destroy.argtypes = [ctypes.c_void_p]
+        lib.hft_feature_engine_destroy.restype = None
+        lib.hft_feature_engine_update.argtypes = [ctypes.c_void_p, ctypes.c_void_p, ctypes.c_size_t]
+        lib.hft_feature_engine_update.restype = ctypes.c_size_t
+        lib.hft_feature_engine_advance.argtypes = [ctypes.c_void_p, ctypes.c_uint64]
+        lib.hft_feature_engine_advance.restype = None
+        lib.hft_feature_engine_clear.argtypes = [ctypes.c_void_p]
+        lib.hft_feature_engine_clear.restype = None
+        lib.hft_feature_engine_matrix.argtypes = [ctypes.c_void_p]
+        lib.hft_feature_engine_matrix.restype = ctypes.POINTER(ctypes.c_double)
+        lib.hft_feature_engine_stride.argtypes = [ctypes.c_void_p]
+        lib.hft_feature_engine_stride.restype = ctypes.c_size_t
+        lib.hft_feature_engine_symbol_capacity.argtypes = [ctypes.c_void_p]
+        lib.hft_feature_engine_symbol_capacity.restype = ctypes.c_size_t
+        lib.hft_feature_engine_now_ns.argtypes = [ctypes.c_void_p]
+        lib.hft_feature_engine_now_ns.restype = ctypes.c_uint64
+        lib.hft_feature_count.argtypes = []
+        lib.hft_feature_count.restype = ctypes.c_size_t
+        if lib.hft_feature_count() != len(FEATURE_NAMES):
+            raise RuntimeError("hft_features library does not match FEATURE_NAMES")
+
+        self._lib = lib
+        self._engine = lib.hft_feature_engine_create(symbol_capacity, bucket_ns, window_buckets, tick_units)
+        if not self._engine:
+            raise MemoryError("hft_feature_engine_create failed")
+        self.symbol_capacity = lib.hft_feature_engine_symbol_capacity(self._engine)
+        stride = lib.hft_feature_engine_stride(self._engine)
+        full = np.ctypeslib.as_array(lib.hft_feature_engine_matrix(self._engine),
+                                     shape=(len(FEATURE_NAMES), stride))
+        full.flags.writeable = False
+        self.matrix = full[:, :self.symbol_capacity]  # (feature, symbol id), shares the engine's memory
+
+    def close(self) -> None:
+        if self._engine:
+            self.matrix = None
+            self._lib.hft_feature_engine_destroy(self._engine)
+            self._engine = None
+
+    def __del__(self):
+        self.close()
+
+    def update(self, messages) -> int:
+        """Apply a contiguous batch of 64-byte message records; returns how many changed features"""
+        view = memoryview(messages).cast('B')
+        if not view.contiguous or view.nbytes % MESSAGE_SIZE:
+            raise ValueError("messages must be a contiguous buffer of 64-byte records")
+        count = view.nbytes // MESSAGE_SIZE
+        if count == 0:
+            return 0
+        buffer = (ctypes.c_char * view.nbytes).from_buffer_copy(view) if view.readonly else \
+            (ctypes.c_char * view.nbytes).from_buffer(view)
+        return self._lib.hft_feature_engine_update(self._engine, ctypes.addressof(buffer), count)
+
+    def advance(self, now_ns: int) -> None:
+        """Roll the windows forward without a message"""
+        self._lib.hft_feature_engine_advance(self._engine, now_ns)
+
+    def clear(self) -> None:
+        self._lib.hft_feature_engine_clear(self._engine)
+
+    @property
+    def now_ns(self) -> int:
+        return self._lib.hft_feature_engine_now_ns(self._engine)
+
+    def row(self, name: str) -> np.ndarray:
+        """One feature for every symbol id"""
+        return self.matrix[FEATURE_NAMES.index(name)]
+
+    def frame(self) -> np.ndarray:
+        """(symbol id, feature) view for models that take one row per sample"""
+        return self.matrix.T
+
+
+if __name__ == '__main__':
+    engine = FeatureEngine(symbol_capacity=16)
+    print(dict(zip(FEATURE_NAMES, engine.frame()[0])))
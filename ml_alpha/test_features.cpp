@@ -0,0 +1,263 @@
+// Unit tests for the streaming feature engine and its C ABI.
+
+#include "bbo_tracker.hpp"
+#include "feature_c_api.h"
+#include "feature_engine.hpp"
+#include "symbol_registry.hpp"
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <random>
+#include <vector>
+
+using namespace hft::ingestion;
+using namespace hft::ml_alpha;
+
+static int g_failures = 0;
+
+#define CHECK(cond)                                                           \
+    do {                                                                      \
+        if (!(cond)) {                                                        \
+            std::fprintf(stderr, "%s:%d: CHECK failed: %s\n", __FILE__, __LINE__, #cond); \
+            g_failures++;                                                     \
+        }                                                                     \
+    } while (0)
+
+namespace {
+
+constexpr uint64_t MS = 1000000ULL;
+constexpr uint64_t SECOND = 1000 * MS;
+constexpr uint64_t T0 = 1705312800ULL * SECOND;  // 2024-01-15 10:00:00 UTC
+constexpr int64_t CENT = 1000000;                // 0.01 in raw fixed-point units
+
+bool near(double a, double b) { return std::fabs(a - b) < 1e-9; }
+
+MarketMessage quote(uint64_t timestamp, uint32_t symbol_id, int64_t bid, int32_t bid_size, int64_t ask,
+                    int32_t ask_size) {
+    MarketMessage message;
+    message.timestamp = timestamp;
+    message.type = MessageType::QUOTE;
+    message.symbol_id = symbol_id;
+    message.flags = MESSAGE_FLAG_TWO_SIDED;
+    message.price = ticks_to_price(bid, CENT);
+    message.size = bid_size;
+    message.ask_price = ticks_to_price(ask, CENT);
+    message.ask_size = ask_size;
+    return message;
+}
+
+MarketMessage trade(uint64_t timestamp, uint32_t symbol_id) {
+    MarketMessage message;
+    message.timestamp = timestamp;
+    message.type = MessageType::TRADE;
+    message.symbol_id = symbol_id;
+    message.price = ticks_to_price(10001, CENT);
+    message.size = 10;
+    return message;
+}
+
+FeatureConfig config_for_tests() {
+    FeatureConfig config;
+    config.symbol_capacity = 10;
+    config.tick_units = CENT;
+    return config;  // 100 ms buckets, 5 s window
+}
+
+void test_features() {
+    FeatureEngine engine(config_for_tests());
+    CHECK(engine.stride() == 16 && engine.window_ns() == 5 * SECOND);
+    CHECK(std::isnan(engine.value(0, Feature::MID)) && engine.value(0, Feature::OFI) == 0.0);
+
+    CHECK(engine.update(quote(T0, 0, 10000, 500, 10002, 300)));
+    CHECK(near(engine.value(0, Feature::MID), 100.01) && near(engine.value(0, Feature::SPREAD), 0.02));
+    CHECK(near(engine.value(0, Feature::MICROPRICE), (100.00 * 300 + 100.02 * 500) / 800));
+    CHECK(engine.value(0, Feature::OFI) == 0.0);  // Nothing to compare the first touch with
+    CHECK(!engine.update(quote(T0, 0, 10000, 500, 10002, 300)));  // Repeat: no change
+
+    // Bid size up 200 at the same price, then the offer steps down with 100
+    engine.update(quote(T0 + 10 * MS, 0, 10000, 700, 10002, 300));
+    CHECK(engine.value(0, Feature::OFI) == 200.0);
+    engine.update(quote(T0 + 20 * MS, 0, 10000, 700, 10001, 100));
+    CHECK(engine.value(0, Feature::OFI) == 100.0);
+    double r = std::log(100.005 / 100.01);
+    CHECK(near(engine.value(0, Feature::VOLATILITY), std::fabs(r)));
+
+    MarketMessage prints[3] = {trade(T0 + 30 * MS, 0), trade(T0 + 40 * MS, 0), trade(T0 + 40 * MS, 1)};
+    CHECK(engine.update(prints, 3) == 3);
+    CHECK(near(engine.value(0, Feature::TRADE_INTENSITY), 2 / 5.0));
+    CHECK(near(engine.value(1, Feature::TRADE_INTENSITY), 1 / 5.0) && std::isnan(engine.value(1, Feature::MID)));
+
+    // Offer lifted back up: the size that left counts for the buyer
+    engine.update(quote(T0 + 2 * SECOND, 0, 10000, 700, 10002, 300));
+    CHECK(engine.value(0, Feature::OFI) == 200.0);
+
+    // The first bucket leaves the window; the +2 s quote stays
+    engine.advance(T0 + 5 * SECOND);
+    CHECK(engine.value(0, Feature::OFI) == 100.0 && engine.value(0, Feature::TRADE_INTENSITY) == 0.0);
+    CHECK(near(engine.value(0, Feature::VOLATILITY), std::fabs(r)));  // The step back up at +2 s
+    engine.advance(T0 + 60 * SECOND);
+    CHECK(engine.value(0, Feature::OFI) == 0.0 && engine.value(0, Feature::VOLATILITY) == 0.0);
+    CHECK(near(engine.value(0, Feature::MID), 100.01));  // Levels persist; only flows expire
+    engine.advance(T0);                                   // Time never goes back
+    CHECK(engine.now_ns() == T0 + 60 * SECOND);
+
+    // One-sided book: price features go NaN, no return is taken across the gap
+    MarketMessage bid_only = quote(T0 + 61 * SECOND, 0, 10000, 700, 0, 0);
+    engine.update(bid_only);
+    CHECK(std::isnan(engine.value(0, Feature::MICROPRICE)));
+    engine.update(quote(T0 + 62 * SECOND, 0, 10010, 700, 10012, 300));
+    CHECK(engine.value(0, Feature::VOLATILITY) == 0.0);
+
+    CHECK(!engine.update(quote(T0, 99, 10000, 1, 10001, 1)));  // Beyond capacity
+    CHECK(engine.value(99, Feature::MID) == 0.0);
+    engine.clear();
+    CHECK(std::isnan(engine.value(0, Feature::MID)) && engine.now_ns() == 0);
+}
+
+// Windowed features against a brute-force recomputation from an event log
+void test_rolling_model() {
+    FeatureConfig config = config_for_tests();
+    config.bucket_ns = 10 * MS;
+    config.window_buckets = 20;
+    FeatureEngine engine(config);
+
+    struct Sample {
+        uint64_t bucket;
+        uint32_t symbol;
+        double flow;
+        double variance;
+        double trades;
+    };
+    std::vector<Sample> log;
+    std::vector<MarketMessage> last(config.symbol_capacity);
+    std::mt19937_64 rng(11);
+    uint64_t now = T0;
+    bool ok = true;
+    for (int i = 0; i < 5000; ++i) {
+        now += rng() % (rng() % 50 == 0 ? 500 * MS : 3 * MS);
+        uint32_t symbol = static_cast<uint32_t>(rng() % config.symbol_capacity);
+        Sample sample{now / config.bucket_ns, symbol, 0.0, 0.0, 0.0};
+        if (rng() % 4 == 0) {
+            engine.update(trade(now, symbol));
+            sample.trades = 1.0;
+        } else {
+            int64_t bid = 10000 + static_cast<int64_t>(rng() % 5);
+            MarketMessage next = quote(now, symbol, bid, 1 + static_cast<int32_t>(rng() % 900), bid + 1 + rng() % 3,
+                                       1 + static_cast<int32_t>(rng() % 900));
+            double previous_mid = engine.value(symbol, Feature::MID);
+            if (!engine.update(next)) {
+                continue;
+            }
+            const MarketMessage& prev = last[symbol];
+            if (prev.timestamp) {
+                double b = price_to_double(next.price, CENT), pb = price_to_double(prev.price, CENT);
+                double a = price_to_double(next.ask_price, CENT), pa = price_to_double(prev.ask_price, CENT);
+                sample.flow = (b >= pb ? next.size : 0) - (b <= pb ? prev.size : 0) -
+                              (a <= pa ? next.ask_size : 0) + (a >= pa ? prev.ask_size : 0);
+                double mid = (a + b) / 2;
+                if (mid != previous_mid) {
+                    sample.variance = std::log(mid / previous_mid) * std::log(mid / previous_mid);
+                }
+            }
+            last[symbol] = next;
+        }
+        log.push_back(sample);
+
+        if (i % 97 == 0) {
+            std::vector<double> flow(config.symbol_capacity), variance(config.symbol_capacity),
+                trades(config.symbol_capacity);
+            uint64_t bucket = now / config.bucket_ns;
+            for (const Sample& s : log) {
+                if (s.bucket + config.window_buckets > bucket) {
+                    flow[s.symbol] += s.flow;
+                    variance[s.symbol] += s.variance;
+                    trades[s.symbol] += s.trades;
+                }
+            }
+            for (uint32_t s = 0; s < config.symbol_capacity; ++s) {
+                ok = ok && engine.value(s, Feature::OFI) == flow[s];
+                ok = ok && std::fabs(engine.value(s, Feature::VOLATILITY) - std::sqrt(variance[s])) < 1e-9;
+                ok = ok && near(engine.value(s, Feature::TRADE_INTENSITY), trades[s] * 1e9 / engine.window_ns());
+            }
+        }
+    }
+    CHECK(ok);
+}
+
+void test_shared_tracker() {
+    BboTracker tracker(10);
+    FeatureEngine engine(config_for_tests());
+    tracker.subscribe([&](const BboEvent& event) { engine.on_event(event); });
+    tracker.apply(quote(T0, 3, 10000, 100, 10002, 100));
+    tracker.apply(quote(T0 + MS, 3, 10001, 100, 10002, 100));
+    CHECK(engine.value(3, Feature::OFI) == 100.0 && near(engine.value(3, Feature::MID), 100.015));
+}
+
+// Each symbol's prices are read at its registry tick size
+void test_registry_ticks() {
+    constexpr int64_t QUARTER = 25 * CENT;
+    SymbolRegistry registry(16);
+    uint32_t aapl = registry.intern("AAPL");
+    uint32_t es = registry.intern("ES");
+    CHECK(registry.set_tick_size(aapl, CENT) && registry.set_tick_size(es, QUARTER));
+    FeatureConfig config = config_for_tests();
+    config.tick_units = 1;  // Unused with a registry
+    FeatureEngine engine(config, &registry);
+
+    engine.update(quote(T0, aapl, 10000, 100, 10002, 100));
+    MarketMessage message = quote(T0 + MS, es, 0, 10, 0, 30);
+    message.price = ticks_to_price(20000, QUARTER);
+    message.ask_price = ticks_to_price(20001, QUARTER);
+    engine.update(message);
+    CHECK(near(engine.value(aapl, Feature::MID), 100.01) && near(engine.value(aapl, Feature::SPREAD), 0.02));
+    CHECK(near(engine.value(es, Feature::MID), 5000.125) && near(engine.value(es, Feature::SPREAD), 0.25));
+    CHECK(near(engine.value(es, Feature::MICROPRICE), 5000.0625));
+
+    message.timestamp = T0 + 2 * MS;
+    message.price = ticks_to_price(20001, QUARTER);
+    message.ask_price = ticks_to_price(20002, QUARTER);
+    engine.update(message);
+    CHECK(near(engine.value(es, Feature::VOLATILITY), std::log(5000.375 / 5000.125)));
+}
+
+void test_c_api() {
+    CHECK(hft_feature_count() == FEATURE_COUNT);
+    hft_feature_engine* engine = hft_feature_engine_create(10, 0, 0, CENT);
+    CHECK(engine != nullptr);
+    CHECK(hft_feature_engine_symbol_capacity(engine) == 10 && hft_feature_engine_stride(engine) == 16);
+
+    // Unaligned input, as a NumPy slice may be
+    std::vector<unsigned char> storage(3 * sizeof(MarketMessage) + 8);
+    hft_market_message* messages = reinterpret_cast<hft_market_message*>(storage.data() + 8);
+    MarketMessage batch[2] = {quote(T0, 2, 10000, 500, 10002, 300), quote(T0 + MS, 2, 10000, 600, 10002, 300)};
+    std::memcpy(static_cast<void*>(messages), batch, sizeof(batch));
+    CHECK(hft_feature_engine_update(engine, messages, 2) == 2);
+
+    const double* matrix = hft_feature_engine_matrix(engine);
+    size_t stride = hft_feature_engine_stride(engine);
+    CHECK(matrix[static_cast<size_t>(Feature::OFI) * stride + 2] == 100.0);
+    CHECK(near(matrix[static_cast<size_t>(Feature::MID) * stride + 2], 100.01));
+    hft_feature_engine_advance(engine, T0 + SECOND);
+    CHECK(hft_feature_engine_now_ns(engine) == T0 + SECOND);
+    hft_feature_engine_clear(engine);
+    CHECK(std::isnan(matrix[static_cast<size_t>(Feature::MID) * stride + 2]));  // Same memory after clear
+    hft_feature_engine_destroy(engine);
+}
+
+} // namespace
+
+int main() {
+    test_features();
+    test_rolling_model();
+    test_shared_tracker();
+    test_registry_ticks();
+    test_c_api();
+
+    if (g_failures > 0) {
+        std::fprintf(stderr, "%d check(s) failed\n", g_failures);
+        return 1;
+    }
+    std::printf("All ml_alpha tests passed\n");
+    return 0;
+}
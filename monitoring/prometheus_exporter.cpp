@@ -0,0 +1,177 @@
+#include "prometheus_exporter.hpp"
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstring>
+
+namespace hft {
+namespace monitoring {
+
+namespace {
+
+constexpr int ACCEPT_POLL_MS = 100;       // How quickly stop() is noticed
+constexpr int CLIENT_TIMEOUT_MS = 2000;   // Per-connection read/write timeout
+constexpr size_t MAX_REQUEST_BYTES = 8192;
+constexpr int LISTEN_BACKLOG = 16;
+constexpr const char* METRICS_CONTENT_TYPE = "text/plain; version=0.0.4; charset=utf-8";
+
+bool send_all(int fd, const char* data, size_t length) {
+    while (length > 0) {
+        ssize_t sent = ::send(fd, data, length, MSG_NOSIGNAL);
+        if (sent < 0 && errno == EINTR) {
+            continue;
+        }
+        if (sent <= 0) {
+            return false;
+        }
+        data += sent;
+        length -= static_cast<size_t>(sent);
+    }
+    return true;
+}
+
+void send_response(int fd, const char* status, const char* content_type, const std::string& body) {
+    std::string response = "HTTP/1.1 ";
+    response += status;
+    response += "\r\nContent-Type: ";
+    response += content_type;
+    response += "\r\nContent-Length: ";
+    response += std::to_string(body.size());
+    response += "\r\nConnection: close\r\n\r\n";
+    response += body;
+    send_all(fd, response.data(), response.size());
+}
+
+} // namespace
+
+PrometheusExporter::PrometheusExporter()
+    : running_(false), scrapes_(0), listen_fd_(-1), port_(0) {}
+
+PrometheusExporter::~PrometheusExporter() {
+    stop();
+}
+
+void PrometheusExporter::add_collector(MetricsCollector collector) {
+    std::lock_guard<std::mutex> lock(collectors_mutex_);
+    collectors_.push_back(std::move(collector));
+}
+
+bool PrometheusExporter::start(uint16_t port, const std::string& bind_address) {
+    if (running()) {
+        return false;
+    }
+
+    sockaddr_in address{};
+    address.sin_family = AF_INET;
+    address.sin_port = htons(port);
+    if (::inet_pton(AF_INET, bind_address.c_str(), &address.sin_addr) != 1) {
+        return false;
+    }
+
+    int fd = ::socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (fd < 0) {
+        return false;
+    }
+    int reuse = 1;
+    ::setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+    socklen_t address_length = sizeof(address);
+    if (::bind(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0 ||
+        ::listen(fd, LISTEN_BACKLOG) != 0 ||
+        ::getsockname(fd, reinterpret_cast<sockaddr*>(&address), &address_length) != 0) {
+        ::close(fd);
+        return false;
+    }
+
+    listen_fd_ = fd;
+    port_ = ntohs(address.sin_port);
+    running_.store(true, std::memory_order_release);
+    thread_ = std::thread(&PrometheusExporter::serve, this);
+    return true;
+}
+
+void PrometheusExporter::stop() {
+    if (!running_.exchange(false, std::memory_order_acq_rel)) {
+        return;
+    }
+    if (thread_.joinable()) {
+        thread_.join();
+    }
+    ::close(listen_fd_);
+    listen_fd_ = -1;
+}
+
+std::string PrometheusExporter::render() const {
+    std::string out;
+    std::lock_guard<std::mutex> lock(collectors_mutex_);
+    for (const MetricsCollector& collector : collectors_) {
+        collector(out);
+    }
+    return out;
+}
+
+void PrometheusExporter::serve() {
+    while (running_.load(std::memory_order_acquire)) {
+        pollfd listener{listen_fd_, POLLIN, 0};
+        int ready = ::poll(&listener, 1, ACCEPT_POLL_MS);
+        if (ready <= 0) {
+            continue;  // Timeout or EINTR: re-check running_
+        }
+        int client = ::accept4(listen_fd_, nullptr, nullptr, SOCK_CLOEXEC);
+        if (client < 0) {
+            continue;
+        }
+        timeval timeout{CLIENT_TIMEOUT_MS / 1000, (CLIENT_TIMEOUT_MS % 1000) * 1000};
+        ::setsockopt(client, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+        ::setsockopt(client, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof(timeout));
+        handle_client(client);
+        ::close(client);
+    }
+}
+
+void PrometheusExporter::handle_client(int fd) {
+    // Only the request line matters; read until the end of the headers
+    std::string request;
+    char buffer[1024];
+    while (request.find("\r\n\r\n") == std::string::npos && request.size() < MAX_REQUEST_BYTES) {
+        ssize_t received = ::recv(fd, buffer, sizeof(buffer), 0);
+        if (received < 0 && errno == EINTR) {
+            continue;
+        }
+        if (received <= 0) {
+            break;
+        }
+        request.append(buffer, static_cast<size_t>(received));
+    }
+
+    size_t line_end = request.find("\r\n");
+    if (line_end == std::string::npos) {
+        send_response(fd, "400 Bad Request", "text/plain", "Bad Request\n");
+        return;
+    }
+    std::string line = request.substr(0, line_end);
+    size_t method_end = line.find(' ');
+    size_t path_end = method_end == std::string::npos ? std::string::npos : line.find(' ', method_end + 1);
+    if (path_end == std::string::npos) {
+        send_response(fd, "400 Bad Request", "text/plain", "Bad Request\n");
+        return;
+    }
+    std::string method = line.substr(0, method_end);
+    std::string path = line.substr(method_end + 1, path_end - method_end - 1);
+    path = path.substr(0, path.find('?'));
+
+    if (path != "/metrics") {
+        send_response(fd, "404 Not Found", "text/plain", "Not Found\n");
+    } else if (method != "GET") {
+        send_response(fd, "405 Method Not Allowed", "text/plain", "Method Not Allowed\n");
+    } else {
+        send_response(fd, "200 OK", METRICS_CONTENT_TYPE, render());
+        scrapes_.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+} // namespace monitoring
+} // namespace hft
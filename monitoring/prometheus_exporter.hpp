@@ -0,0 +1,67 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace hft {
+namespace monitoring {
+
+// Appends metrics in the Prometheus text exposition format (version 0.0.4)
+using MetricsCollector = std::function<void(std::string& out)>;
+
+// Minimal HTTP endpoint serving GET /metrics for Prometheus scrapes.
+//
+// Collectors run on the exporter's own thread at scrape time, so the hot
+// path is never called into; they are expected to read lock-free state
+// such as ParserMetricsRegistry. One connection is served at a time, which
+// is plenty for a scraper polling every few seconds.
+//
+//   PrometheusExporter exporter;
+//   exporter.add_collector([](std::string& out) {
+//       ingestion::ParserMetricsRegistry::instance().render_prometheus(out);
+//   });
+//   exporter.start(9464);
+class PrometheusExporter {
+public:
+    static constexpr uint16_t DEFAULT_PORT = 9464;
+
+    PrometheusExporter();
+    ~PrometheusExporter();
+
+    PrometheusExporter(const PrometheusExporter&) = delete;
+    PrometheusExporter& operator=(const PrometheusExporter&) = delete;
+
+    // Collectors may be added at any time; each scrape runs all of them in order
+    void add_collector(MetricsCollector collector);
+
+    // Binds and starts the server thread; port 0 picks an ephemeral port
+    bool start(uint16_t port = DEFAULT_PORT, const std::string& bind_address = "0.0.0.0");
+    void stop();
+
+    bool running() const { return running_.load(std::memory_order_acquire); }
+    uint16_t port() const { return port_; }
+    uint64_t scrapes() const { return scrapes_.load(std::memory_order_relaxed); }
+
+    // The /metrics body, as served
+    std::string render() const;
+
+private:
+    void serve();
+    void handle_client(int fd);
+
+    mutable std::mutex collectors_mutex_;
+    std::vector<MetricsCollector> collectors_;
+    std::thread thread_;
+    std::atomic<bool> running_;
+    std::atomic<uint64_t> scrapes_;
+    int listen_fd_;
+    uint16_t port_;
+};
+
+} // namespace monitoring
+} // namespace hft
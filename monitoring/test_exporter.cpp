@@ -0,0 +1,144 @@
+// Unit tests for the Prometheus exporter: starts it on an ephemeral
+// loopback port and scrapes it over a real socket.
+
+#include "message_parser.hpp"
+#include "parser_metrics.hpp"
+#include "prometheus_exporter.hpp"
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <cstdio>
+#include <string>
+
+using namespace hft::ingestion;
+using namespace hft::monitoring;
+
+static int g_failures = 0;
+
+#define CHECK(cond)                                                           \
+    do {                                                                      \
+        if (!(cond)) {                                                        \
+            std::fprintf(stderr, "%s:%d: CHECK failed: %s\n", __FILE__, __LINE__, #cond); \
+            g_failures++;                                                     \
+        }                                                                     \
+    } while (0)
+
+namespace {
+
+// Sends one request and returns the whole response, empty on failure
+std::string http_request(uint16_t port, const std::string& request) {
+    int fd = ::socket(AF_INET, SOCK_STREAM, 0);
+    if (fd < 0) {
+        return std::string();
+    }
+    sockaddr_in address{};
+    address.sin_family = AF_INET;
+    address.sin_port = htons(port);
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    std::string response;
+    if (::connect(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) == 0 &&
+        ::send(fd, request.data(), request.size(), MSG_NOSIGNAL) == static_cast<ssize_t>(request.size())) {
+        char buffer[4096];
+        ssize_t received;
+        while ((received = ::recv(fd, buffer, sizeof(buffer), 0)) > 0) {
+            response.append(buffer, static_cast<size_t>(received));
+        }
+    }
+    ::close(fd);
+    return response;
+}
+
+void test_latency_histogram() {
+    CHECK(LatencyHistogram::bucket_index(0) == 0);
+    CHECK(LatencyHistogram::bucket_index(15) == 15);
+    CHECK(LatencyHistogram::bucket_index(16) == 16 && LatencyHistogram::bucket_index(17) == 16);
+    CHECK(LatencyHistogram::bucket_index(UINT64_MAX) == LatencyHistogram::BUCKET_COUNT - 1);
+    for (size_t i = 0; i + 1 < LatencyHistogram::BUCKET_COUNT; ++i) {
+        uint64_t upper = LatencyHistogram::bucket_upper_bound(i);
+        CHECK(LatencyHistogram::bucket_index(upper - 1) == i && LatencyHistogram::bucket_index(upper) == i + 1);
+    }
+
+    LatencyHistogram histogram;
+    for (uint64_t value = 1; value <= 1000; ++value) {
+        histogram.record(value);
+    }
+    HistogramSnapshot snapshot;
+    snapshot.merge(histogram);
+    CHECK(snapshot.count == 1000 && snapshot.sum == 500500);
+    CHECK(snapshot.count_below(512) == 511);
+    uint64_t p99 = snapshot.value_at_quantile(0.99);
+    CHECK(p99 >= 990 && p99 <= 990 * 9 / 8 + 1);  // Within one sub-bucket
+}
+
+void test_parser_metrics() {
+    ParserMetricsSnapshot before = ParserMetricsRegistry::instance().snapshot();
+    {
+        MessageParser parser;
+        MarketMessage message;
+        ParseContext context;
+        std::string fix = "8=FIX.4.4\x01" "35=D\x01" "55=AAPL\x01" "44=1.5\x01";
+        std::string bad_json = "{\"price\":1.5}";
+        for (int i = 0; i < 3; ++i) {
+            context.reset();
+            parser.parse_message(fix.data(), fix.size(), message, context);
+        }
+        context.reset();
+        parser.parse_message(bad_json.data(), bad_json.size(), message, context);
+        context.reset();
+        parser.parse_message("garbage", 7, message, context);
+
+        CHECK(parser.messages_parsed() == 3 && parser.parse_errors() == 2);
+        CHECK(parser.metrics().count(ProtocolType::FIX, ParseResult::SUCCESS) == 3);
+        CHECK(parser.metrics().count(ProtocolType::WEBSOCKET_JSON, ParseResult::INVALID_FORMAT) == 1);
+        CHECK(parser.metrics().count(ProtocolType::UNKNOWN, ParseResult::UNKNOWN_PROTOCOL) == 1);
+        parser.reset_parser_state();
+        CHECK(parser.messages_parsed() == 0 && parser.metrics().count(ProtocolType::FIX, ParseResult::SUCCESS) == 3);
+    }
+
+    // Counts outlive the parser that recorded them
+    ParserMetricsSnapshot after = ParserMetricsRegistry::instance().snapshot();
+    CHECK(after.count(ProtocolType::FIX, ParseResult::SUCCESS) ==
+          before.count(ProtocolType::FIX, ParseResult::SUCCESS) + 3);
+    CHECK(after.count(ParseResult::UNKNOWN_PROTOCOL) == before.count(ParseResult::UNKNOWN_PROTOCOL) + 1);
+}
+
+void test_exporter() {
+    PrometheusExporter exporter;
+    exporter.add_collector([](std::string& out) { out += "test_metric 42\n"; });
+    exporter.add_collector([](std::string& out) { ParserMetricsRegistry::instance().render_prometheus(out); });
+    CHECK(exporter.start(0, "127.0.0.1"));
+    CHECK(exporter.running() && exporter.port() != 0);
+    CHECK(!exporter.start(0, "127.0.0.1"));
+
+    std::string response = http_request(exporter.port(), "GET /metrics HTTP/1.1\r\nHost: localhost\r\n\r\n");
+    CHECK(response.compare(0, 15, "HTTP/1.1 200 OK") == 0);
+    CHECK(response.find("text/plain; version=0.0.4") != std::string::npos);
+    CHECK(response.find("\r\n\r\ntest_metric 42\n") != std::string::npos);
+    CHECK(response.find("hft_parser_messages_total{protocol=\"fix\",result=\"success\"}") != std::string::npos);
+    CHECK(response.find("hft_parser_latency_seconds_bucket{protocol=\"fix\",result=\"success\",le=\"+Inf\"}") !=
+          std::string::npos);
+    CHECK(exporter.scrapes() == 1);
+
+    CHECK(http_request(exporter.port(), "GET /other HTTP/1.1\r\n\r\n").compare(0, 12, "HTTP/1.1 404") == 0);
+    CHECK(http_request(exporter.port(), "POST /metrics HTTP/1.1\r\n\r\n").compare(0, 12, "HTTP/1.1 405") == 0);
+
+    exporter.stop();
+    CHECK(!exporter.running());
+    CHECK(http_request(exporter.port(), "GET /metrics HTTP/1.1\r\n\r\n").empty());
+}
+
+} // namespace
+
+int main() {
+    test_latency_histogram();
+    test_parser_metrics();
+    test_exporter();
+
+    if (g_failures > 0) {
+        std::fprintf(stderr, "%d check(s) failed\n", g_failures);
+        return 1;
+    }
+    std::printf("All monitoring tests passed\n");
+    return 0;
+}
@@ -0,0 +1,97 @@
+#include "corpus.hpp"
+#include <cstdio>
+#include <random>
+#include <vector>
+
+namespace hft {
+namespace profiling {
+
+namespace {
+
+struct RestingOrder {
+    uint64_t id;
+    int64_t price_cents;
+    int32_t quantity;
+};
+
+void append_frame(std::string& out, const std::string& body) {
+    size_t start = out.size();
+    out += "8=FIX.4.4\x01" "9=" + std::to_string(body.size()) + "\x01" + body;
+    unsigned sum = 0;
+    for (size_t i = start; i < out.size(); ++i) {
+        sum += static_cast<unsigned char>(out[i]);
+    }
+    char trailer[8];
+    std::snprintf(trailer, sizeof(trailer), "10=%03u\x01", sum & 0xFF);
+    out += trailer;
+}
+
+std::string price_field(int64_t cents) {
+    char buf[32];
+    std::snprintf(buf, sizeof(buf), "44=%lld.%02lld\x01", static_cast<long long>(cents / 100),
+                  static_cast<long long>(cents % 100));
+    return buf;
+}
+
+} // namespace
+
+std::string synthetic_fix_corpus(const CorpusConfig& config) {
+    std::mt19937_64 rng(config.seed);
+    uint32_t symbols = config.symbols ? config.symbols : 1;
+    std::vector<std::vector<RestingOrder>> resting(symbols);
+    std::string out;
+    out.reserve(config.messages * 72);
+    uint64_t next_id = 1;
+
+    for (size_t n = 0; n < config.messages; ++n) {
+        uint32_t symbol = static_cast<uint32_t>(rng() % symbols);
+        std::vector<RestingOrder>& orders = resting[symbol];
+        std::string body = "55=SYM" + std::to_string(symbol) + "\x01";
+        unsigned roll = static_cast<unsigned>(rng() % 100);
+        bool add = orders.empty() || roll < (orders.size() < config.resting_per_symbol ? 60u : 30u);
+
+        if (add) {
+            bool buy = rng() % 2;
+            // Bids at or below 100.00, offers above, a few ticks deep
+            RestingOrder order{next_id++, buy ? 10000 - static_cast<int64_t>(rng() % 20)
+                                              : 10001 + static_cast<int64_t>(rng() % 20),
+                               1 + static_cast<int32_t>(rng() % 500)};
+            body = "35=D\x01" + body + "54=" + (buy ? "1" : "2") + "\x01" + price_field(order.price_cents) +
+                   "38=" + std::to_string(order.quantity) + "\x01" "11=" + std::to_string(order.id) + "\x01";
+            orders.push_back(order);
+            append_frame(out, body);
+            continue;
+        }
+
+        size_t index = rng() % orders.size();
+        RestingOrder& order = orders[index];
+        bool removed = false;
+        if (roll < 60) {
+            body = "35=F\x01" + body + "41=" + std::to_string(order.id) + "\x01";
+            removed = true;
+        } else if (roll < 80) {
+            // Size-only replaces keep priority; a price change requeues the order
+            if (rng() % 2) {
+                order.price_cents += rng() % 2 ? 1 : -1;
+            }
+            order.quantity = 1 + static_cast<int32_t>(rng() % 500);
+            body = "35=G\x01" + body + price_field(order.price_cents) + "38=" + std::to_string(order.quantity) +
+                   "\x01" "41=" + std::to_string(order.id) + "\x01";
+        } else {
+            int32_t quantity = 1 + static_cast<int32_t>(rng() % static_cast<uint64_t>(order.quantity));
+            body = "35=8\x01" + body + price_field(order.price_cents) + "38=" + std::to_string(quantity) + "\x01"
+                   "11=" + std::to_string(order.id) + "\x01";
+            order.quantity -= quantity;
+            removed = order.quantity == 0;
+        }
+        append_frame(out, body);
+        if (removed) {
+            orders[index] = orders.back();
+            orders.pop_back();
+        }
+    }
+    return out;
+}
+
+} // namespace profiling
+} // namespace hft
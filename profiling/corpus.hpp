@@ -0,0 +1,25 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace hft {
+namespace profiling {
+
+struct CorpusConfig {
+    size_t messages = 1000000;
+    uint32_t symbols = 16;          // SYM0 .. SYM<n-1>
+    size_t resting_per_symbol = 64; // Orders kept resting before cancels and executions dominate
+    uint64_t seed = 1;
+};
+
+// Order-by-order FIX stream for replays when no capture is at hand: new
+// orders (35=D) around 100.00 plus cancels (F), replaces (G) and executions
+// (8), all keyed by ClOrdID so every book operation is exercised. Frames
+// carry valid BodyLength and CheckSum and follow one another with no
+// separator, as FramingMode::FIX expects.
+std::string synthetic_fix_corpus(const CorpusConfig& config = CorpusConfig());
+
+} // namespace profiling
+} // namespace hft
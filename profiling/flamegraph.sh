@@ -0,0 +1,63 @@
+#!/usr/bin/env bash
+# Replays a corpus under perf and writes a CPU flame graph next to the
+# per-stage cycle breakdown of the same run.
+#
+#   profiling/flamegraph.sh [-b BUILD_DIR] [-o OUT_DIR] [-F HZ] [-- profile_replay arguments]
+#
+# Outputs in OUT_DIR: perf.data, stages.txt (the harness report), stages.csv,
+# stacks.folded and flame.svg. Stacks are collapsed with inferno when it is
+# installed, otherwise with Brendan Gregg's FlameGraph scripts from
+# $FLAMEGRAPH_DIR (https://github.com/brendangregg/FlameGraph).
+# Without replay arguments the harness generates a synthetic FIX corpus.
+set -euo pipefail
+
+build_dir=build
+out_dir="profile-$(date +%Y%m%d-%H%M%S)"
+frequency=999
+
+usage() {
+    sed -n '2,11p' "$0" | sed 's/^# \{0,1\}//'
+    exit "${1:-0}"
+}
+
+while getopts "b:o:F:h" option; do
+    case "$option" in
+        b) build_dir="$OPTARG" ;;
+        o) out_dir="$OPTARG" ;;
+        F) frequency="$OPTARG" ;;
+        h) usage 0 ;;
+        *) usage 2 ;;
+    esac
+done
+shift $((OPTIND - 1))
+[[ "${1:-}" == "--" ]] && shift
+
+replay="$build_dir/profiling/profile_replay"
+if [[ ! -x "$replay" ]]; then
+    echo "error: $replay not found; build with cmake -DHFT_PROFILING=ON first" >&2
+    exit 1
+fi
+if ! grep -q '^HFT_PROFILING:BOOL=ON' "$build_dir/CMakeCache.txt" 2>/dev/null; then
+    echo "warning: $build_dir was not configured with -DHFT_PROFILING=ON;" \
+         "call stacks will be truncated and there are no stage timings" >&2
+fi
+command -v perf >/dev/null || { echo "error: perf not found" >&2; exit 1; }
+
+if command -v inferno-collapse-perf >/dev/null && command -v inferno-flamegraph >/dev/null; then
+    collapse=(inferno-collapse-perf)
+    render=(inferno-flamegraph)
+elif [[ -n "${FLAMEGRAPH_DIR:-}" && -x "$FLAMEGRAPH_DIR/stackcollapse-perf.pl" ]]; then
+    collapse=("$FLAMEGRAPH_DIR/stackcollapse-perf.pl")
+    render=("$FLAMEGRAPH_DIR/flamegraph.pl")
+else
+    echo "error: install inferno (cargo install inferno) or set FLAMEGRAPH_DIR" >&2
+    exit 1
+fi
+
+mkdir -p "$out_dir"
+# Frame-pointer unwinding: cheap enough to sample every thread at full rate
+perf record -F "$frequency" -g --call-graph fp -o "$out_dir/perf.data" -- \
+    "$replay" --csv="$out_dir/stages.csv" "$@" | tee "$out_dir/stages.txt"
+perf script -i "$out_dir/perf.data" | "${collapse[@]}" > "$out_dir/stacks.folded"
+"${render[@]}" --title "profile_replay $*" "$out_dir/stacks.folded" > "$out_dir/flame.svg"
+echo "flame graph: $out_dir/flame.svg"
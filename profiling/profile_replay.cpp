@@ -0,0 +1,225 @@
+// Replays a corpus through the live ingestion path (framer, parser, feed
+// queue, timestamp merge) into per-symbol order books, then prints the
+// per-stage cycle breakdown from the HFT_PROBE_SCOPE timings. Run it under
+// perf (profiling/flamegraph.sh) for the matching flame graph.
+//
+//   profile_replay [--framing=fix|json|length] [--passes=N] [--csv=PATH] [--no-checksum] FILE...
+//   profile_replay [--synthetic=N] [--write-corpus=PATH] ...   (synthetic FIX corpus, the default)
+
+#include "corpus.hpp"
+#include "feed_handler.hpp"
+#include "mapped_file.hpp"
+#include "order_book.hpp"
+#include "probes.hpp"
+#include "stage_report.hpp"
+#include "symbol_registry.hpp"
+#include "tsc_clock.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cinttypes>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace hft;
+
+namespace {
+
+struct Options {
+    ingestion::FramingMode framing = ingestion::FramingMode::FIX;
+    size_t synthetic = 0;
+    std::string write_corpus;
+    std::string csv;
+    size_t passes = 1;
+    bool verify_checksum = true;
+    std::vector<std::string> files;
+};
+
+// One replay input, whether a mapped capture or the generated corpus
+struct Corpus {
+    std::string name;
+    ingestion::MappedFile file;
+    std::string generated;
+
+    const char* data() const { return generated.empty() ? file.data() : generated.data(); }
+    size_t size() const { return generated.empty() ? file.size() : generated.size(); }
+};
+
+const char* flag_value(const char* arg, const char* flag) {
+    size_t n = std::strlen(flag);
+    return std::strncmp(arg, flag, n) == 0 ? arg + n : nullptr;
+}
+
+bool parse_options(int argc, char** argv, Options& options) {
+    for (int i = 1; i < argc; ++i) {
+        const char* arg = argv[i];
+        const char* value;
+        if ((value = flag_value(arg, "--framing="))) {
+            if (std::strcmp(value, "fix") == 0) {
+                options.framing = ingestion::FramingMode::FIX;
+            } else if (std::strcmp(value, "json") == 0) {
+                options.framing = ingestion::FramingMode::JSON_BRACES;
+            } else if (std::strcmp(value, "length") == 0) {
+                options.framing = ingestion::FramingMode::LENGTH_PREFIXED;
+            } else {
+                std::fprintf(stderr, "unknown framing: %s\n", value);
+                return false;
+            }
+        } else if ((value = flag_value(arg, "--synthetic="))) {
+            options.synthetic = std::strtoull(value, nullptr, 10);
+        } else if ((value = flag_value(arg, "--write-corpus="))) {
+            options.write_corpus = value;
+        } else if ((value = flag_value(arg, "--csv="))) {
+            options.csv = value;
+        } else if ((value = flag_value(arg, "--passes="))) {
+            options.passes = std::max<size_t>(std::strtoull(value, nullptr, 10), 1);
+        } else if (std::strcmp(arg, "--no-checksum") == 0) {
+            options.verify_checksum = false;
+        } else if (arg[0] == '-') {
+            std::fprintf(stderr, "unknown option: %s\n", arg);
+            return false;
+        } else {
+            options.files.push_back(arg);
+        }
+    }
+    if (options.files.empty() && options.synthetic == 0) {
+        options.synthetic = profiling::CorpusConfig().messages;
+    }
+    if (options.synthetic > 0 && options.framing != ingestion::FramingMode::FIX) {
+        std::fprintf(stderr, "the synthetic corpus is FIX\n");
+        return false;
+    }
+    return true;
+}
+
+bool write_file(const std::string& path, const std::string& contents) {
+    FILE* file = std::fopen(path.c_str(), "wb");
+    if (!file) {
+        return false;
+    }
+    bool ok = std::fwrite(contents.data(), 1, contents.size(), file) == contents.size();
+    return std::fclose(file) == 0 && ok;
+}
+
+// Feeds a corpus to the feed thread in receive-buffer sized reads
+ingestion::FeedSource memory_source(const Corpus& corpus) {
+    auto offset = std::make_shared<size_t>(0);
+    return [&corpus, offset](char* buffer, size_t capacity, uint64_t&) -> ssize_t {
+        if (*offset == corpus.size()) {
+            return -1;
+        }
+        size_t n = std::min(capacity, corpus.size() - *offset);
+        std::memcpy(buffer, corpus.data() + *offset, n);
+        *offset += n;
+        return static_cast<ssize_t>(n);
+    };
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    Options options;
+    if (!parse_options(argc, argv, options)) {
+        std::fprintf(stderr, "usage: %s [--framing=fix|json|length] [--synthetic=N] [--write-corpus=PATH] "
+                             "[--passes=N] [--csv=PATH] [--no-checksum] [FILE...]\n", argv[0]);
+        return 2;
+    }
+
+    std::vector<std::unique_ptr<Corpus>> corpora;
+    uint64_t corpus_bytes = 0;
+    if (options.synthetic > 0) {
+        profiling::CorpusConfig config;
+        config.messages = options.synthetic;
+        corpora.emplace_back(new Corpus());
+        corpora.back()->name = "synthetic";
+        corpora.back()->generated = profiling::synthetic_fix_corpus(config);
+        if (!options.write_corpus.empty() && !write_file(options.write_corpus, corpora.back()->generated)) {
+            std::fprintf(stderr, "cannot write %s\n", options.write_corpus.c_str());
+            return 1;
+        }
+    }
+    for (const std::string& path : options.files) {
+        corpora.emplace_back(new Corpus());
+        corpora.back()->name = path;
+        if (!corpora.back()->file.open(path)) {
+            std::fprintf(stderr, "cannot open %s\n", path.c_str());
+            return 1;
+        }
+    }
+    for (const auto& corpus : corpora) {
+        corpus_bytes += corpus->size();
+    }
+
+    ingestion::SymbolRegistry registry;
+    ingestion::ProbeSnapshot before = ingestion::ProbeRegistry::instance().snapshot();
+    uint64_t messages = 0;
+    uint64_t parse_errors = 0;
+    uint64_t book_results[lob::BOOK_RESULT_COUNT] = {};
+    auto start = std::chrono::steady_clock::now();
+
+    for (size_t pass = 0; pass < options.passes; ++pass) {
+        ingestion::FeedHandler handler;
+        for (const auto& corpus : corpora) {
+            ingestion::FeedConfig feed;
+            feed.name = corpus->name;
+            feed.source = memory_source(*corpus);
+            feed.framing = options.framing;
+            feed.verify_checksum = options.verify_checksum;
+            feed.symbol_registry = &registry;
+            handler.add_feed(feed);
+        }
+        if (!handler.start()) {
+            std::fprintf(stderr, "feed threads failed to start\n");
+            return 1;
+        }
+        lob::BookManager books(lob::OrderBookConfig(), &registry);  // Fresh books: each pass reuses order ids
+        messages += handler.run([&books](const ingestion::MarketMessage& message) {
+            books.apply(message);
+            return true;
+        });
+        for (size_t f = 0; f < handler.feed_count(); ++f) {
+            parse_errors += handler.feed_stats(f).parse_errors;
+        }
+        for (size_t r = 0; r < lob::BOOK_RESULT_COUNT; ++r) {
+            book_results[r] += books.result_count(static_cast<lob::BookResult>(r));
+        }
+    }
+
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    ingestion::ProbeSnapshot after = ingestion::ProbeRegistry::instance().snapshot();
+    std::vector<profiling::StageStats> stages = profiling::stage_breakdown(profiling::probe_delta(after, before));
+
+    std::printf("%" PRIu64 " messages (%" PRIu64 " parse errors) from %zu corpus file(s), %" PRIu64
+                " bytes x %zu pass(es), in %.3f s: %.2f M msg/s\n",
+                messages, parse_errors, corpora.size(), corpus_bytes, options.passes, seconds,
+                seconds > 0.0 ? static_cast<double>(messages) / seconds / 1e6 : 0.0);
+    std::printf("books: %" PRIu64 " applied, %" PRIu64 " ignored, %" PRIu64 " unknown order, %" PRIu64
+                " duplicate, %" PRIu64 " invalid\n",
+                book_results[static_cast<size_t>(lob::BookResult::APPLIED)],
+                book_results[static_cast<size_t>(lob::BookResult::IGNORED)],
+                book_results[static_cast<size_t>(lob::BookResult::UNKNOWN_ORDER)],
+                book_results[static_cast<size_t>(lob::BookResult::DUPLICATE_ORDER)],
+                book_results[static_cast<size_t>(lob::BookResult::INVALID)]);
+
+    if (!ingestion::probe_timing_enabled()) {
+        std::printf("no stage timings: configure with -DHFT_PROFILING=ON\n");
+        return messages > 0 ? 0 : 1;
+    }
+    const ingestion::TscClock& clock = ingestion::TscClock::instance();
+    double counter_hz = clock.using_counter() ? clock.counter_hz() : 0.0;
+    std::string report;
+    profiling::render_stage_table(stages, counter_hz, report);
+    std::fputs(report.c_str(), stdout);
+    if (!options.csv.empty()) {
+        std::string csv;
+        profiling::render_stage_csv(stages, counter_hz, csv);
+        if (!write_file(options.csv, csv)) {
+            std::fprintf(stderr, "cannot write %s\n", options.csv.c_str());
+            return 1;
+        }
+    }
+    return messages > 0 ? 0 : 1;
+}
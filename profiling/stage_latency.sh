@@ -0,0 +1,35 @@
+#!/usr/bin/env bash
+# Per-stage latency histograms from the hft:stage_begin/stage_end USDT
+# probes of a running process, for chasing tail latency in production
+# builds (-DHFT_PROBES=usdt; no HFT_PROFILING needed, the probes are nops
+# until attached).
+#
+#   sudo profiling/stage_latency.sh PID [SECONDS]
+#
+# Prints one log2 histogram of nanoseconds per stage. Attaching turns each
+# probe into a trap, so expect a few hundred nanoseconds per probed call
+# while it runs.
+set -euo pipefail
+
+if [[ $# -lt 1 ]]; then
+    sed -n '2,11p' "$0" | sed 's/^# \{0,1\}//'
+    exit 2
+fi
+pid="$1"
+seconds="${2:-10}"
+binary="$(readlink -f "/proc/$pid/exe")"
+command -v bpftrace >/dev/null || { echo "error: bpftrace not found" >&2; exit 1; }
+
+# Stage ids follow hft::ingestion::ProbeStage
+bpftrace -p "$pid" -e "
+usdt:$binary:hft:stage_begin { @start[tid, arg0] = nsecs; }
+usdt:$binary:hft:stage_end /@start[tid, arg0]/ {
+    @ns[arg0 == 0 ? \"parse_message\" : arg0 == 1 ? \"detect_protocol\" : arg0 == 2 ? \"queue_push\" :
+        arg0 == 3 ? \"queue_pop\" : arg0 == 4 ? \"book_add\" : arg0 == 5 ? \"book_cancel\" :
+        arg0 == 6 ? \"book_modify\" : arg0 == 7 ? \"book_execute\" : \"match_submit\"] =
+        hist(nsecs - @start[tid, arg0]);
+    delete(@start[tid, arg0]);
+}
+interval:s:$seconds { exit(); }
+END { clear(@start); }
+"
@@ -0,0 +1,108 @@
+#include "stage_report.hpp"
+#include <algorithm>
+#include <cinttypes>
+#include <cstdarg>
+#include <cstdio>
+
+namespace hft {
+namespace profiling {
+
+using ingestion::HistogramSnapshot;
+using ingestion::LatencyHistogram;
+using ingestion::PROBE_STAGE_COUNT;
+using ingestion::ProbeSnapshot;
+using ingestion::ProbeStage;
+
+namespace {
+
+void append_format(std::string& out, const char* format, ...) __attribute__((format(printf, 2, 3)));
+
+void append_format(std::string& out, const char* format, ...) {
+    char line[256];
+    va_list args;
+    va_start(args, format);
+    int n = std::vsnprintf(line, sizeof(line), format, args);
+    va_end(args);
+    if (n > 0) {
+        out.append(line, std::min(static_cast<size_t>(n), sizeof(line) - 1));
+    }
+}
+
+double to_ns(double cycles, double counter_hz) {
+    return cycles * 1e9 / counter_hz;
+}
+
+} // namespace
+
+ProbeSnapshot probe_delta(const ProbeSnapshot& after, const ProbeSnapshot& before) {
+    ProbeSnapshot delta;
+    for (size_t s = 0; s < PROBE_STAGE_COUNT; ++s) {
+        const HistogramSnapshot& a = after.cycles[s];
+        const HistogramSnapshot& b = before.cycles[s];
+        delta.cycles[s].count = a.count - b.count;
+        delta.cycles[s].sum = a.sum - b.sum;
+        for (size_t i = 0; i < LatencyHistogram::BUCKET_COUNT; ++i) {
+            delta.cycles[s].buckets[i] = a.buckets[i] - b.buckets[i];
+        }
+    }
+    return delta;
+}
+
+std::vector<StageStats> stage_breakdown(const ProbeSnapshot& snapshot) {
+    std::vector<StageStats> stages;
+    for (size_t s = 0; s < PROBE_STAGE_COUNT; ++s) {
+        const HistogramSnapshot& cycles = snapshot.cycles[s];
+        if (cycles.count == 0) {
+            continue;
+        }
+        StageStats stats;
+        stats.stage = static_cast<ProbeStage>(s);
+        stats.calls = cycles.count;
+        stats.total_cycles = cycles.sum;
+        stats.mean_cycles = static_cast<double>(cycles.sum) / static_cast<double>(cycles.count);
+        stats.p50_cycles = cycles.value_at_quantile(0.5);
+        stats.p99_cycles = cycles.value_at_quantile(0.99);
+        stats.p999_cycles = cycles.value_at_quantile(0.999);
+        stages.push_back(stats);
+    }
+    return stages;
+}
+
+void render_stage_table(const std::vector<StageStats>& stages, double counter_hz, std::string& out) {
+    append_format(out, "%-16s %12s %10s %10s %10s %10s", "stage", "calls", "mean_cyc", "p50_cyc", "p99_cyc",
+                  "p999_cyc");
+    if (counter_hz > 0.0) {
+        append_format(out, " %10s %10s", "mean_ns", "p99_ns");
+    }
+    out += '\n';
+    for (const StageStats& stats : stages) {
+        append_format(out, "%-16s %12" PRIu64 " %10.1f %10" PRIu64 " %10" PRIu64 " %10" PRIu64,
+                      ingestion::probe_stage_name(stats.stage), stats.calls, stats.mean_cycles, stats.p50_cycles,
+                      stats.p99_cycles, stats.p999_cycles);
+        if (counter_hz > 0.0) {
+            append_format(out, " %10.1f %10.1f", to_ns(stats.mean_cycles, counter_hz),
+                          to_ns(static_cast<double>(stats.p99_cycles), counter_hz));
+        }
+        out += '\n';
+    }
+}
+
+void render_stage_csv(const std::vector<StageStats>& stages, double counter_hz, std::string& out) {
+    out += "stage,calls,total_cycles,mean_cycles,p50_cycles,p99_cycles,p999_cycles";
+    out += counter_hz > 0.0 ? ",mean_ns,p50_ns,p99_ns,p999_ns\n" : "\n";
+    for (const StageStats& stats : stages) {
+        append_format(out, "%s,%" PRIu64 ",%" PRIu64 ",%.3f,%" PRIu64 ",%" PRIu64 ",%" PRIu64,
+                      ingestion::probe_stage_name(stats.stage), stats.calls, stats.total_cycles, stats.mean_cycles,
+                      stats.p50_cycles, stats.p99_cycles, stats.p999_cycles);
+        if (counter_hz > 0.0) {
+            append_format(out, ",%.3f,%.3f,%.3f,%.3f", to_ns(stats.mean_cycles, counter_hz),
+                          to_ns(static_cast<double>(stats.p50_cycles), counter_hz),
+                          to_ns(static_cast<double>(stats.p99_cycles), counter_hz),
+                          to_ns(static_cast<double>(stats.p999_cycles), counter_hz));
+        }
+        out += '\n';
+    }
+}
+
+} // namespace profiling
+} // namespace hft
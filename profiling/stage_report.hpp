@@ -0,0 +1,35 @@
+#pragma once
+
+#include "probes.hpp"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace hft {
+namespace profiling {
+
+// One probed stage's calls, in counter ticks (TSC cycles on x86). The
+// quantiles are histogram bucket bounds, so within 12.5% of the true value.
+struct StageStats {
+    ingestion::ProbeStage stage;
+    uint64_t calls = 0;
+    uint64_t total_cycles = 0;
+    double mean_cycles = 0.0;
+    uint64_t p50_cycles = 0;
+    uint64_t p99_cycles = 0;
+    uint64_t p999_cycles = 0;
+};
+
+// What was recorded between two snapshots of the same registry
+ingestion::ProbeSnapshot probe_delta(const ingestion::ProbeSnapshot& after, const ingestion::ProbeSnapshot& before);
+
+// Stages with at least one call, in ProbeStage order
+std::vector<StageStats> stage_breakdown(const ingestion::ProbeSnapshot& snapshot);
+
+// Fixed-width table and CSV. With counter_hz > 0 (TscClock::counter_hz())
+// the table also shows nanoseconds and the CSV gains _ns columns.
+void render_stage_table(const std::vector<StageStats>& stages, double counter_hz, std::string& out);
+void render_stage_csv(const std::vector<StageStats>& stages, double counter_hz, std::string& out);
+
+} // namespace profiling
+} // namespace hft
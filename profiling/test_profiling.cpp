@@ -0,0 +1,156 @@
+// Unit tests for the probe registry, the stage report and the synthetic corpus.
+
+#include "corpus.hpp"
+#include "message_parser.hpp"
+#include "order_book.hpp"
+#include "probes.hpp"
+#include "spsc_queue.hpp"
+#include "stage_report.hpp"
+#include "stream_framer.hpp"
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <thread>
+
+using namespace hft::ingestion;
+using namespace hft::profiling;
+
+static int g_failures = 0;
+
+#define CHECK(cond)                                                           \
+    do {                                                                      \
+        if (!(cond)) {                                                        \
+            std::fprintf(stderr, "%s:%d: CHECK failed: %s\n", __FILE__, __LINE__, #cond); \
+            g_failures++;                                                     \
+        }                                                                     \
+    } while (0)
+
+namespace {
+
+uint64_t calls(const ProbeSnapshot& after, const ProbeSnapshot& before, ProbeStage stage) {
+    return after.stage(stage).count - before.stage(stage).count;
+}
+
+void test_stage_report() {
+    LatencyHistogram parse, pop;
+    for (uint64_t cycles = 1; cycles <= 100; ++cycles) {
+        parse.record(cycles * 10);
+    }
+    pop.record(40);
+    ProbeSnapshot before;
+    before.cycles[static_cast<size_t>(ProbeStage::QUEUE_POP)].merge(pop);
+    ProbeSnapshot after = before;
+    after.cycles[static_cast<size_t>(ProbeStage::PARSE_MESSAGE)].merge(parse);
+    after.cycles[static_cast<size_t>(ProbeStage::QUEUE_POP)].merge(pop);
+
+    std::vector<StageStats> stages = stage_breakdown(probe_delta(after, before));
+    CHECK(stages.size() == 2);
+    CHECK(stages[0].stage == ProbeStage::PARSE_MESSAGE && stages[0].calls == 100);
+    CHECK(stages[0].total_cycles == 50500 && stages[0].mean_cycles == 505.0);
+    CHECK(stages[0].p50_cycles >= 500 && stages[0].p50_cycles <= 500 * 9 / 8);  // Bucket bound
+    CHECK(stages[0].p999_cycles >= 1000 && stages[0].p99_cycles <= stages[0].p999_cycles);
+    CHECK(stages[1].stage == ProbeStage::QUEUE_POP && stages[1].calls == 1);
+
+    std::string table;
+    render_stage_table(stages, 0.0, table);
+    CHECK(table.find("parse_message") != std::string::npos && table.find("queue_pop") != std::string::npos);
+    CHECK(table.find("mean_ns") == std::string::npos);
+    std::string csv;
+    render_stage_csv(stages, 2e9, csv);  // 2 GHz: 505 cycles are 252.5 ns
+    CHECK(csv.find("stage,calls,total_cycles") == 0 && csv.find(",p999_ns\n") != std::string::npos);
+    CHECK(csv.find("parse_message,100,50500,505.000,") != std::string::npos);
+    CHECK(csv.find(",252.500,") != std::string::npos);
+    CHECK(std::string(probe_stage_name(static_cast<ProbeStage>(PROBE_STAGE_COUNT))) == "unknown");
+}
+
+// Every generated frame parses, and every book operation finds its order
+void test_corpus() {
+    CorpusConfig config;
+    config.messages = 20000;
+    config.symbols = 4;
+    config.resting_per_symbol = 16;
+    std::string corpus = synthetic_fix_corpus(config);
+    CHECK(corpus == synthetic_fix_corpus(config));
+    config.seed = 2;
+    CHECK(corpus != synthetic_fix_corpus(config));
+
+    SymbolRegistry registry;
+    MessageParser parser;
+    parser.set_symbol_registry(&registry);
+    hft::lob::BookManager books(hft::lob::OrderBookConfig(), &registry);
+    size_t pos = 0, frames = 0, parsed = 0;
+    uint64_t types[8] = {};
+    while (pos < corpus.size()) {
+        size_t offset = 0, length = 0, consumed = 0;
+        if (StreamFramer::find_frame(FramingMode::FIX, corpus.data() + pos, corpus.size() - pos, offset, length,
+                                     consumed, true) != ParseResult::SUCCESS) {
+            break;
+        }
+        frames++;
+        MarketMessage message;
+        ParseContext context;
+        if (parser.parse_message(corpus.data() + pos + offset, length, message, context) == ParseResult::SUCCESS) {
+            parsed++;
+            types[static_cast<size_t>(message.type) & 7]++;
+            books.apply(message);
+        }
+        pos += consumed;
+    }
+    CHECK(pos == corpus.size() && frames == 20000 && parsed == 20000);
+    CHECK(registry.size() == 4);
+    CHECK(books.result_count(hft::lob::BookResult::APPLIED) == 20000);
+    for (MessageType type : {MessageType::NEW_ORDER, MessageType::CANCEL_ORDER, MessageType::MODIFY_ORDER,
+                             MessageType::TRADE}) {
+        CHECK(types[static_cast<size_t>(type)] > 1000);
+    }
+}
+
+void test_probe_timing() {
+    ProbeSnapshot before = ProbeRegistry::instance().snapshot();
+
+    MessageParser parser;
+    MarketMessage message;
+    ParseContext context;
+    std::string fix = "8=FIX.4.4\x01" "35=D\x01" "55=AAPL\x01" "54=1\x01" "44=10\x01" "38=5\x01" "11=7\x01";
+    CHECK(parser.parse_message(fix.data(), fix.size(), message, context) == ParseResult::SUCCESS);
+    SpscQueue<MarketMessage> queue(8);
+    CHECK(queue.push(message) && queue.pop(message));
+    hft::lob::OrderBook book;
+    CHECK(book.add(7, Side::BUY, 1000, 5) == hft::lob::BookResult::APPLIED);
+    CHECK(book.modify(7, 1000, 0) == hft::lob::BookResult::APPLIED);  // Cancels, nested in the modify
+
+    // A finished thread's timings stay in the registry
+    std::thread worker([] { CHECK(SpscQueue<int>(4).push(1)); });
+    worker.join();
+
+    ProbeSnapshot after = ProbeRegistry::instance().snapshot();
+    uint64_t expected = probe_timing_enabled() ? 1 : 0;
+    CHECK(calls(after, before, ProbeStage::PARSE_MESSAGE) == expected);
+    CHECK(calls(after, before, ProbeStage::DETECT_PROTOCOL) == expected);
+    CHECK(calls(after, before, ProbeStage::QUEUE_POP) == expected);
+    CHECK(calls(after, before, ProbeStage::QUEUE_PUSH) == 2 * expected);
+    CHECK(calls(after, before, ProbeStage::BOOK_ADD) == expected);
+    CHECK(calls(after, before, ProbeStage::BOOK_MODIFY) == expected);
+    CHECK(calls(after, before, ProbeStage::BOOK_CANCEL) == expected);
+    CHECK(calls(after, before, ProbeStage::MATCH_SUBMIT) == 0);
+    if (probe_timing_enabled()) {
+        // Parsing includes detection
+        CHECK(after.stage(ProbeStage::PARSE_MESSAGE).sum - before.stage(ProbeStage::PARSE_MESSAGE).sum >=
+              after.stage(ProbeStage::DETECT_PROTOCOL).sum - before.stage(ProbeStage::DETECT_PROTOCOL).sum);
+    }
+}
+
+} // namespace
+
+int main() {
+    test_stage_report();
+    test_corpus();
+    test_probe_timing();
+
+    if (g_failures > 0) {
+        std::fprintf(stderr, "%d check(s) failed\n", g_failures);
+        return 1;
+    }
+    std::printf("All profiling tests passed\n");
+    return 0;
+}
@@ -0,0 +1,313 @@
+#include "execution_engine.hpp"
+#include "numeric_parse.hpp"
+#include <algorithm>
+#include <cmath>
+
+namespace hft {
+namespace strategy {
+
+namespace {
+
+constexpr uint32_t MAX_SLICES = 100000;
+
+bool parse_u64(std::string_view value, uint64_t& out) {
+    return ingestion::parse_uint64(value.data(), value.data() + value.size(), out);
+}
+
+} // namespace
+
+int64_t fill_notional(const lob::Trade* trades, size_t count) {
+    int64_t notional = 0;
+    for (size_t i = 0; i < count; ++i) {
+        if (!(trades[i].flags & lob::TRADE_STP_CANCEL)) {
+            notional += trades[i].price * trades[i].quantity;
+        }
+    }
+    return notional;
+}
+
+bool parse_execution_params(std::string_view spec, ExecutionParams& params,
+                            const ingestion::SymbolRegistry* registry) {
+    ExecutionParams parsed;
+    size_t pos = 0;
+    while (pos < spec.size()) {
+        while (pos < spec.size() && (spec[pos] == ' ' || spec[pos] == '\t' || spec[pos] == '\n')) {
+            pos++;
+        }
+        size_t end = pos;
+        while (end < spec.size() && spec[end] != ' ' && spec[end] != '\t' && spec[end] != '\n') {
+            end++;
+        }
+        if (end == pos) {
+            break;
+        }
+        std::string_view pair = spec.substr(pos, end - pos);
+        pos = end;
+        size_t equals = pair.find('=');
+        if (equals == std::string_view::npos) {
+            return false;
+        }
+        std::string_view key = pair.substr(0, equals);
+        std::string_view value = pair.substr(equals + 1);
+        const char* first = value.data();
+        const char* last = first + value.size();
+        uint64_t number = 0;
+        bool ok = true;
+
+        if (key == "algo") {
+            if (value == "twap") {
+                parsed.algo = ExecutionAlgo::TWAP;
+            } else if (value == "vwap") {
+                parsed.algo = ExecutionAlgo::VWAP;
+            } else {
+                ok = false;
+            }
+        } else if (key == "symbol") {
+            parsed.symbol_id = registry ? registry->find(value) : ingestion::INVALID_SYMBOL_ID;
+            ok = parsed.symbol_id != ingestion::INVALID_SYMBOL_ID;
+        } else if (key == "symbol_id") {
+            ok = parse_u64(value, number) && number < ingestion::INVALID_SYMBOL_ID;
+            parsed.symbol_id = static_cast<uint32_t>(number);
+        } else if (key == "side") {
+            if (value == "buy") {
+                parsed.side = ingestion::Side::BUY;
+            } else if (value == "sell") {
+                parsed.side = ingestion::Side::SELL;
+            } else {
+                ok = false;
+            }
+        } else if (key == "quantity") {
+            ok = ingestion::parse_int32(first, last, parsed.quantity);
+        } else if (key == "start_ns") {
+            ok = parse_u64(value, parsed.start_ns);
+        } else if (key == "end_ns") {
+            ok = parse_u64(value, parsed.end_ns);
+        } else if (key == "duration_ns") {
+            ok = parse_u64(value, parsed.duration_ns);
+        } else if (key == "slices") {
+            ok = parse_u64(value, number) && number <= MAX_SLICES;
+            parsed.slices = static_cast<uint32_t>(number);
+        } else if (key == "limit") {
+            ok = ingestion::parse_fixed_point(first, last, ingestion::PRICE_DECIMALS, parsed.limit_price);
+        } else if (key == "owner") {
+            ok = parse_u64(value, number) && number <= 0xFFFF;
+            parsed.owner = static_cast<uint16_t>(number);
+        } else {
+            ok = false;  // Typos must not silently change an order
+        }
+        if (!ok) {
+            return false;
+        }
+    }
+    params = parsed;
+    return true;
+}
+
+ExecutionEngine::ExecutionEngine(const ExecutionConfig& config)
+    : config_(config),
+      clock_(ingestion::TscClock::instance()),
+      wheel_(config.start_ns ? config.start_ns : clock_.now_ns(), config.resolution_ns),
+      venues_(config.symbol_capacity),
+      trades_(std::max<size_t>(config.max_trades_per_child, 1)),
+      next_child_id_(config.child_id_base) {}
+
+bool ExecutionEngine::attach(uint32_t symbol_id, lob::MatchingEngine* venue) {
+    if (symbol_id >= venues_.size() || !venue) {
+        return false;
+    }
+    Venue& slot = venues_[symbol_id];
+    slot.engine = venue;
+    if (slot.curve == NO_CURVE) {
+        slot.curve = static_cast<uint32_t>(curves_.size());
+        curves_.emplace_back(config_.volume_bucket_ns);
+    }
+    return true;
+}
+
+void ExecutionEngine::on_message(const ingestion::MarketMessage& message) {
+    if (message.type == ingestion::MessageType::TRADE && message.symbol_id < venues_.size()) {
+        uint32_t curve = venues_[message.symbol_id].curve;
+        if (curve != NO_CURVE) {
+            curves_[curve].add(message.timestamp, message.size);
+        }
+    }
+}
+
+const VolumeCurve* ExecutionEngine::volume_curve(uint32_t symbol_id) const {
+    if (symbol_id >= venues_.size() || venues_[symbol_id].curve == NO_CURVE) {
+        return nullptr;
+    }
+    return &curves_[venues_[symbol_id].curve];
+}
+
+ExecutionStatus ExecutionEngine::start(const ExecutionParams& params, uint32_t& parent_id) {
+    Parent parent;
+    parent.report.params = params;
+    ExecutionParams& p = parent.report.params;
+    if (p.start_ns == 0) {
+        p.start_ns = wheel_.now_ns();
+    }
+    if (p.end_ns == 0) {
+        p.end_ns = p.start_ns + p.duration_ns;
+    }
+    if ((p.side != ingestion::Side::BUY && p.side != ingestion::Side::SELL) || p.quantity <= 0 ||
+        p.slices == 0 || p.slices > MAX_SLICES || p.end_ns < p.start_ns || p.limit_price < 0) {
+        return ExecutionStatus::INVALID;
+    }
+    if (p.symbol_id >= venues_.size() || !venues_[p.symbol_id].engine) {
+        return ExecutionStatus::NO_VENUE;
+    }
+
+    parent.interval_ns = (p.end_ns - p.start_ns) / p.slices;
+    plan(parent);
+    parent_id = static_cast<uint32_t>(parents_.size());
+    uint64_t first_slice = p.start_ns;
+    parents_.push_back(std::move(parent));
+    working_++;
+    if (first_slice <= wheel_.now_ns()) {
+        fire(parent_id, first_slice, wheel_.now_ns());  // Starting now: no wait for the next tick
+    } else {
+        parents_[parent_id].timer = wheel_.schedule(first_slice, parent_id);
+    }
+    return ExecutionStatus::ACCEPTED;
+}
+
+bool ExecutionEngine::cancel(uint32_t parent_id) {
+    if (parent_id >= parents_.size() || parents_[parent_id].report.state != ExecutionState::WORKING) {
+        return false;
+    }
+    Parent& parent = parents_[parent_id];
+    wheel_.cancel(parent.timer);
+    parent.timer = INVALID_TIMER;
+    parent.report.state = ExecutionState::CANCELLED;
+    working_--;
+    return true;
+}
+
+size_t ExecutionEngine::advance(uint64_t now_ns) {
+    size_t sent = 0;
+    wheel_.advance(now_ns, [&](uint64_t cookie, uint64_t deadline_ns) {
+        if (fire(static_cast<uint32_t>(cookie), deadline_ns, now_ns)) {
+            sent++;
+        }
+    });
+    return sent;
+}
+
+void ExecutionEngine::plan(Parent& parent) const {
+    const ExecutionParams& p = parent.report.params;
+    parent.targets.resize(p.slices);
+    const VolumeCurve* curve = volume_curve(p.symbol_id);
+    double window = 0.0;
+    if (p.algo == ExecutionAlgo::VWAP && curve) {
+        window = curve->volume(p.start_ns, p.start_ns + parent.interval_ns * p.slices);
+    }
+    for (uint32_t i = 0; i < p.slices; ++i) {
+        if (i + 1 == p.slices) {
+            parent.targets[i] = p.quantity;  // Whatever rounding left goes last
+        } else if (window > 0.0) {
+            double share = curve->volume(p.start_ns, p.start_ns + parent.interval_ns * (i + 1)) / window;
+            parent.targets[i] = static_cast<int32_t>(std::llround(share * p.quantity));
+        } else {
+            parent.targets[i] = static_cast<int32_t>(static_cast<int64_t>(p.quantity) * (i + 1) / p.slices);
+        }
+    }
+}
+
+bool ExecutionEngine::fire(uint32_t parent_id, uint64_t deadline_ns, uint64_t now_ns) {
+    Parent& parent = parents_[parent_id];
+    ExecutionReport& report = parent.report;
+    parent.timer = INVALID_TIMER;
+    slice_lateness_.record(now_ns > deadline_ns ? now_ns - deadline_ns : 0);
+
+    uint32_t slice = report.slices_sent++;
+    int32_t due = parent.targets[slice] - report.filled - report.in_flight;
+    bool sent = due > 0 && send_child(parent_id, due);
+
+    if (report.state == ExecutionState::WORKING && !finish(parent)) {
+        parent.timer = wheel_.schedule(report.params.start_ns + parent.interval_ns * report.slices_sent, parent_id);
+    }
+    return sent;
+}
+
+bool ExecutionEngine::finish(Parent& parent) {
+    ExecutionReport& report = parent.report;
+    if (report.filled >= report.params.quantity) {
+        report.state = ExecutionState::FILLED;
+    } else if (report.slices_sent == report.params.slices) {
+        if (report.in_flight > 0) {
+            return true;  // Decided once the last results come back
+        }
+        report.state = ExecutionState::EXPIRED;
+    } else {
+        return false;
+    }
+    working_--;
+    wheel_.cancel(parent.timer);
+    parent.timer = INVALID_TIMER;
+    return true;
+}
+
+void ExecutionEngine::on_child_result(uint32_t parent_id, const lob::OrderRequest& request, int32_t filled,
+                                      int64_t notional) {
+    if (parent_id >= parents_.size()) {
+        return;
+    }
+    Parent& parent = parents_[parent_id];
+    parent.report.in_flight -= request.quantity;
+    parent.report.filled += filled;
+    parent.report.notional += notional;
+    if (risk_) {
+        uint32_t symbol_id = parent.report.params.symbol_id;
+        risk_->on_fill(symbol_id, request.side, filled, filled > 0 ? notional / filled : 0);
+        risk_->release(symbol_id, request.side, request.quantity - filled);
+    }
+    if (parent.report.state == ExecutionState::WORKING) {
+        finish(parent);
+    }
+}
+
+bool ExecutionEngine::send_child(uint32_t parent_id, int32_t quantity) {
+    ExecutionReport& report = parents_[parent_id].report;
+    lob::MatchingEngine& venue = *venues_[report.params.symbol_id].engine;
+
+    lob::OrderRequest request;
+    request.id = next_child_id_++;
+    request.quantity = quantity;
+    request.side = report.params.side;
+    request.owner = report.params.owner;
+    if (report.params.limit_price > 0) {
+        request.price = ingestion::raw_to_ticks(report.params.limit_price, venue.book().tick_units());
+        request.flags = lob::ORDER_IOC;
+    } else {
+        request.price = 0;
+        request.flags = lob::ORDER_MARKET;
+    }
+
+    if (risk_ && risk_->check(report.params.symbol_id, request, wheel_.now_ns()) != RiskResult::ACCEPTED) {
+        report.risk_rejects++;
+        return false;
+    }
+
+    report.children++;
+    if (router_) {
+        report.in_flight += quantity;
+        router_(parent_id, request);
+        return true;
+    }
+    lob::MatchResult result = venue.submit(request, trades_.data(), trades_.size());
+    report.filled += result.filled;
+    report.notional += fill_notional(trades_.data(), result.trades);
+    if (risk_) {
+        for (size_t i = 0; i < result.trades; ++i) {
+            if (!(trades_[i].flags & lob::TRADE_STP_CANCEL)) {
+                risk_->on_fill(report.params.symbol_id, request.side, trades_[i].quantity, trades_[i].price);
+            }
+        }
+        risk_->release(report.params.symbol_id, request.side, quantity - result.filled);
+    }
+    return true;
+}
+
+} // namespace strategy
+} // namespace hft
@@ -0,0 +1,180 @@
+#pragma once
+
+#include "matching_engine.hpp"
+#include "message_types.hpp"
+#include "parser_metrics.hpp"
+#include "risk_gate.hpp"
+#include "symbol_registry.hpp"
+#include "timer_wheel.hpp"
+#include "tsc_clock.hpp"
+#include "volume_curve.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace hft {
+namespace strategy {
+
+enum class ExecutionAlgo : uint8_t {
+    TWAP = 1,  // Equal slices
+    VWAP = 2   // Slices weighted by the symbol's VolumeCurve over the window
+};
+
+// A parent order. The window [start_ns, end_ns) is cut into `slices`
+// equal intervals; slice i fires at start_ns + i * interval and sends
+// whatever keeps the cumulative fill on schedule, so unfilled quantity
+// rolls into later slices.
+struct ExecutionParams {
+    ExecutionAlgo algo = ExecutionAlgo::TWAP;
+    uint32_t symbol_id = ingestion::INVALID_SYMBOL_ID;
+    ingestion::Side side = ingestion::Side::UNKNOWN;
+    int32_t quantity = 0;
+    uint64_t start_ns = 0;       // 0 = the engine's current time
+    uint64_t end_ns = 0;
+    uint64_t duration_ns = 0;    // Window length when end_ns is 0
+    uint32_t slices = 1;
+    int64_t limit_price = 0;     // Raw fixed-point units of 1e-8 (price.hpp); children are IOC limits,
+                                 // or market orders when 0
+    uint16_t owner = 0;          // Self-trade prevention group of the children
+};
+
+enum class ExecutionStatus : uint8_t {
+    ACCEPTED = 0,
+    INVALID,    // Bad side, quantity, window or slice count
+    NO_VENUE    // No matching engine attached for the symbol
+};
+
+enum class ExecutionState : uint8_t {
+    WORKING = 0,
+    FILLED,      // Parent quantity done
+    EXPIRED,     // Window over with quantity left
+    CANCELLED
+};
+
+struct ExecutionReport {
+    ExecutionParams params;
+    ExecutionState state = ExecutionState::WORKING;
+    uint32_t slices_sent = 0;    // Slices that fired (children only when something was due)
+    uint32_t children = 0;       // Child orders submitted
+    int32_t filled = 0;
+    int32_t in_flight = 0;       // Routed children without a result yet
+    uint32_t risk_rejects = 0;   // Children the risk gate refused; their quantity rolls forward
+    int64_t notional = 0;        // Sum of fill ticks x quantity
+
+    int32_t remaining() const { return params.quantity - filled; }
+};
+
+// Parses "algo=vwap symbol=AAPL side=buy quantity=5000 duration_ns=... slices=20
+// limit=150.25 owner=3" (whitespace-separated, any order; start_ns/end_ns
+// for absolute windows, symbol_id=N instead of symbol= without a registry).
+// Returns false, leaving params untouched, on any bad key or value; symbols
+// must already be in the registry, so a typo cannot start a parent.
+// This is the whole surface Python needs: see strategy/execution_params.py.
+bool parse_execution_params(std::string_view spec, ExecutionParams& params,
+                            const ingestion::SymbolRegistry* registry = nullptr);
+
+// Sum of ticks x quantity over real fills, skipping self-trade cancels
+int64_t fill_notional(const lob::Trade* trades, size_t count);
+
+struct ExecutionConfig {
+    uint64_t start_ns = 0;               // Initial engine time, 0 = TscClock now (backtests pass the capture start)
+    uint64_t resolution_ns = TimerWheel::DEFAULT_RESOLUTION_NS;
+    uint64_t volume_bucket_ns = VolumeCurve::DEFAULT_BUCKET_NS;
+    size_t symbol_capacity = 4096;       // Symbol ids accepted by attach()
+    size_t max_trades_per_child = 256;   // Fill records per child; deeper sweeps are cut short
+    uint64_t child_id_base = 1ULL << 62; // Child order ids count up from here, clear of parsed ids
+};
+
+// Takes a child order instead of the engine submitting it; the outcome is
+// reported back through ExecutionEngine::on_child_result()
+using ChildRouter = std::function<void(uint32_t parent_id, const lob::OrderRequest& request)>;
+
+// TWAP/VWAP execution: parent orders whose child slices are scheduled on a
+// TimerWheel and submitted straight into a MatchingEngine per symbol.
+//
+// Time comes from whoever drives it: poll() advances to TscClock::now_ns(),
+// the clock MessageParser stamps messages with, while a backtest calls
+// advance() with event times. on_message() feeds TRADE prints into each
+// attached symbol's VolumeCurve; VWAP parents fix their slice weights from
+// the curve when they start, falling back to TWAP while it is empty.
+//
+// Single-threaded: run it on the thread that owns the matching engines.
+class ExecutionEngine {
+public:
+    explicit ExecutionEngine(const ExecutionConfig& config = ExecutionConfig());
+
+    // The venue receives this symbol's children; it must outlive the engine
+    bool attach(uint32_t symbol_id, lob::MatchingEngine* venue);
+
+    void on_message(const ingestion::MarketMessage& message);
+
+    // Children go to the router rather than straight into the venue, e.g.
+    // through a simulated network. Routed quantity counts as in flight:
+    // later slices do not resend it, and a parent whose last slice has
+    // fired stays WORKING until its results are in.
+    void set_router(ChildRouter router) { router_ = std::move(router); }
+    // Every child is checked first and the gate is kept up to date with its
+    // fills; must outlive the engine
+    void set_risk_gate(RiskGate* gate) { risk_ = gate; }
+    // notional: sum of fill ticks x quantity, as in ExecutionReport
+    void on_child_result(uint32_t parent_id, const lob::OrderRequest& request, int32_t filled, int64_t notional);
+
+    // A parent starting at or before the engine's time sends its first slice
+    // from within start()
+    ExecutionStatus start(const ExecutionParams& params, uint32_t& parent_id);
+    bool cancel(uint32_t parent_id);
+
+    // Fires due slices; returns the number of child orders submitted
+    size_t advance(uint64_t now_ns);
+    size_t poll() { return advance(clock_.now_ns()); }
+
+    const ExecutionReport* report(uint32_t parent_id) const {
+        return parent_id < parents_.size() ? &parents_[parent_id].report : nullptr;
+    }
+    const VolumeCurve* volume_curve(uint32_t symbol_id) const;
+
+    uint64_t now_ns() const { return wheel_.now_ns(); }
+    size_t working() const { return working_; }  // Parents in the WORKING state
+    // How far past their deadline slices ran (wheel resolution plus polling delay)
+    const ingestion::LatencyHistogram& slice_lateness() const { return slice_lateness_; }
+
+private:
+    static constexpr uint32_t NO_CURVE = 0xFFFFFFFF;
+
+    struct Venue {
+        lob::MatchingEngine* engine = nullptr;
+        uint32_t curve = NO_CURVE;
+    };
+
+    struct Parent {
+        ExecutionReport report;
+        std::vector<int32_t> targets;  // Cumulative quantity due by the end of each slice
+        uint64_t interval_ns = 0;
+        TimerId timer = INVALID_TIMER;
+    };
+
+    void plan(Parent& parent) const;
+    bool fire(uint32_t parent_id, uint64_t deadline_ns, uint64_t now_ns);
+    bool send_child(uint32_t parent_id, int32_t quantity);
+    // Sets a final state if the parent is done; true when no slice remains
+    bool finish(Parent& parent);
+
+    ExecutionConfig config_;
+    const ingestion::TscClock& clock_;
+    TimerWheel wheel_;
+    std::vector<Venue> venues_;
+    std::vector<VolumeCurve> curves_;
+    std::vector<Parent> parents_;
+    std::vector<lob::Trade> trades_;
+    ChildRouter router_;
+    RiskGate* risk_ = nullptr;
+    uint64_t next_child_id_;
+    size_t working_ = 0;
+    ingestion::LatencyHistogram slice_lateness_;
+};
+
+} // namespace strategy
+} // namespace hft
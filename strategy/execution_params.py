@@ -0,0 +1,73 @@
+"""
+Parameters for the C++ TWAP/VWAP execution engine (execution_engine.hpp).
+
+Slicing, scheduling and child order submission all happen in C++; Python
+only describes the parent order. to_spec() renders the key=value string
+that hft::strategy::parse_execution_params() accepts, e.g. to hand to the
+engine process over a control channel or in a config file.
+"""
+
+from dataclasses import dataclass
+from decimal import Decimal
+from typing import Optional, Union
+
+ALGOS = ('twap', 'vwap')
+SIDES = ('buy', 'sell')
+MAX_SLICES = 100000
+
+
+@dataclass
+class ExecutionParams:
+    """One parent order, mirroring hft::strategy::ExecutionParams"""
+    symbol: str
+    side: str
+    quantity: int
+    algo: str = 'twap'
+    duration_ns: int = 0            # Window length from start (or from now)
+    start_ns: int = 0               # 0 = the engine's current time
+    end_ns: int = 0                 # Overrides duration_ns when set
+    slices: int = 1
+    limit: Optional[Union[str, float, Decimal]] = None  # None = market children
+    owner: int = 0                  # Self-trade prevention group
+
+    def validate(self) -> None:
+        """Raise ValueError for anything the engine would reject"""
+        if self.algo not in ALGOS:
+            raise ValueError(f"algo must be one of {ALGOS}")
+        if self.side not in SIDES:
+            raise ValueError(f"side must be one of {SIDES}")
+        if not self.symbol or any(c.isspace() or c == '=' for c in self.symbol):
+            raise ValueError("symbol must be a non-empty token")
+        if not 0 < self.quantity < 2**31:
+            raise ValueError("quantity must be a positive 32-bit integer")
+        if not 1 <= self.slices <= MAX_SLICES:
+            raise ValueError(f"slices must be between 1 and {MAX_SLICES}")
+        if min(self.start_ns, self.end_ns, self.duration_ns) < 0:
+            raise ValueError("times must be non-negative")
+        if self.end_ns and self.start_ns and self.end_ns < self.start_ns:
+            raise ValueError("end_ns is before start_ns")
+        if not 0 <= self.owner <= 0xFFFF:
+            raise ValueError("owner must fit in 16 bits")
+        if self.limit is not None and Decimal(str(self.limit)) <= 0:
+            raise ValueError("limit must be positive")
+
+    def to_spec(self) -> str:
+        """Render for parse_execution_params()"""
+        self.validate()
+        parts = [f"algo={self.algo}", f"symbol={self.symbol}", f"side={self.side}",
+                 f"quantity={self.quantity}", f"slices={self.slices}"]
+        for key in ('start_ns', 'end_ns', 'duration_ns'):
+            value = getattr(self, key)
+            if value:
+                parts.append(f"{key}={value}")
+        if self.limit is not None:
+            # Fixed notation, at most 8 decimals (price.hpp PRICE_DECIMALS)
+            parts.append(f"limit={Decimal(str(self.limit)).quantize(Decimal('1e-8')).normalize():f}")
+        if self.owner:
+            parts.append(f"owner={self.owner}")
+        return ' '.join(parts)
+
+
+if __name__ == '__main__':
+    print(ExecutionParams(symbol='AAPL', side='buy', quantity=5000, algo='vwap',
+                          duration_ns=30 * 60 * 10**9, slices=30, limit='150.25').to_spec())
@@ -0,0 +1,172 @@
+#include "risk_gate.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+
+namespace hft {
+namespace strategy {
+
+namespace {
+
+constexpr uint64_t NS_PER_SECOND = 1000000000ULL;
+
+} // namespace
+
+RiskGate::RiskGate(size_t symbol_capacity)
+    : capacity_(symbol_capacity), symbols_(new SymbolRisk[symbol_capacity]), halted_(false) {}
+
+bool RiskGate::set_limits(uint32_t symbol_id, const RiskLimits& limits) {
+    if (symbol_id >= capacity_ || limits.max_position < 0 || limits.max_notional < 0 || limits.tick_units <= 0) {
+        return false;
+    }
+    Limits& target = symbols_[symbol_id].limits;
+    uint64_t interval = limits.max_orders_per_second ? NS_PER_SECOND / limits.max_orders_per_second : 0;
+    target.max_position.store(limits.max_position, std::memory_order_relaxed);
+    target.max_notional.store(limits.max_notional, std::memory_order_relaxed);
+    target.order_interval_ns.store(interval, std::memory_order_relaxed);
+    target.burst_ns.store(interval * limits.max_orders_per_second, std::memory_order_relaxed);
+    target.price_band_bps.store(limits.price_band_bps, std::memory_order_relaxed);
+    target.tick_units.store(limits.tick_units, std::memory_order_relaxed);
+    target.configured.store(true, std::memory_order_release);
+    return true;
+}
+
+bool RiskGate::set_reference_price(uint32_t symbol_id, int64_t price_ticks) {
+    if (symbol_id >= capacity_ || price_ticks <= 0) {
+        return false;
+    }
+    symbols_[symbol_id].state.reference_price.store(price_ticks, std::memory_order_relaxed);
+    return true;
+}
+
+bool RiskGate::halt(uint32_t symbol_id, bool halted) {
+    if (symbol_id >= capacity_) {
+        return false;
+    }
+    symbols_[symbol_id].limits.halted.store(halted, std::memory_order_relaxed);
+    return true;
+}
+
+RiskResult RiskGate::check(uint32_t symbol_id, ingestion::Side side, int32_t quantity, int64_t price_ticks,
+                           uint64_t now_ns) {
+    if (symbol_id >= capacity_) {
+        return RiskResult::UNKNOWN_SYMBOL;
+    }
+    SymbolRisk& risk = symbols_[symbol_id];
+    const Limits& limits = risk.limits;
+    State& state = risk.state;
+    if (!limits.configured.load(std::memory_order_acquire)) {
+        return reject(risk, RiskResult::NO_LIMITS);
+    }
+    if (halted_.load(std::memory_order_relaxed) || limits.halted.load(std::memory_order_relaxed)) {
+        return reject(risk, RiskResult::HALTED);
+    }
+    if (quantity <= 0 || (side != ingestion::Side::BUY && side != ingestion::Side::SELL)) {
+        return reject(risk, RiskResult::INVALID);
+    }
+
+    int64_t reference = state.reference_price.load(std::memory_order_relaxed);
+    int64_t band_bps = limits.price_band_bps.load(std::memory_order_relaxed);
+    if (price_ticks > 0 && band_bps > 0 && reference > 0 &&
+        std::fabs(static_cast<double>(price_ticks - reference)) * 1e4 > static_cast<double>(band_bps) * reference) {
+        return reject(risk, RiskResult::PRICE_BAND);
+    }
+
+    // Reserve first, so a concurrent check sees this order's quantity
+    bool buy = side == ingestion::Side::BUY;
+    std::atomic<int64_t>& open = buy ? state.open_buy : state.open_sell;
+    int64_t open_after = open.fetch_add(quantity, std::memory_order_acq_rel) + quantity;
+    int64_t position = state.position.load(std::memory_order_acquire);
+    int64_t worst = buy ? position + open_after : position - open_after;
+    bool increases = buy ? worst > 0 : worst < 0;  // Orders that reduce exposure always pass the size limits
+
+    RiskResult result = RiskResult::ACCEPTED;
+    int64_t max_position = limits.max_position.load(std::memory_order_relaxed);
+    int64_t max_notional = limits.max_notional.load(std::memory_order_relaxed);
+    if (increases && max_position > 0 && std::abs(worst) > max_position) {
+        result = RiskResult::POSITION_LIMIT;
+    } else if (increases && max_notional > 0) {
+        int64_t price = price_ticks > 0 ? price_ticks : reference;
+        if (price <= 0) {
+            result = RiskResult::NO_REFERENCE_PRICE;
+        } else if (static_cast<double>(std::abs(worst)) * static_cast<double>(price) *
+                       static_cast<double>(limits.tick_units.load(std::memory_order_relaxed)) >
+                   static_cast<double>(max_notional)) {
+            result = RiskResult::NOTIONAL_LIMIT;
+        }
+    }
+    if (result == RiskResult::ACCEPTED && !take_rate_token(risk, now_ns)) {
+        result = RiskResult::ORDER_RATE;
+    }
+    if (result != RiskResult::ACCEPTED) {
+        open.fetch_sub(quantity, std::memory_order_acq_rel);
+        return reject(risk, result);
+    }
+    return RiskResult::ACCEPTED;
+}
+
+// GCRA: the bucket's theoretical arrival time advances one interval per
+// order and may run at most burst_ns ahead of now
+bool RiskGate::take_rate_token(SymbolRisk& risk, uint64_t now_ns) {
+    uint64_t interval = risk.limits.order_interval_ns.load(std::memory_order_relaxed);
+    if (interval == 0) {
+        return true;
+    }
+    uint64_t burst = risk.limits.burst_ns.load(std::memory_order_relaxed);
+    uint64_t tat = risk.state.rate_tat_ns.load(std::memory_order_relaxed);
+    for (;;) {
+        uint64_t next = std::max(tat, now_ns) + interval;
+        if (next > now_ns + burst) {
+            return false;
+        }
+        if (risk.state.rate_tat_ns.compare_exchange_weak(tat, next, std::memory_order_relaxed)) {
+            return true;
+        }
+    }
+}
+
+RiskResult RiskGate::reject(SymbolRisk& risk, RiskResult result) {
+    risk.state.rejected.fetch_add(1, std::memory_order_relaxed);
+    return result;
+}
+
+void RiskGate::on_fill(uint32_t symbol_id, ingestion::Side side, int32_t quantity, int64_t price_ticks) {
+    if (symbol_id >= capacity_ || quantity <= 0) {
+        return;
+    }
+    State& state = symbols_[symbol_id].state;
+    bool buy = side == ingestion::Side::BUY;
+    // Position first: until open drops, a concurrent check counts the fill twice, never zero times
+    state.position.fetch_add(buy ? quantity : -quantity, std::memory_order_acq_rel);
+    (buy ? state.open_buy : state.open_sell).fetch_sub(quantity, std::memory_order_acq_rel);
+    if (price_ticks > 0) {
+        state.reference_price.store(price_ticks, std::memory_order_relaxed);
+    }
+}
+
+void RiskGate::release(uint32_t symbol_id, ingestion::Side side, int32_t quantity) {
+    if (symbol_id >= capacity_ || quantity <= 0) {
+        return;
+    }
+    State& state = symbols_[symbol_id].state;
+    (side == ingestion::Side::BUY ? state.open_buy : state.open_sell).fetch_sub(quantity, std::memory_order_acq_rel);
+}
+
+int64_t RiskGate::position(uint32_t symbol_id) const {
+    return symbol_id < capacity_ ? symbols_[symbol_id].state.position.load(std::memory_order_relaxed) : 0;
+}
+
+int64_t RiskGate::open_quantity(uint32_t symbol_id, ingestion::Side side) const {
+    if (symbol_id >= capacity_) {
+        return 0;
+    }
+    const State& state = symbols_[symbol_id].state;
+    return (side == ingestion::Side::BUY ? state.open_buy : state.open_sell).load(std::memory_order_relaxed);
+}
+
+uint64_t RiskGate::rejected(uint32_t symbol_id) const {
+    return symbol_id < capacity_ ? symbols_[symbol_id].state.rejected.load(std::memory_order_relaxed) : 0;
+}
+
+} // namespace strategy
+} // namespace hft
@@ -0,0 +1,110 @@
+#pragma once
+
+#include "matching_engine.hpp"
+#include "message_types.hpp"
+#include "price.hpp"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+namespace hft {
+namespace strategy {
+
+enum class RiskResult : uint8_t {
+    ACCEPTED = 0,
+    UNKNOWN_SYMBOL,      // Beyond the gate's capacity
+    NO_LIMITS,           // set_limits() never called for the symbol
+    HALTED,              // Symbol or whole gate halted
+    INVALID,             // Bad side or quantity
+    PRICE_BAND,          // Limit price too far from the reference price
+    NO_REFERENCE_PRICE,  // Market order with a notional limit but no reference yet
+    POSITION_LIMIT,
+    NOTIONAL_LIMIT,
+    ORDER_RATE
+};
+
+// Zero disables a limit
+struct RiskLimits {
+    int64_t max_position = 0;            // Shares either way, counting working orders as filled
+    int64_t max_notional = 0;            // Raw 1e-8 units (price.hpp) of that worst-case position
+    uint32_t max_orders_per_second = 0;  // Sustained rate, bursts up to the same count
+    uint32_t price_band_bps = 0;         // Limit prices within this of the reference price
+    int64_t tick_units = ingestion::DEFAULT_TICK_UNITS;  // Converts order ticks to raw units
+};
+
+// Inline pre-trade checks keyed by symbol id, for the order path.
+//
+// Each symbol has two cache lines of atomics: limits, written rarely by a
+// control thread, and state, written by checks and fills. check() runs
+// without locks on any thread. An accepted order reserves its quantity as
+// open, so concurrent checks cannot both use the same headroom. After
+// that, on_fill() moves quantity into the position and release() returns
+// whatever will not fill (IOC remainders, cancels).
+//
+// The order rate is a GCRA token bucket held in one atomic. Price is in
+// ticks, as in lob::OrderRequest, and the reference price follows fills
+// unless set_reference_price() is fed from market data.
+class RiskGate {
+public:
+    explicit RiskGate(size_t symbol_capacity = 4096);
+
+    bool set_limits(uint32_t symbol_id, const RiskLimits& limits);
+    bool set_reference_price(uint32_t symbol_id, int64_t price_ticks);
+    bool halt(uint32_t symbol_id, bool halted = true);
+    void halt_all(bool halted = true) { halted_.store(halted, std::memory_order_relaxed); }
+
+    // price_ticks <= 0 is a market order. Reserves quantity on ACCEPTED.
+    RiskResult check(uint32_t symbol_id, ingestion::Side side, int32_t quantity, int64_t price_ticks,
+                     uint64_t now_ns);
+    RiskResult check(uint32_t symbol_id, const lob::OrderRequest& request, uint64_t now_ns) {
+        int64_t price = (request.flags & lob::ORDER_MARKET) ? 0 : request.price;
+        return check(symbol_id, request.side, request.quantity, price, now_ns);
+    }
+
+    void on_fill(uint32_t symbol_id, ingestion::Side side, int32_t quantity, int64_t price_ticks);
+    void release(uint32_t symbol_id, ingestion::Side side, int32_t quantity);
+
+    int64_t position(uint32_t symbol_id) const;
+    int64_t open_quantity(uint32_t symbol_id, ingestion::Side side) const;
+    uint64_t rejected(uint32_t symbol_id) const;
+    size_t symbol_capacity() const { return capacity_; }
+
+private:
+    struct alignas(64) Limits {
+        std::atomic<int64_t> max_position{0};
+        std::atomic<int64_t> max_notional{0};
+        std::atomic<uint64_t> order_interval_ns{0};  // 1 s / max_orders_per_second, 0 = unlimited
+        std::atomic<uint64_t> burst_ns{0};           // How far ahead of now the bucket may run
+        std::atomic<int64_t> price_band_bps{0};
+        std::atomic<int64_t> tick_units{ingestion::DEFAULT_TICK_UNITS};
+        std::atomic<bool> configured{false};
+        std::atomic<bool> halted{false};
+    };
+
+    struct alignas(64) State {
+        std::atomic<int64_t> position{0};
+        std::atomic<int64_t> open_buy{0};
+        std::atomic<int64_t> open_sell{0};
+        std::atomic<int64_t> reference_price{0};  // Ticks, 0 = none yet
+        std::atomic<uint64_t> rate_tat_ns{0};     // GCRA theoretical arrival time
+        std::atomic<uint64_t> rejected{0};        // Accepted orders are not counted: one less RMW per check
+    };
+
+    struct SymbolRisk {
+        Limits limits;
+        State state;
+    };
+
+    static_assert(sizeof(SymbolRisk) == 128, "Limits and state take one cache line each");
+
+    bool take_rate_token(SymbolRisk& risk, uint64_t now_ns);
+    RiskResult reject(SymbolRisk& risk, RiskResult result);
+
+    size_t capacity_;
+    std::unique_ptr<SymbolRisk[]> symbols_;
+    std::atomic<bool> halted_;
+};
+
+} // namespace strategy
+} // namespace hft
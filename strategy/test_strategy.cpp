@@ -0,0 +1,394 @@
+// Unit tests for the timer wheel, the TWAP/VWAP execution engine and the risk gate.
+
+#include "execution_engine.hpp"
+#include "matching_engine.hpp"
+#include "risk_gate.hpp"
+#include "timer_wheel.hpp"
+#include "volume_curve.hpp"
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <iterator>
+#include <map>
+#include <random>
+#include <thread>
+#include <vector>
+
+using namespace hft::ingestion;
+using namespace hft::lob;
+using namespace hft::strategy;
+
+static int g_failures = 0;
+
+#define CHECK(cond)                                                           \
+    do {                                                                      \
+        if (!(cond)) {                                                        \
+            std::fprintf(stderr, "%s:%d: CHECK failed: %s\n", __FILE__, __LINE__, #cond); \
+            g_failures++;                                                     \
+        }                                                                     \
+    } while (0)
+
+namespace {
+
+constexpr uint64_t SECOND = 1000000000ULL;
+constexpr uint64_t T0 = 1705312800ULL * SECOND;  // 2024-01-15 10:00:00 UTC
+
+void test_timer_wheel() {
+    TimerWheel wheel(T0, 1000);
+    std::vector<uint64_t> fired;
+    auto collect = [&](uint64_t cookie, uint64_t) { fired.push_back(cookie); };
+
+    TimerId soon = wheel.schedule(T0 + 1500, 1);   // Rounds up to tick 2
+    wheel.schedule(T0 + 300 * SECOND, 2);          // Three levels up
+    TimerId gone = wheel.schedule(T0 + 5000, 3);
+    wheel.schedule(T0 - SECOND, 4);                // Already due: next tick
+    CHECK(wheel.cancel(gone) && !wheel.cancel(gone));
+    CHECK(wheel.size() == 3);
+
+    CHECK(wheel.advance(T0 + 1999, collect) == 1 && fired.back() == 4);  // Never early
+    CHECK(wheel.advance(T0 + 2000, collect) == 1 && fired.back() == 1);
+    CHECK(!wheel.cancel(soon));                                          // Fired handles are stale
+    CHECK(wheel.advance(T0 + 300 * SECOND - 1, collect) == 0);
+    CHECK(wheel.advance(T0 + 300 * SECOND, collect) == 1 && fired.back() == 2);
+    CHECK(wheel.empty() && wheel.now_ns() == T0 + 300 * SECOND);
+
+    // Beyond the top level's reach (2^32 us, ~72 min): parked and re-cascaded
+    uint64_t far = wheel.now_ns() + 3 * 3600 * SECOND;
+    wheel.schedule(far, 5);
+    CHECK(wheel.advance(far - 1000, collect) == 0);
+    CHECK(wheel.advance(far, collect) == 1 && fired.back() == 5);
+
+    // Randomized against an ordered model, with callbacks scheduling more
+    std::mt19937_64 rng(7);
+    std::multimap<uint64_t, uint64_t> model;  // tick -> cookie
+    std::map<uint64_t, TimerId> handles;
+    uint64_t cookie = 100;
+    uint64_t now = wheel.now_ns();
+    bool ok = true;
+    for (int round = 0; round < 2000; ++round) {
+        uint64_t delay = 1000 + (rng() % 4 == 0 ? rng() % (600 * SECOND) : rng() % 5000000);
+        uint64_t deadline = now + delay;
+        handles[cookie] = wheel.schedule(deadline, cookie);
+        model.emplace((deadline + 999) / 1000, cookie++);
+        if (rng() % 5 == 0 && !handles.empty()) {
+            auto victim = handles.begin();
+            std::advance(victim, rng() % handles.size());
+            CHECK(wheel.cancel(victim->second));
+            for (auto it = model.begin(); it != model.end(); ++it) {
+                if (it->second == victim->first) {
+                    model.erase(it);
+                    break;
+                }
+            }
+            handles.erase(victim);
+        }
+        now += rng() % (rng() % 8 == 0 ? 100 * SECOND : 2000000);
+        uint64_t last_tick = 0;
+        wheel.advance(now, [&](uint64_t c, uint64_t deadline_ns) {
+            auto it = model.begin();
+            uint64_t tick = (deadline_ns + 999) / 1000;
+            ok = ok && it != model.end() && tick >= last_tick && tick <= now / 1000;
+            for (; it != model.end() && it->first == tick && it->second != c; ++it) {
+            }
+            ok = ok && it != model.end() && it->second == c && it->first == model.begin()->first;
+            if (it != model.end()) {
+                model.erase(it);
+            }
+            handles.erase(c);
+            last_tick = tick;
+        });
+        ok = ok && (model.empty() || model.begin()->first > now / 1000);
+    }
+    CHECK(ok);
+    CHECK(wheel.size() == model.size());
+}
+
+// Resting asks that children can sweep
+void seed_asks(MatchingEngine& venue, uint64_t first_id, int32_t each, int levels) {
+    Trade trades[4];
+    for (int i = 0; i < levels; ++i) {
+        OrderRequest request;
+        request.id = first_id + i;
+        request.price = 10000 + i;
+        request.quantity = each;
+        request.side = Side::SELL;
+        venue.submit(request, trades, 4);
+    }
+}
+
+void test_twap() {
+    ExecutionConfig config;
+    config.start_ns = T0;
+    ExecutionEngine engine(config);
+    MatchingEngine venue;
+    seed_asks(venue, 1, 1000, 5);
+    CHECK(engine.attach(3, &venue));
+    CHECK(!engine.attach(4096, &venue));
+
+    ExecutionParams params;
+    params.symbol_id = 3;
+    params.side = Side::BUY;
+    params.quantity = 1000;
+    params.duration_ns = 10 * SECOND;
+    params.slices = 4;
+    uint32_t id = 0;
+    CHECK(engine.start(params, id) == ExecutionStatus::ACCEPTED);  // First slice goes at once
+    CHECK(engine.working() == 1);
+    const ExecutionReport* report = engine.report(id);
+    CHECK(report->filled == 250 && report->children == 1 && report->notional == 250 * 10000);
+    params.symbol_id = 9;
+    uint32_t unused = 0;
+    CHECK(engine.start(params, unused) == ExecutionStatus::NO_VENUE);
+    params.quantity = 0;
+    CHECK(engine.start(params, unused) == ExecutionStatus::INVALID);
+
+    CHECK(engine.advance(T0 + 2 * SECOND) == 0);
+    CHECK(engine.advance(T0 + 3 * SECOND) == 1 && report->filled == 500);
+    CHECK(engine.advance(T0 + 60 * SECOND) == 2);
+    CHECK(report->state == ExecutionState::FILLED && report->filled == 1000 && engine.working() == 0);
+    CHECK(venue.book().order_count() == 4);  // 1000 of 5000 taken at the best level
+    CHECK(engine.slice_lateness().count() == 4);
+
+    // A limit below the offer: children cancel, the shortfall rolls forward, then expires
+    ExecutionParams limited;
+    limited.symbol_id = 3;
+    limited.side = Side::BUY;
+    limited.quantity = 300;
+    limited.duration_ns = 3 * SECOND;
+    limited.slices = 3;
+    limited.limit_price = 9999 * DEFAULT_TICK_UNITS;  // One tick under the best ask
+    CHECK(engine.start(limited, id) == ExecutionStatus::ACCEPTED);
+    CHECK(engine.report(id)->children == 1 && engine.report(id)->filled == 0);
+    engine.advance(T0 + 120 * SECOND);
+    report = engine.report(id);
+    CHECK(report->state == ExecutionState::EXPIRED && report->children == 3 && report->remaining() == 300);
+
+    limited.duration_ns = 100 * SECOND;
+    CHECK(engine.start(limited, id) == ExecutionStatus::ACCEPTED);
+    CHECK(engine.working() == 1);
+    CHECK(engine.cancel(id) && !engine.cancel(id));
+    CHECK(engine.advance(T0 + 1000 * SECOND) == 0);
+    CHECK(engine.report(id)->state == ExecutionState::CANCELLED && engine.working() == 0);
+}
+
+// A routed parent stays working after its last slice until the results are in
+void test_routed_children() {
+    ExecutionConfig config;
+    config.start_ns = T0;
+    ExecutionEngine engine(config);
+    MatchingEngine venue;
+    seed_asks(venue, 1, 1000, 5);
+    CHECK(engine.attach(3, &venue));
+    std::vector<OrderRequest> routed;
+    engine.set_router([&](uint32_t, const OrderRequest& request) { routed.push_back(request); });
+
+    ExecutionParams params;
+    params.symbol_id = 3;
+    params.side = Side::BUY;
+    params.quantity = 400;
+    params.duration_ns = 2 * SECOND;
+    params.slices = 2;
+    uint32_t id = 0;
+    CHECK(engine.start(params, id) == ExecutionStatus::ACCEPTED);
+    CHECK(routed.size() == 1 && engine.working() == 1);
+    CHECK(engine.advance(T0 + 10 * SECOND) == 1);  // The last slice fires; no timer is left
+    const ExecutionReport* report = engine.report(id);
+    CHECK(routed.size() == 2 && report->in_flight == 400 && report->state == ExecutionState::WORKING);
+    CHECK(engine.working() == 1);
+
+    engine.on_child_result(id, routed[0], 200, 200 * 10000);
+    CHECK(engine.working() == 1);
+    engine.on_child_result(id, routed[1], 200, 200 * 10000);
+    CHECK(report->state == ExecutionState::FILLED && report->in_flight == 0 && engine.working() == 0);
+}
+
+void test_vwap() {
+    VolumeCurve curve(60 * SECOND);
+    CHECK(curve.bucket_count() == 1440);
+    curve.add(T0, 300);                // 10:00
+    curve.add(T0 + 60 * SECOND, 100);  // 10:01
+    CHECK(std::fabs(curve.volume(T0, T0 + 120 * SECOND) - 400.0) < 1e-9);
+    CHECK(std::fabs(curve.volume(T0 + 30 * SECOND, T0 + 90 * SECOND) - 200.0) < 1e-9);  // Pro rata
+    CHECK(std::fabs(curve.volume(T0, T0 + 86400 * SECOND) - 400.0) < 1e-9);           // Wraps midnight
+
+    ExecutionConfig config;
+    config.start_ns = T0;
+    config.volume_bucket_ns = 60 * SECOND;
+    ExecutionEngine engine(config);
+    MatchingEngine venue;
+    seed_asks(venue, 1, 10000, 2);
+    engine.attach(0, &venue);
+
+    // Yesterday's prints: 3/4 of the window's volume in its first minute
+    MarketMessage trade;
+    trade.type = MessageType::TRADE;
+    trade.symbol_id = 0;
+    trade.timestamp = T0 - 86400 * SECOND;
+    trade.size = 300;
+    engine.on_message(trade);
+    trade.timestamp += 60 * SECOND;
+    trade.size = 100;
+    engine.on_message(trade);
+    trade.symbol_id = 1;  // Not attached: ignored
+    engine.on_message(trade);
+    CHECK(engine.volume_curve(0)->total() == 400.0 && engine.volume_curve(1) == nullptr);
+
+    ExecutionParams params;
+    parse_execution_params("algo=vwap symbol_id=0 side=buy quantity=800 duration_ns=120000000000 slices=2", params);
+    uint32_t id = 0;
+    CHECK(engine.start(params, id) == ExecutionStatus::ACCEPTED);
+    CHECK(engine.report(id)->filled == 600);
+    engine.advance(T0 + 60 * SECOND);
+    CHECK(engine.report(id)->filled == 800 && engine.report(id)->state == ExecutionState::FILLED);
+
+    // Without a curve VWAP slices evenly
+    MatchingEngine other;
+    seed_asks(other, 1, 10000, 1);
+    engine.attach(2, &other);
+    params.symbol_id = 2;
+    params.start_ns = T0 + 200 * SECOND;
+    CHECK(engine.start(params, id) == ExecutionStatus::ACCEPTED);
+    engine.advance(T0 + 200 * SECOND);
+    CHECK(engine.report(id)->filled == 400);
+}
+
+void test_execution_params() {
+    SymbolRegistry registry(8);
+    registry.intern("AAPL");
+    ExecutionParams params;
+    CHECK(parse_execution_params("algo=vwap symbol=AAPL side=sell quantity=5000 duration_ns=1800000000000 "
+                                 "slices=30 limit=150.25 owner=3", params, &registry));
+    CHECK(params.algo == ExecutionAlgo::VWAP && params.symbol_id == registry.find("AAPL"));
+    CHECK(params.side == Side::SELL && params.quantity == 5000 && params.slices == 30);
+    CHECK(params.duration_ns == 1800 * SECOND && params.limit_price == 15025000000LL && params.owner == 3);
+
+    ExecutionParams untouched = params;
+    CHECK(!parse_execution_params("algo=vwap side=buy qty=5", params));  // Unknown key
+    CHECK(!parse_execution_params("symbol=AAPL", params));               // Needs a registry
+    CHECK(!parse_execution_params("symbol=APPL side=buy quantity=5", params, &registry));  // Unknown symbol
+    CHECK(registry.size() == 1);
+    CHECK(!parse_execution_params("side=hold", params));
+    CHECK(!parse_execution_params("slices=1000001", params));
+    CHECK(params.quantity == untouched.quantity && params.symbol_id == untouched.symbol_id);
+    CHECK(parse_execution_params("  symbol_id=7\tside=buy\n", params) && params.symbol_id == 7);
+}
+
+void test_risk_gate() {
+    constexpr int64_t CENT = 1000000;  // Raw units per tick
+    RiskGate gate(8);
+    CHECK(gate.check(2, Side::BUY, 100, 10000, T0) == RiskResult::NO_LIMITS);
+    CHECK(gate.check(8, Side::BUY, 100, 10000, T0) == RiskResult::UNKNOWN_SYMBOL);
+
+    RiskLimits limits;
+    limits.max_position = 1000;
+    limits.max_notional = 50000 * PRICE_SCALE;  // 50,000.00
+    limits.max_orders_per_second = 4;
+    limits.price_band_bps = 100;
+    limits.tick_units = CENT;
+    CHECK(gate.set_limits(2, limits) && !gate.set_limits(8, limits));
+    CHECK(gate.check(2, Side::UNKNOWN, 100, 10000, T0) == RiskResult::INVALID);
+
+    // Accepted quantity stays reserved until filled or released
+    CHECK(gate.check(2, Side::BUY, 400, 10000, T0) == RiskResult::ACCEPTED);
+    CHECK(gate.check(2, Side::BUY, 700, 10000, T0) == RiskResult::POSITION_LIMIT);
+    CHECK(gate.check(2, Side::BUY, 100, 10000, T0) == RiskResult::ACCEPTED);  // 500 x 100.00: at the cap
+    CHECK(gate.check(2, Side::BUY, 1, 10000, T0) == RiskResult::NOTIONAL_LIMIT);
+    CHECK(gate.open_quantity(2, Side::BUY) == 500);
+    gate.on_fill(2, Side::BUY, 400, 10000);
+    gate.release(2, Side::BUY, 100);
+    CHECK(gate.position(2) == 400 && gate.open_quantity(2, Side::BUY) == 0);
+
+    // Band around the last fill; exposure-reducing orders skip the size limits
+    CHECK(gate.check(2, Side::BUY, 10, 10101, T0) == RiskResult::PRICE_BAND);
+    CHECK(gate.check(2, Side::BUY, 10, 10100, T0) == RiskResult::ACCEPTED);
+    CHECK(gate.check(2, Side::SELL, 400, 0, T0) == RiskResult::ACCEPTED);
+    // Four orders a second: the fifth waits a quarter second
+    CHECK(gate.check(2, Side::BUY, 1, 10000, T0) == RiskResult::ORDER_RATE);
+    CHECK(gate.check(2, Side::BUY, 1, 10000, T0 + 250 * 1000000ULL) == RiskResult::ACCEPTED);
+    CHECK(gate.rejected(2) == 6);
+
+    CHECK(gate.halt(2) && gate.check(2, Side::SELL, 1, 10000, T0 + SECOND) == RiskResult::HALTED);
+    gate.halt(2, false);
+    gate.halt_all();
+    CHECK(gate.check(2, Side::SELL, 1, 10000, T0 + SECOND) == RiskResult::HALTED);
+    gate.halt_all(false);
+    CHECK(gate.check(2, Side::SELL, 1, 10000, T0 + SECOND) == RiskResult::ACCEPTED);
+
+    // Market orders are valued at the reference price
+    RiskLimits notional_only;
+    notional_only.max_notional = 1000 * PRICE_SCALE;
+    notional_only.tick_units = CENT;
+    gate.set_limits(3, notional_only);
+    OrderRequest market;
+    market.id = 1;
+    market.price = 0;
+    market.quantity = 5;
+    market.side = Side::BUY;
+    market.flags = ORDER_MARKET;
+    CHECK(gate.check(3, market, T0) == RiskResult::NO_REFERENCE_PRICE);
+    CHECK(gate.set_reference_price(3, 10000) && gate.check(3, market, T0) == RiskResult::ACCEPTED);
+    market.quantity = 6;
+    CHECK(gate.check(3, market, T0) == RiskResult::NOTIONAL_LIMIT);  // 11 x 100.00 with the first still open
+
+    // Concurrent checks never share headroom
+    RiskLimits position_only;
+    position_only.max_position = 1000;
+    gate.set_limits(4, position_only);
+    std::atomic<int> accepted{0};
+    auto hammer = [&]() {
+        for (int i = 0; i < 2000; ++i) {
+            if (gate.check(4, Side::BUY, 1, 10000, T0) == RiskResult::ACCEPTED) {
+                accepted.fetch_add(1);
+            }
+        }
+    };
+    std::thread other(hammer);
+    hammer();
+    other.join();
+    CHECK(accepted.load() > 0 && accepted.load() <= 1000 && gate.open_quantity(4, Side::BUY) == accepted.load());
+
+    // In the execution engine: children beyond the limit are refused and roll forward
+    ExecutionConfig config;
+    config.start_ns = T0;
+    ExecutionEngine engine(config);
+    MatchingEngine venue;
+    seed_asks(venue, 1, 1000, 2);
+    engine.attach(5, &venue);
+    RiskGate engine_gate(8);
+    RiskLimits small;
+    small.max_position = 300;
+    engine_gate.set_limits(5, small);
+    engine.set_risk_gate(&engine_gate);
+    ExecutionParams params;
+    params.symbol_id = 5;
+    params.side = Side::BUY;
+    params.quantity = 1000;
+    params.duration_ns = 4 * SECOND;
+    params.slices = 4;
+    uint32_t id = 0;
+    CHECK(engine.start(params, id) == ExecutionStatus::ACCEPTED);
+    CHECK(engine.advance(T0 + 10 * SECOND) == 0);
+    const ExecutionReport* report = engine.report(id);
+    CHECK(report->filled == 250 && report->children == 1 && report->risk_rejects == 3);
+    CHECK(report->state == ExecutionState::EXPIRED);
+    CHECK(engine_gate.position(5) == 250 && engine_gate.open_quantity(5, Side::BUY) == 0);
+}
+
+} // namespace
+
+int main() {
+    test_timer_wheel();
+    test_twap();
+    test_routed_children();
+    test_vwap();
+    test_execution_params();
+    test_risk_gate();
+
+    if (g_failures > 0) {
+        std::fprintf(stderr, "%d check(s) failed\n", g_failures);
+        return 1;
+    }
+    std::printf("All strategy tests passed\n");
+    return 0;
+}
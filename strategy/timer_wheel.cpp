@@ -0,0 +1,151 @@
+#include "timer_wheel.hpp"
+#include <algorithm>
+
+namespace hft {
+namespace strategy {
+
+TimerWheel::TimerWheel(uint64_t start_ns, uint64_t resolution_ns, size_t expected_timers)
+    : resolution_ns_(std::max<uint64_t>(resolution_ns, 1)),
+      now_tick_(start_ns / resolution_ns_),
+      free_head_(NIL),
+      active_(0) {
+    for (Level& level : levels_) {
+        level.heads.fill(NIL);
+        level.occupied.fill(0);
+    }
+    nodes_.reserve(expected_timers);
+}
+
+TimerId TimerWheel::schedule(uint64_t deadline_ns, uint64_t cookie) {
+    uint32_t index = free_head_;
+    if (index == NIL) {
+        nodes_.push_back(Node{});
+        index = static_cast<uint32_t>(nodes_.size() - 1);
+    } else {
+        free_head_ = nodes_[index].next;
+    }
+    Node& node = nodes_[index];
+    node.deadline_ns = deadline_ns;
+    node.cookie = cookie;
+    // Rounded up so a timer never fires before its deadline
+    node.tick = std::max(deadline_ns / resolution_ns_ + (deadline_ns % resolution_ns_ != 0), now_tick_ + 1);
+    node.generation++;
+    active_++;
+    insert(index);
+    return (static_cast<uint64_t>(node.generation) << 32) | index;
+}
+
+bool TimerWheel::cancel(TimerId id) {
+    uint32_t index = static_cast<uint32_t>(id);
+    uint32_t generation = static_cast<uint32_t>(id >> 32);
+    if (index >= nodes_.size() || nodes_[index].generation != generation || !(generation & 1)) {
+        return false;
+    }
+    unlink(index);
+    release(index);
+    return true;
+}
+
+void TimerWheel::insert(uint32_t index) {
+    uint64_t tick = nodes_[index].tick;
+    uint64_t delta = tick > now_tick_ ? tick - now_tick_ : 0;
+    for (uint32_t level = 0; level < LEVELS; ++level) {
+        if (delta < (uint64_t(1) << (SLOT_BITS * (level + 1)))) {
+            // delta 0 only happens while cascading into the tick being processed
+            uint64_t at = delta == 0 ? now_tick_ : tick;
+            link(index, level, static_cast<uint32_t>(at >> (SLOT_BITS * level)) & SLOT_MASK);
+            return;
+        }
+    }
+    // Beyond the top rotation: park in the last top-level slot before wrapping
+    uint32_t top = LEVELS - 1;
+    link(index, top, static_cast<uint32_t>((now_tick_ >> (SLOT_BITS * top)) + SLOTS - 1) & SLOT_MASK);
+}
+
+void TimerWheel::link(uint32_t index, uint32_t level, uint32_t slot) {
+    Level& wheel = levels_[level];
+    Node& node = nodes_[index];
+    node.bucket = static_cast<uint16_t>(level * SLOTS + slot);
+    node.prev = NIL;
+    node.next = wheel.heads[slot];
+    if (node.next != NIL) {
+        nodes_[node.next].prev = index;
+    }
+    wheel.heads[slot] = index;
+    wheel.occupied[slot >> 6] |= uint64_t(1) << (slot & 63);
+}
+
+void TimerWheel::unlink(uint32_t index) {
+    Node& node = nodes_[index];
+    Level& wheel = levels_[node.bucket / SLOTS];
+    uint32_t slot = node.bucket % SLOTS;
+    if (node.prev != NIL) {
+        nodes_[node.prev].next = node.next;
+    } else {
+        wheel.heads[slot] = node.next;
+    }
+    if (node.next != NIL) {
+        nodes_[node.next].prev = node.prev;
+    }
+    if (wheel.heads[slot] == NIL) {
+        wheel.occupied[slot >> 6] &= ~(uint64_t(1) << (slot & 63));
+    }
+}
+
+void TimerWheel::release(uint32_t index) {
+    Node& node = nodes_[index];
+    node.generation++;
+    node.next = free_head_;
+    free_head_ = index;
+    active_--;
+}
+
+void TimerWheel::cascade(uint32_t level) {
+    Level& wheel = levels_[level];
+    uint32_t slot = static_cast<uint32_t>(now_tick_ >> (SLOT_BITS * level)) & SLOT_MASK;
+    uint32_t index = wheel.heads[slot];
+    wheel.heads[slot] = NIL;
+    wheel.occupied[slot >> 6] &= ~(uint64_t(1) << (slot & 63));
+    while (index != NIL) {
+        uint32_t next = nodes_[index].next;
+        insert(index);
+        index = next;
+    }
+}
+
+uint64_t TimerWheel::next_event_tick() const {
+    uint64_t best = UINT64_MAX;
+    for (uint32_t level = 0; level < LEVELS; ++level) {
+        uint64_t current = now_tick_ >> (SLOT_BITS * level);
+        uint32_t from = static_cast<uint32_t>(current + 1) & SLOT_MASK;
+        uint32_t slot = next_occupied(levels_[level], from);
+        if (slot == SLOTS) {
+            continue;
+        }
+        // A slot is processed (level 0) or cascaded (above) when time reaches its start
+        uint64_t steps = ((slot - from) & SLOT_MASK) + 1;
+        best = std::min(best, (current + steps) << (SLOT_BITS * level));
+    }
+    return best;
+}
+
+uint32_t TimerWheel::next_occupied(const Level& level, uint32_t from) const {
+    uint32_t first_word = from >> 6;
+    uint32_t bit = from & 63;
+    for (uint32_t i = 0; i <= BITMAP_WORDS; ++i) {
+        uint32_t word = (first_word + i) % BITMAP_WORDS;
+        uint64_t bits = level.occupied[word];
+        if (i == 0) {
+            bits &= ~uint64_t(0) << bit;
+        } else if (i == BITMAP_WORDS) {
+            bits &= (uint64_t(1) << bit) - 1;  // Wrapped back to the bits skipped first
+        }
+        if (bits) {
+            return word * 64 + static_cast<uint32_t>(__builtin_ctzll(bits));
+        }
+    }
+    return SLOTS;
+}
+
+} // namespace strategy
+} // namespace hft
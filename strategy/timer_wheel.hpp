@@ -0,0 +1,127 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace hft {
+namespace strategy {
+
+// Handle returned by TimerWheel::schedule(); a cancelled or fired timer's
+// handle goes stale (generation mismatch) rather than hitting a reused slot
+using TimerId = uint64_t;
+constexpr TimerId INVALID_TIMER = 0;
+
+// Hierarchical timing wheel: LEVELS wheels of SLOTS slots, each level's
+// slot spanning a whole rotation of the level below. A timer goes into the
+// lowest level whose rotation covers its delay and cascades down as time
+// reaches its slot, so schedule and cancel are O(1) and advance() costs per
+// occupied slot rather than per tick: per-level occupancy bitmaps let it
+// jump straight to the next slot holding timers, which matters when a
+// backtest leaps over idle stretches. Delays beyond SLOTS^LEVELS ticks are
+// parked in the top level and re-cascaded until due.
+//
+// Time is in nanoseconds, quantized to resolution_ns. A timer fires on the
+// first advance() whose time reaches its tick, i.e. up to one resolution
+// late but never early; deadlines already past fire on the next tick.
+//
+// Single-threaded, driven by whoever owns the clock (TscClock::now_ns() live,
+// message timestamps in a backtest).
+class TimerWheel {
+public:
+    static constexpr uint32_t LEVELS = 4;
+    static constexpr uint32_t SLOT_BITS = 8;
+    static constexpr uint32_t SLOTS = 1u << SLOT_BITS;
+    static constexpr uint64_t DEFAULT_RESOLUTION_NS = 1000;
+
+    explicit TimerWheel(uint64_t start_ns = 0, uint64_t resolution_ns = DEFAULT_RESOLUTION_NS,
+                        size_t expected_timers = 1024);
+
+    // cookie is handed back when the timer fires
+    TimerId schedule(uint64_t deadline_ns, uint64_t cookie);
+    bool cancel(TimerId id);
+
+    // Moves time forward to now_ns, calling fire(cookie, deadline_ns) for
+    // every due timer in deadline-tick order. Callbacks may schedule and
+    // cancel. Returns the number fired; time never moves backwards.
+    template <typename Fn>
+    size_t advance(uint64_t now_ns, Fn&& fire);
+
+    uint64_t now_ns() const { return now_tick_ * resolution_ns_; }
+    uint64_t resolution_ns() const { return resolution_ns_; }
+    size_t size() const { return active_; }
+    bool empty() const { return active_ == 0; }
+
+private:
+    static constexpr uint32_t NIL = 0xFFFFFFFF;
+    static constexpr uint32_t SLOT_MASK = SLOTS - 1;
+    static constexpr uint32_t BITMAP_WORDS = SLOTS / 64;
+
+    struct Node {
+        uint64_t deadline_ns;
+        uint64_t cookie;
+        uint64_t tick;
+        uint32_t prev;
+        uint32_t next;
+        uint32_t generation;  // Bumped on release; odd while scheduled
+        uint16_t bucket;      // level * SLOTS + slot
+    };
+
+    struct Level {
+        std::array<uint32_t, SLOTS> heads;
+        std::array<uint64_t, BITMAP_WORDS> occupied;
+    };
+
+    void insert(uint32_t index);
+    void link(uint32_t index, uint32_t level, uint32_t slot);
+    void unlink(uint32_t index);
+    void release(uint32_t index);
+    void cascade(uint32_t level);
+    uint64_t next_event_tick() const;
+    // First occupied slot at or after from, wrapping; SLOTS if none
+    uint32_t next_occupied(const Level& level, uint32_t from) const;
+
+    uint64_t resolution_ns_;
+    uint64_t now_tick_;
+    std::array<Level, LEVELS> levels_;
+    std::vector<Node> nodes_;
+    uint32_t free_head_;
+    size_t active_;
+};
+
+template <typename Fn>
+size_t TimerWheel::advance(uint64_t now_ns, Fn&& fire) {
+    uint64_t target = now_ns / resolution_ns_;
+    size_t fired = 0;
+    while (now_tick_ < target) {
+        uint64_t next = active_ ? next_event_tick() : target;
+        if (next > target) {
+            now_tick_ = target;  // Nothing due in between
+            break;
+        }
+        now_tick_ = next;
+        // Higher levels whose slot starts at this tick move down first
+        for (uint32_t level = 1; level < LEVELS; ++level) {
+            if (now_tick_ & ((uint64_t(1) << (SLOT_BITS * level)) - 1)) {
+                break;
+            }
+            cascade(level);
+        }
+        uint32_t slot = static_cast<uint32_t>(now_tick_) & SLOT_MASK;
+        uint32_t index;
+        while ((index = levels_[0].heads[slot]) != NIL) {
+            Node& node = nodes_[index];
+            uint64_t cookie = node.cookie;
+            uint64_t deadline = node.deadline_ns;
+            unlink(index);
+            release(index);
+            fired++;
+            fire(cookie, deadline);
+        }
+    }
+    return fired;
+}
+
+} // namespace strategy
+} // namespace hft
@@ -0,0 +1,38 @@
+#include "volume_curve.hpp"
+#include <algorithm>
+
+namespace hft {
+namespace strategy {
+
+VolumeCurve::VolumeCurve(uint64_t bucket_ns)
+    : bucket_ns_(std::min(std::max<uint64_t>(bucket_ns, 1000000000ULL), NS_PER_DAY)),
+      buckets_((NS_PER_DAY + bucket_ns_ - 1) / bucket_ns_, 0.0),
+      total_(0.0) {}
+
+double VolumeCurve::volume(uint64_t from_ns, uint64_t to_ns) const {
+    if (to_ns <= from_ns) {
+        return 0.0;
+    }
+    uint64_t span = to_ns - from_ns;
+    double result = static_cast<double>(span / NS_PER_DAY) * total_;  // Whole days
+    uint64_t start = from_ns % NS_PER_DAY;
+    uint64_t remaining = span % NS_PER_DAY;
+    while (remaining > 0) {
+        size_t index = start / bucket_ns_;
+        uint64_t bucket_end = std::min<uint64_t>((index + 1) * bucket_ns_, NS_PER_DAY);
+        uint64_t take = std::min(remaining, bucket_end - start);
+        uint64_t width = bucket_end - index * bucket_ns_;
+        result += buckets_[index] * static_cast<double>(take) / static_cast<double>(width);
+        remaining -= take;
+        start = bucket_end == NS_PER_DAY ? 0 : bucket_end;
+    }
+    return result;
+}
+
+void VolumeCurve::clear() {
+    std::fill(buckets_.begin(), buckets_.end(), 0.0);
+    total_ = 0.0;
+}
+
+} // namespace strategy
+} // namespace hft
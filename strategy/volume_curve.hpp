@@ -0,0 +1,48 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace hft {
+namespace strategy {
+
+constexpr uint64_t NS_PER_DAY = 86400ULL * 1000000000ULL;
+
+// Intraday traded-volume profile for VWAP scheduling: trade sizes summed
+// into fixed time-of-day buckets (UTC), across however many sessions have
+// been fed in. Only the shape matters, so days need not be normalized.
+class VolumeCurve {
+public:
+    static constexpr uint64_t DEFAULT_BUCKET_NS = 300ULL * 1000000000ULL;  // 5 minutes
+
+    explicit VolumeCurve(uint64_t bucket_ns = DEFAULT_BUCKET_NS);
+
+    void add(uint64_t timestamp_ns, int64_t quantity) {
+        if (quantity > 0) {
+            buckets_[bucket_of(timestamp_ns)] += static_cast<double>(quantity);
+            total_ += static_cast<double>(quantity);
+        }
+    }
+
+    // Volume expected in [from_ns, to_ns), partial buckets pro rata; spans
+    // wrap around midnight
+    double volume(uint64_t from_ns, uint64_t to_ns) const;
+
+    void clear();
+
+    double total() const { return total_; }
+    uint64_t bucket_ns() const { return bucket_ns_; }
+    size_t bucket_count() const { return buckets_.size(); }
+    double bucket(size_t index) const { return buckets_[index]; }
+
+private:
+    size_t bucket_of(uint64_t timestamp_ns) const { return (timestamp_ns % NS_PER_DAY) / bucket_ns_; }
+
+    uint64_t bucket_ns_;
+    std::vector<double> buckets_;
+    double total_;
+};
+
+} // namespace strategy
+} // namespace hft